@@ -31,7 +31,9 @@
 
 #include "ns3/ipv4-address.h"
 #include "ns3/simulator.h"
-#include <vector>
+#include "ns3/sgi-hashmap.h"
+#include <map>
+#include <utility>
 
 namespace ns3
 {
@@ -41,6 +43,9 @@ namespace aodv
  * \ingroup aodv
  * 
  * \brief Unique packets identification cache used for simple duplicate detection.
+ *
+ * The IDs are hashed, and also ordered by expiration time so that Purge
+ * only visits the expired records.
  */
 class IdCache
 {
@@ -58,25 +63,21 @@ public:
   /// Return lifetime for existing entries in cache
   Time GetLifeTime () const { return m_lifetime; }
 private:
-  /// Unique packet ID
-  struct UniqueId
-  {
-    /// ID is supposed to be unique in single address context (e.g. sender address)
-    Ipv4Address m_context;
-    /// The id
-    uint32_t m_id;
-    /// When record will expire
-    Time m_expire;
-  };
-  struct IsExpired
+  /// Unique packet ID: the address, and the ID, which is supposed to be
+  /// unique in single address context (e.g. sender address)
+  typedef std::pair<Ipv4Address, uint32_t> UniqueId;
+  /// Hash function of the unique packet IDs
+  struct UniqueIdHash
   {
-    bool operator() (const struct UniqueId & u) const
+    size_t operator() (const UniqueId & u) const
     {
-      return (u.m_expire < Simulator::Now ());
+      return Ipv4AddressHash () (u.first) ^ (u.second * 0x9e3779b9U);
     }
   };
-  /// Already seen IDs
-  std::vector<UniqueId> m_idCache;
+  /// Already seen IDs, with the time when the record will expire
+  sgi::hash_map<UniqueId, Time, UniqueIdHash> m_idCache;
+  /// Already seen IDs, by the time when the record will expire
+  std::multimap<Time, UniqueId> m_expiry;
   /// Default lifetime for ID records
   Time m_lifetime;
 };
@@ -27,10 +27,10 @@
  */
 #include "aodv-rqueue.h"
 #include <algorithm>
-#include <functional>
 #include "ns3/ipv4-route.h"
 #include "ns3/socket.h"
 #include "ns3/log.h"
+#include "ns3/assert.h"
 
 namespace ns3
 {
@@ -50,21 +50,29 @@ bool
 RequestQueue::Enqueue (QueueEntry & entry)
 {
   Purge ();
-  for (std::vector<QueueEntry>::const_iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  Ipv4Address dst = entry.GetIpv4Header ().GetDestination ();
+  DestinationIndex::const_iterator d = m_destinations.find (dst);
+  if (d != m_destinations.end ())
     {
-      if ((i->GetPacket ()->GetUid () == entry.GetPacket ()->GetUid ())
-          && (i->GetIpv4Header ().GetDestination ()
-              == entry.GetIpv4Header ().GetDestination ()))
-        return false;
+      for (std::vector<Queue::iterator>::const_iterator i = d->second.begin (); i
+           != d->second.end (); ++i)
+        {
+          if ((*i)->GetPacket ()->GetUid () == entry.GetPacket ()->GetUid ())
+            return false;
+        }
     }
   entry.SetExpireTime (m_queueTimeout);
   if (m_queue.size () == m_maxLen)
     {
       Drop (m_queue.front (), "Drop the most aged packet"); // Drop the most aged packet
-      m_queue.erase (m_queue.begin ());
+      Erase (m_queue.begin ());
+    }
+  Time expire = m_queueTimeout + Simulator::Now ();
+  if (m_queue.empty () || expire < m_nextExpire)
+    {
+      m_nextExpire = expire;
     }
-  m_queue.push_back (entry);
+  m_destinations[dst].push_back (m_queue.insert (m_queue.end (), entry));
   return true;
 }
 
@@ -73,69 +81,80 @@ RequestQueue::DropPacketWithDst (Ipv4Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
   Purge ();
-  for (std::vector<QueueEntry>::iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  DestinationIndex::iterator d = m_destinations.find (dst);
+  if (d == m_destinations.end ())
+    return;
+  std::vector<Queue::iterator> entries;
+  entries.swap (d->second);
+  m_destinations.erase (d);
+  for (std::vector<Queue::iterator>::const_iterator i = entries.begin (); i
+       != entries.end (); ++i)
     {
-      if (IsEqual (*i, dst))
-        {
-          Drop (*i, "DropPacketWithDst ");
-        }
+      Drop (**i, "DropPacketWithDst ");
+    }
+  for (std::vector<Queue::iterator>::const_iterator i = entries.begin (); i
+       != entries.end (); ++i)
+    {
+      m_queue.erase (*i);
     }
-  m_queue.erase (std::remove_if (m_queue.begin (), m_queue.end (),
-                                 std::bind2nd (std::ptr_fun (RequestQueue::IsEqual), dst)), m_queue.end ());
 }
 
 bool
 RequestQueue::Dequeue (Ipv4Address dst, QueueEntry & entry)
 {
   Purge ();
-  for (std::vector<QueueEntry>::iterator i = m_queue.begin (); i != m_queue.end (); ++i)
-    {
-      if (i->GetIpv4Header ().GetDestination () == dst)
-        {
-          entry = *i;
-          m_queue.erase (i);
-          return true;
-        }
-    }
-  return false;
+  DestinationIndex::const_iterator d = m_destinations.find (dst);
+  if (d == m_destinations.end ())
+    return false;
+  Queue::iterator i = d->second.front ();
+  entry = *i;
+  Erase (i);
+  return true;
 }
 
 bool
 RequestQueue::Find (Ipv4Address dst)
 {
-  for (std::vector<QueueEntry>::const_iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
-    {
-      if (i->GetIpv4Header ().GetDestination () == dst)
-        return true;
-    }
-  return false;
+  return m_destinations.find (dst) != m_destinations.end ();
 }
 
-struct IsExpired
+void
+RequestQueue::Erase (Queue::iterator i)
 {
-  bool
-  operator() (QueueEntry const & e) const
-  {
-    return (e.GetExpireTime () < Seconds (0));
-  }
-};
+  DestinationIndex::iterator d = m_destinations.find (i->GetIpv4Header ().GetDestination ());
+  NS_ASSERT (d != m_destinations.end ());
+  d->second.erase (std::find (d->second.begin (), d->second.end (), i));
+  if (d->second.empty ())
+    {
+      m_destinations.erase (d);
+    }
+  m_queue.erase (i);
+}
 
 void
 RequestQueue::Purge ()
 {
-  IsExpired pred;
-  for (std::vector<QueueEntry>::iterator i = m_queue.begin (); i
-       != m_queue.end (); ++i)
+  Time now = Simulator::Now ();
+  if (m_queue.empty () || !(m_nextExpire < now))
+    {
+      return;
+    }
+  Time nextExpire = Time::Max ();
+  for (Queue::iterator i = m_queue.begin (); i != m_queue.end (); )
     {
-      if (pred (*i))
+      Time expire = i->GetExpireTime ();
+      if (expire < Seconds (0))
         {
           Drop (*i, "Drop outdated packet ");
+          Erase (i++);
+        }
+      else
+        {
+          nextExpire = std::min (nextExpire, expire + now);
+          ++i;
         }
     }
-  m_queue.erase (std::remove_if (m_queue.begin (), m_queue.end (), pred),
-                 m_queue.end ());
+  m_nextExpire = nextExpire;
 }
 
 void
@@ -28,9 +28,11 @@
 #ifndef AODV_RQUEUE_H
 #define AODV_RQUEUE_H
 
+#include <list>
 #include <vector>
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/simulator.h"
+#include "ns3/sgi-hashmap.h"
 
 
 namespace ns3 {
@@ -92,6 +94,10 @@ private:
  * \brief AODV route request queue
  * 
  * Since AODV is an on demand routing we queue requests while looking for route.
+ *
+ * The entries are kept in arrival order and are also indexed by
+ * destination. The earliest expiration time of the entries is tracked,
+ * so that Purge only visits the queue when an entry may have expired.
  */
 class RequestQueue
 {
@@ -119,8 +125,19 @@ public:
   void SetQueueTimeout (Time t) { m_queueTimeout = t; }
 
 private:
-  
-  std::vector<QueueEntry> m_queue;
+  /// Queue entries container
+  typedef std::list<QueueEntry> Queue;
+  /// The entries of each destination, the most aged first
+  typedef sgi::hash_map<Ipv4Address, std::vector<Queue::iterator>, Ipv4AddressHash> DestinationIndex;
+
+  /// The queue entries, the most aged first
+  Queue m_queue;
+  /// The entries by destination
+  DestinationIndex m_destinations;
+  /// No entry expires before this time
+  Time m_nextExpire;
+  /// Remove an entry from the queue and from the destination index
+  void Erase (Queue::iterator i);
   /// Remove all expired entries
   void Purge ();
   /// Notify that packet is dropped from queue by timeout
@@ -129,7 +146,6 @@ private:
   uint32_t m_maxLen;
   /// The maximum period of time that a routing protocol is allowed to buffer a packet for, seconds.
   Time m_queueTimeout;
-  static bool IsEqual (QueueEntry en, const Ipv4Address dst) { return (en.GetIpv4Header ().GetDestination () == dst); }
 };
 
 
@@ -93,12 +93,73 @@ IdCacheTest::CheckTimeout3 ()
   NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 0, "All records expire");
 }
 //-----------------------------------------------------------------------------
+/// Unit test for the expiration order of the id cache records
+class IdCacheExpiryOrderTest : public TestCase
+{
+public:
+  IdCacheExpiryOrderTest () : TestCase ("Id Cache expiration order"), cache (Seconds (10))
+  {}
+  virtual void DoRun ();
+
+private:
+  void CheckTimeout1 ();
+  void CheckTimeout2 ();
+  void CheckTimeout3 ();
+
+  IdCache cache;
+};
+
+void
+IdCacheExpiryOrderTest::DoRun ()
+{
+  // the records added last expire first
+  cache.IsDuplicate (Ipv4Address ("1.1.1.1"), 1);
+  cache.IsDuplicate (Ipv4Address ("2.2.2.2"), 2);
+  cache.SetLifetime (Seconds (2));
+  cache.IsDuplicate (Ipv4Address ("3.3.3.3"), 3);
+  cache.IsDuplicate (Ipv4Address ("4.4.4.4"), 4);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 4, "trivial");
+
+  Simulator::Schedule (Seconds (3), &IdCacheExpiryOrderTest::CheckTimeout1, this);
+  Simulator::Schedule (Seconds (6), &IdCacheExpiryOrderTest::CheckTimeout2, this);
+  Simulator::Schedule (Seconds (11), &IdCacheExpiryOrderTest::CheckTimeout3, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+IdCacheExpiryOrderTest::CheckTimeout1 ()
+{
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 2, "The short lived records expire");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (Ipv4Address ("1.1.1.1"), 1), true, "Long lived record");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (Ipv4Address ("2.2.2.2"), 2), true, "Long lived record");
+  // an expired ID is recorded again, until 5 s
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (Ipv4Address ("3.3.3.3"), 3), false, "Expired record");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (Ipv4Address ("3.3.3.3"), 3), true, "Record added again");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 3, "trivial");
+}
+
+void
+IdCacheExpiryOrderTest::CheckTimeout2 ()
+{
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 2, "The record added again expires");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (Ipv4Address ("3.3.3.3"), 3), false, "Expired record");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (Ipv4Address ("1.1.1.1"), 1), true, "Long lived record");
+}
+
+void
+IdCacheExpiryOrderTest::CheckTimeout3 ()
+{
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 0, "All records expire");
+}
+//-----------------------------------------------------------------------------
 class IdCacheTestSuite : public TestSuite
 {
 public:
   IdCacheTestSuite () : TestSuite ("aodv-routing-id-cache", UNIT)
   {
     AddTestCase (new IdCacheTest, TestCase::QUICK);
+    AddTestCase (new IdCacheExpiryOrderTest, TestCase::QUICK);
   }
 } g_idCacheTestSuite;
 
@@ -388,6 +388,122 @@ AodvRqueueTest::CheckTimeout ()
   NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 0, "Must be empty now");
 }
 //-----------------------------------------------------------------------------
+/// Unit test for the drops of the RequestQueue
+struct AodvRqueueDropTest : public TestCase
+{
+  AodvRqueueDropTest () : TestCase ("Rqueue drops"), q (4, Seconds (10)) {}
+  virtual void DoRun ();
+  void Unicast (Ptr<Ipv4Route> route, Ptr<const Packet> packet, const Ipv4Header & header) {}
+  void Error (Ptr<const Packet> packet, const Ipv4Header & header, Socket::SocketErrno) { dropped.push_back (packet); }
+  /// Enqueue a new packet for dst, and return it
+  Ptr<const Packet> Enqueue (Ipv4Address dst);
+  void CheckTimeout1 ();
+  void CheckTimeout2 ();
+
+  RequestQueue q;
+  std::vector<Ptr<const Packet> > dropped;
+  Ptr<const Packet> shortLived;
+  Ptr<const Packet> longLived;
+};
+
+Ptr<const Packet>
+AodvRqueueDropTest::Enqueue (Ipv4Address dst)
+{
+  Ptr<const Packet> packet = Create<Packet> ();
+  Ipv4Header h;
+  h.SetDestination (dst);
+  QueueEntry e (packet, h, MakeCallback (&AodvRqueueDropTest::Unicast, this), MakeCallback (&AodvRqueueDropTest::Error, this));
+  q.Enqueue (e);
+  return packet;
+}
+
+void
+AodvRqueueDropTest::DoRun ()
+{
+  Ipv4Address a ("1.1.1.1");
+  Ipv4Address b ("2.2.2.2");
+  Ipv4Address c ("3.3.3.3");
+
+  // drop by destination, in arrival order, without touching the other destinations
+  Ptr<const Packet> a1 = Enqueue (a);
+  Ptr<const Packet> b1 = Enqueue (b);
+  Ptr<const Packet> a2 = Enqueue (a);
+  Ptr<const Packet> c1 = Enqueue (c);
+  q.DropPacketWithDst (a);
+  NS_TEST_EXPECT_MSG_EQ (dropped.size (), 2, "The two packets to 1.1.1.1 are dropped");
+  if (dropped.size () == 2)
+    {
+      NS_TEST_EXPECT_MSG_EQ (dropped[0], a1, "The oldest packet is dropped first");
+      NS_TEST_EXPECT_MSG_EQ (dropped[1], a2, "The newest packet is dropped last");
+    }
+  NS_TEST_EXPECT_MSG_EQ (q.Find (a), false, "No packet left to 1.1.1.1");
+  NS_TEST_EXPECT_MSG_EQ (q.Find (b), true, "The packet to 2.2.2.2 is kept");
+  NS_TEST_EXPECT_MSG_EQ (q.Find (c), true, "The packet to 3.3.3.3 is kept");
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 2, "Two packets left");
+  q.DropPacketWithDst (a);
+  NS_TEST_EXPECT_MSG_EQ (dropped.size (), 2, "Nothing more to drop");
+
+  // when the queue is full, the most aged packet is dropped, and is no longer found
+  dropped.clear ();
+  Ptr<const Packet> a3 = Enqueue (a);
+  Ptr<const Packet> c2 = Enqueue (c);
+  Ptr<const Packet> a4 = Enqueue (a);
+  NS_TEST_EXPECT_MSG_EQ (dropped.size (), 1, "The queue holds 4 packets");
+  if (dropped.size () == 1)
+    {
+      NS_TEST_EXPECT_MSG_EQ (dropped[0], b1, "The most aged packet is dropped");
+    }
+  NS_TEST_EXPECT_MSG_EQ (q.Find (b), false, "No packet left to 2.2.2.2");
+  QueueEntry e;
+  NS_TEST_EXPECT_MSG_EQ (q.Dequeue (c, e), true, "Packets to 3.3.3.3");
+  NS_TEST_EXPECT_MSG_EQ (e.GetPacket (), c1, "The oldest packet to 3.3.3.3 first");
+  NS_TEST_EXPECT_MSG_EQ (q.Dequeue (a, e), true, "Packets to 1.1.1.1");
+  NS_TEST_EXPECT_MSG_EQ (e.GetPacket (), a3, "The oldest packet to 1.1.1.1 first");
+  q.DropPacketWithDst (a);
+  q.DropPacketWithDst (c);
+  NS_TEST_EXPECT_MSG_EQ (dropped.size (), 3, "The packets left are dropped");
+  if (dropped.size () == 3)
+    {
+      NS_TEST_EXPECT_MSG_EQ (dropped[1], a4, "trivial");
+      NS_TEST_EXPECT_MSG_EQ (dropped[2], c2, "trivial");
+    }
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 0, "Empty queue");
+
+  // a packet queued with a shorter timeout expires first
+  dropped.clear ();
+  longLived = Enqueue (a);
+  q.SetQueueTimeout (Seconds (2));
+  shortLived = Enqueue (b);
+  Simulator::Schedule (Seconds (3), &AodvRqueueDropTest::CheckTimeout1, this);
+  Simulator::Schedule (Seconds (11), &AodvRqueueDropTest::CheckTimeout2, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+AodvRqueueDropTest::CheckTimeout1 ()
+{
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 1, "The packet to 2.2.2.2 has expired");
+  NS_TEST_EXPECT_MSG_EQ (dropped.size (), 1, "One packet dropped");
+  if (dropped.size () == 1)
+    {
+      NS_TEST_EXPECT_MSG_EQ (dropped[0], shortLived, "The packet to 2.2.2.2 is dropped");
+    }
+  NS_TEST_EXPECT_MSG_EQ (q.Find (Ipv4Address ("1.1.1.1")), true, "The packet to 1.1.1.1 is kept");
+  NS_TEST_EXPECT_MSG_EQ (q.Find (Ipv4Address ("2.2.2.2")), false, "No packet left to 2.2.2.2");
+}
+
+void
+AodvRqueueDropTest::CheckTimeout2 ()
+{
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 0, "Must be empty now");
+  NS_TEST_EXPECT_MSG_EQ (dropped.size (), 2, "Both packets dropped");
+  if (dropped.size () == 2)
+    {
+      NS_TEST_EXPECT_MSG_EQ (dropped[1], longLived, "The packet to 1.1.1.1 is dropped last");
+    }
+}
+//-----------------------------------------------------------------------------
 /// Unit test for AODV routing table entry
 struct AodvRtableEntryTest : public TestCase
 {
@@ -533,6 +649,7 @@ public:
     AddTestCase (new RerrHeaderTest, TestCase::QUICK);
     AddTestCase (new QueueEntryTest, TestCase::QUICK);
     AddTestCase (new AodvRqueueTest, TestCase::QUICK);
+    AddTestCase (new AodvRqueueDropTest, TestCase::QUICK);
     AddTestCase (new AodvRtableEntryTest, TestCase::QUICK);
     AddTestCase (new AodvRtableTest, TestCase::QUICK);
   }
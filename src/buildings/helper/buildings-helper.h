@@ -53,12 +53,16 @@ public:
   * the list, calls BuildingsHelper::MakeConsistent() passing to it
   * the MobilityModel of that node. 
   *
+  * The MobilityBuildingInfo instances update themselves when their
+  * node moves, so this method is only needed when the buildings
+  * change after the positions were looked up.
   */
   static void MakeMobilityModelConsistent ();
   /**
   * Make the given mobility model consistent, by determining whether
   * its position falls inside any of the building in BuildingList, and
   * updating accordingly the BuildingInfo aggregated with the MobilityModel.
+  * The building is looked up through BuildingList::FindBuilding.
   *
   * \param bmm the mobility model to be made consistent
   */
@@ -25,8 +25,11 @@
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "building-list.h"
 #include "building.h"
+#include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -47,6 +50,8 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  Ptr<Building> FindBuilding (const Vector &position);
+  void NotifyBoundariesChanged (void);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -54,7 +59,27 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  /**
+   * Build the grid of the buildings from their current boundaries.
+   */
+  void BuildGrid (void);
+  /**
+   * \param v a coordinate.
+   * \param min the lowest coordinate of the grid.
+   * \param size the size of the cells.
+   * \param n the number of cells.
+   * \returns the index of the cell of the coordinate, clamped to the grid.
+   */
+  static uint32_t GetCell (double v, double min, double size, uint32_t n);
   std::vector<Ptr<Building> > m_buildings;
+  bool m_gridValid;         //!< True if the grid matches the buildings.
+  double m_gridXMin;        //!< The lowest X coordinate of the grid.
+  double m_gridYMin;        //!< The lowest Y coordinate of the grid.
+  double m_cellSizeX;       //!< The size of the cells along the X axis.
+  double m_cellSizeY;       //!< The size of the cells along the Y axis.
+  uint32_t m_nCells;        //!< The number of cells along each axis.
+  /// The indices of the buildings which overlap each cell, row by row.
+  std::vector<std::vector<uint32_t> > m_cells;
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +125,12 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_gridValid (false),
+    m_gridXMin (0),
+    m_gridYMin (0),
+    m_cellSizeX (0),
+    m_cellSizeY (0),
+    m_nCells (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +149,8 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  m_cells.clear ();
+  m_gridValid = false;
   Object::DoDispose ();
 }
 
@@ -127,6 +160,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_gridValid = false;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +189,108 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::NotifyBoundariesChanged (void)
+{
+  m_gridValid = false;
+}
+
+uint32_t
+BuildingListPriv::GetCell (double v, double min, double size, uint32_t n)
+{
+  if (size <= 0)
+    {
+      return 0;
+    }
+  double cell = std::floor ((v - min) / size);
+  if (cell < 0)
+    {
+      return 0;
+    }
+  if (cell >= n)
+    {
+      return n - 1;
+    }
+  return static_cast<uint32_t> (cell);
+}
+
+void
+BuildingListPriv::BuildGrid (void)
+{
+  NS_LOG_FUNCTION (this << m_buildings.size ());
+  m_gridValid = true;
+  m_cells.clear ();
+  m_nCells = 0;
+  if (m_buildings.empty ())
+    {
+      return;
+    }
+  Box bounds = m_buildings.front ()->GetBoundaries ();
+  for (std::vector<Ptr<Building> >::const_iterator i = m_buildings.begin ();
+       i != m_buildings.end (); i++)
+    {
+      Box box = (*i)->GetBoundaries ();
+      bounds.xMin = std::min (bounds.xMin, box.xMin);
+      bounds.xMax = std::max (bounds.xMax, box.xMax);
+      bounds.yMin = std::min (bounds.yMin, box.yMin);
+      bounds.yMax = std::max (bounds.yMax, box.yMax);
+    }
+  // About one building per cell when the buildings are spread evenly.
+  m_nCells = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (m_buildings.size ()))));
+  m_gridXMin = bounds.xMin;
+  m_gridYMin = bounds.yMin;
+  m_cellSizeX = (bounds.xMax - bounds.xMin) / m_nCells;
+  m_cellSizeY = (bounds.yMax - bounds.yMin) / m_nCells;
+  m_cells.resize (m_nCells * m_nCells);
+  // A position inside a box is between its corners on each axis, and so
+  // is its cell, since GetCell is monotonic.
+  for (uint32_t n = 0; n < m_buildings.size (); n++)
+    {
+      Box box = m_buildings[n]->GetBoundaries ();
+      uint32_t xFirst = GetCell (box.xMin, m_gridXMin, m_cellSizeX, m_nCells);
+      uint32_t xLast = GetCell (box.xMax, m_gridXMin, m_cellSizeX, m_nCells);
+      uint32_t yFirst = GetCell (box.yMin, m_gridYMin, m_cellSizeY, m_nCells);
+      uint32_t yLast = GetCell (box.yMax, m_gridYMin, m_cellSizeY, m_nCells);
+      for (uint32_t y = yFirst; y <= yLast; y++)
+        {
+          for (uint32_t x = xFirst; x <= xLast; x++)
+            {
+              m_cells[y * m_nCells + x].push_back (n);
+            }
+        }
+    }
+}
+
+Ptr<Building>
+BuildingListPriv::FindBuilding (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  if (!m_gridValid)
+    {
+      BuildGrid ();
+    }
+  if (m_cells.empty ())
+    {
+      return 0;
+    }
+  uint32_t x = GetCell (position.x, m_gridXMin, m_cellSizeX, m_nCells);
+  uint32_t y = GetCell (position.y, m_gridYMin, m_cellSizeY, m_nCells);
+  const std::vector<uint32_t> &cell = m_cells[y * m_nCells + x];
+  Ptr<Building> found = 0;
+  for (std::vector<uint32_t>::const_iterator i = cell.begin (); i != cell.end (); i++)
+    {
+      Ptr<Building> building = m_buildings[*i];
+      NS_LOG_LOGIC ("checking building " << building->GetId () << " with boundaries " << building->GetBoundaries ());
+      if (building->IsInside (position))
+        {
+          NS_ABORT_MSG_UNLESS (found == 0, "position " << position << " falls inside buildings "
+                                                       << found->GetId () << " and " << building->GetId ());
+          found = building;
+        }
+    }
+  return found;
+}
+
 }
 
 /**
@@ -189,5 +325,15 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+Ptr<Building>
+BuildingList::FindBuilding (const Vector &position)
+{
+  return BuildingListPriv::Get ()->FindBuilding (position);
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->NotifyBoundariesChanged ();
+}
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,26 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param position a position.
+   * \returns the Building inside which the position falls, or 0 if
+   *          the position is outdoor.
+   *
+   * The buildings are looked up through a uniform grid over their
+   * boundaries on the XY plane, so that only the buildings which
+   * overlap the grid cell of the position are checked. The grid is
+   * rebuilt at the first lookup after a building is added or its
+   * boundaries change. It is a fatal error for the position to fall
+   * inside more than one building.
+   */
+  static Ptr<Building> FindBuilding (const Vector &position);
+  /**
+   * Notify the list that the boundaries of a building changed.
+   *
+   * This method is called automatically from Building::SetBoundaries
+   * so the user has little reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
@@ -25,7 +25,15 @@
 #include "ns3/mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/node.h"
+#include "ns3/abort.h"
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 #include "buildings-propagation-loss-model.h"
 #include <ns3/mobility-building-info.h>
 #include "ns3/enum.h"
@@ -37,26 +45,21 @@ NS_LOG_COMPONENT_DEFINE ("BuildingsPropagationLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingsPropagationLossModel);
 
-BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss ()
+BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss (ShadowingKey key, double value, Time now)
+  : m_key (key),
+    m_value (value),
+    m_drawn (now),
+    m_used (now)
 {
+  NS_LOG_INFO (this << " New Shadowing value " << m_value);
 }
 
-BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss (double shadowingValue, Ptr<MobilityModel> receiver)
-  : m_shadowingValue (shadowingValue), m_receiver (receiver)
+size_t
+BuildingsPropagationLossModel::ShadowingKeyHash::operator () (const ShadowingKey &key) const
 {
-  NS_LOG_INFO (this << " New Shadowing value " << m_shadowingValue);
-}
-
-double
-BuildingsPropagationLossModel::ShadowingLoss::GetLoss () const
-{
-  return (m_shadowingValue);
-}
-
-Ptr<MobilityModel>
-BuildingsPropagationLossModel::ShadowingLoss::GetReceiver () const
-{
-  return m_receiver;
+  size_t a = reinterpret_cast<size_t> (PeekPointer (key.first));
+  size_t b = reinterpret_cast<size_t> (PeekPointer (key.second));
+  return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
 }
 
 TypeId
@@ -89,7 +92,30 @@ BuildingsPropagationLossModel::GetTypeId (void)
                    "Additional loss for each internal wall [dB]",
                    DoubleValue (5.0),
                    MakeDoubleAccessor (&BuildingsPropagationLossModel::m_lossInternalWall),
-                   MakeDoubleChecker<double> ());
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("ShadowingMode",
+                   "How the shadowing of a pair of nodes is kept: drawn and stored, "
+                   "or computed again from a hash of the node ids and of the seed",
+                   EnumValue (BuildingsPropagationLossModel::STORED),
+                   MakeEnumAccessor (&BuildingsPropagationLossModel::m_shadowingMode),
+                   MakeEnumChecker (BuildingsPropagationLossModel::STORED, "Stored",
+                                    BuildingsPropagationLossModel::HASHED, "Hashed"))
+    .AddAttribute ("SymmetricShadowing",
+                   "If true, the shadowing from a to b is the same as from b to a",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&BuildingsPropagationLossModel::m_symmetricShadowing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ShadowingCacheSize",
+                   "The maximum number of stored shadowing values (0 means no limit); "
+                   "the least recently used ones are dropped first",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&BuildingsPropagationLossModel::m_shadowingCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ShadowingLifetime",
+                   "The time after which a shadowing value is drawn again (0 means never)",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&BuildingsPropagationLossModel::m_shadowingLifetime),
+                   MakeTimeChecker ());
 
 
   return tid;
@@ -153,33 +179,97 @@ const
     Ptr<MobilityBuildingInfo> b1 = b->GetObject <MobilityBuildingInfo> ();
     NS_ASSERT_MSG ((a1 != 0) && (b1 != 0), "BuildingsPropagationLossModel only works with MobilityBuildingInfo");
   
-  std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> >::iterator ait = m_shadowingLossMap.find (a);
-  if (ait != m_shadowingLossMap.end ())
+  if (m_shadowingMode == HASHED)
     {
-      std::map<Ptr<MobilityModel>, ShadowingLoss>::iterator bit = ait->second.find (b);
-      if (bit != ait->second.end ())
-        {
-          return (bit->second.GetLoss ());
-        }
-      else
+      return GetHashedShadowing (a, b, EvaluateSigma (a1, b1));
+    }
+
+  ShadowingKey key (a, b);
+  if (m_symmetricShadowing && PeekPointer (b) < PeekPointer (a))
+    {
+      key = ShadowingKey (b, a);
+    }
+  Time now;
+  if (!m_shadowingLifetime.IsZero ())
+    {
+      now = Simulator::Now ();
+      PurgeShadowing (now);
+    }
+  ShadowingIndex::iterator it = m_shadowingIndex.find (key);
+  if (it != m_shadowingIndex.end ())
+    {
+      ShadowingList::iterator loss = it->second;
+      if (!m_shadowingLifetime.IsZero () && now - loss->m_drawn >= m_shadowingLifetime)
         {
           double sigma = EvaluateSigma (a1, b1);
-          // side effect: will create new entry          
-          // sigma is standard deviation, not variance
-          double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
-          ait->second[b] = ShadowingLoss (shadowingValue, b);          
-          return (ait->second[b].GetLoss ());
+          loss->m_value = m_randVariable->GetValue (0.0, (sigma*sigma));
+          loss->m_drawn = now;
         }
+      loss->m_used = now;
+      m_shadowingList.splice (m_shadowingList.end (), m_shadowingList, loss);
+      return loss->m_value;
     }
-  else
+
+  double sigma = EvaluateSigma (a1, b1);
+  // sigma is standard deviation, not variance
+  double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
+  m_shadowingIndex[key] = m_shadowingList.insert (m_shadowingList.end (), ShadowingLoss (key, shadowingValue, now));
+  if (m_shadowingCacheSize > 0 && m_shadowingIndex.size () > m_shadowingCacheSize)
+    {
+      m_shadowingIndex.erase (m_shadowingList.front ().m_key);
+      m_shadowingList.pop_front ();
+    }
+  return shadowingValue;
+}
+
+void
+BuildingsPropagationLossModel::PurgeShadowing (Time now) const
+{
+  while (!m_shadowingList.empty ()
+         && now - m_shadowingList.front ().m_used >= m_shadowingLifetime)
+    {
+      m_shadowingIndex.erase (m_shadowingList.front ().m_key);
+      m_shadowingList.pop_front ();
+    }
+}
+
+double
+BuildingsPropagationLossModel::GetHashedShadowing (Ptr<MobilityModel> a, Ptr<MobilityModel> b, double sigma) const
+{
+  Ptr<Node> aNode = a->GetObject<Node> ();
+  Ptr<Node> bNode = b->GetObject<Node> ();
+  NS_ABORT_MSG_IF ((aNode == 0) || (bNode == 0), "The Hashed shadowing mode needs the mobility models to be aggregated to nodes");
+  uint32_t ids[2] = { aNode->GetId (), bNode->GetId () };
+  if (m_symmetricShadowing && ids[1] < ids[0])
+    {
+      std::swap (ids[0], ids[1]);
+    }
+  // The lifetime divides the time into periods with independent values.
+  int64_t period = 0;
+  if (!m_shadowingLifetime.IsZero ())
     {
-      double sigma = EvaluateSigma (a1, b1);
-      // side effect: will create new entries in both maps
-      // sigma is standard deviation, not variance
-      double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
-      m_shadowingLossMap[a][b] = ShadowingLoss (shadowingValue, b);  
-      return (m_shadowingLossMap[a][b].GetLoss ());       
+      period = Simulator::Now ().GetTimeStep () / m_shadowingLifetime.GetTimeStep ();
     }
+  uint32_t seed = RngSeedManager::GetSeed ();
+  uint64_t run = RngSeedManager::GetRun ();
+  int64_t stream = m_randVariable->GetStream ();
+  char buffer[sizeof (ids) + sizeof (seed) + sizeof (run) + sizeof (stream) + sizeof (period)];
+  char *p = buffer;
+  std::memcpy (p, ids, sizeof (ids));
+  p += sizeof (ids);
+  std::memcpy (p, &seed, sizeof (seed));
+  p += sizeof (seed);
+  std::memcpy (p, &run, sizeof (run));
+  p += sizeof (run);
+  std::memcpy (p, &stream, sizeof (stream));
+  p += sizeof (stream);
+  std::memcpy (p, &period, sizeof (period));
+  uint64_t hash = m_hasher.clear ().GetHash64 (buffer, sizeof (buffer));
+
+  // Box-Muller transform of two uniform values in (0, 1)
+  double u1 = ((hash >> 32) + 0.5) / 4294967296.0;
+  double u2 = ((hash & 0xffffffff) + 0.5) / 4294967296.0;
+  return sigma * std::sqrt (-2.0 * std::log (u1)) * std::cos (2.0 * M_PI * u2);
 }
 
 
@@ -26,8 +26,11 @@
 #include "ns3/nstime.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/hash.h"
+#include "ns3/sgi-hashmap.h"
 #include <ns3/building.h>
 #include <ns3/mobility-building-info.h>
+#include <list>
 
 
 
@@ -52,6 +55,16 @@ class JakesFadingLossModel;
  *  \warning This model works only when MobilityBuildingInfo is aggreegated
  *  to the mobility model
  *
+ *  By default, the shadowing of a pair of mobility models is drawn at the
+ *  first evaluation of the pair and stored for the rest of the simulation.
+ *  The ShadowingCacheSize and ShadowingLifetime attributes bound the
+ *  storage: the least recently used pairs are dropped when there are too
+ *  many, and the values older than the lifetime are drawn again. With
+ *  SymmetricShadowing, the pairs (a, b) and (b, a) share their value.
+ *  In the Hashed shadowing mode, nothing is stored: the value is computed
+ *  again at each evaluation from a hash of the node ids and of the seed,
+ *  run and stream of the random variable, so that it is the same at each
+ *  evaluation of the pair.
  */
 
 class BuildingsPropagationLossModel : public PropagationLossModel
@@ -60,6 +73,13 @@ class BuildingsPropagationLossModel : public PropagationLossModel
 public:
   static TypeId GetTypeId (void);
 
+  /// How the shadowing of a pair of mobility models is kept.
+  enum ShadowingMode_t
+    {
+      STORED,  //!< Draw the value at the first evaluation of the pair and store it.
+      HASHED   //!< Compute the value again from a hash of the pair and of the seed.
+    };
+
   BuildingsPropagationLossModel ();
   /**
    * \param a the mobility model of the source
@@ -81,19 +101,61 @@ protected:
   double m_lossInternalWall; // in meters
 
   
-  class ShadowingLoss
+  /**
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param sigma the standard deviation of the shadowing
+   * \returns the shadowing of the pair in the Hashed mode
+   */
+  double GetHashedShadowing (Ptr<MobilityModel> a, Ptr<MobilityModel> b, double sigma) const;
+  /**
+   * Drop the pairs which have not been evaluated for the shadowing lifetime.
+   *
+   * \param now the current time
+   */
+  void PurgeShadowing (Time now) const;
+
+  /// A pair of mobility models.
+  typedef std::pair<Ptr<MobilityModel>, Ptr<MobilityModel> > ShadowingKey;
+
+  /// Hash function of a pair of mobility models.
+  struct ShadowingKeyHash
   {
-  public:
-    ShadowingLoss ();
-    ShadowingLoss (double shadowingValue, Ptr<MobilityModel> receiver);
-    double GetLoss () const;
-    Ptr<MobilityModel> GetReceiver (void) const;
-  protected:
-    double m_shadowingValue;
-    Ptr<MobilityModel> m_receiver;
+    /**
+     * \param key a pair of mobility models
+     * \returns the hash of the pair
+     */
+    size_t operator () (const ShadowingKey &key) const;
   };
 
-  mutable std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> > m_shadowingLossMap;
+  /// The shadowing of a pair of mobility models.
+  struct ShadowingLoss
+  {
+    /**
+     * \param key the pair of mobility models
+     * \param value the shadowing value
+     * \param now the current time
+     */
+    ShadowingLoss (ShadowingKey key, double value, Time now);
+    ShadowingKey m_key;      //!< The pair of mobility models.
+    double m_value;          //!< The shadowing value.
+    Time m_drawn;            //!< When the value was drawn.
+    Time m_used;             //!< When the value was last evaluated.
+  };
+
+  /// The stored shadowing values, from the least to the most recently used.
+  typedef std::list<ShadowingLoss> ShadowingList;
+  /// The stored shadowing values, by pair of mobility models.
+  typedef sgi::hash_map<ShadowingKey, ShadowingList::iterator, ShadowingKeyHash> ShadowingIndex;
+
+  mutable ShadowingList m_shadowingList;    //!< The stored shadowing values.
+  mutable ShadowingIndex m_shadowingIndex;  //!< The stored shadowing values, by pair.
+  mutable Hasher m_hasher;                  //!< The hash function of the Hashed mode.
+  ShadowingMode_t m_shadowingMode;          //!< How the shadowing values are kept.
+  bool m_symmetricShadowing;                //!< True if (a, b) and (b, a) share their value.
+  uint32_t m_shadowingCacheSize;            //!< The maximum number of stored pairs, 0 for no limit.
+  Time m_shadowingLifetime;                 //!< The lifetime of the values, 0 for no limit.
+
   double EvaluateSigma (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b) const;
 
 
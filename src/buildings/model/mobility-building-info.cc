@@ -22,6 +22,8 @@
 #include <ns3/simulator.h>
 #include <ns3/position-allocator.h>
 #include <ns3/mobility-building-info.h>
+#include <ns3/mobility-model.h>
+#include <ns3/building-list.h>
 #include <ns3/pointer.h>
 #include <ns3/log.h>
 #include <ns3/assert.h>
@@ -51,6 +53,7 @@ MobilityBuildingInfo::MobilityBuildingInfo ()
   m_nFloor = 1;
   m_roomX = 1;
   m_roomY = 1;
+  m_cachedPositionValid = false;
 }
 
 
@@ -62,12 +65,14 @@ MobilityBuildingInfo::MobilityBuildingInfo (Ptr<Building> building)
   m_nFloor = 1;
   m_roomX = 1;
   m_roomY = 1;
+  m_cachedPositionValid = false;
 }
 
 bool
 MobilityBuildingInfo::IsIndoor (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_indoor);
 }
 
@@ -75,6 +80,7 @@ bool
 MobilityBuildingInfo::IsOutdoor (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (!m_indoor);
 }
 
@@ -95,6 +101,7 @@ MobilityBuildingInfo::SetIndoor (Ptr<Building> building, uint8_t nfloor, uint8_t
   NS_ASSERT (m_roomY <= building->GetNRoomsY ());
   NS_ASSERT (m_nFloor > 0);
   NS_ASSERT (m_nFloor <= building->GetNFloors ());
+  CachePosition ();
 
 }
 
@@ -115,6 +122,7 @@ MobilityBuildingInfo::SetIndoor (uint8_t nfloor, uint8_t nroomx, uint8_t nroomy)
   NS_ASSERT (m_roomY <= m_myBuilding->GetNRoomsY ());
   NS_ASSERT (m_nFloor > 0);
   NS_ASSERT (m_nFloor <= m_myBuilding->GetNFloors ());
+  CachePosition ();
 
 }
 
@@ -124,12 +132,14 @@ MobilityBuildingInfo::SetOutdoor (void)
 {
   NS_LOG_FUNCTION (this);
   m_indoor = false;
+  CachePosition ();
 }
 
 uint8_t
 MobilityBuildingInfo::GetFloorNumber (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_nFloor);
 }
 
@@ -137,6 +147,7 @@ uint8_t
 MobilityBuildingInfo::GetRoomNumberX (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_roomX);
 }
 
@@ -144,6 +155,7 @@ uint8_t
 MobilityBuildingInfo::GetRoomNumberY (void)
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_roomY);
 }
 
@@ -152,8 +164,56 @@ Ptr<Building>
 MobilityBuildingInfo::GetBuilding ()
 {
   NS_LOG_FUNCTION (this);
+  Update ();
   return (m_myBuilding);
 }
 
-  
+void
+MobilityBuildingInfo::MakeConsistent (Ptr<MobilityModel> mm)
+{
+  NS_LOG_FUNCTION (this << mm);
+  Vector pos = mm->GetPosition ();
+  Ptr<Building> building = BuildingList::FindBuilding (pos);
+  if (building != 0)
+    {
+      NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos << " falls inside building " << building->GetId ());
+      uint16_t floor = building->GetFloor (pos);
+      uint16_t roomX = building->GetRoomX (pos);
+      uint16_t roomY = building->GetRoomY (pos);
+      SetIndoor (building, floor, roomX, roomY);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("MobilityBuildingInfo " << this << " pos " << pos << " is outdoor");
+      SetOutdoor ();
+    }
+}
+
+void
+MobilityBuildingInfo::Update (void)
+{
+  Ptr<MobilityModel> mm = GetObject<MobilityModel> ();
+  if (mm == 0)
+    {
+      return;
+    }
+  Vector pos = mm->GetPosition ();
+  if (!m_cachedPositionValid || pos.x != m_cachedPosition.x
+      || pos.y != m_cachedPosition.y || pos.z != m_cachedPosition.z)
+    {
+      MakeConsistent (mm);
+    }
+}
+
+void
+MobilityBuildingInfo::CachePosition (void)
+{
+  Ptr<MobilityModel> mm = GetObject<MobilityModel> ();
+  if (mm != 0)
+    {
+      m_cachedPosition = mm->GetPosition ();
+      m_cachedPositionValid = true;
+    }
+}
+
 } // namespace
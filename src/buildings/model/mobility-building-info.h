@@ -35,6 +35,7 @@
 
 namespace ns3 {
 
+class MobilityModel;
 
 /**
  * \ingroup buildings
@@ -42,7 +43,14 @@ namespace ns3 {
  *
  * This model implements the managment of scenarios where users might be
  * either indoor (e.g., houses, offices, etc.) and outdoor.
- * 
+ *
+ * The information is kept consistent with the position of the
+ * MobilityModel to which this object is aggregated: the accessors
+ * look up the building of the position again whenever it differs
+ * from the position of the last update, so that moving nodes do not
+ * need BuildingsHelper::MakeMobilityModelConsistent to be called
+ * again. A state set with SetIndoor or SetOutdoor holds until the
+ * node moves.
  */
 class MobilityBuildingInfo : public Object
 {
@@ -107,15 +115,36 @@ public:
    */
   Ptr<Building> GetBuilding ();
 
+  /**
+   * Make this MobilityBuildingInfo instance consistent with the given
+   * mobility model, by determining whether its position falls inside
+   * any of the buildings in BuildingList.
+   *
+   * \param mm the mobility model
+   */
+  void MakeConsistent (Ptr<MobilityModel> mm);
 
 
 private:
 
+  /**
+   * Call MakeConsistent with the aggregated mobility model if it moved
+   * since the last update.
+   */
+  void Update (void);
+  /**
+   * Record the current position of the aggregated mobility model as the
+   * position of the last update.
+   */
+  void CachePosition (void);
+
   Ptr<Building> m_myBuilding;
   bool m_indoor;
   uint8_t m_nFloor;
   uint8_t m_roomX;
   uint8_t m_roomY;
+  bool m_cachedPositionValid; //!< True if a position has been cached.
+  Vector m_cachedPosition;    //!< The position of the last update.
 
 };
 
@@ -26,6 +26,9 @@
 #include <ns3/constant-position-mobility-model.h>
 #include <ns3/building.h>
 #include <ns3/buildings-helper.h>
+#include <ns3/building-list.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/random-variable-stream.h>
 #include <ns3/mobility-helper.h>
 #include <ns3/simulator.h>
 
@@ -173,6 +176,101 @@ BuildingsHelperOneTestCase::DoRun ()
 
 
 
+/**
+ * Check that a moving node finds the buildings of its positions through
+ * the grid of BuildingList, without calling
+ * BuildingsHelper::MakeMobilityModelConsistent, as a scan of all the
+ * buildings would.
+ */
+class BuildingsHelperMovingNodeTestCase : public TestCase
+{
+public:
+  BuildingsHelperMovingNodeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the building information of the node at the current time.
+   *
+   * \param mm the mobility model of the node
+   */
+  void Check (Ptr<MobilityModel> mm);
+};
+
+BuildingsHelperMovingNodeTestCase::BuildingsHelperMovingNodeTestCase ()
+  : TestCase ("moving node among a grid of buildings")
+{
+}
+
+void
+BuildingsHelperMovingNodeTestCase::Check (Ptr<MobilityModel> mm)
+{
+  Vector pos = mm->GetPosition ();
+  Ptr<Building> expected = 0;
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsInside (pos))
+        {
+          expected = *bit;
+        }
+    }
+  Ptr<MobilityBuildingInfo> buildingInfo = mm->GetObject<MobilityBuildingInfo> ();
+  NS_TEST_ASSERT_MSG_EQ (buildingInfo->IsIndoor (), (expected != 0), "indoor/outdoor mismatch at " << pos);
+  if (expected != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buildingInfo->GetBuilding (), expected, "building mismatch at " << pos);
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) buildingInfo->GetFloorNumber (), expected->GetFloor (pos), "floor number mismatch");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) buildingInfo->GetRoomNumberX (), expected->GetRoomX (pos), "x room number mismatch");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) buildingInfo->GetRoomNumberY (), expected->GetRoomY (pos), "y room number mismatch");
+    }
+}
+
+void
+BuildingsHelperMovingNodeTestCase::DoRun ()
+{
+  NS_LOG_FUNCTION (this);
+  // 10 x 10 blocks of 20 m, separated by streets of 10 m
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      for (uint32_t j = 0; j < 10; j++)
+        {
+          Ptr<Building> b = CreateObject<Building> ();
+          b->SetBoundaries (Box (30 * i, 30 * i + 20, 30 * j, 30 * j + 20, 0, 10 + j));
+          b->SetNFloors (1 + i % 3);
+          b->SetNRoomsX (1 + j % 4);
+          b->SetNRoomsY (2);
+        }
+    }
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  NodeContainer nodes;
+  nodes.Create (1);
+  mobility.Install (nodes);
+  BuildingsHelper::Install (nodes);
+  Ptr<ConstantVelocityMobilityModel> mm = nodes.Get (0)->GetObject<ConstantVelocityMobilityModel> ();
+  mm->SetPosition (Vector (-5, 3, 2));
+  mm->SetVelocity (Vector (1.5, 1, 0.05));
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  for (uint32_t t = 0; t < 200; t++)
+    {
+      Simulator::Schedule (Seconds (t), &BuildingsHelperMovingNodeTestCase::Check, this, mm);
+      if (t % 20 == 10)
+        {
+          Simulator::Schedule (Seconds (t + 0.5), &ConstantVelocityMobilityModel::SetPosition, mm,
+                               Vector (random->GetValue (-10, 300), random->GetValue (-10, 300), random->GetValue (0, 12)));
+        }
+    }
+  // move a building onto the path of the node
+  Simulator::Schedule (Seconds (100.5), &Building::SetBoundaries, BuildingList::GetBuilding (0),
+                       Box (-10, 300, 310, 320, 0, 20));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+
+
 class BuildingsHelperTestSuite : public TestSuite
 {
 public:
@@ -321,6 +419,8 @@ BuildingsHelperTestSuite::BuildingsHelperTestSuite ()
   q7.pos = vq7;
   q7.indoor = false;
   AddTestCase (new BuildingsHelperOneTestCase (q7, b2), TestCase::QUICK);     
+
+  AddTestCase (new BuildingsHelperMovingNodeTestCase, TestCase::QUICK);
 }
 
 static BuildingsHelperTestSuite buildingsHelperAntennaTestSuiteInstance;
@@ -30,6 +30,10 @@
 #include <ns3/mobility-model.h>
 #include <ns3/mobility-building-info.h>
 #include <ns3/constant-position-mobility-model.h>
+#include <ns3/node.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
 
 #include "buildings-shadowing-test.h"
 
@@ -63,6 +67,14 @@ BuildingsShadowingTestSuite::BuildingsShadowingTestSuite ()
   // Test #3 Indoor -> Outdoor
   AddTestCase (new BuildingsShadowingTestCase (9, 10, 85.0012, 8.6, "Indoor -> Outdoor Shadowing"), TestCase::QUICK);
 
+  // Tests #4-6 Hashed shadowing mode
+  AddTestCase (new BuildingsShadowingTestCase (1, 2, 148.86, 7.0, "Outdoor Shadowing, hashed", true), TestCase::QUICK);
+  AddTestCase (new BuildingsShadowingTestCase (5, 6, 88.5724, 8.0, "Indoor Shadowing, hashed", true), TestCase::QUICK);
+  AddTestCase (new BuildingsShadowingTestCase (9, 10, 85.0012, 8.6, "Indoor -> Outdoor Shadowing, hashed", true), TestCase::QUICK);
+
+  // Test #7 Bounded storage of the shadowing values
+  AddTestCase (new BuildingsShadowingCacheTestCase, TestCase::QUICK);
+
 }
 
 static BuildingsShadowingTestSuite buildingsShadowingTestSuite;
@@ -72,12 +84,13 @@ static BuildingsShadowingTestSuite buildingsShadowingTestSuite;
 * TestCase
 */
 
-BuildingsShadowingTestCase::BuildingsShadowingTestCase ( uint16_t m1, uint16_t m2, double refValue, double sigmaRef, std::string name)
+BuildingsShadowingTestCase::BuildingsShadowingTestCase ( uint16_t m1, uint16_t m2, double refValue, double sigmaRef, std::string name, bool hashed)
   : TestCase ("SHADOWING calculation: " + name),
     m_mobilityModelIndex1 (m1),
     m_mobilityModelIndex2 (m2),
     m_lossRef (refValue),
-    m_sigmaRef (sigmaRef)
+    m_sigmaRef (sigmaRef),
+    m_hashed (hashed)
 {
 }
 
@@ -99,6 +112,10 @@ BuildingsShadowingTestCase::DoRun (void)
   building1->SetNFloors (3);
   
   Ptr<HybridBuildingsPropagationLossModel> propagationLossModel = CreateObject<HybridBuildingsPropagationLossModel> ();
+  if (m_hashed)
+    {
+      propagationLossModel->SetAttribute ("ShadowingMode", EnumValue (BuildingsPropagationLossModel::HASHED));
+    }
   
   std::vector<double> loss;
   double sum = 0.0;
@@ -108,6 +125,12 @@ BuildingsShadowingTestCase::DoRun (void)
     {
       Ptr<MobilityModel> mma = CreateMobilityModel (m_mobilityModelIndex1);
       Ptr<MobilityModel> mmb = CreateMobilityModel (m_mobilityModelIndex2);
+      if (m_hashed)
+        {
+          // the Hashed mode identifies the pairs by their node ids
+          mma->AggregateObject (CreateObject<Node> ());
+          mmb->AggregateObject (CreateObject<Node> ());
+        }
       double shadowingLoss = propagationLossModel->DoCalcRxPower (0.0, mma, mmb) + m_lossRef;
       double shadowingLoss2 = propagationLossModel->DoCalcRxPower (0.0, mma, mmb) + m_lossRef;
       NS_TEST_ASSERT_MSG_EQ_TOL (shadowingLoss, shadowingLoss2, 0.001, 
@@ -226,3 +249,81 @@ BuildingsShadowingTestCase::CreateMobilityModel (uint16_t index)
   BuildingsHelper::MakeConsistent (mm); 
   return mm;
 }
+
+
+
+BuildingsShadowingCacheTestCase::BuildingsShadowingCacheTestCase ()
+  : TestCase ("SHADOWING storage: cache size, lifetime and symmetry")
+{
+}
+
+BuildingsShadowingCacheTestCase::~BuildingsShadowingCacheTestCase ()
+{
+}
+
+void
+BuildingsShadowingCacheTestCase::CheckLifetime (bool changed)
+{
+  for (uint32_t i = 0; i < m_values.size (); i++)
+    {
+      double value = m_lifetime->CalcRxPower (0.0, m_mobility[0], m_mobility[i + 1]);
+      if (changed)
+        {
+          NS_TEST_ASSERT_MSG_NE (value, m_values[i], "shadowing not drawn again after its lifetime");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (value, m_values[i], "shadowing changed within its lifetime");
+        }
+    }
+}
+
+void
+BuildingsShadowingCacheTestCase::DoRun (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<MobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+      mm->SetPosition (Vector (100.0 * i, 0.0, 1.5));
+      mm->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      m_mobility.push_back (mm);
+    }
+
+  Ptr<PropagationLossModel> lru = CreateObject<HybridBuildingsPropagationLossModel> ();
+  lru->SetAttribute ("ShadowingCacheSize", UintegerValue (2));
+  double values[3];
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      values[i] = lru->CalcRxPower (0.0, m_mobility[0], m_mobility[i + 1]);
+    }
+  // only the last two pairs are kept
+  NS_TEST_ASSERT_MSG_NE (lru->CalcRxPower (0.0, m_mobility[0], m_mobility[1]), values[0],
+                         "the least recently used pair was not dropped");
+  NS_TEST_ASSERT_MSG_EQ (lru->CalcRxPower (0.0, m_mobility[0], m_mobility[3]), values[2],
+                         "a recently used pair was dropped");
+
+  Ptr<PropagationLossModel> symmetric = CreateObject<HybridBuildingsPropagationLossModel> ();
+  symmetric->SetAttribute ("SymmetricShadowing", BooleanValue (true));
+  for (uint32_t i = 1; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (symmetric->CalcRxPower (0.0, m_mobility[0], m_mobility[i]),
+                             symmetric->CalcRxPower (0.0, m_mobility[i], m_mobility[0]),
+                             "shadowing is not symmetric");
+    }
+
+  m_lifetime = CreateObject<HybridBuildingsPropagationLossModel> ();
+  m_lifetime->SetAttribute ("ShadowingLifetime", TimeValue (Seconds (1)));
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_values.push_back (m_lifetime->CalcRxPower (0.0, m_mobility[0], m_mobility[i + 1]));
+    }
+  Simulator::Schedule (Seconds (0.5), &BuildingsShadowingCacheTestCase::CheckLifetime, this, false);
+  Simulator::Schedule (Seconds (1.7), &BuildingsShadowingCacheTestCase::CheckLifetime, this, true);
+  Simulator::Run ();
+
+  m_lifetime = 0;
+  m_mobility.clear ();
+  m_values.clear ();
+  Simulator::Destroy ();
+}
@@ -22,6 +22,9 @@
 #define BUILDINGS_SHADOWING_TEST_H
 
 #include "ns3/test.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include <vector>
 
 
 
@@ -40,7 +43,7 @@ public:
 class BuildingsShadowingTestCase : public TestCase
 {
 public:
-  BuildingsShadowingTestCase (uint16_t m1, uint16_t m2, double refValue, double sigmaRef, std::string name);
+  BuildingsShadowingTestCase (uint16_t m1, uint16_t m2, double refValue, double sigmaRef, std::string name, bool hashed = false);
   virtual ~BuildingsShadowingTestCase ();
 
 private:
@@ -51,6 +54,27 @@ private:
   uint16_t m_mobilityModelIndex2;
   double m_lossRef;     // pathloss value (without shadowing)
   double m_sigmaRef;
+  bool m_hashed;        // true to test the Hashed shadowing mode
+
+};
+
+
+/**
+ * Test the bounds on the stored shadowing values
+ */
+class BuildingsShadowingCacheTestCase : public TestCase
+{
+public:
+  BuildingsShadowingCacheTestCase ();
+  virtual ~BuildingsShadowingCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckLifetime (bool changed);
+
+  Ptr<PropagationLossModel> m_lifetime;     // model with a shadowing lifetime
+  std::vector<Ptr<MobilityModel> > m_mobility;
+  std::vector<double> m_values;             // values drawn by m_lifetime at time 0
 
 };
 
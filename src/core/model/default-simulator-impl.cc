@@ -22,6 +22,7 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-pool.h"
 
 #include "ptr.h"
 #include "pointer.h"
@@ -108,6 +109,9 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  NS_LOG_INFO ("event pool hits=" << EventPool::GetHits () <<
+               " misses=" << EventPool::GetMisses () <<
+               " free=" << EventPool::GetFree ());
 }
 
 void
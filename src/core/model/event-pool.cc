@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-pool.h"
+#include "system-thread.h"
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventPool implementation.
+ */
+
+namespace ns3 {
+
+// These are all zero-initialized before any dynamic initialization
+// takes place, so the pool can be used by static constructors.
+EventPool::Block *EventPool::m_free[EventPool::N_CLASSES];
+uint64_t EventPool::m_hits;
+uint64_t EventPool::m_misses;
+uint64_t EventPool::m_nFree;
+
+#ifdef HAVE_PTHREAD_H
+namespace {
+/** Has the owner thread been recorded yet. */
+bool g_hasOwner;
+/** The thread which owns the free lists. */
+SystemThread::ThreadId g_owner;
+} // unnamed namespace
+#endif /* HAVE_PTHREAD_H */
+
+bool
+EventPool::IsOwner (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (!g_hasOwner)
+    {
+      g_owner = SystemThread::Self ();
+      g_hasOwner = true;
+      return true;
+    }
+  return SystemThread::Equals (g_owner);
+#else /* HAVE_PTHREAD_H */
+  return true;
+#endif /* HAVE_PTHREAD_H */
+}
+
+void *
+EventPool::Allocate (std::size_t size)
+{
+  std::size_t sizeClass = (size + GRANULARITY - 1) / GRANULARITY;
+  if (sizeClass >= N_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  if (sizeClass == 0)
+    {
+      sizeClass = 1;
+    }
+  if (!IsOwner ())
+    {
+      return ::operator new (sizeClass * GRANULARITY);
+    }
+  Block *block = m_free[sizeClass];
+  if (block != 0)
+    {
+      m_free[sizeClass] = block->next;
+      m_hits++;
+      m_nFree--;
+      return block;
+    }
+  m_misses++;
+  return ::operator new (sizeClass * GRANULARITY);
+}
+
+void
+EventPool::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  std::size_t sizeClass = (size + GRANULARITY - 1) / GRANULARITY;
+  if (sizeClass == 0)
+    {
+      sizeClass = 1;
+    }
+  if (sizeClass >= N_CLASSES || !IsOwner ())
+    {
+      ::operator delete (p);
+      return;
+    }
+  Block *block = static_cast<Block *> (p);
+  block->next = m_free[sizeClass];
+  m_free[sizeClass] = block;
+  m_nFree++;
+}
+
+uint64_t
+EventPool::GetHits (void)
+{
+  return m_hits;
+}
+
+uint64_t
+EventPool::GetMisses (void)
+{
+  return m_misses;
+}
+
+uint64_t
+EventPool::GetFree (void)
+{
+  return m_nFree;
+}
+
+} // namespace ns3
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_POOL_H
+#define EVENT_POOL_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventPool and ns3::EventPoolAllocator declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Size-classed free lists for the small objects created
+ * for every scheduled event.
+ *
+ * Every call to Simulator::Schedule creates an EventImpl subclass
+ * and, depending on the Scheduler, a container node to hold the
+ * Scheduler::Event. These objects are small, short-lived and
+ * created at a very high rate, so instead of returning them to the
+ * system allocator when they are released, this pool keeps them on
+ * one free list per 16-byte size class and hands them out again.
+ * Once a simulation has reached its steady state, scheduling
+ * events does not call malloc at all.
+ *
+ * The free lists are owned by the first thread which uses the pool,
+ * which is the simulation thread in all practical cases. Blocks
+ * requested or released by any other thread (such as the ones
+ * calling Simulator::ScheduleWithContext in a real-time simulation)
+ * bypass the free lists and go straight to the system allocator.
+ * Each block is allocated individually, so a block obtained from
+ * the free lists can safely be released by another thread and
+ * vice versa.
+ *
+ * Memory kept in the free lists is never given back to the system.
+ */
+class EventPool
+{
+public:
+  /**
+   * Allocate a block of memory.
+   *
+   * \param [in] size The block size, in bytes.
+   * \returns A pointer to the new block.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release a block of memory obtained from Allocate().
+   *
+   * \param [in] p The block.
+   * \param [in] size The block size, which must be the same
+   *             as the one given to Allocate().
+   */
+  static void Deallocate (void *p, std::size_t size);
+  /**
+   * \returns The number of allocations served from the free lists.
+   */
+  static uint64_t GetHits (void);
+  /**
+   * \returns The number of allocations served by the system allocator.
+   */
+  static uint64_t GetMisses (void);
+  /**
+   * \returns The number of blocks currently held in the free lists.
+   */
+  static uint64_t GetFree (void);
+
+private:
+  /** Size class granularity, in bytes. */
+  static const std::size_t GRANULARITY = 16;
+  /** Number of size classes: larger blocks are not pooled. */
+  static const std::size_t N_CLASSES = 16;
+
+  /** A block in a free list. */
+  struct Block
+  {
+    Block *next;  /**< Next free block of the same size class. */
+  };
+
+  /**
+   * \returns \c true if the calling thread owns the free lists.
+   */
+  static bool IsOwner (void);
+
+  static Block *m_free[N_CLASSES];  /**< The free lists. */
+  static uint64_t m_hits;           /**< Allocations served from the free lists. */
+  static uint64_t m_misses;         /**< Allocations served by the system. */
+  static uint64_t m_nFree;          /**< Blocks held in the free lists. */
+};
+
+/**
+ * \ingroup events
+ * \brief A standard allocator which gets its memory from the EventPool.
+ *
+ * This is meant for the node-based containers (std::map, std::list)
+ * used by the Scheduler implementations.
+ *
+ * \tparam T \explicit The type of the allocated objects.
+ */
+template <typename T>
+class EventPoolAllocator
+{
+public:
+  typedef T value_type;                    //!< Allocated type.
+  typedef T *pointer;                      //!< Pointer type.
+  typedef const T *const_pointer;          //!< Const pointer type.
+  typedef T &reference;                    //!< Reference type.
+  typedef const T &const_reference;        //!< Const reference type.
+  typedef std::size_t size_type;           //!< Size type.
+  typedef std::ptrdiff_t difference_type;  //!< Pointer difference type.
+
+  /**
+   * Obtain the same allocator for another type.
+   * \tparam U \explicit The other type.
+   */
+  template <typename U>
+  struct rebind
+  {
+    typedef EventPoolAllocator<U> other;  //!< The rebound allocator.
+  };
+
+  /** Default constructor. */
+  EventPoolAllocator () {}
+  /**
+   * Converting copy constructor.
+   * \tparam U \deduced The allocated type of the other allocator.
+   */
+  template <typename U>
+  EventPoolAllocator (const EventPoolAllocator<U> &) {}
+
+  /**
+   * \param [in] x An object.
+   * \returns The address of \p x.
+   */
+  pointer address (reference x) const
+  {
+    return &x;
+  }
+  /**
+   * \param [in] x An object.
+   * \returns The address of \p x.
+   */
+  const_pointer address (const_reference x) const
+  {
+    return &x;
+  }
+  /**
+   * \param [in] n The number of objects.
+   * \returns Uninitialized storage for \p n objects.
+   */
+  pointer allocate (size_type n, const void * = 0)
+  {
+    return static_cast<pointer> (EventPool::Allocate (n * sizeof (T)));
+  }
+  /**
+   * \param [in] p Storage obtained from allocate().
+   * \param [in] n The number of objects given to allocate().
+   */
+  void deallocate (pointer p, size_type n)
+  {
+    EventPool::Deallocate (p, n * sizeof (T));
+  }
+  /**
+   * \returns The largest supported number of objects.
+   */
+  size_type max_size (void) const
+  {
+    return size_type (-1) / sizeof (T);
+  }
+  /**
+   * Copy-construct an object in place.
+   * \param [in] p The storage.
+   * \param [in] val The value to copy.
+   */
+  void construct (pointer p, const T &val)
+  {
+    new (static_cast<void *> (p)) T (val);
+  }
+  /**
+   * Destroy an object in place.
+   * \param [in] p The object.
+   */
+  void destroy (pointer p)
+  {
+    p->~T ();
+  }
+};
+
+/**
+ * All EventPoolAllocator objects are interchangeable.
+ * \returns \c true
+ */
+template <typename T, typename U>
+inline bool operator == (const EventPoolAllocator<T> &, const EventPoolAllocator<U> &)
+{
+  return true;
+}
+
+/**
+ * All EventPoolAllocator objects are interchangeable.
+ * \returns \c false
+ */
+template <typename T, typename U>
+inline bool operator != (const EventPoolAllocator<T> &, const EventPoolAllocator<U> &)
+{
+  return false;
+}
+
+} // namespace ns3
+
+#endif /* EVENT_POOL_H */
@@ -0,0 +1,395 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("Threshold",
+                   "Number of events in a bucket above which the bucket "
+                   "is spread over a new rung instead of being sorted.",
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs in the ladder.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxRungs),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_bottomHead (0),
+    m_qSize (0),
+    m_threshold (50),
+    m_maxRungs (8)
+{
+  NS_LOG_FUNCTION (this);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart (const Rung &rung)
+{
+  return rung.m_start + rung.m_current * rung.m_width;
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  uint32_t i = 0;
+  while (i < m_nRungs && ts < CurrentStart (m_rungs[i]))
+    {
+      i++;
+    }
+  return i;
+}
+
+LadderScheduler::Rung &
+LadderScheduler::AddRung (uint64_t start, uint64_t width, uint32_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << start << width << nBuckets);
+  NS_ASSERT (m_nRungs < m_maxRungs);
+  if (m_rungs.size () <= m_nRungs)
+    {
+      m_rungs.resize (m_nRungs + 1);
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  if (rung.m_buckets.size () < nBuckets)
+    {
+      rung.m_buckets.resize (nBuckets);
+    }
+  rung.m_nBuckets = nBuckets;
+  rung.m_width = width;
+  rung.m_start = start;
+  rung.m_current = 0;
+  rung.m_count = 0;
+  return rung;
+}
+
+void
+LadderScheduler::InsertInRung (Rung &rung, const Scheduler::Event &ev)
+{
+  uint32_t bucket = (ev.key.m_ts - rung.m_start) / rung.m_width;
+  NS_ASSERT (bucket >= rung.m_current && bucket < rung.m_nBuckets);
+  rung.m_buckets[bucket].push_back (ev);
+  rung.m_count++;
+}
+
+void
+LadderScheduler::InsertInBottom (const Scheduler::Event &ev)
+{
+  if (m_bottom.empty () || m_bottom.back () < ev)
+    {
+      // the common case of an event scheduled after all the others
+      // of the bottom, such as a burst at the current time.
+      m_bottom.push_back (ev);
+      return;
+    }
+  Bucket::iterator i = std::upper_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (), ev);
+  m_bottom.insert (i, ev);
+}
+
+void
+LadderScheduler::CompactBottom (void)
+{
+  if (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+    }
+  else if (m_bottomHead > m_threshold && 2 * m_bottomHead > m_bottom.size ())
+    {
+      m_bottom.erase (m_bottom.begin (), m_bottom.begin () + m_bottomHead);
+      m_bottomHead = 0;
+    }
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  if (m_qSize == 0)
+    {
+      // restart from scratch with this event as the only one.
+      m_nRungs = 0;
+      m_bottom.push_back (ev);
+      m_topStart = ev.key.m_ts + 1;
+      m_qSize++;
+      return;
+    }
+  m_qSize++;
+  if (ev.key.m_ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ev.key.m_ts;
+          m_topMax = ev.key.m_ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ev.key.m_ts);
+          m_topMax = std::max (m_topMax, ev.key.m_ts);
+        }
+      m_top.push_back (ev);
+      return;
+    }
+  uint32_t i = FindRung (ev.key.m_ts);
+  if (i < m_nRungs)
+    {
+      InsertInRung (m_rungs[i], ev);
+      return;
+    }
+  InsertInBottom (ev);
+  SpreadBottom ();
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Scheduler::Event ev = m_bottom[m_bottomHead];
+  m_bottomHead++;
+  CompactBottom ();
+  m_qSize--;
+  Refill ();
+  NS_LOG_LOGIC ("remove ts=" << ev.key.m_ts << ", key=" << ev.key.m_uid);
+  return ev;
+}
+
+bool
+LadderScheduler::RemoveFrom (Bucket &events, const Scheduler::Event &ev)
+{
+  for (Bucket::iterator i = events.begin (); i != events.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          *i = events.back ();
+          events.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  bool found;
+  if (ev.key.m_ts >= m_topStart)
+    {
+      found = RemoveFrom (m_top, ev);
+    }
+  else
+    {
+      uint32_t i = FindRung (ev.key.m_ts);
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          uint32_t bucket = (ev.key.m_ts - rung.m_start) / rung.m_width;
+          found = RemoveFrom (rung.m_buckets[bucket], ev);
+          if (found)
+            {
+              rung.m_count--;
+            }
+        }
+      else
+        {
+          Bucket::iterator j = std::lower_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (), ev);
+          found = j != m_bottom.end () && j->key.m_uid == ev.key.m_uid;
+          if (found)
+            {
+              NS_ASSERT (ev.impl == j->impl);
+              m_bottom.erase (j);
+              CompactBottom ();
+            }
+        }
+    }
+  if (!found)
+    {
+      NS_FATAL_ERROR ("Event " << ev.key.m_uid << " not found in the scheduler");
+    }
+  m_qSize--;
+  Refill ();
+}
+
+void
+LadderScheduler::TransferTop (void)
+{
+  NS_LOG_FUNCTION (this << m_top.size () << m_topMin << m_topMax);
+  NS_ASSERT (m_nRungs == 0 && !m_top.empty ());
+  if (m_topMin == m_topMax)
+    {
+      // nothing to spread: all events go straight to the bottom.
+      m_bottom.swap (m_top);
+      m_top.clear ();
+      std::sort (m_bottom.begin (), m_bottom.end ());
+      m_topStart = m_topMax + 1;
+      return;
+    }
+  uint64_t span = m_topMax - m_topMin;
+  uint64_t width = std::max (span / m_top.size (), (uint64_t)1);
+  uint32_t nBuckets = span / width + 1;
+  Rung &rung = AddRung (m_topMin, width, nBuckets);
+  for (Bucket::const_iterator i = m_top.begin (); i != m_top.end (); ++i)
+    {
+      InsertInRung (rung, *i);
+    }
+  m_top.clear ();
+  m_topStart = m_topMin + nBuckets * width;
+}
+
+void
+LadderScheduler::SpreadBottom (void)
+{
+  uint32_t size = m_bottom.size () - m_bottomHead;
+  // a bottom of events at the same time cannot be spread, but the
+  // events are appended to it in O(1).
+  if (size <= m_threshold
+      || m_nRungs >= m_maxRungs
+      || m_bottom[m_bottomHead].key.m_ts == m_bottom.back ().key.m_ts)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << size);
+  uint64_t start = m_bottom[m_bottomHead].key.m_ts;
+  uint64_t end = m_nRungs > 0 ? CurrentStart (m_rungs[m_nRungs - 1]) : m_topStart;
+  uint64_t span = end - start;
+  uint64_t width = std::max (span / size, (uint64_t)1);
+  uint32_t nBuckets = (span + width - 1) / width;
+  Rung &rung = AddRung (start, width, nBuckets);
+  for (Bucket::const_iterator i = m_bottom.begin () + m_bottomHead; i != m_bottom.end (); ++i)
+    {
+      InsertInRung (rung, *i);
+    }
+  m_bottom.clear ();
+  m_bottomHead = 0;
+  Refill ();
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  if (!m_bottom.empty () || m_qSize == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      if (m_nRungs == 0)
+        {
+          TransferTop ();
+          if (!m_bottom.empty ())
+            {
+              return;
+            }
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      if (rung.m_count == 0)
+        {
+          // this rung is exhausted: its remaining time interval
+          // now belongs to the bottom.
+          m_nRungs--;
+          continue;
+        }
+      while (rung.m_buckets[rung.m_current].empty ())
+        {
+          rung.m_current++;
+        }
+      NS_ASSERT (rung.m_current < rung.m_nBuckets);
+      Bucket &bucket = rung.m_buckets[rung.m_current];
+      uint64_t bucketStart = CurrentStart (rung);
+      uint64_t width = rung.m_width;
+      rung.m_current++;
+      rung.m_count -= bucket.size ();
+      if (bucket.size () > m_threshold
+          && m_nRungs < m_maxRungs
+          && width > 1)
+        {
+          // spread this bucket over a new, finer, rung.
+          uint64_t childWidth = std::max (width / bucket.size (), (uint64_t)1);
+          uint32_t nBuckets = (width + childWidth - 1) / childWidth;
+          Bucket events;
+          events.swap (bucket);
+          Rung &child = AddRung (bucketStart, childWidth, nBuckets);
+          for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+            {
+              InsertInRung (child, *i);
+            }
+          // give the storage back to the bucket for later reuse.
+          events.clear ();
+          m_rungs[m_nRungs - 2].m_buckets[m_rungs[m_nRungs - 2].m_current - 1].swap (events);
+          continue;
+        }
+      m_bottom.swap (bucket);
+      std::sort (m_bottom.begin (), m_bottom.end ());
+      return;
+    }
+}
+
+} // namespace ns3
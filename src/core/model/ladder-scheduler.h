@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh
+ * and Ian Li-Jin Thng (ACM TOMACS, 2005).
+ *
+ * The event set is split in three tiers:
+ *  - Top: an unsorted vector which receives all the events scheduled
+ *    far in the future. Insertion is a simple append.
+ *  - Ladder: a small number of rungs, each one an array of buckets
+ *    (themselves plain vectors, also unsorted). Every rung spans the
+ *    time interval of one bucket of the rung above it. Buckets which
+ *    hold too many events are spread over a new, finer, rung instead
+ *    of being sorted.
+ *  - Bottom: a small sorted vector from which events are dequeued.
+ *    It is sorted in increasing order and read from a head index, so
+ *    that the events scheduled at the current time, whose uids are
+ *    larger than the ones already there, are appended in O(1).
+ *
+ * Contrary to the CalendarScheduler, there is no global resize step:
+ * the bucket width of every rung is computed from the events it
+ * receives when it is created, which gives O(1) amortized Insert and
+ * RemoveNext over a wide range of event time distributions.
+ *
+ * All storage is contiguous and is recycled from one rung to the
+ * next, so that a steady-state simulation does not allocate memory
+ * in the scheduler.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder: an array of equally sized buckets. */
+  struct Rung
+  {
+    std::vector<Bucket> m_buckets; /**< The buckets of this rung. */
+    uint32_t m_nBuckets;           /**< Number of buckets in use. */
+    uint64_t m_width;              /**< Bucket width, in dimensionless time units. */
+    uint64_t m_start;              /**< Start time of the first bucket. */
+    uint32_t m_current;            /**< Index of the next bucket to dequeue. */
+    uint32_t m_count;              /**< Number of events held by this rung. */
+  };
+
+  /**
+   * Get the start time of the next bucket to dequeue from a rung.
+   *
+   * \param [in] rung The rung.
+   * \returns The start time of the current bucket of \p rung.
+   */
+  static inline uint64_t CurrentStart (const Rung &rung);
+  /**
+   * Find the rung which covers a timestamp.
+   *
+   * \param [in] ts The dimensionless timestamp.
+   * \returns The rung index, or m_nRungs if \p ts belongs in the bottom.
+   */
+  uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Set up a new, empty rung at the bottom of the ladder.
+   *
+   * \param [in] start The start time of the rung.
+   * \param [in] width The bucket width.
+   * \param [in] nBuckets The number of buckets.
+   * \returns The new rung.
+   */
+  Rung & AddRung (uint64_t start, uint64_t width, uint32_t nBuckets);
+  /**
+   * Insert an event in a rung.
+   *
+   * \param [in] rung The rung.
+   * \param [in] ev The event.
+   */
+  void InsertInRung (Rung &rung, const Scheduler::Event &ev);
+  /**
+   * Insert an event in the sorted bottom.
+   *
+   * \param [in] ev The event.
+   */
+  void InsertInBottom (const Scheduler::Event &ev);
+  /**
+   * Drop the events already dequeued from the head of the bottom,
+   * once they are the larger part of it.
+   */
+  void CompactBottom (void);
+  /**
+   * Move all the events of the top to a new first rung.
+   * This can only be called when the ladder is empty.
+   */
+  void TransferTop (void);
+  /**
+   * Spread the bottom over a new rung if it has grown too large.
+   */
+  void SpreadBottom (void);
+  /**
+   * Refill the bottom from the ladder and the top if it is empty.
+   *
+   * After this call, the bottom is not empty unless the whole
+   * scheduler is empty.
+   */
+  void Refill (void);
+  /**
+   * Remove an event from an unsorted vector of events.
+   *
+   * \param [in,out] events The events.
+   * \param [in] ev The event to remove.
+   * \returns \c true if the event was found.
+   */
+  static bool RemoveFrom (Bucket &events, const Scheduler::Event &ev);
+
+  /** Events in the top, unsorted. */
+  Bucket m_top;
+  /** Smallest timestamp in the top. */
+  uint64_t m_topMin;
+  /** Largest timestamp in the top. */
+  uint64_t m_topMax;
+  /** Events at or after this timestamp go in the top. */
+  uint64_t m_topStart;
+  /** The rungs, finer rungs at higher indexes. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Events in the bottom, sorted in increasing order from m_bottomHead. */
+  Bucket m_bottom;
+  /** Index of the next event of the bottom. */
+  uint32_t m_bottomHead;
+  /** Number of events in queue. */
+  uint32_t m_qSize;
+  /** Number of events in a bucket above which it is spread on a new rung. */
+  uint32_t m_threshold;
+  /** Maximum number of rungs. */
+  uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -22,6 +22,7 @@
 #define LIST_SCHEDULER_H
 
 #include "scheduler.h"
+#include "event-pool.h"
 #include <list>
 #include <utility>
 #include <stdint.h>
@@ -65,10 +66,13 @@ public:
   virtual void Remove (const Scheduler::Event &ev);
 
 private:
-  /** Event list type: a simple list of Events. */
-  typedef std::list<Scheduler::Event> Events;
+  /**
+   * Event list type: a simple list of Events, with its nodes
+   * allocated from the EventPool.
+   */
+  typedef std::list<Scheduler::Event, EventPoolAllocator<Scheduler::Event> > Events;
   /** Events iterator. */
-  typedef std::list<Scheduler::Event>::iterator EventsI;
+  typedef Events::iterator EventsI;
 
   /** The event list. */
   Events m_events;
@@ -22,9 +22,11 @@
 #define MAP_SCHEDULER_H
 
 #include "scheduler.h"
+#include "event-pool.h"
 #include <stdint.h>
 #include <map>
 #include <utility>
+#include <functional>
 
 /**
  * \file
@@ -63,12 +65,17 @@ public:
   virtual void Remove (const Scheduler::Event &ev);
 
 private:
-  /** Event list type: a Map from EventKey to EventImpl. */
-  typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
+  /**
+   * Event list type: a Map from EventKey to EventImpl, with its nodes
+   * allocated from the EventPool.
+   */
+  typedef std::map<Scheduler::EventKey, EventImpl*,
+                   std::less<Scheduler::EventKey>,
+                   EventPoolAllocator<std::pair<const Scheduler::EventKey, EventImpl*> > > EventMap;
   /** EventMap iterator. */
-  typedef std::map<Scheduler::EventKey, EventImpl*>::iterator EventMapI;
+  typedef EventMap::iterator EventMapI;
   /** EventMap const iterator. */
-  typedef std::map<Scheduler::EventKey, EventImpl*>::const_iterator EventMapCI;
+  typedef EventMap::const_iterator EventMapCI;
 
   /** The event list. */
   EventMap m_list;
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/event-pool.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/list-scheduler.h"
+#include <list>
+
+using namespace ns3;
+
+class EventPoolAllocatorTestCase : public TestCase
+{
+public:
+  EventPoolAllocatorTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+EventPoolAllocatorTestCase::EventPoolAllocatorTestCase ()
+  : TestCase ("Check that released blocks are handed out again")
+{
+}
+
+void
+EventPoolAllocatorTestCase::DoRun (void)
+{
+  void *a = EventPool::Allocate (40);
+  void *b = EventPool::Allocate (40);
+  NS_TEST_EXPECT_MSG_NE (a, b, "Two live blocks share the same memory");
+  EventPool::Deallocate (b, 40);
+  uint64_t hits = EventPool::GetHits ();
+  // same size class.
+  void *c = EventPool::Allocate (48);
+  NS_TEST_EXPECT_MSG_EQ (c, b, "Released block was not reused");
+  NS_TEST_EXPECT_MSG_EQ (EventPool::GetHits (), hits + 1, "Reuse was not counted as a hit");
+  EventPool::Deallocate (c, 48);
+  EventPool::Deallocate (a, 40);
+
+  std::list<uint32_t, EventPoolAllocator<uint32_t> > l;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      l.push_back (i);
+    }
+  l.clear ();
+  uint64_t misses = EventPool::GetMisses ();
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      l.push_back (i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (EventPool::GetMisses (), misses, "List nodes were not recycled");
+}
+
+class EventPoolSteadyStateTestCase : public TestCase
+{
+public:
+  EventPoolSteadyStateTestCase (ObjectFactory schedulerFactory);
+private:
+  virtual void DoRun (void);
+  void Event (uint32_t n);
+  ObjectFactory m_schedulerFactory;
+  uint64_t m_misses;
+  uint32_t m_count;
+};
+
+EventPoolSteadyStateTestCase::EventPoolSteadyStateTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that steady-state scheduling does not allocate with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+EventPoolSteadyStateTestCase::Event (uint32_t n)
+{
+  m_count++;
+  if (m_count == 1000)
+    {
+      // the event population does not grow after this point.
+      m_misses = EventPool::GetMisses ();
+    }
+  if (m_count < 10000)
+    {
+      Simulator::Schedule (NanoSeconds (n % 7 + 1), &EventPoolSteadyStateTestCase::Event, this, n + 1);
+    }
+}
+
+void
+EventPoolSteadyStateTestCase::DoRun (void)
+{
+  m_count = 0;
+  Simulator::SetScheduler (m_schedulerFactory);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &EventPoolSteadyStateTestCase::Event, this, i);
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (EventPool::GetMisses (), m_misses, "Scheduling events allocated memory");
+  Simulator::Destroy ();
+}
+
+static class EventPoolTestSuite : public TestSuite
+{
+public:
+  EventPoolTestSuite ()
+    : TestSuite ("event-pool", UNIT)
+  {
+    AddTestCase (new EventPoolAllocatorTestCase (), TestCase::QUICK);
+    ObjectFactory factory;
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new EventPoolSteadyStateTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new EventPoolSteadyStateTestCase (factory), TestCase::QUICK);
+  }
+} g_eventPoolTestSuite;
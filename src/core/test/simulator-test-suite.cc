@@ -23,6 +23,9 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -168,6 +171,147 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorOrderingTestCase : public TestCase
+{
+public:
+  SimulatorOrderingTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (uint64_t expectedNs);
+  uint64_t m_lastNs;
+  uint32_t m_count;
+  bool m_ordered;
+  std::vector<EventId> m_ids;
+  Ptr<UniformRandomVariable> m_delay;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorOrderingTestCase::SimulatorOrderingTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that events are run in order with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorOrderingTestCase::Event (uint64_t expectedNs)
+{
+  uint64_t now = Now ().GetNanoSeconds ();
+  if (now != expectedNs
+      || now < m_lastNs)
+    {
+      m_ordered = false;
+    }
+  m_lastNs = now;
+  m_count++;
+  if (m_count < 20000)
+    {
+      // a mix of short (MAC-like) and long (timer-like) delays, with
+      // frequent ties.
+      uint64_t delay = m_delay->GetInteger (0, 9) < 8 ? m_delay->GetInteger (0, 100)
+        : m_delay->GetInteger (0, 10000000);
+      m_ids.push_back (Simulator::Schedule (NanoSeconds (delay),
+                                            &SimulatorOrderingTestCase::Event,
+                                            this, now + delay));
+      if (m_delay->GetInteger (0, 9) == 0)
+        {
+          Simulator::Cancel (m_ids[m_delay->GetInteger (0, m_ids.size () - 1)]);
+        }
+      if (m_delay->GetInteger (0, 9) == 0)
+        {
+          Simulator::Remove (m_ids[m_delay->GetInteger (0, m_ids.size () - 1)]);
+        }
+    }
+}
+
+void
+SimulatorOrderingTestCase::DoRun (void)
+{
+  m_lastNs = 0;
+  m_count = 0;
+  m_ordered = true;
+  m_delay = CreateObject<UniformRandomVariable> ();
+  m_delay->SetStream (1);
+
+  Simulator::SetScheduler (m_schedulerFactory);
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      uint64_t at = m_delay->GetInteger (0, 1000000);
+      m_ids.push_back (Simulator::Schedule (NanoSeconds (at),
+                                            &SimulatorOrderingTestCase::Event,
+                                            this, at));
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events were not run in timestamp order");
+  for (std::vector<EventId>::const_iterator i = m_ids.begin (); i != m_ids.end (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (i->IsExpired (), true, "Event was left in the scheduler");
+    }
+  m_ids.clear ();
+  Simulator::Destroy ();
+}
+
+class SimulatorBurstTestCase : public TestCase
+{
+public:
+  SimulatorBurstTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Burst (void);
+  void Event (uint32_t index);
+  uint32_t m_next;
+  bool m_ordered;
+  ObjectFactory m_schedulerFactory;
+};
+
+// large enough for a scheduler which inserts the events of a burst in
+// linear time to take seconds.
+static const uint32_t BURST_SIZE = 100000;
+
+SimulatorBurstTestCase::SimulatorBurstTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that a burst of events at the same time is run in order with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorBurstTestCase::Burst (void)
+{
+  for (uint32_t i = 0; i < BURST_SIZE; i++)
+    {
+      Simulator::ScheduleNow (&SimulatorBurstTestCase::Event, this, i);
+    }
+}
+
+void
+SimulatorBurstTestCase::Event (uint32_t index)
+{
+  if (index != m_next
+      || Now () != MicroSeconds (1))
+    {
+      m_ordered = false;
+    }
+  m_next++;
+  if (index < BURST_SIZE)
+    {
+      // a second burst, scheduled while the first one runs.
+      Simulator::ScheduleNow (&SimulatorBurstTestCase::Event, this, index + BURST_SIZE);
+    }
+}
+
+void
+SimulatorBurstTestCase::DoRun (void)
+{
+  m_next = 0;
+  m_ordered = true;
+
+  Simulator::SetScheduler (m_schedulerFactory);
+  Simulator::Schedule (MicroSeconds (1), &SimulatorBurstTestCase::Burst, this);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events were not run in insertion order");
+  NS_TEST_EXPECT_MSG_EQ (m_next, 2 * BURST_SIZE, "Events were lost");
+  Simulator::Destroy ();
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -475,5 +619,27 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderingTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderingTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderingTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderingTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderingTestCase (factory), TestCase::QUICK);
+
+    // the list and calendar schedulers insert the events of a burst in
+    // linear time.
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBurstTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBurstTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBurstTestCase (factory), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
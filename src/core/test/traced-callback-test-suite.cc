@@ -108,6 +108,88 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class EmptyTracedCallbackTestCase : public TestCase
+{
+public:
+  EmptyTracedCallbackTestCase ();
+  virtual ~EmptyTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint8_t a, double b);
+  void CbTwo (uint8_t a, double b);
+
+  TracedCallback<uint8_t, double> m_trace;
+  uint32_t m_one;
+  uint32_t m_two;
+};
+
+EmptyTracedCallbackTestCase::EmptyTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback::IsEmpty and connections from a Callback")
+{
+}
+
+void
+EmptyTracedCallbackTestCase::CbOne (uint8_t a, double b)
+{
+  m_one++;
+  //
+  // Connect callback two many times while the chain is being invoked, so
+  // that the storage of the chain has to grow.
+  //
+  if (m_one == 1)
+    {
+      for (uint32_t i = 0; i < 20; ++i)
+        {
+          m_trace.ConnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbTwo, this));
+        }
+    }
+}
+
+void
+EmptyTracedCallbackTestCase::CbTwo (uint8_t a, double b)
+{
+  m_two++;
+}
+
+void
+EmptyTracedCallbackTestCase::DoRun (void)
+{
+  m_one = 0;
+  m_two = 0;
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback not empty");
+
+  m_trace.ConnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "Connected TracedCallback empty");
+
+  //
+  // The callbacks connected by callback one are invoked in the same call,
+  // after it.
+  //
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 20, "Callbacks connected during the call not called");
+
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 2, "Callback CbOne not called twice");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 40, "Callbacks CbTwo not called");
+
+  //
+  // Disconnecting removes all the copies of a callback.
+  //
+  m_trace.DisconnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbTwo, this));
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 3, "Callback CbOne not called");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 40, "Callback CbTwo unexpectedly called");
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback unexpectedly empty");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&EmptyTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback not empty");
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 3, "Callback CbOne unexpectedly called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +200,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new EmptyTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
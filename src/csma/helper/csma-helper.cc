@@ -211,6 +211,62 @@ CsmaHelper::EnableAsciiInternal (
   Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
 }
 
+void 
+CsmaHelper::EnableBinaryInternal (
+  Ptr<BinaryTraceFile> file, 
+  std::string prefix, 
+  Ptr<NetDevice> nd,
+  bool explicitFilename)
+{
+  //
+  // All of the binary enable functions vector through here.  We can only
+  // deal with devices of type CsmaNetDevice.
+  //
+  Ptr<CsmaNetDevice> device = nd->GetObject<CsmaNetDevice> ();
+  if (device == 0)
+    {
+      NS_LOG_INFO ("CsmaHelper::EnableBinaryInternal(): Device " << device << 
+                   " not of type ns3::CsmaNetDevice");
+      return;
+    }
+
+  //
+  // As for the ascii traces, the events written to a file created for the
+  // device have no context, and the events written to a provided file have
+  // the config path of their trace source as context.  Unlike the ascii
+  // traces, packet printing is not needed.
+  //
+  BinaryTraceHelper binaryTraceHelper;
+  std::string devicePath;
+  std::string queuePath;
+  if (file == 0)
+    {
+      std::string filename;
+      if (explicitFilename)
+        {
+          filename = prefix;
+        }
+      else
+        {
+          filename = binaryTraceHelper.GetFilenameFromDevice (prefix, device);
+        }
+      file = binaryTraceHelper.CreateFile (filename, GetBinaryCaptureSize ());
+    }
+  else
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << nd->GetNode ()->GetId () << "/DeviceList/" << nd->GetIfIndex () << "/$ns3::CsmaNetDevice/";
+      devicePath = oss.str ();
+      queuePath = devicePath + "TxQueue/";
+    }
+
+  binaryTraceHelper.HookDefaultSink<CsmaNetDevice> (device, "MacRx", file, 'r', device, devicePath);
+  Ptr<Queue> queue = device->GetQueue ();
+  binaryTraceHelper.HookDefaultSink<Queue> (queue, "Enqueue", file, '+', device, queuePath);
+  binaryTraceHelper.HookDefaultSink<Queue> (queue, "Dequeue", file, '-', device, queuePath);
+  binaryTraceHelper.HookDefaultSink<Queue> (queue, "Drop", file, 'd', device, queuePath);
+}
+
 NetDeviceContainer
 CsmaHelper::Install (Ptr<Node> node) const
 {
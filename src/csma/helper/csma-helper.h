@@ -43,7 +43,8 @@ class Packet;
  * encapsulates a general attribute or a set of functionality that
  * may be of interest to many other classes.
  */
-class CsmaHelper : public PcapHelperForDevice, public AsciiTraceHelperForDevice
+class CsmaHelper : public PcapHelperForDevice, public AsciiTraceHelperForDevice,
+                   public BinaryTraceHelperForDevice
 {
 public:
   /**
@@ -247,6 +248,22 @@ private:
                                     Ptr<NetDevice> nd,
                                     bool explicitFilename);
 
+  /**
+   * \brief Enable binary trace output on the indicated net device.
+   *
+   * NetDevice-specific implementation mechanism for hooking the trace and
+   * writing to the trace file.
+   *
+   * \param file The binary trace file to use, or 0 to create one.
+   * \param prefix Filename prefix to use for binary trace files.
+   * \param nd Net device for which you want to enable tracing.
+   * \param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  virtual void EnableBinaryInternal (Ptr<BinaryTraceFile> file, 
+                                     std::string prefix, 
+                                     Ptr<NetDevice> nd,
+                                     bool explicitFilename);
+
   ObjectFactory m_queueFactory;   //!< factory for the queues
   ObjectFactory m_deviceFactory;  //!< factory for the NetDevices
   ObjectFactory m_channelFactory; //!< factory for the channel
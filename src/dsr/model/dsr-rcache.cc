@@ -39,6 +39,7 @@
 #include <vector>
 #include <functional>
 #include <iomanip>
+#include <queue>
 
 #include "ns3/simulator.h"
 #include "ns3/ipv4-route.h"
@@ -317,115 +318,90 @@ void
 DsrRouteCache::RebuildBestRouteTable (Ipv4Address source)
 {
   NS_LOG_FUNCTION (this << source);
+  // clean the best route table
+  m_bestRoutesTable_link.clear ();
+  std::vector<Ipv4Address>::const_iterator sourceNode = std::lower_bound (m_netGraphNodes.begin (),
+                                                                          m_netGraphNodes.end (), source);
+  if (sourceNode == m_netGraphNodes.end () || *sourceNode != source)
+    {
+      NS_LOG_LOGIC ("No link from " << source << " in the link cache");
+      return;
+    }
+  uint32_t n = m_netGraphNodes.size ();
+  uint32_t root = sourceNode - m_netGraphNodes.begin ();
   /**
    * \brief The followings are initialize-single-source
    */
+  uint32_t maxWeight = MAXWEIGHT;
   // @d shortest-path estimate
-  std::map<Ipv4Address, uint32_t> d;
-  // @pre preceeding node
-  std::map<Ipv4Address, Ipv4Address> pre;
-  for (std::map<Ipv4Address, std::map<Ipv4Address, uint32_t> >::iterator i = m_netGraph.begin (); i != m_netGraph.end (); ++i)
-    {
-      if (i->second.find (source) != i->second.end ())
-        {
-          d[i->first] = i->second[source];
-          pre[i->first] = source;
-        }
-      else
-        {
-          d[i->first] = MAXWEIGHT;
-          pre[i->first] = Ipv4Address ("255.255.255.255");
-        }
-    }
-  d[source] = 0;
+  std::vector<uint32_t> d (n, maxWeight);
+  // @pre preceeding node, n if none
+  std::vector<uint32_t> pre (n, n);
+  // the stability of the link from the preceeding node
+  std::vector<Time> preStability (n);
+  // the node set which shortest distance has been calculated, if true calculated
+  std::vector<bool> s (n, false);
+  d[root] = 0;
   /**
    * \brief The followings are core of dijskra algorithm
+   *
+   * The nodes are taken by increasing distance and, for equal distances, by decreasing address.
    */
-  // the node set which shortest distance has been calculated, if true calculated
-  std::map<Ipv4Address, bool> s;
-  double temp = MAXWEIGHT;
-  Ipv4Address tempip = Ipv4Address ("255.255.255.255");
-  for (uint32_t i = 0; i < m_netGraph.size (); i++)
+  typedef std::pair<uint32_t, uint32_t> Candidate; // distance, n - 1 - node
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+  candidates.push (Candidate (0, n - 1 - root));
+  while (!candidates.empty ())
     {
-      temp = MAXWEIGHT;
-      for (std::map<Ipv4Address,uint32_t>::const_iterator j = d.begin (); j != d.end (); ++j)
+      uint32_t tempip = n - 1 - candidates.top ().second;
+      candidates.pop ();
+      if (s[tempip])
         {
-          Ipv4Address ip = j->first;
-          if (s.find (ip) == s.end ())
-            {
-              /*
-               * \brief The followings are for comparison
-               */
-              if (j->second <= temp)
-                {
-                  temp = j->second;
-                  tempip = ip;
-                }
-            }
+          continue;
         }
-      if (!tempip.IsBroadcast ())
+      s[tempip] = true;
+      for (uint32_t e = m_netGraphFirstEdge[tempip]; e < m_netGraphFirstEdge[tempip + 1]; e++)
         {
-          s[tempip] = true;
-          for (std::map<Ipv4Address, uint32_t>::const_iterator k = m_netGraph[tempip].begin (); k != m_netGraph[tempip].end (); ++k)
+          const NetGraphEdge &edge = m_netGraphEdges[e];
+          uint32_t k = edge.neighbor;
+          if (!s[k] && d[k] > d[tempip] + edge.weight)
             {
-              if (s.find (k->first) == s.end () && d[k->first] > d[tempip] + k->second)
-                {
-                  d[k->first] = d[tempip] + k->second;
-                  pre[k->first] = tempip;
-                }
-              /*
-               *  Selects the shortest-length route that has the longest expected lifetime
-               *  (highest minimum timeout of any link in the route)
-               *  For the computation overhead and complexity
-               *  Here I just implement kind of greedy strategy to select link with the longest expected lifetime when there is two options
-               */
-              else if (d[k->first] == d[tempip] + k->second)
-                {
-                  std::map<Link, DsrLinkStab>::iterator oldlink = m_linkCache.find (Link (k->first, pre[k->first]));
-                  std::map<Link, DsrLinkStab>::iterator newlink = m_linkCache.find (Link (k->first, tempip));
-                  if (oldlink != m_linkCache.end () && newlink != m_linkCache.end ())
-                    {
-                      if (oldlink->second.GetLinkStability () < newlink->second.GetLinkStability ())
-                        {
-                          NS_LOG_INFO ("Select the link with longest expected lifetime");
-                          d[k->first] = d[tempip] + k->second;
-                          pre[k->first] = tempip;
-                        }
-                    }
-                  else
-                    {
-                      NS_LOG_INFO ("Link Stability Info Corrupt");
-                    }
-                }
+              d[k] = d[tempip] + edge.weight;
+              pre[k] = tempip;
+              preStability[k] = edge.stability;
+              candidates.push (Candidate (d[k], n - 1 - k));
+            }
+          /*
+           *  Selects the shortest-length route that has the longest expected lifetime
+           *  (highest minimum timeout of any link in the route)
+           *  For the computation overhead and complexity
+           *  Here I just implement kind of greedy strategy to select link with the longest expected lifetime when there is two options
+           */
+          else if (d[k] == d[tempip] + edge.weight && preStability[k] < edge.stability)
+            {
+              NS_LOG_INFO ("Select the link with longest expected lifetime");
+              pre[k] = tempip;
+              preStability[k] = edge.stability;
             }
         }
     }
-  // clean the best route table
-  m_bestRoutesTable_link.clear ();
-  for (std::map<Ipv4Address, Ipv4Address>::iterator i = pre.begin (); i != pre.end (); ++i)
+  for (uint32_t i = 0; i < n; i++)
     {
       // loop for all vertexes
+      if (pre[i] == n || i == root)
+        {
+          continue;
+        }
       DsrRouteCacheEntry::IP_VECTOR route;
-      Ipv4Address iptemp = i->first;
-
-      if (!i->second.IsBroadcast () && iptemp != source)
+      for (uint32_t iptemp = i; iptemp != root; iptemp = pre[iptemp])
         {
-          while (iptemp != source)
-            {
-              route.push_back (iptemp);
-              iptemp = pre[iptemp];
-            }
-          route.push_back (source);
-          // Reverse the route
-          DsrRouteCacheEntry::IP_VECTOR reverseroute;
-          for (DsrRouteCacheEntry::IP_VECTOR::reverse_iterator j = route.rbegin (); j != route.rend (); ++j)
-            {
-              reverseroute.push_back (*j);
-            }
-          NS_LOG_LOGIC ("Add newly calculated best routes");
-          PrintVector (reverseroute);
-          m_bestRoutesTable_link[i->first] = reverseroute;
+          route.push_back (m_netGraphNodes[iptemp]);
         }
+      route.push_back (source);
+      // Reverse the route
+      DsrRouteCacheEntry::IP_VECTOR reverseroute (route.rbegin (), route.rend ());
+      NS_LOG_LOGIC ("Add newly calculated best routes");
+      PrintVector (reverseroute);
+      m_bestRoutesTable_link.insert (m_bestRoutesTable_link.end (), std::make_pair (m_netGraphNodes[i], reverseroute));
     }
 }
 
@@ -500,14 +476,45 @@ void
 DsrRouteCache::UpdateNetGraph ()
 {
   NS_LOG_FUNCTION (this);
-  m_netGraph.clear ();
+  m_netGraphNodes.clear ();
   for (std::map<Link, DsrLinkStab>::iterator i = m_linkCache.begin (); i != m_linkCache.end (); ++i)
+    {
+      m_netGraphNodes.push_back (i->first.m_low);
+      m_netGraphNodes.push_back (i->first.m_high);
+    }
+  std::sort (m_netGraphNodes.begin (), m_netGraphNodes.end ());
+  m_netGraphNodes.erase (std::unique (m_netGraphNodes.begin (), m_netGraphNodes.end ()), m_netGraphNodes.end ());
+
+  // count the edges of each node, then place them
+  uint32_t n = m_netGraphNodes.size ();
+  std::vector<uint32_t> low;
+  std::vector<uint32_t> high;
+  m_netGraphFirstEdge.assign (n + 1, 0);
+  for (std::map<Link, DsrLinkStab>::iterator i = m_linkCache.begin (); i != m_linkCache.end (); ++i)
+    {
+      low.push_back (std::lower_bound (m_netGraphNodes.begin (), m_netGraphNodes.end (), i->first.m_low) - m_netGraphNodes.begin ());
+      high.push_back (std::lower_bound (m_netGraphNodes.begin (), m_netGraphNodes.end (), i->first.m_high) - m_netGraphNodes.begin ());
+      m_netGraphFirstEdge[low.back () + 1]++;
+      m_netGraphFirstEdge[high.back () + 1]++;
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_netGraphFirstEdge[i + 1] += m_netGraphFirstEdge[i];
+    }
+  m_netGraphEdges.resize (m_netGraphFirstEdge[n]);
+  std::vector<uint32_t> next (m_netGraphFirstEdge.begin (), m_netGraphFirstEdge.end () - 1);
+  uint32_t j = 0;
+  for (std::map<Link, DsrLinkStab>::iterator i = m_linkCache.begin (); i != m_linkCache.end (); ++i, ++j)
     {
       // Here the weight is set as 1
       /// \todo May need to set different weight for different link here later
-      uint32_t weight = 1;
-      m_netGraph[i->first.m_low][i->first.m_high] = weight;
-      m_netGraph[i->first.m_high][i->first.m_low] = weight;
+      NetGraphEdge edge;
+      edge.weight = 1;
+      edge.stability = i->second.GetLinkStability ();
+      edge.neighbor = high[j];
+      m_netGraphEdges[next[low[j]]++] = edge;
+      edge.neighbor = low[j];
+      m_netGraphEdges[next[high[j]]++] = edge;
     }
 }
 
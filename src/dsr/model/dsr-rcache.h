@@ -568,11 +568,22 @@ private:
    */
   #define MAXWEIGHT 0xFFFF;
   /**
-   * Current network graph state for this node, double is weight, which is calculated by the node information
-   * and link information, any time some changes of link cache and node cache
-   * change the weight and then recompute the best choice for each node
+   * An edge of the network graph
    */
-  std::map<Ipv4Address, std::map<Ipv4Address, uint32_t> > m_netGraph;
+  struct NetGraphEdge
+  {
+    uint32_t neighbor;                  ///< The index of the node at the other end
+    uint32_t weight;                    ///< The weight of the link
+    Time stability;                     ///< The stability of the link
+  };
+  /**
+   * Current network graph state for this node, built from the link cache, any time some changes of link cache
+   * and node cache change the weight and then recompute the best choice for each node. The nodes are numbered
+   * in increasing address order, and the edges of each node are stored contiguously.
+   */
+  std::vector<Ipv4Address> m_netGraphNodes;                                        ///< The nodes of the network graph
+  std::vector<uint32_t> m_netGraphFirstEdge;                                       ///< The index of the first edge of each node, and the number of edges
+  std::vector<NetGraphEdge> m_netGraphEdges;                                       ///< The edges of the nodes, in both directions
 
   std::map<Ipv4Address, DsrRouteCacheEntry::IP_VECTOR> m_bestRoutesTable_link;     ///< for link route cache
   std::map<Link, DsrLinkStab> m_linkCache;                                         ///< The data structure to store link info
@@ -596,7 +607,7 @@ private:
 
 public:
   /**
-   * \brief Dijsktra algorithm to get the best route from m_netGraph and update the m_bestRoutesTable_link
+   * \brief Dijsktra algorithm to get the best route from the network graph and update the m_bestRoutesTable_link
    * when current graph information has changed
    * \param type The type of the cache
    */
@@ -604,7 +615,8 @@ public:
   bool IsLinkCache ();
   bool AddRoute_Link (DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Address node);
   /**
-   *  \brief USE MAXWEIGHT TO REPRESENT MAX; USE BROADCAST ADDRESS TO REPRESENT NULL PRECEEDING ADDRESS
+   *  \brief Compute the shortest routes from the source with a binary heap; among the routes of equal length,
+   *  prefer the last link with the longest expected lifetime
    *  \param source The source address the routes based on
    */
   void RebuildBestRouteTable (Ipv4Address source);
@@ -30,6 +30,8 @@
  */
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #include "ns3/ptr.h"
 #include "ns3/boolean.h"
 #include "ns3/test.h"
@@ -40,6 +42,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/string.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/random-variable-stream.h"
 
 #include "ns3/dsr-fs-header.h"
 #include "ns3/dsr-option-header.h"
@@ -384,6 +387,201 @@ DsrCacheEntryTest::DoRun ()
   NS_TEST_EXPECT_MSG_EQ (rcache->DeleteRoute (Ipv4Address ("1.1.1.1")), false, "trivial");
 }
 // -----------------------------------------------------------------------------
+// / Unit test for DSR link cache routes
+class DsrLinkCacheTest : public TestCase
+{
+public:
+  DsrLinkCacheTest ();
+  ~DsrLinkCacheTest ();
+  virtual void
+  DoRun (void);
+  /**
+   * Mirrors the link and node stabilities of the route cache when a link is added
+   */
+  void AddLink (Ipv4Address a, Ipv4Address b, Time initStability, Time minLifeTime);
+  /**
+   * Mirrors the link and node stabilities of the route cache when a link is used
+   */
+  void UseLink (Ipv4Address a, Ipv4Address b, Time initStability, Time useExtends, uint64_t incrFactor);
+  /**
+   * The routes computed by the former implementation of DsrRouteCache::RebuildBestRouteTable,
+   * which scanned all the nodes to find the closest one
+   */
+  std::map<Ipv4Address, std::vector<Ipv4Address> > GetReferenceRoutes (Ipv4Address source);
+
+  std::map<dsr::Link, Time> m_links;
+  std::map<Ipv4Address, Time> m_nodes;
+};
+DsrLinkCacheTest::DsrLinkCacheTest ()
+  : TestCase ("DSR link cache routes")
+{
+}
+DsrLinkCacheTest::~DsrLinkCacheTest ()
+{
+}
+void
+DsrLinkCacheTest::AddLink (Ipv4Address a, Ipv4Address b, Time initStability, Time minLifeTime)
+{
+  if (m_nodes.find (a) == m_nodes.end ())
+    {
+      m_nodes[a] = initStability;
+    }
+  if (m_nodes.find (b) == m_nodes.end ())
+    {
+      m_nodes[b] = initStability;
+    }
+  m_links[dsr::Link (a, b)] = std::max (std::min (m_nodes[a], m_nodes[b]), minLifeTime);
+}
+void
+DsrLinkCacheTest::UseLink (Ipv4Address a, Ipv4Address b, Time initStability, Time useExtends, uint64_t incrFactor)
+{
+  std::map<dsr::Link, Time>::iterator link = m_links.find (dsr::Link (a, b));
+  if (link != m_links.end () && link->second < useExtends)
+    {
+      link->second = useExtends;
+    }
+  Ipv4Address ends[2] = { a, b };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      std::map<Ipv4Address, Time>::iterator node = m_nodes.find (ends[i]);
+      if (node != m_nodes.end () && node->second <= initStability)
+        {
+          node->second = Time (node->second * incrFactor);
+        }
+    }
+}
+std::map<Ipv4Address, std::vector<Ipv4Address> >
+DsrLinkCacheTest::GetReferenceRoutes (Ipv4Address source)
+{
+  const uint32_t maxWeight = 0xFFFF;
+  std::map<Ipv4Address, std::map<Ipv4Address, uint32_t> > netGraph;
+  for (std::map<dsr::Link, Time>::const_iterator i = m_links.begin (); i != m_links.end (); ++i)
+    {
+      netGraph[i->first.m_low][i->first.m_high] = 1;
+      netGraph[i->first.m_high][i->first.m_low] = 1;
+    }
+  std::map<Ipv4Address, uint32_t> d;
+  std::map<Ipv4Address, Ipv4Address> pre;
+  for (std::map<Ipv4Address, std::map<Ipv4Address, uint32_t> >::iterator i = netGraph.begin (); i != netGraph.end (); ++i)
+    {
+      if (i->second.find (source) != i->second.end ())
+        {
+          d[i->first] = i->second[source];
+          pre[i->first] = source;
+        }
+      else
+        {
+          d[i->first] = maxWeight;
+          pre[i->first] = Ipv4Address ("255.255.255.255");
+        }
+    }
+  d[source] = 0;
+  std::map<Ipv4Address, bool> s;
+  uint32_t temp = maxWeight;
+  Ipv4Address tempip = Ipv4Address ("255.255.255.255");
+  for (uint32_t i = 0; i < netGraph.size (); i++)
+    {
+      temp = maxWeight;
+      for (std::map<Ipv4Address, uint32_t>::const_iterator j = d.begin (); j != d.end (); ++j)
+        {
+          if (s.find (j->first) == s.end () && j->second <= temp)
+            {
+              temp = j->second;
+              tempip = j->first;
+            }
+        }
+      if (!tempip.IsBroadcast ())
+        {
+          s[tempip] = true;
+          for (std::map<Ipv4Address, uint32_t>::const_iterator k = netGraph[tempip].begin (); k != netGraph[tempip].end (); ++k)
+            {
+              if (s.find (k->first) == s.end () && d[k->first] > d[tempip] + k->second)
+                {
+                  d[k->first] = d[tempip] + k->second;
+                  pre[k->first] = tempip;
+                }
+              else if (d[k->first] == d[tempip] + k->second
+                       && m_links[dsr::Link (k->first, pre[k->first])] < m_links[dsr::Link (k->first, tempip)])
+                {
+                  pre[k->first] = tempip;
+                }
+            }
+        }
+    }
+  std::map<Ipv4Address, std::vector<Ipv4Address> > routes;
+  for (std::map<Ipv4Address, Ipv4Address>::iterator i = pre.begin (); i != pre.end (); ++i)
+    {
+      if (!i->second.IsBroadcast () && i->first != source)
+        {
+          std::vector<Ipv4Address> route;
+          for (Ipv4Address iptemp = i->first; iptemp != source; iptemp = pre[iptemp])
+            {
+              route.push_back (iptemp);
+            }
+          route.push_back (source);
+          routes[i->first] = std::vector<Ipv4Address> (route.rbegin (), route.rend ());
+        }
+    }
+  return routes;
+}
+void
+DsrLinkCacheTest::DoRun ()
+{
+  Ptr<dsr::DsrRouteCache> rcache = CreateObject<dsr::DsrRouteCache> ();
+  rcache->SetCacheType ("LinkCache");
+  rcache->SetStabilityIncrFactor (2);
+  rcache->SetMinLifeTime (Seconds (2));
+  rcache->SetUseExtends (Seconds (4));
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  const uint32_t nNodes = 30;
+  std::vector<Ipv4Address> nodes;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      nodes.push_back (Ipv4Address (0x0a000001 + i));
+    }
+  Ipv4Address source = nodes[0];
+
+  // a random sequence of added and used links, with different stabilities
+  for (uint32_t step = 0; step < 200; step++)
+    {
+      Ipv4Address a = nodes[random->GetInteger (0, nNodes - 1)];
+      Ipv4Address b = nodes[random->GetInteger (0, nNodes - 1)];
+      if (a == b)
+        {
+          continue;
+        }
+      std::vector<Ipv4Address> link;
+      link.push_back (a);
+      link.push_back (b);
+      Time initStability = Seconds (random->GetInteger (1, 4));
+      rcache->SetInitStability (initStability);
+      if (random->GetValue () < 0.25)
+        {
+          rcache->UseExtends (link);
+          UseLink (a, b, initStability, rcache->GetUseExtends (), rcache->GetStabilityIncrFactor ());
+          continue;
+        }
+      rcache->AddRoute_Link (link, source);
+      AddLink (a, b, initStability, rcache->GetMinLifeTime ());
+
+      std::map<Ipv4Address, std::vector<Ipv4Address> > routes = GetReferenceRoutes (source);
+      for (uint32_t i = 1; i < nNodes; i++)
+        {
+          dsr::DsrRouteCacheEntry entry;
+          std::map<Ipv4Address, std::vector<Ipv4Address> >::const_iterator route = routes.find (nodes[i]);
+          bool found = rcache->LookupRoute (nodes[i], entry);
+          bool expected = route != routes.end ();
+          NS_TEST_ASSERT_MSG_EQ (found, expected, "Route to " << nodes[i] << " at step " << step);
+          if (found)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((entry.GetVector () == route->second), true, "Route to " << nodes[i] << " at step " << step);
+            }
+        }
+    }
+}
+// -----------------------------------------------------------------------------
 // / Unit test for Send Buffer
 class DsrSendBuffTest : public TestCase
 {
@@ -516,6 +714,7 @@ public:
     AddTestCase (new DsrAckReqHeaderTest, TestCase::QUICK);
     AddTestCase (new DsrAckHeaderTest, TestCase::QUICK);
     AddTestCase (new DsrCacheEntryTest, TestCase::QUICK);
+    AddTestCase (new DsrLinkCacheTest, TestCase::QUICK);
     AddTestCase (new DsrSendBuffTest, TestCase::QUICK);
   }
 } g_dsrTestSuite;
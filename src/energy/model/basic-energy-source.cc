@@ -22,9 +22,12 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("BasicEnergySource");
@@ -66,6 +69,15 @@ BasicEnergySource::GetTypeId (void)
                    MakeTimeAccessor (&BasicEnergySource::SetEnergyUpdateInterval,
                                      &BasicEnergySource::GetEnergyUpdateInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("EventDrivenEnergyUpdate",
+                   "If true, the remaining energy is only updated when a "
+                   "device changes state or when it is read, and a single "
+                   "event is scheduled when the remaining energy is "
+                   "predicted to cross a battery threshold, instead of "
+                   "an update every PeriodicEnergyUpdateInterval.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&BasicEnergySource::m_eventDriven),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RemainingEnergy",
                      "Remaining energy at BasicEnergySource.",
                      MakeTraceSourceAccessor (&BasicEnergySource::m_remainingEnergyJ),
@@ -79,6 +91,7 @@ BasicEnergySource::BasicEnergySource ()
   NS_LOG_FUNCTION (this);
   m_lastUpdateTime = Seconds (0.0);
   m_depleted = false;
+  m_eventDriven = false;
 }
 
 BasicEnergySource::~BasicEnergySource ()
@@ -178,6 +191,18 @@ BasicEnergySource::UpdateEnergySource (void)
       HandleEnergyRechargedEvent ();
     }
 
+  if (m_eventDriven)
+    {
+      // the devices notify their state changes before they change their
+      // current, so wait for the end of the current event to predict
+      if (!m_thresholdEvent.IsRunning ())
+        {
+          m_thresholdEvent = Simulator::ScheduleNow (&BasicEnergySource::ScheduleThresholdEvent,
+                                                     this);
+        }
+      return;
+    }
+
   m_energyUpdateEvent = Simulator::Schedule (m_energyUpdateInterval,
                                              &BasicEnergySource::UpdateEnergySource,
                                              this);
@@ -239,4 +264,42 @@ BasicEnergySource::CalculateRemainingEnergy (void)
   NS_LOG_DEBUG ("BasicEnergySource:Remaining energy = " << m_remainingEnergyJ);
 }
 
+void
+BasicEnergySource::ScheduleThresholdEvent (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyUpdateEvent.Cancel ();
+
+  // the power drawn from the source is constant until the next update
+  double powerW = CalculateTotalCurrent () * m_supplyVoltageV;
+  double energyToCrossJ;
+  if (!m_depleted && powerW > 0)
+    {
+      energyToCrossJ = m_remainingEnergyJ - m_lowBatteryTh * m_initialEnergyJ;
+    }
+  else if (m_depleted && powerW < 0)
+    {
+      energyToCrossJ = m_highBatteryTh * m_initialEnergyJ - m_remainingEnergyJ;
+      powerW = -powerW;
+    }
+  else
+    {
+      NS_LOG_DEBUG ("BasicEnergySource:No threshold crossing ahead");
+      return;
+    }
+
+  double delayS = std::max (energyToCrossJ, 0.0) / powerW;
+  Time maxDelay = Simulator::GetMaximumSimulationTime () - Simulator::Now ();
+  if (delayS >= maxDelay.GetSeconds ())
+    {
+      return;
+    }
+  // one more time step, so that the update happens after the crossing
+  Time delay = Seconds (delayS) + TimeStep (1);
+  NS_LOG_DEBUG ("BasicEnergySource:Threshold crossing in " << delay.GetSeconds () << " s");
+  m_energyUpdateEvent = Simulator::Schedule (delay,
+                                             &BasicEnergySource::UpdateEnergySource,
+                                             this);
+}
+
 } // namespace ns3
@@ -135,6 +135,13 @@ private:
    */
   void CalculateRemainingEnergy (void);
 
+  /**
+   * Schedules an update when the remaining energy crosses the low battery
+   * threshold, or the high battery threshold after depletion, if the
+   * total current does not change. Only used with EventDrivenEnergyUpdate.
+   */
+  void ScheduleThresholdEvent (void);
+
 private:
   double m_initialEnergyJ;                // initial energy, in Joules
   double m_supplyVoltageV;                // supply voltage, in Volts
@@ -146,6 +153,8 @@ private:
   EventId m_energyUpdateEvent;            // energy update event
   Time m_lastUpdateTime;                  // last update time
   Time m_energyUpdateInterval;            // energy update interval
+  bool m_eventDriven;                     // update only on state changes and threshold crossings
+  EventId m_thresholdEvent;               // threshold crossing prediction event
 
 };
 
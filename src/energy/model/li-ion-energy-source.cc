@@ -21,9 +21,11 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "li-ion-energy-source.h"
@@ -104,6 +106,16 @@ LiIonEnergySource::GetTypeId (void)
                    MakeTimeAccessor (&LiIonEnergySource::SetEnergyUpdateInterval,
                                      &LiIonEnergySource::GetEnergyUpdateInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("EventDrivenEnergyUpdate",
+                   "If true, the remaining energy is only updated when a "
+                   "device changes state or when it is read, and a single "
+                   "event is scheduled when the remaining energy is "
+                   "predicted to cross the low battery threshold, instead "
+                   "of an update every PeriodicEnergyUpdateInterval. The "
+                   "cell voltage is then only updated at these times.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LiIonEnergySource::m_eventDriven),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RemainingEnergy",
                      "Remaining energy at BasicEnergySource.",
                      MakeTraceSourceAccessor (&LiIonEnergySource::m_remainingEnergyJ),
@@ -114,7 +126,8 @@ LiIonEnergySource::GetTypeId (void)
 
 LiIonEnergySource::LiIonEnergySource ()
   : m_drainedCapacity (0.0),
-    m_lastUpdateTime (Seconds (0.0))
+    m_lastUpdateTime (Seconds (0.0)),
+    m_eventDriven (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -235,6 +248,18 @@ LiIonEnergySource::UpdateEnergySource (void)
       return; // stop periodic update
     }
 
+  if (m_eventDriven)
+    {
+      // the devices notify their state changes before they change their
+      // current, so wait for the end of the current event to predict
+      if (!m_thresholdEvent.IsRunning ())
+        {
+          m_thresholdEvent = Simulator::ScheduleNow (&LiIonEnergySource::ScheduleThresholdEvent,
+                                                     this);
+        }
+      return;
+    }
+
   m_energyUpdateEvent = Simulator::Schedule (m_energyUpdateInterval,
                                              &LiIonEnergySource::UpdateEnergySource,
                                              this);
@@ -293,6 +318,35 @@ LiIonEnergySource::CalculateRemainingEnergy (void)
   NS_LOG_DEBUG ("LiIonEnergySource:Remaining energy = " << m_remainingEnergyJ);
 }
 
+void
+LiIonEnergySource::ScheduleThresholdEvent (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyUpdateEvent.Cancel ();
+
+  // the power drawn from the cell is constant until the next update
+  double powerW = CalculateTotalCurrent () * m_supplyVoltageV;
+  if (powerW <= 0)
+    {
+      NS_LOG_DEBUG ("LiIonEnergySource:No threshold crossing ahead");
+      return;
+    }
+
+  double energyToCrossJ = m_remainingEnergyJ - m_lowBatteryTh * m_initialEnergyJ;
+  double delayS = std::max (energyToCrossJ, 0.0) / powerW;
+  Time maxDelay = Simulator::GetMaximumSimulationTime () - Simulator::Now ();
+  if (delayS >= maxDelay.GetSeconds ())
+    {
+      return;
+    }
+  // one more time step, so that the update happens after the crossing
+  Time delay = Seconds (delayS) + TimeStep (1);
+  NS_LOG_DEBUG ("LiIonEnergySource:Threshold crossing in " << delay.GetSeconds () << " s");
+  m_energyUpdateEvent = Simulator::Schedule (delay,
+                                             &LiIonEnergySource::UpdateEnergySource,
+                                             this);
+}
+
 double
 LiIonEnergySource::GetVoltage (double i) const
 {
@@ -171,6 +171,13 @@ private:
    */
   void CalculateRemainingEnergy (void);
 
+  /**
+   * Schedules an update when the remaining energy crosses the low battery
+   * threshold, if the total current does not change. Only used with
+   * EventDrivenEnergyUpdate.
+   */
+  void ScheduleThresholdEvent (void);
+
   /**
    *  \param current the actual discharge current value.
    *
@@ -189,6 +196,8 @@ private:
   EventId m_energyUpdateEvent;            // energy update event
   Time m_lastUpdateTime;                  // last update time
   Time m_energyUpdateInterval;            // energy update interval
+  bool m_eventDriven;                     // update only on state changes and threshold crossings
+  EventId m_thresholdEvent;               // threshold crossing prediction event
   double m_eFull;                         // initial voltage of the cell, in Volts
   double m_eNom;                          // nominal voltage of the cell, in Volts
   double m_eExp;                          // cell voltage at the end of the exponential zone, in Volts
@@ -21,7 +21,9 @@
 #include "rv-battery-model.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 #include <cmath>
@@ -80,6 +82,24 @@ RvBatteryModel::GetTypeId (void)
                    MakeIntegerAccessor (&RvBatteryModel::SetNumOfTerms,
                                         &RvBatteryModel::GetNumOfTerms),
                    MakeIntegerChecker<int> ())
+    .AddAttribute ("RvBatteryModelIncremental",
+                   "If true, the battery level is computed from running sums "
+                   "which are updated at each sample, instead of from the "
+                   "whole load profile. The number of terms and the beta "
+                   "value must then not be changed after the first sample.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&RvBatteryModel::m_incremental),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RvBatteryModelEventDriven",
+                   "If true, the battery level is only updated when a "
+                   "device changes state or when it is read, and a single "
+                   "event is scheduled when the battery level is predicted "
+                   "to cross the low battery threshold, instead of a "
+                   "sample every RvBatteryModelPeriodicEnergyUpdateInterval. "
+                   "This requires RvBatteryModelIncremental.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RvBatteryModel::m_eventDriven),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RvBatteryModelBatteryLevel",
                      "RV battery model battery level.",
                      MakeTraceSourceAccessor (&RvBatteryModel::m_batteryLevel),
@@ -98,6 +118,10 @@ RvBatteryModel::RvBatteryModel ()
   m_lastSampleTime = Simulator::Now ();
   m_timeStamps.push_back (m_lastSampleTime);
   m_previousLoad = -1.0;
+  m_linearSum = 0.0;
+  m_openLoad = 0.0;
+  m_openStart = m_lastSampleTime;
+  m_eventDriven = false;
   m_batteryLevel = 1; // fully charged
   m_lifetime = Seconds (0.0);
 }
@@ -182,6 +206,19 @@ RvBatteryModel::UpdateEnergySource (void)
 
   m_previousLoad = currentLoad;
   m_lastSampleTime = Simulator::Now ();
+
+  if (m_eventDriven)
+    {
+      // the devices notify their state changes before they change their
+      // current, so wait for the end of the current event to predict
+      if (m_batteryLevel > m_lowBatteryTh && !m_thresholdEvent.IsRunning ())
+        {
+          m_thresholdEvent = Simulator::ScheduleNow (&RvBatteryModel::ScheduleThresholdEvent,
+                                                     this);
+        }
+      return;
+    }
+
   m_currentSampleEvent = Simulator::Schedule (m_samplingInterval,
                                               &RvBatteryModel::UpdateEnergySource,
                                               this);
@@ -251,6 +288,9 @@ RvBatteryModel::SetBeta (double beta)
 {
   NS_LOG_FUNCTION (this << beta);
   NS_ASSERT (beta >= 0);
+  NS_ABORT_MSG_IF (!m_decayedSums.empty () && beta != m_beta,
+                   "RvBatteryModel: the beta value cannot be changed after the first "
+                   "sample when RvBatteryModelIncremental is true");
   m_beta = beta;
 }
 
@@ -280,6 +320,9 @@ void
 RvBatteryModel::SetNumOfTerms (int num)
 {
   NS_LOG_FUNCTION (this << num);
+  NS_ABORT_MSG_IF (!m_decayedSums.empty () && num != m_numOfTerms,
+                   "RvBatteryModel: the number of terms cannot be changed after the first "
+                   "sample when RvBatteryModelIncremental is true");
   m_numOfTerms = num;
 }
 
@@ -298,6 +341,10 @@ void
 RvBatteryModel::DoInitialize (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_eventDriven && !m_incremental)
+    {
+      NS_FATAL_ERROR ("RvBatteryModelEventDriven requires RvBatteryModelIncremental");
+    }
   NS_LOG_DEBUG ("RvBatteryModel:Starting battery level update!");
   UpdateEnergySource ();  // start periodic sampling of load (total current)
 }
@@ -322,6 +369,11 @@ RvBatteryModel::Discharge (double load, Time t)
 {
   NS_LOG_FUNCTION (this << load << t);
 
+  if (m_incremental)
+    {
+      return IncrementalDischarge (load, t);
+    }
+
   // record only when load changes
   if (load != m_previousLoad)
     {
@@ -382,4 +434,110 @@ RvBatteryModel::RvModelAFunction (Time t, Time sk, Time sk_1, double beta)
   return delta + 2 * sum;
 }
 
+double
+RvBatteryModel::IncrementalDischarge (double load, Time t)
+{
+  NS_LOG_FUNCTION (this << load << t);
+
+  /*
+   * The A function of a past load interval [sk_1, sk] only depends on t
+   * through exp (-beta^2 m^2 t), so the sum of the terms of order m over
+   * all the past intervals is a single value, m_decayedSums[m - 1], which
+   * decays by exp (-beta^2 m^2 d) when t advances by d. The sums are kept
+   * at the start of the current interval, m_openStart.
+   */
+  if (m_decayedSums.size () != static_cast<uint32_t> (m_numOfTerms))
+    {
+      m_decayedSums.resize (m_numOfTerms, 0.0);
+    }
+
+  // a new load starts a new interval at the previous sampling time
+  if (load != m_previousLoad)
+    {
+      double delta = (m_lastSampleTime.GetSeconds () - m_openStart.GetSeconds ()) / 60;
+      m_linearSum += m_openLoad * delta;
+      for (int m = 1; m <= m_numOfTerms; m++)
+        {
+          double decay = std::exp (-m_beta * m_beta * m * m * delta);
+          m_decayedSums[m - 1] = m_decayedSums[m - 1] * decay + m_openLoad * (1 - decay);
+        }
+      m_openLoad = load;
+      m_openStart = m_lastSampleTime;
+      m_previousLoad = load;
+    }
+
+  m_lastSampleTime = t;
+
+  // everything is in minutes
+  return IncrementalAlpha ((t.GetSeconds () - m_openStart.GetSeconds ()) / 60);
+}
+
+double
+RvBatteryModel::IncrementalAlpha (double delta) const
+{
+  double sum = 0.0;
+  for (int m = 1; m <= m_numOfTerms; m++)
+    {
+      double square = m_beta * m_beta * m * m;
+      double decay = std::exp (-square * delta);
+      sum += (m_decayedSums[m - 1] * decay + m_openLoad * (1 - decay)) / square;
+    }
+  return m_linearSum + m_openLoad * delta + 2 * sum;
+}
+
+void
+RvBatteryModel::ScheduleThresholdEvent (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_currentSampleEvent.Cancel ();
+
+  // start the interval of the new load, which lasts until the next update
+  Time now = Simulator::Now ();
+  double load = CalculateTotalCurrent () * 1000; // must be in mA
+  IncrementalDischarge (load, now);
+  m_previousLoad = load;
+
+  /*
+   * Find the first time at which alpha reaches the low battery threshold.
+   * Alpha does not grow faster than its derivative at the current time
+   * with the recovery terms left out, so moving by the missing charge
+   * divided by that slope never goes past the crossing.
+   */
+  double target = (1 - m_lowBatteryTh) * m_alpha;
+  double maxDelta = (Simulator::GetMaximumSimulationTime () - now).GetSeconds () / 60;
+  double start = (now.GetSeconds () - m_openStart.GetSeconds ()) / 60;
+  double delta = start;
+  double missing = target - IncrementalAlpha (delta);
+  for (int i = 0; i < 100 && missing > target * 1e-12; i++)
+    {
+      double slope = m_openLoad;
+      for (int m = 1; m <= m_numOfTerms; m++)
+        {
+          if (m_openLoad > m_decayedSums[m - 1])
+            {
+              double square = m_beta * m_beta * m * m;
+              slope += 2 * (m_openLoad - m_decayedSums[m - 1]) * std::exp (-square * delta);
+            }
+        }
+      if (slope <= 0)
+        {
+          NS_LOG_DEBUG ("RvBatteryModel:No threshold crossing ahead");
+          return;
+        }
+      delta += missing / slope;
+      if (delta - start >= maxDelta)
+        {
+          return;
+        }
+      missing = target - IncrementalAlpha (delta);
+    }
+
+  // one more time step, so that the update happens after the crossing
+  Time delay = Seconds ((delta - start) * 60) + TimeStep (1);
+  NS_LOG_DEBUG ("RvBatteryModel:Threshold crossing in " << delay.GetSeconds () << " s");
+  m_currentSampleEvent = Simulator::Schedule (delay,
+                                              &RvBatteryModel::UpdateEnergySource,
+                                              this);
+}
+
 } // namespace ns3
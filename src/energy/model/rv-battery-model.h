@@ -140,6 +140,9 @@ public:
   /**
    * \brief Sets the beta value for the battery model.
    *
+   * With RvBatteryModelIncremental, the beta value cannot be changed after
+   * the first sample of the load.
+   *
    * \param beta Beta.
    */
   void SetBeta (double beta);
@@ -163,6 +166,9 @@ public:
    * \brief Sets the number of terms of the infinite sum for estimating battery
    * level.
    *
+   * With RvBatteryModelIncremental, the number of terms cannot be changed
+   * after the first sample of the load.
+   *
    * \param num Number of terms.
    */
   void SetNumOfTerms (int num);
@@ -215,6 +221,31 @@ private:
    */
   double RvModelAFunction (Time t, Time sk, Time sk_1, double beta);
 
+  /**
+   * \brief Discharges the battery, in O(number of terms) operations.
+   *
+   * \param load Load value (total current form devices, in mA).
+   * \param t Time stamp of the load value.
+   * \returns Calculated alpha value.
+   *
+   * This function returns the same value as the sum of the A functions
+   * of the load profile, without recording the load profile.
+   */
+  double IncrementalDischarge (double load, Time t);
+
+  /**
+   * \param delta Time since the start of the current load interval, in minutes.
+   * \returns Calculated alpha value, if the load does not change.
+   */
+  double IncrementalAlpha (double delta) const;
+
+  /**
+   * Schedules a sample when the battery level crosses the low battery
+   * threshold, if the total current does not change. Only used with
+   * RvBatteryModelEventDriven.
+   */
+  void ScheduleThresholdEvent (void);
+
 private:
   double m_openCircuitVoltage;
   double m_cutoffVoltage;
@@ -228,6 +259,15 @@ private:
 
   int m_numOfTerms; // # of terms for infinite sum in battery level estimation
 
+  bool m_incremental;    // use IncrementalDischarge
+  double m_linearSum;    // sum of load * duration of the past load intervals, in mA.min
+  std::vector<double> m_decayedSums; // sum of the terms of each order of the past load intervals
+  double m_openLoad;     // load of the current interval
+  Time m_openStart;      // start of the current interval
+
+  bool m_eventDriven;          // sample only on state changes and threshold crossings
+  EventId m_thresholdEvent;    // threshold crossing prediction event
+
   /**
    * Battery level is defined as: output of Discharge function / alpha value
    *
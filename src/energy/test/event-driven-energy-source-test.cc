@@ -0,0 +1,280 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simple-device-energy-model.h"
+#include "ns3/basic-energy-source.h"
+#include "ns3/li-ion-energy-source.h"
+#include "ns3/rv-battery-model.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EventDrivenEnergySourceTestSuite");
+
+/**
+ * Attach an energy source and a simple device to a new node.
+ *
+ * \param source The energy source.
+ * \returns The device.
+ */
+static Ptr<SimpleDeviceEnergyModel>
+InstallSource (Ptr<EnergySource> source)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleDeviceEnergyModel> device = CreateObject<SimpleDeviceEnergyModel> ();
+  source->SetNode (node);
+  device->SetEnergySource (source);
+  device->SetNode (node);
+  source->AppendDeviceEnergyModel (device);
+  node->AggregateObject (source);
+  return device;
+}
+
+/**
+ * Records the updates of a traced value.
+ */
+class TraceRecorder
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param threshold The value whose first crossing is recorded.
+   */
+  TraceRecorder (double threshold = 0)
+    : count (0),
+      value (0),
+      threshold (threshold)
+  {
+  }
+  /**
+   * Record an update.
+   *
+   * \param oldValue The previous value.
+   * \param newValue The new value.
+   */
+  void Update (double oldValue, double newValue)
+  {
+    count++;
+    value = newValue;
+    time = Simulator::Now ();
+    if (newValue <= threshold && crossing.IsZero ())
+      {
+        crossing = time;
+      }
+  }
+  uint32_t count;    //!< Number of updates.
+  double value;      //!< Last value.
+  Time time;         //!< Time of the last update.
+  double threshold;  //!< The value whose crossing is recorded.
+  Time crossing;     //!< Time of the first update to a value below the threshold.
+};
+
+/**
+ * Check that the event-driven BasicEnergySource and RvBatteryModel
+ * follow the periodic ones under a random load.
+ */
+class EventDrivenEnergySourceCompareTestCase : public TestCase
+{
+public:
+  EventDrivenEnergySourceCompareTestCase ();
+
+  void DoRun (void);
+
+private:
+  /**
+   * Set the same current on all devices.
+   *
+   * \param current The current, in Amperes.
+   */
+  void SetCurrent (double current);
+  /** Compare the event-driven and periodic sources. */
+  void Check (void);
+
+  Ptr<BasicEnergySource> m_basic[2];
+  Ptr<RvBatteryModel> m_rv[2];
+  std::vector<Ptr<SimpleDeviceEnergyModel> > m_devices;
+  uint32_t m_checks;
+};
+
+EventDrivenEnergySourceCompareTestCase::EventDrivenEnergySourceCompareTestCase ()
+  : TestCase ("Compare event-driven and periodic energy sources"),
+    m_checks (0)
+{
+}
+
+void
+EventDrivenEnergySourceCompareTestCase::SetCurrent (double current)
+{
+  for (uint32_t i = 0; i < m_devices.size (); ++i)
+    {
+      m_devices[i]->SetCurrentA (current);
+    }
+}
+
+void
+EventDrivenEnergySourceCompareTestCase::Check (void)
+{
+  double periodic = m_basic[0]->GetRemainingEnergy ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_basic[1]->GetRemainingEnergy (), periodic, 1e-9 * periodic,
+                             "Wrong basic remaining energy at " << Simulator::Now ().GetSeconds ());
+  periodic = m_rv[0]->GetBatteryLevel ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rv[1]->GetBatteryLevel (), periodic, 1e-9,
+                             "Wrong RV battery level at " << Simulator::Now ().GetSeconds ());
+  m_checks++;
+}
+
+void
+EventDrivenEnergySourceCompareTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      m_basic[i] = CreateObject<BasicEnergySource> ();
+      m_basic[i]->SetAttribute ("BasicEnergySourceInitialEnergyJ", DoubleValue (20000));
+      m_basic[i]->SetAttribute ("EventDrivenEnergyUpdate", BooleanValue (i == 1));
+      m_devices.push_back (InstallSource (m_basic[i]));
+      m_rv[i] = CreateObject<RvBatteryModel> ();
+      m_rv[i]->SetAttribute ("RvBatteryModelEventDriven", BooleanValue (i == 1));
+      m_devices.push_back (InstallSource (m_rv[i]));
+    }
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < 300; ++i)
+    {
+      double current = random->GetValue () < 0.2 ? 0 : random->GetValue (0, 0.4);
+      Simulator::Schedule (Seconds (random->GetValue (0, 7200)),
+                           &EventDrivenEnergySourceCompareTestCase::SetCurrent, this, current);
+    }
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      Simulator::Schedule (Seconds (random->GetValue (0, 7200)),
+                           &EventDrivenEnergySourceCompareTestCase::Check, this);
+    }
+  Simulator::Stop (Seconds (7200));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 200, "Some checks did not run");
+
+  Simulator::Destroy ();
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      m_basic[i] = 0;
+      m_rv[i] = 0;
+    }
+  m_devices.clear ();
+}
+
+/**
+ * Check that the event-driven energy sources update themselves when
+ * the low battery threshold is crossed under a constant load, and
+ * only then.
+ */
+class EventDrivenEnergySourceThresholdTestCase : public TestCase
+{
+public:
+  EventDrivenEnergySourceThresholdTestCase ();
+
+  void DoRun (void);
+};
+
+EventDrivenEnergySourceThresholdTestCase::EventDrivenEnergySourceThresholdTestCase ()
+  : TestCase ("Check the threshold crossings of event-driven energy sources")
+{
+}
+
+void
+EventDrivenEnergySourceThresholdTestCase::DoRun (void)
+{
+  // 0.3 W from 10 J, down to 1 J at 30 s
+  Ptr<BasicEnergySource> basic = CreateObject<BasicEnergySource> ();
+  basic->SetAttribute ("EventDrivenEnergyUpdate", BooleanValue (true));
+  Ptr<SimpleDeviceEnergyModel> device = InstallSource (basic);
+  Simulator::Schedule (Seconds (0), &SimpleDeviceEnergyModel::SetCurrentA, device, 0.1);
+  TraceRecorder basicTrace;
+  basic->TraceConnectWithoutContext ("RemainingEnergy",
+                                     MakeCallback (&TraceRecorder::Update, &basicTrace));
+
+  Ptr<LiIonEnergySource> liIon = CreateObject<LiIonEnergySource> ();
+  liIon->SetAttribute ("EventDrivenEnergyUpdate", BooleanValue (true));
+  device = InstallSource (liIon);
+  Simulator::Schedule (Seconds (0), &SimpleDeviceEnergyModel::SetCurrentA, device, 2.33);
+  TraceRecorder liIonTrace;
+  liIon->TraceConnectWithoutContext ("RemainingEnergy",
+                                     MakeCallback (&TraceRecorder::Update, &liIonTrace));
+
+  Ptr<RvBatteryModel> rv[2];
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      rv[i] = CreateObject<RvBatteryModel> ();
+      rv[i]->SetAttribute ("RvBatteryModelEventDriven", BooleanValue (i == 1));
+      device = InstallSource (rv[i]);
+      Simulator::Schedule (Seconds (0), &SimpleDeviceEnergyModel::SetCurrentA, device, 0.5);
+      Simulator::Schedule (Seconds (1200), &SimpleDeviceEnergyModel::SetCurrentA, device, 0.1);
+      Simulator::Schedule (Seconds (1500), &SimpleDeviceEnergyModel::SetCurrentA, device, 0.8);
+    }
+  TraceRecorder rvTrace[2] = { TraceRecorder (0.1), TraceRecorder (0.1) };
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      rv[i]->TraceConnectWithoutContext ("RvBatteryModelBatteryLevel",
+                                         MakeCallback (&TraceRecorder::Update, &rvTrace[i]));
+    }
+
+  Simulator::Stop (Seconds (20000));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (basicTrace.time, Seconds (30), "Basic update too early");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (basicTrace.time, Seconds (30) + TimeStep (2), "Basic update too late");
+  NS_TEST_ASSERT_MSG_EQ_TOL (basicTrace.value, 1, 1e-6, "Wrong basic remaining energy");
+  NS_TEST_ASSERT_MSG_LT (basicTrace.count, 5, "Too many basic updates");
+
+  double liIonThreshold = 0.1 * liIon->GetInitialEnergy ();
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (liIonTrace.value, liIonThreshold, "Li-Ion threshold not crossed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (liIonTrace.value, liIonThreshold, 1e-6, "Li-Ion threshold crossed late");
+  NS_TEST_ASSERT_MSG_LT (liIonTrace.count, 5, "Too many Li-Ion updates");
+
+  // the periodic model notices the crossing at the next sample
+  NS_TEST_ASSERT_MSG_EQ_TOL (rvTrace[1].value, 0.1, 1e-6, "Wrong RV battery level");
+  NS_TEST_ASSERT_MSG_LT (rvTrace[1].count, 10, "Too many RV updates");
+  NS_TEST_ASSERT_MSG_EQ (rv[1]->GetLifetime (), rvTrace[1].crossing, "Wrong RV lifetime");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (rvTrace[1].crossing, rvTrace[0].crossing, "RV battery depleted late");
+  NS_TEST_ASSERT_MSG_GT (rvTrace[1].crossing, rvTrace[0].crossing - Seconds (1), "RV battery depleted early");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Event-driven energy sources test suite.
+ */
+class EventDrivenEnergySourceTestSuite : public TestSuite
+{
+public:
+  EventDrivenEnergySourceTestSuite ();
+};
+
+EventDrivenEnergySourceTestSuite::EventDrivenEnergySourceTestSuite ()
+  : TestSuite ("event-driven-energy-source", UNIT)
+{
+  AddTestCase (new EventDrivenEnergySourceCompareTestCase, TestCase::QUICK);
+  AddTestCase (new EventDrivenEnergySourceThresholdTestCase, TestCase::QUICK);
+}
+
+// create an instance of the test suite
+static EventDrivenEnergySourceTestSuite g_eventDrivenEnergySourceTestSuite;
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simple-device-energy-model.h"
+#include "ns3/rv-battery-model.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
+
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("RvBatteryModelTestSuite");
+
+/**
+ * Check that the incremental computation of the RV battery level gives
+ * the same results as the sum over the whole load profile.
+ */
+class RvBatteryModelIncrementalTestCase : public TestCase
+{
+public:
+  RvBatteryModelIncrementalTestCase ();
+  ~RvBatteryModelIncrementalTestCase ();
+
+  void DoRun (void);
+
+private:
+  /**
+   * Create a battery and its device on a new node.
+   *
+   * \param incremental Value of the RvBatteryModelIncremental attribute.
+   * \param [out] battery The battery.
+   * \param [out] device The device drawing current from the battery.
+   */
+  void CreateBattery (bool incremental, Ptr<RvBatteryModel> &battery,
+                      Ptr<SimpleDeviceEnergyModel> &device);
+  /**
+   * Set the same current on both devices.
+   *
+   * \param current The current, in Amperes.
+   */
+  void SetCurrent (double current);
+  /** Compare the battery levels. */
+  void Check (void);
+
+  Ptr<RvBatteryModel> m_incremental;
+  Ptr<RvBatteryModel> m_reference;
+  Ptr<SimpleDeviceEnergyModel> m_incrementalDevice;
+  Ptr<SimpleDeviceEnergyModel> m_referenceDevice;
+  uint32_t m_checks;
+};
+
+RvBatteryModelIncrementalTestCase::RvBatteryModelIncrementalTestCase ()
+  : TestCase ("Compare the incremental RV battery model with the load profile sum"),
+    m_checks (0)
+{
+}
+
+RvBatteryModelIncrementalTestCase::~RvBatteryModelIncrementalTestCase ()
+{
+}
+
+void
+RvBatteryModelIncrementalTestCase::CreateBattery (bool incremental,
+                                                  Ptr<RvBatteryModel> &battery,
+                                                  Ptr<SimpleDeviceEnergyModel> &device)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  device = CreateObject<SimpleDeviceEnergyModel> ();
+  battery = CreateObject<RvBatteryModel> ();
+  battery->SetAttribute ("RvBatteryModelIncremental", BooleanValue (incremental));
+  battery->SetNode (node);
+  device->SetEnergySource (battery);
+  device->SetNode (node);
+  battery->AppendDeviceEnergyModel (device);
+  node->AggregateObject (battery);
+}
+
+void
+RvBatteryModelIncrementalTestCase::SetCurrent (double current)
+{
+  m_incrementalDevice->SetCurrentA (current);
+  m_referenceDevice->SetCurrentA (current);
+}
+
+void
+RvBatteryModelIncrementalTestCase::Check (void)
+{
+  double reference = m_reference->GetBatteryLevel ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_incremental->GetBatteryLevel (), reference, 1e-9,
+                             "Wrong battery level at " << Simulator::Now ().GetSeconds ());
+  m_checks++;
+}
+
+void
+RvBatteryModelIncrementalTestCase::DoRun (void)
+{
+  CreateBattery (true, m_incremental, m_incrementalDevice);
+  CreateBattery (false, m_reference, m_referenceDevice);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  // two hours with load changes between and at the sampling times
+  for (uint32_t i = 0; i < 300; ++i)
+    {
+      double t = random->GetValue (0, 7200);
+      if (i % 3 == 0)
+        {
+          t = std::floor (t);
+        }
+      double current = random->GetValue () < 0.2 ? 0 : random->GetValue (0, 0.4);
+      Simulator::Schedule (Seconds (t), &RvBatteryModelIncrementalTestCase::SetCurrent,
+                           this, current);
+    }
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      Simulator::Schedule (Seconds (random->GetValue (0, 7200)),
+                           &RvBatteryModelIncrementalTestCase::Check, this);
+    }
+  Simulator::Stop (Seconds (7200));
+  Simulator::Run ();
+
+  // the batteries must have been partly discharged
+  NS_TEST_ASSERT_MSG_LT (m_reference->GetBatteryLevel (), 0.9, "Battery not discharged");
+  NS_TEST_ASSERT_MSG_GT (m_reference->GetBatteryLevel (), 0, "Battery drained");
+  Check ();
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 201, "Some checks did not run");
+
+  Simulator::Destroy ();
+  m_incremental = 0;
+  m_reference = 0;
+  m_incrementalDevice = 0;
+  m_referenceDevice = 0;
+}
+
+/**
+ * RV battery model test suite.
+ */
+class RvBatteryModelTestSuite : public TestSuite
+{
+public:
+  RvBatteryModelTestSuite ();
+};
+
+RvBatteryModelTestSuite::RvBatteryModelTestSuite ()
+  : TestSuite ("rv-battery-model", UNIT)
+{
+  AddTestCase (new RvBatteryModelIncrementalTestCase, TestCase::QUICK);
+}
+
+// create an instance of the test suite
+static RvBatteryModelTestSuite g_rvBatteryModelTestSuite;
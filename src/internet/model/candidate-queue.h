@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
+#include <map>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +48,11 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The queue is a binary heap, indexed by vertex ID for Find () and
+ * Reorder (SPFVertex*): Push, Pop and Reorder take a logarithmic time.
+ * Vertices which compare equal are popped in the order in which they were
+ * pushed, or last reordered.
  */
 class CandidateQueue
 {
@@ -154,6 +160,17 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Reorders the Candidate Queue after the m_distanceFromRoot of
+ * one vertex has decreased.
+ *
+ * The vertex is then ordered as if it had just been pushed.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex, which is in the queue.
+ */
+  void Reorder (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -184,8 +201,40 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  /** A vertex in the heap. */
+  struct Candidate
+  {
+    SPFVertex *vertex;  //!< The vertex.
+    uint32_t sequence;  //!< Push or reorder order, to break ties.
+  };
+
+  /**
+   * \param c1 first operand
+   * \param c2 second operand
+   * \return True if c1 should be popped before c2; false otherwise
+   */
+  static bool CompareCandidate (const Candidate &c1, const Candidate &c2);
+  /**
+   * Move a candidate towards the top of the heap.
+   * \param i The index of the candidate.
+   */
+  void SiftUp (uint32_t i);
+  /**
+   * Move a candidate towards the bottom of the heap.
+   * \param i The index of the candidate.
+   */
+  void SiftDown (uint32_t i);
+  /**
+   * Store a candidate in the heap, and record its position.
+   * \param i The index where the candidate is stored.
+   * \param c The candidate.
+   */
+  void Place (uint32_t i, const Candidate &c);
+
+  typedef std::vector<Candidate> CandidateList_t; //!< container of SPFVertex pointers
+  CandidateList_t m_candidates;  //!< SPFVertex candidates, as a binary heap
+  std::map<Ipv4Address, uint32_t> m_positions; //!< Heap index by vertex ID
+  uint32_t m_sequence;  //!< The sequence number of the next push or reorder
 
   /**
    * \brief Stream insertion operator.
@@ -24,9 +24,12 @@
 
 #include <utility>
 #include <vector>
+#include <set>
 #include <queue>
 #include <algorithm>
+#include <iterator>
 #include <iostream>
+#include <unistd.h>
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -35,6 +38,10 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/system-thread.h"
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -44,6 +51,27 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * The number of threads of the SPF computations.
+ */
+static GlobalValue g_spfThreads = GlobalValue ("GlobalRoutingSpfThreads",
+                                               "The number of threads which compute the global routes, "
+                                               "or zero for one per online processor",
+                                               UintegerValue (1),
+                                               MakeUintegerChecker<uint32_t> ());
+
+/**
+ * \ingroup globalrouting
+ * Whether the global routes are recomputed incrementally.
+ */
+static GlobalValue g_incrementalSpf = GlobalValue ("GlobalRoutingIncrementalSpf",
+                                                   "If true, the global routes are recomputed incrementally: "
+                                                   "after a change of the topology, only the routers whose "
+                                                   "shortest path trees may change are recomputed",
+                                                   BooleanValue (false),
+                                                   MakeBooleanChecker ());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -423,7 +451,8 @@ SPFVertex::ClearVertexProcessed (void)
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB ()
   :
     m_database (),
-    m_extdatabase ()
+    m_extdatabase (),
+    m_linkDataIndexValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -471,6 +500,7 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
   else
     {
       m_database.insert (LSDBPair_t (addr, lsa));
+      m_linkDataIndexValid = false;
     }
 }
 
@@ -495,13 +525,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -511,26 +538,70 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Index the LSAs by the link data of their TransitNetwork link records the
+// first time, keeping the first LSA (in database order) for each address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  if (!m_linkDataIndexValid)
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      m_linkDataIndex.clear ();
+      LSDBMap_t::const_iterator i;
+      for (i= m_database.begin (); i!= m_database.end (); i++)
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
+          GlobalRoutingLSA* temp = i->second;
+// Iterate among temp's Link Records
+          for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
             {
-              return temp;
+              GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+                {
+                  m_linkDataIndex.insert (LSDBPair_t (lr->GetLinkData (), temp));
+                }
             }
         }
+      m_linkDataIndexValid = true;
+    }
+//
+// Look up an LSA by its address.
+//
+  LSDBMap_t::const_iterator i = m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
+    {
+      return i->second;
     }
   return 0;
 }
 
+std::vector<Ipv4Address>
+GlobalRouteManagerLSDB::GetLinkStateIds (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Ipv4Address> ids;
+  LSDBMap_t::const_iterator i;
+  for (i= m_database.begin (); i!= m_database.end (); i++)
+    {
+      ids.push_back (i->first);
+    }
+  return ids;
+}
+
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Copy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  GlobalRouteManagerLSDB* lsdb = new GlobalRouteManagerLSDB ();
+  LSDBMap_t::const_iterator i;
+  for (i= m_database.begin (); i!= m_database.end (); i++)
+    {
+      lsdb->Insert (i->first, new GlobalRoutingLSA (*i->second));
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      GlobalRoutingLSA* temp = m_extdatabase.at (j);
+      lsdb->Insert (temp->GetLinkStateId (), new GlobalRoutingLSA (*temp));
+    }
+  return lsdb;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
@@ -539,7 +610,9 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_spfrootNodeId (0),
+    m_jobs (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -578,20 +651,10 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
         {
           continue;
         }
-      Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-      uint32_t j = 0;
-      uint32_t nRoutes = gr->GetNRoutes ();
-      NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
-      // Each time we delete route 0, the route index shifts downward
-      // We can delete all routes if we delete the route numbered 0
-      // nRoutes times
-      for (j = 0; j < nRoutes; j++)
-        {
-          NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
-          gr->RemoveRoute (0);
-        }
-      NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
+      NS_LOG_LOGIC ("Deleting routes from node " << node->GetId ());
+      DeleteRoutes (router->GetRoutingProtocol ());
     }
+  m_spfDistances.clear ();
   if (m_lsdb)
     {
       NS_LOG_LOGIC ("Deleting LSDB, creating new one");
@@ -600,6 +663,24 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
     }
 }
 
+void
+GlobalRouteManagerImpl::DeleteRoutes (Ptr<Ipv4GlobalRouting> gr)
+{
+  NS_LOG_FUNCTION (this << gr);
+  uint32_t j = 0;
+  uint32_t nRoutes = gr->GetNRoutes ();
+  NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes");
+  // Each time we delete route 0, the route index shifts downward
+  // We can delete all routes if we delete the route numbered 0
+  // nRoutes times
+  for (j = 0; j < nRoutes; j++)
+    {
+      NS_LOG_LOGIC ("Deleting global route " << j);
+      gr->RemoveRoute (0);
+    }
+  NS_LOG_LOGIC ("Deleted " << j << " global routes");
+}
+
 //
 // In order to build the routing database, we need to walk the list of nodes
 // in the system and look for those that support the GlobalRouter interface.
@@ -697,9 +778,86 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 {
   NS_LOG_FUNCTION (this);
 //
-// Walk the list of nodes in the system.
+// Walk the list of nodes in the system, looking for the nodes participating
+// in routing, and run the global routing algorithms for them.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  std::vector<SPFRoot> roots;
+  GetSPFRoots (roots);
+  m_spfDistances.clear ();
+  CalculateRoutes (roots);
+  NS_LOG_INFO ("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::UpdateGlobalRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  BooleanValue incremental;
+  g_incrementalSpf.GetValue (incremental);
+  if (!incremental.Get () || m_spfDistances.empty ())
+    {
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
+//
+// Gather the new Link State Advertisements, and compare them with the ones
+// used by the previous computation.
+//
+  GlobalRouteManagerLSDB *oldLsdb = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  std::vector<SPFRoot> roots;
+  GetSPFRoots (roots);
+  std::vector<bool> affected;
+  GetAffectedRoots (oldLsdb, roots, affected);
+  delete oldLsdb;
+//
+// The routers which are not affected keep their routes, and the distances of
+// their shortest path trees, which have not changed.
+//
+  std::map<Ipv4Address, SPFDistances_t> distances;
+  std::vector<SPFRoot> recompute;
+  std::set<uint32_t> rootNodes;
+  for (uint32_t i = 0; i < roots.size (); ++i)
+    {
+      rootNodes.insert (roots[i].nodeId);
+      if (affected[i])
+        {
+          NS_LOG_LOGIC ("Recomputing the routes of node " << roots[i].nodeId);
+          DeleteRoutes (roots[i].routing);
+          recompute.push_back (roots[i]);
+        }
+      else
+        {
+          distances[roots[i].routerId].swap (m_spfDistances[roots[i].routerId]);
+        }
+    }
+  m_spfDistances.swap (distances);
+//
+// As in DeleteGlobalRoutes (), the other routers lose their routes.
+//
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
+      if (router != 0 && rootNodes.find (node->GetId ()) == rootNodes.end ())
+        {
+          DeleteRoutes (router->GetRoutingProtocol ());
+        }
+    }
+  NS_LOG_INFO ("Recomputing " << recompute.size () << " of " << roots.size () << " routers");
+  CalculateRoutes (recompute);
+}
+
+void
+GlobalRouteManagerImpl::GetSPFRoots (std::vector<SPFRoot> &roots) const
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t systemId = MpiInterface::GetSystemId ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -711,7 +869,6 @@ GlobalRouteManagerImpl::InitializeRoutes ()
       Ptr<GlobalRouter> rtr = 
         node->GetObject<GlobalRouter> ();
 
-      uint32_t systemId = MpiInterface::GetSystemId ();
       // Ignore nodes that are not assigned to our systemId (distributed sim)
       if (node->GetSystemId () != systemId) 
         {
@@ -724,10 +881,330 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          SPFRoot root;
+          root.routerId = rtr->GetRouterId ();
+          root.nodeId = node->GetId ();
+          root.ipv4 = node->GetObject<Ipv4> ();
+          NS_ASSERT_MSG (root.ipv4, 
+                         "GlobalRouteManagerImpl::GetSPFRoots (): "
+                         "GetObject for <Ipv4> interface failed");
+          root.routing = rtr->GetRoutingProtocol ();
+          NS_ASSERT (root.routing);
+          roots.push_back (root);
+        }
+    }
+}
+
+bool
+GlobalRouteManagerImpl::GetSPFRoot (Ipv4Address routerId, SPFRoot &root) const
+{
+  NS_LOG_FUNCTION (this << routerId);
+  root.routerId = routerId;
+  root.nodeId = 0;
+  root.ipv4 = 0;
+  root.routing = 0;
+//
+// We need to walk the list of nodes looking for the one that has the router
+// ID corresponding to the root vertex.  This is the one we're going to write
+// the routing information to.
+//
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+//
+// The router ID is accessible through the GlobalRouter interface, so we need
+// to GetObject for that interface.  If there's no GlobalRouter interface, 
+// the node in question cannot be the router we want, so we continue.
+// 
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr == 0)
+        {
+          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
+          continue;
+        }
+      if (rtr->GetRouterId () == routerId)
+        {
+          root.nodeId = node->GetId ();
+          root.ipv4 = node->GetObject<Ipv4> ();
+          NS_ASSERT_MSG (root.ipv4, 
+                         "GlobalRouteManagerImpl::GetSPFRoot (): "
+                         "GetObject for <Ipv4> interface failed");
+          root.routing = rtr->GetRoutingProtocol ();
+          NS_ASSERT (root.routing);
+          return true;
+        }
+    }
+  NS_LOG_LOGIC ("Can't find root node " << routerId);
+  return false;
+}
+
+//
+// The SPF computations of the routers only share the Link State Database,
+// where they record the status of the LSAs.  Each worker thread then uses its
+// own copy of the database, and only touches the node of the root it is
+// computing: the nodes are found beforehand, since walking the node list
+// would update the reference counts of all of the nodes.
+//
+void
+GlobalRouteManagerImpl::CalculateRoutes (const std::vector<SPFRoot> &roots)
+{
+  NS_LOG_FUNCTION (this);
+  BooleanValue incremental;
+  g_incrementalSpf.GetValue (incremental);
+  UintegerValue threadsValue;
+  g_spfThreads.GetValue (threadsValue);
+  uint32_t nThreads = threadsValue.Get ();
+  if (nThreads == 0)
+    {
+      nThreads = std::max (sysconf (_SC_NPROCESSORS_ONLN), 1L);
+    }
+  nThreads = std::min (nThreads, (uint32_t) roots.size ());
+
+  SPFJobs jobs;
+  jobs.roots = roots;
+  jobs.distances.resize (roots.size ());
+  jobs.keepDistances = incremental.Get ();
+  jobs.next = 0;
+
+#ifdef HAVE_PTHREAD_H
+  if (nThreads > 1)
+    {
+      NS_LOG_LOGIC ("Running SPF calculations on " << nThreads << " threads");
+      std::vector<GlobalRouteManagerImpl*> workers;
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t i = 0; i < nThreads; ++i)
+        {
+          GlobalRouteManagerImpl *worker = new GlobalRouteManagerImpl ();
+          delete worker->m_lsdb;
+          worker->m_lsdb = m_lsdb->Copy ();
+          worker->m_jobs = &jobs;
+          workers.push_back (worker);
+          threads.push_back (Create<SystemThread> (MakeCallback (&GlobalRouteManagerImpl::RunSPFJobs, worker)));
+        }
+      for (uint32_t i = 0; i < nThreads; ++i)
+        {
+          threads[i]->Start ();
+        }
+      for (uint32_t i = 0; i < nThreads; ++i)
+        {
+          threads[i]->Join ();
+          delete workers[i];
+        }
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      m_jobs = &jobs;
+      RunSPFJobs ();
+      m_jobs = 0;
+    }
+
+  if (jobs.keepDistances)
+    {
+      for (uint32_t i = 0; i < roots.size (); ++i)
+        {
+          m_spfDistances[roots[i].routerId].swap (jobs.distances[i]);
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::RunSPFJobs (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (;;)
+    {
+      uint32_t i;
+      {
+        CriticalSection cs (m_jobs->mutex);
+        i = m_jobs->next++;
+      }
+      if (i >= m_jobs->roots.size ())
+        {
+          break;
+        }
+      SPFCalculate (m_jobs->roots[i], m_jobs->keepDistances ? &m_jobs->distances[i] : 0);
+    }
+}
+
+void
+GlobalRouteManagerImpl::GetSPFDistances (SPFDistances_t &distances) const
+{
+  NS_LOG_FUNCTION (this);
+  distances.clear ();
+  // with ECMP, the tree is a DAG: visit each vertex once
+  std::set<const SPFVertex*> visited;
+  std::vector<const SPFVertex*> stack;
+  stack.push_back (m_spfroot);
+  visited.insert (m_spfroot);
+  while (!stack.empty ())
+    {
+      const SPFVertex *v = stack.back ();
+      stack.pop_back ();
+      distances.push_back (std::make_pair (v->GetVertexId (), v->GetDistanceFromRoot ()));
+      for (uint32_t i = 0; i < v->GetNChildren (); i++)
+        {
+          const SPFVertex *child = v->GetChild (i);
+          if (visited.insert (child).second)
+            {
+              stack.push_back (child);
+            }
+        }
+    }
+  std::sort (distances.begin (), distances.end ());
+}
+
+uint32_t
+GlobalRouteManagerImpl::GetDistance (const SPFDistances_t &distances, Ipv4Address id)
+{
+  SPFDistances_t::const_iterator i =
+    std::lower_bound (distances.begin (), distances.end (), std::make_pair (id, (uint32_t) 0));
+  if (i != distances.end () && i->first == id)
+    {
+      return i->second;
+    }
+  return SPF_INFINITY;
+}
+
+/**
+ * \brief Compare two versions of a Link State Advertisement.
+ *
+ * The metrics of the links to stub networks are ignored, since they are
+ * not used by the SPF calculation.
+ *
+ * \param a the first version
+ * \param b the second version
+ * \param compareMetrics whether to compare the metrics of the other links
+ * \return true if the versions are the same
+ */
+static bool
+IsSameLSA (GlobalRoutingLSA *a, GlobalRoutingLSA *b, bool compareMetrics)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetLinkStateId () != b->GetLinkStateId ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ()
+      || a->GetNLinkRecords () != b->GetNLinkRecords ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a->GetNAttachedRouters (); i++)
+    {
+      if (a->GetAttachedRouter (i) != b->GetAttachedRouter (i))
+        {
+          return false;
+        }
+    }
+  for (uint32_t i = 0; i < a->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *la = a->GetLinkRecord (i);
+      GlobalRoutingLinkRecord *lb = b->GetLinkRecord (i);
+      if (la->GetLinkType () != lb->GetLinkType ()
+          || la->GetLinkId () != lb->GetLinkId ()
+          || la->GetLinkData () != lb->GetLinkData ())
+        {
+          return false;
+        }
+      if (compareMetrics
+          && la->GetLinkType () != GlobalRoutingLinkRecord::StubNetwork
+          && la->GetMetric () != lb->GetMetric ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+//
+// A router must be recomputed if a changed LSA may change its routes:
+//
+// - the LSAs of the vertices of its shortest path tree are used to compute
+//   its routes, and all of their records (except the metrics) end up in
+//   them, as host routes, stub routes or next hops.  Any other change of
+//   such an LSA, or its removal, affects the router.  An LSA which is not in
+//   the tree can only enter it through a changed LSA which is;
+//
+// - a changed metric of a link from vertex <x> to vertex <y> only affects
+//   the router if the link is, or becomes, part of a shortest path (or an
+//   equal cost one) to <y>, that is if D(x) + metric <= D(y) for the
+//   smallest of the two metrics.  Otherwise, the distances and the parents
+//   of all of the vertices are unchanged, and so are the routes;
+//
+// - any change of the AS-external LSAs affects all of the routers.
+//
+void
+GlobalRouteManagerImpl::GetAffectedRoots (const GlobalRouteManagerLSDB *oldLsdb,
+                                          const std::vector<SPFRoot> &roots,
+                                          std::vector<bool> &affected) const
+{
+  NS_LOG_FUNCTION (this << oldLsdb);
+  affected.assign (roots.size (), false);
+
+  bool all = oldLsdb->GetNumExtLSAs () != m_lsdb->GetNumExtLSAs ();
+  for (uint32_t i = 0; !all && i < m_lsdb->GetNumExtLSAs (); i++)
+    {
+      all = !IsSameLSA (oldLsdb->GetExtLSA (i), m_lsdb->GetExtLSA (i), true);
+    }
+  if (all)
+    {
+      NS_LOG_LOGIC ("AS-external LSAs changed");
+      affected.assign (roots.size (), true);
+      return;
+    }
+
+  // the changed LSAs, and the changed metrics, as (from, to) and metric
+  std::vector<Ipv4Address> changed;
+  std::vector<std::pair<std::pair<Ipv4Address, Ipv4Address>, uint32_t> > metrics;
+  std::vector<Ipv4Address> oldIds = oldLsdb->GetLinkStateIds ();
+  std::vector<Ipv4Address> newIds = m_lsdb->GetLinkStateIds ();
+  std::vector<Ipv4Address> ids;
+  std::set_union (oldIds.begin (), oldIds.end (), newIds.begin (), newIds.end (),
+                  std::back_inserter (ids));
+  for (std::vector<Ipv4Address>::const_iterator i = ids.begin (); i != ids.end (); i++)
+    {
+      GlobalRoutingLSA *a = oldLsdb->GetLSA (*i);
+      GlobalRoutingLSA *b = m_lsdb->GetLSA (*i);
+      if (a == 0 || b == 0 || !IsSameLSA (a, b, false))
+        {
+          NS_LOG_LOGIC ("LSA " << *i << " changed");
+          changed.push_back (*i);
+          continue;
+        }
+      for (uint32_t j = 0; j < a->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *la = a->GetLinkRecord (j);
+          GlobalRoutingLinkRecord *lb = b->GetLinkRecord (j);
+          if (la->GetLinkType () != GlobalRoutingLinkRecord::StubNetwork
+              && la->GetMetric () != lb->GetMetric ())
+            {
+              NS_LOG_LOGIC ("Metric of link " << *i << " to " << la->GetLinkId () << " changed");
+              metrics.push_back (std::make_pair (std::make_pair (*i, la->GetLinkId ()),
+                                                 std::min (la->GetMetric (), lb->GetMetric ())));
+            }
+        }
+    }
+
+  for (uint32_t i = 0; i < roots.size (); ++i)
+    {
+      std::map<Ipv4Address, SPFDistances_t>::const_iterator d = m_spfDistances.find (roots[i].routerId);
+      if (d == m_spfDistances.end ())
+        {
+          affected[i] = true;
+          continue;
+        }
+      for (uint32_t j = 0; !affected[i] && j < changed.size (); ++j)
+        {
+          affected[i] = GetDistance (d->second, changed[j]) != SPF_INFINITY;
+        }
+      for (uint32_t j = 0; !affected[i] && j < metrics.size (); ++j)
+        {
+          uint64_t from = GetDistance (d->second, metrics[j].first.first);
+          uint64_t to = GetDistance (d->second, metrics[j].first.second);
+          affected[i] = from != SPF_INFINITY && from + metrics[j].second <= to;
         }
     }
-  NS_LOG_INFO ("Finished SPF calculation");
 }
 
 //
@@ -960,7 +1437,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.Reorder (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1320,9 +1797,7 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
+                  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
                   NS_ASSERT (gr);
                   gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
                                          FindOutgoingInterfaceId (transitLink->GetLinkData ()));
@@ -1342,9 +1817,26 @@ void
 GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
+  SPFRoot spfRoot;
+  GetSPFRoot (root, spfRoot);
+  SPFCalculate (spfRoot, 0);
+}
+
+void
+GlobalRouteManagerImpl::SPFCalculate (const SPFRoot &spfRoot, SPFDistances_t *distances)
+{
+  Ipv4Address root = spfRoot.routerId;
+  NS_LOG_FUNCTION (this << root << distances);
 
   SPFVertex *v;
 //
+// Remember the node at the root of the calculations, to which we are going
+// to write the routing information.
+//
+  m_spfrootIpv4 = spfRoot.ipv4;
+  m_spfrootRouting = spfRoot.routing;
+  m_spfrootNodeId = spfRoot.nodeId;
+//
 // Initialize the Link State Database.
 //
   m_lsdb->Initialize ();
@@ -1377,10 +1869,32 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+  if (m_spfrootRouting && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
+      if (distances)
+        {
+//
+// The default route only depends on the LSAs of the root and of its
+// neighbor.
+//
+          distances->clear ();
+          distances->push_back (std::make_pair (root, (uint32_t) 0));
+          GlobalRoutingLSA *rlsa = m_spfroot->GetLSA ();
+          for (uint32_t i = 0; i < rlsa->GetNLinkRecords (); i++)
+            {
+              GlobalRoutingLinkRecord *l = rlsa->GetLinkRecord (i);
+              if (l->GetLinkType () != GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  distances->push_back (std::make_pair (l->GetLinkId (), l->GetMetric ()));
+                }
+            }
+          std::sort (distances->begin (), distances->end ());
+        }
       delete m_spfroot;
+      m_spfroot = 0;
+      m_spfrootIpv4 = 0;
+      m_spfrootRouting = 0;
       return;
     }
 
@@ -1497,11 +2011,18 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 
 //
 // We're all done setting the routing information for the node at the root of
-// the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-// possibly do it again for the next router.
+// the SPF tree.  Keep the distances for incremental SPF if needed, and delete
+// all of the vertices and corresponding resources.  Go possibly do it again
+// for the next router.
 //
+  if (distances)
+    {
+      GetSPFDistances (*distances);
+    }
   delete m_spfroot;
   m_spfroot = 0;
+  m_spfrootIpv4 = 0;
+  m_spfrootRouting = 0;
 }
 
 void
@@ -1555,110 +2076,61 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
     }
   NS_LOG_LOGIC ("External is on remote host: " 
                 << extlsa->GetAdvertisingRouter () << "; installing");
-
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The routing protocol of the node at the root of the SPF tree was looked up
+// by SPFCalculate.  This is the one we're going to write the routing
+// information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  if (gr == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("No node for router " << m_spfroot->GetVertexId ());
+      return;
+    }
+  NS_LOG_LOGIC ("Setting routes for node " << m_spfrootNodeId);
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+//
+// Here's why we did all of that work.  The vertex <v> (corresponding to the
+// router advertising the external network) has an m_nextHop address
+// precalculated for us that is the address to which the root node should
+// send packets to be forwarded to this network.  Similarly, the vertex <v>
+// has an m_rootOif (outbound interface index) to which the packets should
+// be send for forwarding.
+//
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                        " add external network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 
@@ -1719,117 +2191,61 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
     }
   NS_LOG_LOGIC ("Stub is on remote host: " << v->GetVertexId () << "; installing");
 //
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
+// The routing protocol of the node at the root of the SPF tree was looked up
+// by SPFCalculate.  This is the one we're going to write the routing
+// information to.
 //
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  if (gr == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("No node for router " << m_spfroot->GetVertexId ());
+      return;
+    }
+  NS_LOG_LOGIC ("Setting routes for node " << m_spfrootNodeId);
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
+//
+// Here's why we did all of that work.  We're going to add a network route to
+// the stub network found in the link record.  The vertex <v> (corresponding
+// to the node that has this stub network) has an m_nextHop address
+// precalculated for us that is the address to which the root node should
+// send packets to be forwarded to this network.  Similarly, the vertex <v>
+// has an m_rootOif (outbound interface index) to which the packets should
+// be send for forwarding.
+//
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
@@ -1844,70 +2260,17 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 {
   NS_LOG_FUNCTION (this << a << amask);
 //
-// We have an IP address <a> and a vertex ID of the root of the SPF tree.
-// The question is what interface index does this address correspond to.
-// The answer is a little complicated since we have to find a pointer to
-// the node corresponding to the vertex ID, find the Ipv4 interface on that
-// node in order to iterate the interfaces and find the one corresponding to
-// the address in question.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
+// We have an IP address <a> and the Ipv4 interface of the node at the root
+// of the SPF tree, which SPFCalculate looked up.  Look through the interfaces
+// on this node for one that has the IP address we're looking for.  If we find
+// one, return the corresponding interface index, or -1 if not found.
 //
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfrootIpv4 == 0)
     {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
-        {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
-        {
-//
-// This is the node we're building the routing table for.  We're going to need
-// the Ipv4 interface to look for the ipv4 interface index.  Since this node
-// is participating in routing IP version 4 packets, it certainly must have 
-// an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Look through the interfaces on this node for one that has the IP address
-// we're looking for.  If we find one, return the corresponding interface
-// index, or -1 if not found.
-//
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif 
-          return interface;
-        }
+      NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << m_spfroot->GetVertexId ());
+      return -1;
     }
-//
-// Couldn't find it.
-//
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
-  return -1;
+  return m_spfrootIpv4->GetInterfaceForPrefix (a, amask);
 }
 
 //
@@ -1935,69 +2298,28 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
 //
 // The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
+// going to write the actual routing table entries.  SPFCalculate looked up
+// the routing protocol of the corresponding node.
 //
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  if (gr == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("No node for router " << m_spfroot->GetVertexId ());
+      return;
+    }
+  NS_LOG_LOGIC ("Setting routes for node " << m_spfrootNodeId);
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -2006,18 +2328,18 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Node " << m_spfrootNodeId <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
+        }
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -2031,44 +2353,31 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+      // walk through all available exit directions due to ECMP,
+      // and add host route for each of the exit direction toward
+      // the vertex 'v'
+      for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+        {
+          SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+          Ipv4Address nextHop = exit.first;
+          int32_t outIf = exit.second;
+          if (outIf >= 0)
+            {
+              gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
+                                  outIf);
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                            " adding host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " and outgoing interface " << outIf);
             }
-//
-// Done adding the routes for the selected node.
-//
-          return;
-        }
+          else
+            {
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                            " NOT able to add host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 void
@@ -2080,104 +2389,54 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
 //
 // The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// going to write the actual routing table entries.  SPFCalculate looked up
+// the routing protocol of the corresponding node.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  if (gr == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("No node for router " << m_spfroot->GetVertexId ());
+      return;
+    }
+  NS_LOG_LOGIC ("setting routes for node " << m_spfrootNodeId);
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all available exit directions due to ECMP,
+  // and add host route for each of the exit direction toward
+  // the vertex 'v'
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
 
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
+      if (outIf >= 0)
+        {
+          gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-    } 
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_spfrootNodeId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
+        }
+    }
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
@@ -30,6 +30,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/system-mutex.h"
 #include "global-router-interface.h"
 
 namespace ns3 {
@@ -38,6 +39,7 @@ const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
 class Ipv4GlobalRouting;
+class Ipv4;
 
 /**
  * \ingroup globalrouting
@@ -641,6 +643,25 @@ public:
  */
   GlobalRoutingLSA* GetLSAByLinkData (Ipv4Address addr) const;
 
+/**
+ * @brief Get the link state IDs of all the Link State Advertisements,
+ * except the External ones.
+ *
+ * @returns The link state IDs, in increasing order.
+ */
+  std::vector<Ipv4Address> GetLinkStateIds (void) const;
+
+/**
+ * @brief Make a copy of the Link State Database, with copies of all of its
+ * Link State Advertisements.
+ *
+ * The SPF status flags of the copies can then be used by a SPF computation
+ * running on another thread.
+ *
+ * @returns The new Link State Database, to be deleted by the caller.
+ */
+  GlobalRouteManagerLSDB* Copy (void) const;
+
 /**
  * @brief Set all LSA flags to an initialized state, for SPF computation
  *
@@ -681,6 +702,8 @@ private:
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  mutable LSDBMap_t m_linkDataIndex; //!< Router LSAs by TransitNetwork link data, built by GetLSAByLinkData
+  mutable bool m_linkDataIndexValid; //!< Whether m_linkDataIndex is up to date
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -732,9 +755,23 @@ public:
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
+ *
+ * The SPF computations of the routers are spread over the number of
+ * threads given by the GlobalRoutingSpfThreads global value.
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Recompute the routes after a change of the topology.
+ *
+ * This is equivalent to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase ()
+ * and InitializeRoutes ().  If the GlobalRoutingIncrementalSpf global value
+ * is true, the Link State Advertisements which changed since the previous
+ * computation are compared with the shortest path trees of that computation,
+ * and only the routers whose routes may change are recomputed.
+ */
+  virtual void UpdateGlobalRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  */
@@ -766,8 +803,100 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+  /**
+   * \brief A router whose routes are computed.
+   */
+  struct SPFRoot
+  {
+    Ipv4Address routerId;           //!< The router ID.
+    uint32_t nodeId;                //!< The node ID.
+    Ptr<Ipv4> ipv4;                 //!< The Ipv4 of the node.
+    Ptr<Ipv4GlobalRouting> routing; //!< The routing protocol to populate.
+  };
+
+  /**
+   * \brief The distances from a root to the vertices of its shortest path
+   * tree, by vertex ID, sorted by vertex ID.
+   */
+  typedef std::vector<std::pair<Ipv4Address, uint32_t> > SPFDistances_t;
+
+  /**
+   * \brief SPF computations shared by several threads.
+   */
+  struct SPFJobs
+  {
+    std::vector<SPFRoot> roots;              //!< The routers to compute.
+    std::vector<SPFDistances_t> distances;   //!< The distances found, by root, if kept.
+    bool keepDistances;                      //!< Whether to fill distances.
+    uint32_t next;                           //!< The next root to compute.
+    SystemMutex mutex;                       //!< Protects next.
+  };
+
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  Ptr<Ipv4> m_spfrootIpv4; //!< the Ipv4 of the node of the root, if any
+  Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< the routing protocol of the node of the root, if any
+  uint32_t m_spfrootNodeId; //!< the node ID of the root
+  SPFJobs *m_jobs; //!< the computations of a worker thread
+  std::map<Ipv4Address, SPFDistances_t> m_spfDistances; //!< the distances of the last computation, by root, for incremental SPF
+
+  /**
+   * \brief Find the routers whose routes are computed by this system.
+   * \param roots the routers
+   */
+  void GetSPFRoots (std::vector<SPFRoot> &roots) const;
+
+  /**
+   * \brief Find a router.
+   * \param routerId the router ID
+   * \param root the router
+   * \return true if a node has this router ID
+   */
+  bool GetSPFRoot (Ipv4Address routerId, SPFRoot &root) const;
+
+  /**
+   * \brief Run the SPF computations of several routers, on as many threads
+   * as allowed by the GlobalRoutingSpfThreads global value, and record
+   * their distances if incremental SPF is enabled.
+   * \param roots the routers
+   */
+  void CalculateRoutes (const std::vector<SPFRoot> &roots);
+
+  /**
+   * \brief Run SPF computations of m_jobs until there are none left.
+   */
+  void RunSPFJobs (void);
+
+  /**
+   * \brief Remove all the routes of a routing protocol.
+   * \param gr the routing protocol
+   */
+  void DeleteRoutes (Ptr<Ipv4GlobalRouting> gr);
+
+  /**
+   * \brief Record the distances of the vertices of the shortest path tree.
+   * \param distances the distances
+   */
+  void GetSPFDistances (SPFDistances_t &distances) const;
+
+  /**
+   * \brief Look up a distance.
+   * \param distances the distances
+   * \param id the vertex ID
+   * \return the distance, or SPF_INFINITY if the vertex is not in the tree
+   */
+  static uint32_t GetDistance (const SPFDistances_t &distances, Ipv4Address id);
+
+  /**
+   * \brief Find the routers whose routes may be changed by the new Link
+   * State Database.
+   * \param oldLsdb the Link State Database of the previous computation
+   * \param roots the routers which compute their routes
+   * \param affected set to whether each router must be recomputed
+   */
+  void GetAffectedRoots (const GlobalRouteManagerLSDB *oldLsdb,
+                         const std::vector<SPFRoot> &roots,
+                         std::vector<bool> &affected) const;
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -789,6 +918,14 @@ private:
    */
   void SPFCalculate (Ipv4Address root);
 
+  /**
+   * \brief Calculate the shortest path first (SPF) tree
+   *
+   * \param root the root node
+   * \param distances if not null, set to the distances of the tree
+   */
+  void SPFCalculate (const SPFRoot &root, SPFDistances_t *distances);
+
   /**
    * \brief Process Stub nodes
    *
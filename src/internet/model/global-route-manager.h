@@ -64,6 +64,17 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and update the per-node forwarding
+ * tables after a change in the topology.
+ *
+ * This is equivalent to DeleteGlobalRoutes, BuildGlobalRoutingDatabase
+ * and InitializeRoutes.  If the "GlobalRoutingIncrementalSpf" global value
+ * is true, only the routers whose shortest paths may have changed are
+ * recomputed.
+ */
+  static void UpdateGlobalRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
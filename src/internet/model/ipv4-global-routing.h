@@ -28,6 +28,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ipv4-prefix-trie.h"
 
 namespace ns3 {
 
@@ -268,10 +269,23 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Rebuild the tries of the routes, after the routes changed.
+   */
+  void UpdateRouteIndex (void);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  /// All the routes, by position in the routing table (see GetRoute)
+  std::vector<Ipv4RoutingTableEntry *> m_routeIndex;
+  Ipv4PrefixTrie m_hostTrie;           //!< Positions of the routes to hosts
+  Ipv4PrefixTrie m_networkTrie;        //!< Positions of the routes to networks
+  Ipv4PrefixTrie m_ASexternalTrie;     //!< Positions of the external routes
+  bool m_routesChanged;                //!< Must the tries be rebuilt
+  std::vector<uint32_t> m_matches;     //!< Lookup results, kept to avoid allocations
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
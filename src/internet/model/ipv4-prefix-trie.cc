@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-prefix-trie.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4PrefixTrie");
+
+/**
+ * \param length A prefix length, up to 32.
+ * \returns The mask of the prefix bits.
+ */
+static inline uint32_t
+PrefixMask (uint32_t length)
+{
+  return length == 0 ? 0 : 0xffffffff << (32 - length);
+}
+
+/**
+ * \param address An address.
+ * \param bit A bit index, from the most significant bit, below 32.
+ * \returns The bit of \p address.
+ */
+static inline uint32_t
+GetBit (uint32_t address, uint32_t bit)
+{
+  return (address >> (31 - bit)) & 1;
+}
+
+Ipv4PrefixTrie::Ipv4PrefixTrie ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+Ipv4PrefixTrie::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nodes.clear ();
+  m_values.clear ();
+  m_others.clear ();
+  NewNode (0, 0);
+}
+
+int32_t
+Ipv4PrefixTrie::NewNode (uint32_t prefix, uint32_t length)
+{
+  Node node;
+  node.prefix = prefix;
+  node.length = length;
+  node.child[0] = -1;
+  node.child[1] = -1;
+  node.firstValue = -1;
+  m_nodes.push_back (node);
+  return m_nodes.size () - 1;
+}
+
+int32_t
+Ipv4PrefixTrie::FindOrInsert (uint32_t prefix, uint32_t length)
+{
+  int32_t current = 0;
+  while (m_nodes[current].length < length)
+    {
+      uint32_t bit = GetBit (prefix, m_nodes[current].length);
+      int32_t next = m_nodes[current].child[bit];
+      if (next < 0)
+        {
+          int32_t leaf = NewNode (prefix, length);
+          m_nodes[current].child[bit] = leaf;
+          return leaf;
+        }
+      // length of the prefix common to the new prefix and the child
+      uint32_t maxCommon = std::min (length, m_nodes[next].length);
+      uint32_t common = m_nodes[current].length + 1;
+      while (common < maxCommon
+             && GetBit (prefix, common) == GetBit (m_nodes[next].prefix, common))
+        {
+          common++;
+        }
+      if (common == m_nodes[next].length)
+        {
+          current = next;
+          continue;
+        }
+      // split the edge to the child
+      int32_t split = NewNode (prefix & PrefixMask (common), common);
+      m_nodes[split].child[GetBit (m_nodes[next].prefix, common)] = next;
+      m_nodes[current].child[bit] = split;
+      if (common == length)
+        {
+          return split;
+        }
+      int32_t leaf = NewNode (prefix, length);
+      m_nodes[split].child[GetBit (prefix, common)] = leaf;
+      return leaf;
+    }
+  NS_ASSERT (m_nodes[current].length == length && m_nodes[current].prefix == prefix);
+  return current;
+}
+
+void
+Ipv4PrefixTrie::Add (Ipv4Address network, Ipv4Mask mask, uint32_t value)
+{
+  NS_LOG_FUNCTION (this << network << mask << value);
+  uint32_t length = mask.GetPrefixLength ();
+  if (mask.Get () != PrefixMask (length))
+    {
+      Other other;
+      other.network = network;
+      other.mask = mask;
+      other.value = value;
+      m_others.push_back (other);
+      return;
+    }
+  int32_t node = FindOrInsert (network.Get () & mask.Get (), length);
+  Value v;
+  v.value = value;
+  v.next = m_nodes[node].firstValue;
+  m_values.push_back (v);
+  m_nodes[node].firstValue = m_values.size () - 1;
+}
+
+uint32_t
+Ipv4PrefixTrie::GetN (void) const
+{
+  return m_values.size () + m_others.size ();
+}
+
+void
+Ipv4PrefixTrie::Lookup (Ipv4Address dest, std::vector<uint32_t> &values) const
+{
+  NS_LOG_FUNCTION (this << dest);
+  values.clear ();
+  uint32_t address = dest.Get ();
+  int32_t current = 0;
+  while (current >= 0)
+    {
+      const Node &node = m_nodes[current];
+      if ((address & PrefixMask (node.length)) != node.prefix)
+        {
+          break;
+        }
+      for (int32_t v = node.firstValue; v >= 0; v = m_values[v].next)
+        {
+          values.push_back (m_values[v].value);
+        }
+      if (node.length == 32)
+        {
+          break;
+        }
+      current = node.child[GetBit (address, node.length)];
+    }
+  for (std::vector<Other>::const_iterator i = m_others.begin (); i != m_others.end (); ++i)
+    {
+      if (i->mask.IsMatch (dest, i->network))
+        {
+          values.push_back (i->value);
+        }
+    }
+  std::sort (values.begin (), values.end ());
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_PREFIX_TRIE_H
+#define IPV4_PREFIX_TRIE_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A path-compressed binary trie of IPv4 prefixes, to find all the
+ * prefixes which match an address.
+ *
+ * Each prefix is added with a value, typically the position of a route
+ * in a routing table. A lookup visits at most 33 nodes, whatever the
+ * number of prefixes, and returns the values of all the matching
+ * prefixes, in increasing order: the routing protocols use it to find
+ * the candidate routes of a destination, and then apply their own
+ * selection rules to these candidates in the routing table order.
+ *
+ * The trie has at most two nodes per distinct prefix. Masks which are
+ * not contiguous, which Ipv4Mask allows, are kept in a separate list
+ * which is checked at every lookup.
+ */
+class Ipv4PrefixTrie
+{
+public:
+  Ipv4PrefixTrie ();
+
+  /**
+   * Remove all the prefixes.
+   */
+  void Clear (void);
+  /**
+   * Add a prefix.
+   *
+   * \param network The prefix address. The bits outside of \p mask are ignored.
+   * \param mask The prefix mask.
+   * \param value The value returned by the lookups which match this prefix.
+   */
+  void Add (Ipv4Address network, Ipv4Mask mask, uint32_t value);
+  /**
+   * \returns The number of prefixes.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Find the prefixes which match an address.
+   *
+   * \param [in] dest The address.
+   * \param [out] values The values of the prefixes which match \p dest,
+   *        in increasing order. The vector is cleared first.
+   */
+  void Lookup (Ipv4Address dest, std::vector<uint32_t> &values) const;
+
+private:
+  /** A trie node: a prefix, and the values added with this prefix. */
+  struct Node
+  {
+    uint32_t prefix;    //!< The prefix bits, zero after \c length.
+    uint32_t length;    //!< The prefix length.
+    int32_t child[2];   //!< The children by the bit following the prefix, or -1.
+    int32_t firstValue; //!< Index of the first value in m_values, or -1.
+  };
+  /** A value, in a list per node. */
+  struct Value
+  {
+    uint32_t value;     //!< The value.
+    int32_t next;       //!< Index of the next value of the node, or -1.
+  };
+  /** A prefix with a non-contiguous mask. */
+  struct Other
+  {
+    Ipv4Address network; //!< The prefix address.
+    Ipv4Mask mask;       //!< The prefix mask.
+    uint32_t value;      //!< The value.
+  };
+
+  /**
+   * \param prefix The prefix bits.
+   * \param length The prefix length.
+   * \returns The index of the new node.
+   */
+  int32_t NewNode (uint32_t prefix, uint32_t length);
+  /**
+   * \param prefix The prefix bits.
+   * \param length The prefix length.
+   * \returns The index of the node of this prefix, created if needed.
+   */
+  int32_t FindOrInsert (uint32_t prefix, uint32_t length);
+
+  std::vector<Node> m_nodes;    //!< The nodes; the root is the empty prefix.
+  std::vector<Value> m_values;  //!< The values of all the nodes.
+  std::vector<Other> m_others;  //!< The prefixes with a non-contiguous mask.
+};
+
+} // namespace ns3
+
+#endif /* IPV4_PREFIX_TRIE_H */
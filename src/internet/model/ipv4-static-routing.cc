@@ -54,7 +54,8 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_routesChanged (false),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -73,6 +74,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_routesChanged = true;
 }
 
 void 
@@ -87,6 +89,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_routesChanged = true;
 }
 
 void 
@@ -144,6 +147,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
                                                         networkMask,
                                                         outputInterface);
   m_networkRoutes.push_back (make_pair (route,0));
+  m_routesChanged = true;
 }
 
 uint32_t 
@@ -239,13 +243,20 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
       return rtentry;
     }
 
+  if (m_routesChanged)
+    {
+      UpdateRouteIndex ();
+    }
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
+  // the trie returns the matching routes in the routing table order
+  m_routeTrie.Lookup (dest, m_matches);
+
+  for (std::vector<uint32_t>::const_iterator i = m_matches.begin (); 
+       i != m_matches.end (); 
        i++) 
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
+      Ipv4RoutingTableEntry *j = m_routeIndex[*i].first;
+      uint32_t metric = m_routeIndex[*i].second;
       Ipv4Mask mask = (j)->GetDestNetworkMask ();
       uint16_t masklen = mask.GetPrefixLength ();
       Ipv4Address entry = (j)->GetDestNetwork ();
@@ -301,6 +312,22 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
   return rtentry;
 }
 
+void
+Ipv4StaticRouting::UpdateRouteIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_routeIndex.clear ();
+  m_routeTrie.Clear ();
+  for (NetworkRoutesCI i = m_networkRoutes.begin (); 
+       i != m_networkRoutes.end (); 
+       i++) 
+    {
+      m_routeTrie.Add (i->first->GetDestNetwork (), i->first->GetDestNetworkMask (), m_routeIndex.size ());
+      m_routeIndex.push_back (*i);
+    }
+  m_routesChanged = false;
+}
+
 Ptr<Ipv4MulticastRoute>
 Ipv4StaticRouting::LookupStatic (
   Ipv4Address origin, 
@@ -449,6 +476,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
         {
           delete j->first;
           m_networkRoutes.erase (j);
+          m_routesChanged = true;
           return;
         }
       tmp++;
@@ -575,6 +603,9 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_routeIndex.clear ();
+  m_routeTrie.Clear ();
+  m_routesChanged = false;
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -615,6 +646,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_routesChanged = true;
         }
       else
         {
@@ -662,6 +694,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_routesChanged = true;
         }
       else
         {
@@ -23,6 +23,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <utility>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
@@ -31,6 +32,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ipv4-prefix-trie.h"
 
 namespace ns3 {
 
@@ -413,11 +415,36 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  /**
+   * \brief Rebuild the trie of the network routes, after the routes changed.
+   */
+  void UpdateRouteIndex (void);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes and their metric, by position in m_networkRoutes.
+   */
+  std::vector<std::pair <Ipv4RoutingTableEntry *, uint32_t> > m_routeIndex;
+
+  /**
+   * \brief the positions of the network routes, by destination prefix.
+   */
+  Ipv4PrefixTrie m_routeTrie;
+
+  /**
+   * \brief true if the routes changed since the trie was built.
+   */
+  bool m_routesChanged;
+
+  /**
+   * \brief lookup results, kept to avoid allocations.
+   */
+  std::vector<uint32_t> m_matches;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -57,7 +57,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0)
 {
 }
 
@@ -111,7 +111,7 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          m_data.push_back (BufItem (m_headOffset + m_size, p));
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -149,56 +149,69 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 
   // Extract data from the buffer and return
   uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
+  NS_ASSERT (offset < m_size);
   NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  BufIterator i = FindOffset (offset);
+  // Offset of the first byte of a packet in the buffer
+  uint32_t count = i->first - m_headOffset;
+  uint32_t pktSize = i->second->GetSize ();
+  NS_LOG_LOGIC ("First byte found in packet #" << i - m_data.begin () + 1 << " at buffer offset " << count
+                                               << ", packet len=" << pktSize);
+  uint32_t packetOffset = offset - count;
+  uint32_t fragmentLength = count + pktSize - offset;
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return i->second->CreateFragment (packetOffset, s);
+    }
+  // This packet only fulfills part of the request
+  Ptr<Packet> outPacket = i->second->CreateFragment (packetOffset, fragmentLength);
+  NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+  for (++i; i != m_data.end (); ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      count = i->first - m_headOffset;
+      pktSize = i->second->GetSize ();
+      if (count + pktSize >= offset + s)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
+          NS_LOG_LOGIC ("Last byte found in packet #" << i - m_data.begin () + 1 << " at buffer offset " << count
                                                       << ", packet len=" << pktSize);
           uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
+          Ptr<Packet> endFragment = i->second->CreateFragment (0, fragmentLength);
           outPacket->AddAtEnd (endFragment);
           NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
           break;
         }
+      NS_LOG_LOGIC ("Appending to output the packet #" << i - m_data.begin () + 1 << " of offset " << count << " len=" << pktSize);
+      outPacket->AddAtEnd (i->second);
+      NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+    }
+  NS_ASSERT (outPacket->GetSize () == s);
+  return outPacket;
+}
+
+TcpTxBuffer::BufIterator
+TcpTxBuffer::FindOffset (uint32_t offset)
+{
+  NS_ASSERT (offset < m_size);
+  // Binary search for the last packet starting at or before the offset.
+  // The offsets of the packets from the head of the buffer are increasing.
+  BufIterator first = m_data.begin ();
+  uint32_t n = m_data.size ();
+  while (n > 0)
+    {
+      uint32_t half = n / 2;
+      BufIterator middle = first + half;
+      if (middle->first - m_headOffset <= offset)
+        {
+          first = middle + 1;
+          n -= half + 1;
+        }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          n = half;
         }
-      count += pktSize;
     }
-  NS_ASSERT (outPacket->GetSize () == s);
-  return outPacket;
+  NS_ASSERT (first != m_data.begin ());
+  return first - 1;
 }
 
 void
@@ -221,26 +234,29 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
   uint32_t pktSize;
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  while (!m_data.empty () && offset > 0)
     {
-      if (offset > (*i)->GetSize ())
+      BufItem &item = m_data.front ();
+      pktSize = item.second->GetSize ();
+      if (offset >= pktSize)
         { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
           m_size -= pktSize;
           offset -= pktSize;
           m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
+          m_headOffset += pktSize;
+          m_data.pop_front ();
           NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
         }
-      else if (offset > 0)
+      else
         { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
+          pktSize -= offset;
+          item.second = item.second->CreateFragment (offset, pktSize);
+          item.first += offset;
           m_size -= offset;
           m_firstByteSeq += offset;
+          m_headOffset += offset;
           NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
+          offset = 0;
         }
     }
   // Catching the case of ACKing a FIN
@@ -21,7 +21,8 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
+#include <utility>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +37,13 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets written by the application are kept, without copying their
+ * bytes, in a double-ended queue together with the stream offset of their
+ * first byte. The packet holding a given sequence number is then found by
+ * a binary search rather than by scanning the buffer from its head, and
+ * the segments are built from fragments of the packets, which share their
+ * data buffers.
  */
 class TcpTxBuffer : public Object
 {
@@ -128,13 +136,23 @@ public:
   void DiscardUpTo (const SequenceNumber32& seq);
 
 private:
+  /// A packet of the buffer, with the stream offset of its first byte
+  typedef std::pair<uint32_t, Ptr<Packet> > BufItem;
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<BufItem>::iterator BufIterator;
+
+  /**
+   * Find the packet which holds a byte of the buffer
+   * \param offset offset of the byte from the head of the buffer, lower than its size
+   * \returns the packet which holds the byte
+   */
+  BufIterator FindOffset (uint32_t offset);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint32_t m_headOffset;                        //!< Stream offset of the first byte in data (modulo 2^32)
+  std::deque<BufItem> m_data;                   //!< Corresponding data, in stream order
 };
 
 } // namepsace ns3
@@ -15,8 +15,10 @@
  */
 
 #include <vector>
+#include <sstream>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -1167,6 +1169,131 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Check that the routing tables do not depend on the number of threads of
+ * the SPF calculations, and that incremental SPF updates them as a full
+ * recomputation does.
+ */
+class Ipv4GlobalRoutingSpfTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingSpfTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns The global routing tables of all of the nodes, one string per node.
+   */
+  std::vector<std::string> GetRoutingTables (void);
+  /**
+   * Recompute the routing tables, and compare them with a full recomputation.
+   * \param what The topology change.
+   */
+  void CheckIncremental (std::string what);
+
+  NodeContainer m_nodes;
+};
+
+Ipv4GlobalRoutingSpfTestCase::Ipv4GlobalRoutingSpfTestCase ()
+  : TestCase ("Global routing with several SPF threads and incremental SPF")
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingSpfTestCase::GetRoutingTables (void)
+{
+  std::vector<std::string> tables;
+  for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+    {
+      Ptr<Ipv4GlobalRouting> routing = m_nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream oss;
+      for (uint32_t j = 0; j < routing->GetNRoutes (); ++j)
+        {
+          oss << *routing->GetRoute (j) << std::endl;
+        }
+      tables.push_back (oss.str ());
+    }
+  return tables;
+}
+
+void
+Ipv4GlobalRoutingSpfTestCase::CheckIncremental (std::string what)
+{
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> incremental = GetRoutingTables ();
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> full = GetRoutingTables ();
+  for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (incremental[i], full[i], "Wrong routes of node " << i << " after " << what);
+    }
+  // keep the distances for the next change
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+}
+
+// A ring of point-to-point links, with chords, and a stub node attached to
+// one of the routers.
+void
+Ipv4GlobalRoutingSpfTestCase::DoRun (void)
+{
+  uint32_t n = 12;
+  m_nodes.Create (n + 1);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (m_nodes);
+
+  SimpleNetDeviceHelper p2pHelper;
+  p2pHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      ipv4.Assign (p2pHelper.Install (NodeContainer (m_nodes.Get (i), m_nodes.Get ((i + 1) % n))));
+      ipv4.NewNetwork ();
+      if (i % 3 == 0)
+        {
+          ipv4.Assign (p2pHelper.Install (NodeContainer (m_nodes.Get (i), m_nodes.Get ((i + n / 2) % n))));
+          ipv4.NewNetwork ();
+        }
+    }
+  ipv4.Assign (p2pHelper.Install (NodeContainer (m_nodes.Get (2), m_nodes.Get (n))));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> serial = GetRoutingTables ();
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (4));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> parallel = GetRoutingTables ();
+  for (uint32_t i = 0; i < m_nodes.GetN (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_NE (serial[i], "", "No routes on node " << i);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i], serial[i], "Wrong routes of node " << i << " with 4 threads");
+    }
+
+  // keep the distances
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+
+  Ptr<Ipv4> ipv4Node0 = m_nodes.Get (0)->GetObject<Ipv4> ();
+  ipv4Node0->SetMetric (1, 10);
+  CheckIncremental ("a metric increase");
+  ipv4Node0->SetMetric (1, 1);
+  CheckIncremental ("a metric decrease");
+  m_nodes.Get (5)->GetObject<Ipv4> ()->SetMetric (2, 3);
+  CheckIncremental ("another metric change");
+  m_nodes.Get (4)->GetObject<Ipv4> ()->SetDown (1);
+  CheckIncremental ("an interface going down");
+  m_nodes.Get (4)->GetObject<Ipv4> ()->SetUp (1);
+  CheckIncremental ("an interface going up");
+
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (1));
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -1184,6 +1311,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingSpfTestCase, TestCase::QUICK);
   }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-prefix-trie.h"
+#include "ns3/random-variable-stream.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Compare the prefixes returned by an Ipv4PrefixTrie with the ones
+ * found by checking every prefix.
+ */
+class Ipv4PrefixTrieTestCase : public TestCase
+{
+public:
+  Ipv4PrefixTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param base An address.
+   * \returns An address which shares a random number of leading bits
+   *          with \p base.
+   */
+  uint32_t GetNear (uint32_t base);
+
+  Ptr<UniformRandomVariable> m_random;
+};
+
+Ipv4PrefixTrieTestCase::Ipv4PrefixTrieTestCase ()
+  : TestCase ("Check Ipv4PrefixTrie lookups against a linear search")
+{
+}
+
+uint32_t
+Ipv4PrefixTrieTestCase::GetNear (uint32_t base)
+{
+  uint32_t common = m_random->GetInteger (0, 32);
+  uint32_t mask = common == 0 ? 0 : 0xffffffff << (32 - common);
+  return (base & mask) | (m_random->GetInteger (0, 0xffffffff) & ~mask);
+}
+
+void
+Ipv4PrefixTrieTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  uint32_t base = 0x0a010000;
+
+  for (uint32_t round = 0; round < 20; ++round)
+    {
+      Ipv4PrefixTrie trie;
+      std::vector<Ipv4Address> networks;
+      std::vector<Ipv4Mask> masks;
+      uint32_t n = m_random->GetInteger (0, 300);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          Ipv4Mask mask;
+          double kind = m_random->GetValue ();
+          if (kind < 0.05)
+            {
+              // not contiguous
+              mask = Ipv4Mask (m_random->GetInteger (0, 0xffffffff));
+            }
+          else if (kind < 0.4)
+            {
+              mask = Ipv4Mask::GetOnes ();
+            }
+          else
+            {
+              uint32_t length = m_random->GetInteger (0, 32);
+              mask = Ipv4Mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+            }
+          // the same network may be added more than once
+          Ipv4Address network = (i > 0 && m_random->GetValue () < 0.05) ?
+            networks[m_random->GetInteger (0, i - 1)] : Ipv4Address (GetNear (base));
+          networks.push_back (network);
+          masks.push_back (mask);
+          trie.Add (network, mask, i);
+        }
+      NS_TEST_ASSERT_MSG_EQ (trie.GetN (), n, "Wrong number of prefixes");
+
+      std::vector<uint32_t> found;
+      for (uint32_t k = 0; k < 500; ++k)
+        {
+          Ipv4Address dest (GetNear (base));
+          std::vector<uint32_t> expected;
+          for (uint32_t i = 0; i < n; ++i)
+            {
+              if (masks[i].IsMatch (dest, networks[i]))
+                {
+                  expected.push_back (i);
+                }
+            }
+          trie.Lookup (dest, found);
+          NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of prefixes matching " << dest);
+          for (uint32_t i = 0; i < found.size (); ++i)
+            {
+              NS_TEST_ASSERT_MSG_EQ (found[i], expected[i], "Wrong prefix matching " << dest);
+            }
+        }
+
+      trie.Clear ();
+      trie.Lookup (Ipv4Address (base), found);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), 0, "Prefixes left after Clear");
+    }
+  m_random = 0;
+}
+
+/**
+ * The Ipv4PrefixTrie test suite.
+ */
+class Ipv4PrefixTrieTestSuite : public TestSuite
+{
+public:
+  Ipv4PrefixTrieTestSuite ();
+};
+
+Ipv4PrefixTrieTestSuite::Ipv4PrefixTrieTestSuite ()
+  : TestSuite ("ipv4-prefix-trie", UNIT)
+{
+  AddTestCase (new Ipv4PrefixTrieTestCase, TestCase::QUICK);
+}
+
+static Ipv4PrefixTrieTestSuite g_ipv4PrefixTrieTestSuite;
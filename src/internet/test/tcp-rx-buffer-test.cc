@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-header.h"
+#include "ns3/log.h"
+#include <vector>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpRxBufferTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the reassembly of TcpRxBuffer.
+ *
+ * Segments of a byte stream are added to the buffer out of order, with
+ * duplicates and overlaps, and the data is read as it becomes contiguous.
+ * The bytes read are compared with the stream.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param stream offset of the byte in the stream
+   * \returns the value of the byte
+   */
+  static uint8_t GetByte (uint32_t stream);
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("Reassemble segments in TcpRxBuffer")
+{
+}
+
+uint8_t
+TcpRxBufferTestCase::GetByte (uint32_t stream)
+{
+  return static_cast<uint8_t> ((stream * 13) ^ (stream >> 8));
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  SequenceNumber32 isn (0xffff8000);
+  TcpRxBuffer rxBuffer (isn.GetValue ());
+  rxBuffer.SetMaxBufferSize (40000);
+
+  uint32_t read = 0;      // stream offset of the next byte to read
+  uint32_t received = 0;  // stream offset of the next byte expected
+  std::vector<bool> have; // the bytes received
+  for (uint32_t step = 0; step < 5000; step++)
+    {
+      // Either the next segment, overlapping the data already received,
+      // or a segment ahead of it, within the window which starts at the
+      // data read
+      uint32_t size = x->GetInteger (1, 1460);
+      uint32_t offset;
+      if (x->GetInteger (0, 1) == 0)
+        {
+          offset = x->GetInteger (received > 2000 ? received - 2000 : 0, received);
+        }
+      else
+        {
+          offset = x->GetInteger (received, read + 40000 - size);
+        }
+      std::vector<uint8_t> data (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          data[i] = GetByte (offset + i);
+        }
+      TcpHeader tcph;
+      tcph.SetSequenceNumber (isn + SequenceNumber32 (offset));
+      rxBuffer.Add (Create<Packet> (&data[0], size), tcph);
+      if (have.size () < offset + size)
+        {
+          have.resize (offset + size, false);
+        }
+      std::fill (have.begin () + offset, have.begin () + offset + size, true);
+      while (received < have.size () && have[received])
+        {
+          received++;
+        }
+      NS_TEST_ASSERT_MSG_EQ (rxBuffer.Available (), received - read, "wrong number of contiguous bytes");
+
+      if (x->GetInteger (0, 3) == 0)
+        {
+          uint32_t maxSize = x->GetInteger (1, 5000);
+          Ptr<Packet> p = rxBuffer.Extract (maxSize);
+          uint32_t expectedSize = std::min (maxSize, received - read);
+          if (expectedSize == 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (p, 0, "data extracted from an empty buffer");
+              continue;
+            }
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expectedSize, "wrong extracted size");
+          std::vector<uint8_t> out (expectedSize);
+          p->CopyData (&out[0], expectedSize);
+          for (uint32_t i = 0; i < expectedSize; i++)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((uint32_t) out[i], (uint32_t) GetByte (read + i),
+                                     "wrong byte at " << read + i);
+            }
+          read += expectedSize;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (read, 100000, "too few bytes read");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRxBuffer TestSuite
+ */
+static class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+} g_tcpRxBufferTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/log.h"
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpTxBufferTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the bytes of the segments extracted from TcpTxBuffer.
+ *
+ * Packets of random sizes, holding a known byte pattern, are added to the
+ * buffer, and random ranges are extracted and acknowledged. The content of
+ * the extracted segments is compared with the bytes written.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param stream offset of the byte in the stream
+   * \returns the value of the byte
+   */
+  static uint8_t GetByte (uint32_t stream);
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Extract segments from TcpTxBuffer")
+{
+}
+
+uint8_t
+TcpTxBufferTestCase::GetByte (uint32_t stream)
+{
+  return static_cast<uint8_t> ((stream * 7) ^ (stream >> 8));
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  // Start close to the wrap around of the sequence numbers
+  SequenceNumber32 isn (0xfffff000);
+  TcpTxBuffer txBuffer (isn.GetValue ());
+  txBuffer.SetMaxBufferSize (20000);
+
+  uint32_t written = 0; // stream offset of the next byte to write
+  uint32_t acked = 0;   // stream offset of the first unacknowledged byte
+  for (uint32_t step = 0; step < 2000; step++)
+    {
+      uint32_t size = x->GetInteger (1, 1500);
+      if (size <= txBuffer.Available ())
+        {
+          std::vector<uint8_t> data (size);
+          for (uint32_t i = 0; i < size; i++)
+            {
+              data[i] = GetByte (written + i);
+            }
+          NS_TEST_ASSERT_MSG_EQ (txBuffer.Add (Create<Packet> (&data[0], size)), true, "packet not added");
+          written += size;
+        }
+      NS_TEST_ASSERT_MSG_EQ (txBuffer.Size (), written - acked, "wrong buffer size");
+      NS_TEST_ASSERT_MSG_EQ (txBuffer.TailSequence (), isn + SequenceNumber32 (written), "wrong tail sequence");
+
+      for (uint32_t segment = 0; segment < 3 && written > acked; segment++)
+        {
+          uint32_t offset = x->GetInteger (acked, written - 1);
+          uint32_t segmentSize = x->GetInteger (1, 3000);
+          Ptr<Packet> p = txBuffer.CopyFromSequence (segmentSize, isn + SequenceNumber32 (offset));
+          uint32_t expectedSize = std::min (segmentSize, written - offset);
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expectedSize, "wrong segment size");
+          std::vector<uint8_t> data (expectedSize);
+          p->CopyData (&data[0], expectedSize);
+          for (uint32_t i = 0; i < expectedSize; i++)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], (uint32_t) GetByte (offset + i),
+                                     "wrong byte " << i << " in segment at " << offset);
+            }
+        }
+
+      if (written > acked && x->GetInteger (0, 2) == 0)
+        {
+          acked = x->GetInteger (acked, written);
+          txBuffer.DiscardUpTo (isn + SequenceNumber32 (acked));
+          NS_TEST_ASSERT_MSG_EQ (txBuffer.HeadSequence (), isn + SequenceNumber32 (acked), "wrong head sequence");
+          NS_TEST_ASSERT_MSG_EQ (txBuffer.Size (), written - acked, "wrong buffer size after discard");
+        }
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpTxBuffer TestSuite
+ */
+static class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase, TestCase::QUICK);
+  }
+} g_tcpTxBufferTestSuite;
+
+} // namespace ns3
@@ -41,6 +41,7 @@
 #include "iolsr-header.h"
 #include "iolsr-repositories.h"
 #include "iolsr-state.h"
+#include "iolsr-mpr-engine.h"
 
 /// Testcase for MPR computation mechanism
 class IOlsrMprTestCase;
@@ -212,6 +213,7 @@ private:
   uint8_t m_willingness;  //!<  Willingness for forwarding packets on behalf of other nodes.
 
   IOlsrState m_state;  //!< Internal state with all needed data structs.
+  MprEngine m_mprEngine;  //!< Computes the MPR set.
   Ptr<Ipv4> m_ipv4;   //!< IPv4 object the routing is linked to.
 
   /**
@@ -745,7 +747,6 @@ private:
   void PopulateMprSelectorSet (const iolsr::MessageHeader &msg,
                                const iolsr::MessageHeader::Hello &hello);
 
-  int Degree (NeighborTuple const &tuple);
   /// Check that address is one of my interfaces
   bool IsMyOwnAddress (const Ipv4Address & a) const;
 
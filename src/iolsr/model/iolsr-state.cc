@@ -28,6 +28,8 @@
 
 #include "iolsr-state.h"
 
+#include <algorithm>
+
 
 namespace ns3 {
 namespace iolsr {
@@ -37,13 +39,11 @@ namespace iolsr {
 MprSelectorTuple*
 IOlsrState::FindMprSelectorTuple (Ipv4Address const &mainAddr)
 {
-  for (MprSelectorSet::iterator it = m_mprSelectorSet.begin ();
-       it != m_mprSelectorSet.end (); it++)
+  TupleIndex<MprSelectorTuple, MprSelectorTupleKey>::Range range =
+    m_mprSelectorIndex.Find (m_mprSelectorSet, mainAddr);
+  if (range.first != range.second)
     {
-      if (it->mainAddr == mainAddr)
-        {
-          return &(*it);
-        }
+      return &m_mprSelectorSet[range.first->second];
     }
   return NULL;
 }
@@ -51,12 +51,15 @@ IOlsrState::FindMprSelectorTuple (Ipv4Address const &mainAddr)
 void
 IOlsrState::EraseMprSelectorTuple (const MprSelectorTuple &tuple)
 {
-  for (MprSelectorSet::iterator it = m_mprSelectorSet.begin ();
-       it != m_mprSelectorSet.end (); it++)
+  TupleIndex<MprSelectorTuple, MprSelectorTupleKey>::Range range =
+    m_mprSelectorIndex.Find (m_mprSelectorSet, MprSelectorTupleKey::Get (tuple));
+  for (; range.first != range.second; range.first++)
     {
-      if (*it == tuple)
+      uint32_t position = range.first->second;
+      if (m_mprSelectorSet[position] == tuple)
         {
-          m_mprSelectorSet.erase (it);
+          m_mprSelectorIndex.Erase (m_mprSelectorSet, position);
+          m_mprSelectorSet.erase (m_mprSelectorSet.begin () + position);
           break;
         }
     }
@@ -65,17 +68,19 @@ IOlsrState::EraseMprSelectorTuple (const MprSelectorTuple &tuple)
 void
 IOlsrState::EraseMprSelectorTuples (const Ipv4Address &mainAddr)
 {
-  for (MprSelectorSet::iterator it = m_mprSelectorSet.begin ();
-       it != m_mprSelectorSet.end (); )
+  // the tuples are erased from the last one, so that the positions of the
+  // others do not change
+  for (;;)
     {
-      if (it->mainAddr == mainAddr)
-        {
-          it = m_mprSelectorSet.erase (it);
-        }
-      else
+      TupleIndex<MprSelectorTuple, MprSelectorTupleKey>::Range range =
+        m_mprSelectorIndex.Find (m_mprSelectorSet, mainAddr);
+      if (range.first == range.second)
         {
-          it++;
+          break;
         }
+      uint32_t position = (--range.second)->second;
+      m_mprSelectorIndex.Erase (m_mprSelectorSet, position);
+      m_mprSelectorSet.erase (m_mprSelectorSet.begin () + position);
     }
 }
 
@@ -83,6 +88,7 @@ void
 IOlsrState::InsertMprSelectorTuple (MprSelectorTuple const &tuple)
 {
   m_mprSelectorSet.push_back (tuple);
+  m_mprSelectorIndex.Append (m_mprSelectorSet);
 }
 
 std::string
@@ -111,13 +117,11 @@ IOlsrState::PrintMprSelectorSet () const
 NeighborTuple*
 IOlsrState::FindNeighborTuple (Ipv4Address const &mainAddr)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  TupleIndex<NeighborTuple, NeighborTupleKey>::Range range =
+    m_neighborIndex.Find (m_neighborSet, mainAddr);
+  if (range.first != range.second)
     {
-      if (it->neighborMainAddr == mainAddr)
-        {
-          return &(*it);
-        }
+      return &m_neighborSet[range.first->second];
     }
   return NULL;
 }
@@ -125,12 +129,14 @@ IOlsrState::FindNeighborTuple (Ipv4Address const &mainAddr)
 const NeighborTuple*
 IOlsrState::FindSymNeighborTuple (Ipv4Address const &mainAddr) const
 {
-  for (NeighborSet::const_iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  TupleIndex<NeighborTuple, NeighborTupleKey>::Range range =
+    m_neighborIndex.Find (m_neighborSet, mainAddr);
+  for (; range.first != range.second; range.first++)
     {
-      if (it->neighborMainAddr == mainAddr && it->status == NeighborTuple::STATUS_SYM)
+      const NeighborTuple &tuple = m_neighborSet[range.first->second];
+      if (tuple.status == NeighborTuple::STATUS_SYM)
         {
-          return &(*it);
+          return &tuple;
         }
     }
   return NULL;
@@ -139,12 +145,14 @@ IOlsrState::FindSymNeighborTuple (Ipv4Address const &mainAddr) const
 NeighborTuple*
 IOlsrState::FindNeighborTuple (Ipv4Address const &mainAddr, uint8_t willingness)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  TupleIndex<NeighborTuple, NeighborTupleKey>::Range range =
+    m_neighborIndex.Find (m_neighborSet, mainAddr);
+  for (; range.first != range.second; range.first++)
     {
-      if (it->neighborMainAddr == mainAddr && it->willingness == willingness)
+      NeighborTuple &tuple = m_neighborSet[range.first->second];
+      if (tuple.willingness == willingness)
         {
-          return &(*it);
+          return &tuple;
         }
     }
   return NULL;
@@ -153,12 +161,15 @@ IOlsrState::FindNeighborTuple (Ipv4Address const &mainAddr, uint8_t willingness)
 void
 IOlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  TupleIndex<NeighborTuple, NeighborTupleKey>::Range range =
+    m_neighborIndex.Find (m_neighborSet, NeighborTupleKey::Get (tuple));
+  for (; range.first != range.second; range.first++)
     {
-      if (*it == tuple)
+      uint32_t position = range.first->second;
+      if (m_neighborSet[position] == tuple)
         {
-          m_neighborSet.erase (it);
+          m_neighborIndex.Erase (m_neighborSet, position);
+          m_neighborSet.erase (m_neighborSet.begin () + position);
           break;
         }
     }
@@ -167,31 +178,28 @@ IOlsrState::EraseNeighborTuple (const NeighborTuple &tuple)
 void
 IOlsrState::EraseNeighborTuple (const Ipv4Address &mainAddr)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  TupleIndex<NeighborTuple, NeighborTupleKey>::Range range =
+    m_neighborIndex.Find (m_neighborSet, mainAddr);
+  if (range.first != range.second)
     {
-      if (it->neighborMainAddr == mainAddr)
-        {
-          it = m_neighborSet.erase (it);
-          break;
-        }
+      uint32_t position = range.first->second;
+      m_neighborIndex.Erase (m_neighborSet, position);
+      m_neighborSet.erase (m_neighborSet.begin () + position);
     }
 }
 
 void
 IOlsrState::InsertNeighborTuple (NeighborTuple const &tuple)
 {
-  for (NeighborSet::iterator it = m_neighborSet.begin ();
-       it != m_neighborSet.end (); it++)
+  NeighborTuple *existing = FindNeighborTuple (tuple.neighborMainAddr);
+  if (existing != NULL)
     {
-      if (it->neighborMainAddr == tuple.neighborMainAddr)
-        {
-          // Update it
-          *it = tuple;
-          return;
-        }
+      // Update it
+      *existing = tuple;
+      return;
     }
   m_neighborSet.push_back (tuple);
+  m_neighborIndex.Append (m_neighborSet);
 }
 
 /********** Neighbor 2 Hop Set Manipulation **********/
@@ -200,14 +208,12 @@ TwoHopNeighborTuple*
 IOlsrState::FindTwoHopNeighborTuple (Ipv4Address const &neighborMainAddr,
                                     Ipv4Address const &twoHopNeighborAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); it++)
+  TupleIndex<TwoHopNeighborTuple, TwoHopNeighborTupleKey>::Range range =
+    m_twoHopNeighborIndex.Find (m_twoHopNeighborSet,
+                                TwoHopNeighborTupleKey::Key (neighborMainAddr, twoHopNeighborAddr));
+  if (range.first != range.second)
     {
-      if (it->neighborMainAddr == neighborMainAddr
-          && it->twoHopNeighborAddr == twoHopNeighborAddr)
-        {
-          return &(*it);
-        }
+      return &m_twoHopNeighborSet[range.first->second];
     }
   return NULL;
 }
@@ -215,12 +221,15 @@ IOlsrState::FindTwoHopNeighborTuple (Ipv4Address const &neighborMainAddr,
 void
 IOlsrState::EraseTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); it++)
+  TupleIndex<TwoHopNeighborTuple, TwoHopNeighborTupleKey>::Range range =
+    m_twoHopNeighborIndex.Find (m_twoHopNeighborSet, TwoHopNeighborTupleKey::Get (tuple));
+  for (; range.first != range.second; range.first++)
     {
-      if (*it == tuple)
+      uint32_t position = range.first->second;
+      if (m_twoHopNeighborSet[position] == tuple)
         {
-          m_twoHopNeighborSet.erase (it);
+          m_twoHopNeighborIndex.Erase (m_twoHopNeighborSet, position);
+          m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + position);
           break;
         }
     }
@@ -230,35 +239,45 @@ void
 IOlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr,
                                       const Ipv4Address &twoHopNeighborAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); )
+  // the tuples are erased from the last one, so that the positions of the
+  // others do not change
+  for (;;)
     {
-      if (it->neighborMainAddr == neighborMainAddr
-          && it->twoHopNeighborAddr == twoHopNeighborAddr)
-        {
-          it = m_twoHopNeighborSet.erase (it);
-        }
-      else
+      TupleIndex<TwoHopNeighborTuple, TwoHopNeighborTupleKey>::Range range =
+        m_twoHopNeighborIndex.Find (m_twoHopNeighborSet,
+                                    TwoHopNeighborTupleKey::Key (neighborMainAddr, twoHopNeighborAddr));
+      if (range.first == range.second)
         {
-          it++;
+          break;
         }
+      uint32_t position = (--range.second)->second;
+      m_twoHopNeighborIndex.Erase (m_twoHopNeighborSet, position);
+      m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + position);
     }
 }
 
 void
 IOlsrState::EraseTwoHopNeighborTuples (const Ipv4Address &neighborMainAddr)
 {
-  for (TwoHopNeighborSet::iterator it = m_twoHopNeighborSet.begin ();
-       it != m_twoHopNeighborSet.end (); )
+  // the range holds the tuples of each 2-hop neighbor in turn: erase the
+  // last tuple of the neighbor until there are none left
+  for (;;)
     {
-      if (it->neighborMainAddr == neighborMainAddr)
+      TupleIndex<TwoHopNeighborTuple, TwoHopNeighborTupleKey>::Range range =
+        m_twoHopNeighborIndex.Find (m_twoHopNeighborSet,
+                                    TwoHopNeighborTupleKey::Key (neighborMainAddr, Ipv4Address ((uint32_t) 0)),
+                                    TwoHopNeighborTupleKey::Key (neighborMainAddr, Ipv4Address (0xffffffff)));
+      if (range.first == range.second)
         {
-          it = m_twoHopNeighborSet.erase (it);
+          break;
         }
-      else
+      uint32_t position = range.first->second;
+      for (; range.first != range.second; range.first++)
         {
-          it++;
+          position = std::max (position, range.first->second);
         }
+      m_twoHopNeighborIndex.Erase (m_twoHopNeighborSet, position);
+      m_twoHopNeighborSet.erase (m_twoHopNeighborSet.begin () + position);
     }
 }
 
@@ -266,6 +285,7 @@ void
 IOlsrState::InsertTwoHopNeighborTuple (TwoHopNeighborTuple const &tuple)
 {
   m_twoHopNeighborSet.push_back (tuple);
+  m_twoHopNeighborIndex.Append (m_twoHopNeighborSet);
 }
 
 /********** MPR Set Manipulation **********/
@@ -293,13 +313,11 @@ IOlsrState::GetMprSet () const
 DuplicateTuple*
 IOlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  TupleIndex<DuplicateTuple, DuplicateTupleKey>::Range range =
+    m_duplicateIndex.Find (m_duplicateSet, DuplicateTupleKey::Key (addr, sequenceNumber));
+  if (range.first != range.second)
     {
-      if (it->address == addr && it->sequenceNumber == sequenceNumber)
-        {
-          return &(*it);
-        }
+      return &m_duplicateSet[range.first->second];
     }
   return NULL;
 }
@@ -307,14 +325,13 @@ IOlsrState::FindDuplicateTuple (Ipv4Address const &addr, uint16_t sequenceNumber
 void
 IOlsrState::EraseDuplicateTuple (const DuplicateTuple &tuple)
 {
-  for (DuplicateSet::iterator it = m_duplicateSet.begin ();
-       it != m_duplicateSet.end (); it++)
+  TupleIndex<DuplicateTuple, DuplicateTupleKey>::Range range =
+    m_duplicateIndex.Find (m_duplicateSet, DuplicateTupleKey::Get (tuple));
+  if (range.first != range.second)
     {
-      if (*it == tuple)
-        {
-          m_duplicateSet.erase (it);
-          break;
-        }
+      uint32_t position = range.first->second;
+      m_duplicateIndex.Erase (m_duplicateSet, position);
+      m_duplicateSet.erase (m_duplicateSet.begin () + position);
     }
 }
 
@@ -322,6 +339,7 @@ void
 IOlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 {
   m_duplicateSet.push_back (tuple);
+  m_duplicateIndex.Append (m_duplicateSet);
 }
 
 /********** Link Set Manipulation **********/
@@ -329,13 +347,11 @@ IOlsrState::InsertDuplicateTuple (DuplicateTuple const &tuple)
 LinkTuple*
 IOlsrState::FindLinkTuple (Ipv4Address const & ifaceAddr)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  TupleIndex<LinkTuple, LinkTupleKey>::Range range =
+    m_linkIndex.Find (m_linkSet, ifaceAddr);
+  if (range.first != range.second)
     {
-      if (it->neighborIfaceAddr == ifaceAddr)
-        {
-          return &(*it);
-        }
+      return &m_linkSet[range.first->second];
     }
   return NULL;
 }
@@ -343,20 +359,10 @@ IOlsrState::FindLinkTuple (Ipv4Address const & ifaceAddr)
 LinkTuple*
 IOlsrState::FindSymLinkTuple (Ipv4Address const &ifaceAddr, Time now)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  LinkTuple *tuple = FindLinkTuple (ifaceAddr);
+  if (tuple != NULL && tuple->symTime > now)
     {
-      if (it->neighborIfaceAddr == ifaceAddr)
-        {
-          if (it->symTime > now)
-            {
-              return &(*it);
-            }
-          else
-            {
-              break;
-            }
-        }
+      return tuple;
     }
   return NULL;
 }
@@ -364,12 +370,15 @@ IOlsrState::FindSymLinkTuple (Ipv4Address const &ifaceAddr, Time now)
 void
 IOlsrState::EraseLinkTuple (const LinkTuple &tuple)
 {
-  for (LinkSet::iterator it = m_linkSet.begin ();
-       it != m_linkSet.end (); it++)
+  TupleIndex<LinkTuple, LinkTupleKey>::Range range =
+    m_linkIndex.Find (m_linkSet, LinkTupleKey::Get (tuple));
+  for (; range.first != range.second; range.first++)
     {
-      if (*it == tuple)
+      uint32_t position = range.first->second;
+      if (m_linkSet[position] == tuple)
         {
-          m_linkSet.erase (it);
+          m_linkIndex.Erase (m_linkSet, position);
+          m_linkSet.erase (m_linkSet.begin () + position);
           break;
         }
     }
@@ -379,6 +388,7 @@ LinkTuple&
 IOlsrState::InsertLinkTuple (LinkTuple const &tuple)
 {
   m_linkSet.push_back (tuple);
+  m_linkIndex.Append (m_linkSet);
   return m_linkSet.back ();
 }
 
@@ -388,13 +398,11 @@ TopologyTuple*
 IOlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
                               Ipv4Address const &lastAddr)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  TupleIndex<TopologyTuple, TopologyTupleKey>::Range range =
+    m_topologyIndex.Find (m_topologySet, TopologyTupleKey::Key (destAddr, lastAddr));
+  if (range.first != range.second)
     {
-      if (it->destAddr == destAddr && it->lastAddr == lastAddr)
-        {
-          return &(*it);
-        }
+      return &m_topologySet[range.first->second];
     }
   return NULL;
 }
@@ -402,26 +410,38 @@ IOlsrState::FindTopologyTuple (Ipv4Address const &destAddr,
 TopologyTuple*
 IOlsrState::FindNewerTopologyTuple (Ipv4Address const & lastAddr, uint16_t ansn)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  TupleIndex<TopologyTuple, TopologyTupleLastKey>::Range range =
+    m_topologyLastIndex.Find (m_topologySet, lastAddr);
+  for (; range.first != range.second; range.first++)
     {
-      if (it->lastAddr == lastAddr && it->sequenceNumber > ansn)
+      TopologyTuple &tuple = m_topologySet[range.first->second];
+      if (tuple.sequenceNumber > ansn)
         {
-          return &(*it);
+          return &tuple;
         }
     }
   return NULL;
 }
 
+void
+IOlsrState::EraseTopologyTuple (uint32_t position)
+{
+  m_topologyIndex.Erase (m_topologySet, position);
+  m_topologyLastIndex.Erase (m_topologySet, position);
+  m_topologySet.erase (m_topologySet.begin () + position);
+}
+
 void
 IOlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); it++)
+  TupleIndex<TopologyTuple, TopologyTupleKey>::Range range =
+    m_topologyIndex.Find (m_topologySet, TopologyTupleKey::Get (tuple));
+  for (; range.first != range.second; range.first++)
     {
-      if (*it == tuple)
+      uint32_t position = range.first->second;
+      if (m_topologySet[position] == tuple)
         {
-          m_topologySet.erase (it);
+          EraseTopologyTuple (position);
           break;
         }
     }
@@ -430,24 +450,30 @@ IOlsrState::EraseTopologyTuple (const TopologyTuple &tuple)
 void
 IOlsrState::EraseOlderTopologyTuples (const Ipv4Address &lastAddr, uint16_t ansn)
 {
-  for (TopologySet::iterator it = m_topologySet.begin ();
-       it != m_topologySet.end (); )
+  std::vector<uint32_t> older;
+  TupleIndex<TopologyTuple, TopologyTupleLastKey>::Range range =
+    m_topologyLastIndex.Find (m_topologySet, lastAddr);
+  for (; range.first != range.second; range.first++)
     {
-      if (it->lastAddr == lastAddr && it->sequenceNumber < ansn)
-        {
-          it = m_topologySet.erase (it);
-        }
-      else
+      if (m_topologySet[range.first->second].sequenceNumber < ansn)
         {
-          it++;
+          older.push_back (range.first->second);
         }
     }
+  // the tuples are erased from the last one, so that the positions of the
+  // others do not change
+  for (std::vector<uint32_t>::reverse_iterator it = older.rbegin (); it != older.rend (); it++)
+    {
+      EraseTopologyTuple (*it);
+    }
 }
 
 void
 IOlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 {
   m_topologySet.push_back (tuple);
+  m_topologyIndex.Append (m_topologySet);
+  m_topologyLastIndex.Append (m_topologySet);
 }
 
 /********** Interface Association Set Manipulation **********/
@@ -455,13 +481,11 @@ IOlsrState::InsertTopologyTuple (TopologyTuple const &tuple)
 IfaceAssocTuple*
 IOlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr)
 {
-  for (IfaceAssocSet::iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  TupleIndex<IfaceAssocTuple, IfaceAssocTupleKey>::Range range =
+    m_ifaceAssocIndex.Find (m_ifaceAssocSet, ifaceAddr);
+  if (range.first != range.second)
     {
-      if (it->ifaceAddr == ifaceAddr)
-        {
-          return &(*it);
-        }
+      return &m_ifaceAssocSet[range.first->second];
     }
   return NULL;
 }
@@ -469,13 +493,11 @@ IOlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr)
 const IfaceAssocTuple*
 IOlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr) const
 {
-  for (IfaceAssocSet::const_iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  TupleIndex<IfaceAssocTuple, IfaceAssocTupleKey>::Range range =
+    m_ifaceAssocIndex.Find (m_ifaceAssocSet, ifaceAddr);
+  if (range.first != range.second)
     {
-      if (it->ifaceAddr == ifaceAddr)
-        {
-          return &(*it);
-        }
+      return &m_ifaceAssocSet[range.first->second];
     }
   return NULL;
 }
@@ -483,12 +505,15 @@ IOlsrState::FindIfaceAssocTuple (Ipv4Address const &ifaceAddr) const
 void
 IOlsrState::EraseIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
-  for (IfaceAssocSet::iterator it = m_ifaceAssocSet.begin ();
-       it != m_ifaceAssocSet.end (); it++)
+  TupleIndex<IfaceAssocTuple, IfaceAssocTupleKey>::Range range =
+    m_ifaceAssocIndex.Find (m_ifaceAssocSet, IfaceAssocTupleKey::Get (tuple));
+  for (; range.first != range.second; range.first++)
     {
-      if (*it == tuple)
+      uint32_t position = range.first->second;
+      if (m_ifaceAssocSet[position] == tuple)
         {
-          m_ifaceAssocSet.erase (it);
+          m_ifaceAssocIndex.Erase (m_ifaceAssocSet, position);
+          m_ifaceAssocSet.erase (m_ifaceAssocSet.begin () + position);
           break;
         }
     }
@@ -498,6 +523,7 @@ void
 IOlsrState::InsertIfaceAssocTuple (const IfaceAssocTuple &tuple)
 {
   m_ifaceAssocSet.push_back (tuple);
+  m_ifaceAssocIndex.Append (m_ifaceAssocSet);
 }
 
 std::vector<Ipv4Address>
@@ -188,9 +188,11 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      SpectrumValue interf (m_rxSignal->GetSpectrumModel ());
+      InterferencePlusNoise (interf, *m_rxSignal, *m_allSignals, *m_noise);
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      SpectrumValue sinr = (*m_rxSignal);
+      sinr /= interf;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
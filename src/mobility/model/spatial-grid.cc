@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spatial-grid.h"
+#include "ns3/simulator.h"
+#include "ns3/callback.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialGrid");
+
+SpatialGrid::SpatialGrid ()
+  : m_cellSize (100.0),
+    m_movingChanged (false),
+    m_lastRefresh (Seconds (-1))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SpatialGrid::~SpatialGrid ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+SpatialGrid::SetCellSize (double size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT_MSG (m_entries.empty (), "The cell size of a grid can only be set while it is empty");
+  NS_ASSERT (size > 0);
+  m_cellSize = size;
+}
+
+double
+SpatialGrid::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+SpatialGrid::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  uint32_t index = m_entries.size ();
+  Entry entry;
+  entry.mobility = mobility;
+  entry.moving = false;
+  m_entries.push_back (entry);
+  if (mobility == 0)
+    {
+      m_unplaced.push_back (index);
+      return index;
+    }
+  std::vector<uint32_t> &models = m_models[PeekPointer (mobility)];
+  if (models.empty ())
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&SpatialGrid::CourseChange, this));
+    }
+  models.push_back (index);
+
+  Vector position = mobility->GetPosition ();
+  Entry &e = m_entries.back ();
+  e.position = position;
+  e.cell = Cell (GetCellIndex (position.x), GetCellIndex (position.y));
+  m_cells[e.cell].push_back (index);
+  Vector velocity = mobility->GetVelocity ();
+  if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+    {
+      e.moving = true;
+      m_moving.push_back (index);
+    }
+  return index;
+}
+
+uint32_t
+SpatialGrid::GetN (void) const
+{
+  return m_entries.size ();
+}
+
+void
+SpatialGrid::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_models.begin ();
+       i != m_models.end (); ++i)
+    {
+      m_entries[i->second.front ()].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                                            MakeCallback (&SpatialGrid::CourseChange, this));
+    }
+  m_models.clear ();
+  m_entries.clear ();
+  m_cells.clear ();
+  m_unplaced.clear ();
+  m_moving.clear ();
+  m_movingChanged = false;
+}
+
+int64_t
+SpatialGrid::GetCellIndex (double coordinate) const
+{
+  return static_cast<int64_t> (std::floor (coordinate / m_cellSize));
+}
+
+void
+SpatialGrid::Update (uint32_t index)
+{
+  Entry &entry = m_entries[index];
+  entry.position = entry.mobility->GetPosition ();
+  Cell cell (GetCellIndex (entry.position.x), GetCellIndex (entry.position.y));
+  if (cell == entry.cell)
+    {
+      return;
+    }
+  Cells::iterator old = m_cells.find (entry.cell);
+  NS_ASSERT (old != m_cells.end ());
+  std::vector<uint32_t>::iterator i = std::find (old->second.begin (), old->second.end (), index);
+  NS_ASSERT (i != old->second.end ());
+  *i = old->second.back ();
+  old->second.pop_back ();
+  if (old->second.empty ())
+    {
+      m_cells.erase (old);
+    }
+  m_cells[cell].push_back (index);
+  entry.cell = cell;
+}
+
+void
+SpatialGrid::Refresh (void)
+{
+  Time now = Simulator::Now ();
+  if (now == m_lastRefresh)
+    {
+      return;
+    }
+  m_lastRefresh = now;
+  if (m_movingChanged)
+    {
+      m_moving.clear ();
+      for (uint32_t i = 0; i < m_entries.size (); ++i)
+        {
+          if (m_entries[i].moving)
+            {
+              m_moving.push_back (i);
+            }
+        }
+      m_movingChanged = false;
+    }
+  // GetPosition may notify a course change, which may change m_moving.
+  std::vector<uint32_t> moving = m_moving;
+  for (std::vector<uint32_t>::const_iterator i = moving.begin (); i != moving.end (); ++i)
+    {
+      Update (*i);
+    }
+}
+
+void
+SpatialGrid::CourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i =
+    m_models.find (PeekPointer (mobility));
+  NS_ASSERT (i != m_models.end ());
+  Vector velocity = mobility->GetVelocity ();
+  bool moving = velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+  for (std::vector<uint32_t>::const_iterator j = i->second.begin (); j != i->second.end (); ++j)
+    {
+      Update (*j);
+      if (m_entries[*j].moving != moving)
+        {
+          m_entries[*j].moving = moving;
+          m_movingChanged = true;
+        }
+    }
+}
+
+void
+SpatialGrid::AddInRange (const std::vector<uint32_t> &cell, const Vector &position,
+                         double range, std::vector<uint32_t> &entries) const
+{
+  for (std::vector<uint32_t>::const_iterator i = cell.begin (); i != cell.end (); ++i)
+    {
+      if (CalculateDistance (m_entries[*i].position, position) <= range)
+        {
+          entries.push_back (*i);
+        }
+    }
+}
+
+void
+SpatialGrid::GetInRange (const Vector &position, double range,
+                         std::vector<uint32_t> &entries)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  Refresh ();
+  entries = m_unplaced;
+
+  int64_t xMin = GetCellIndex (position.x - range);
+  int64_t xMax = GetCellIndex (position.x + range);
+  int64_t yMin = GetCellIndex (position.y - range);
+  int64_t yMax = GetCellIndex (position.y + range);
+  if ((double)(xMax - xMin + 1) * (yMax - yMin + 1) > m_cells.size ())
+    {
+      // the range covers more cells than there are entries.
+      for (Cells::const_iterator i = m_cells.begin (); i != m_cells.end (); ++i)
+        {
+          AddInRange (i->second, position, range, entries);
+        }
+    }
+  else
+    {
+      for (int64_t x = xMin; x <= xMax; ++x)
+        {
+          Cells::const_iterator i = m_cells.lower_bound (Cell (x, yMin));
+          for (; i != m_cells.end () && i->first <= Cell (x, yMax); ++i)
+            {
+              AddInRange (i->second, position, range, entries);
+            }
+        }
+    }
+  std::sort (entries.begin (), entries.end ());
+}
+
+} // namespace ns3
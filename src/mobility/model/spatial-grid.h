@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief A uniform grid of MobilityModel positions, to find the ones
+ * which are within some range of a point.
+ *
+ * This is meant for the channels which would otherwise evaluate the
+ * propagation models between a transmitter and every receiver: with
+ * a grid whose cell size is the maximum range of interest, a query
+ * only visits the 3x3 cells around the point.
+ *
+ * The cells are kept up to date through the CourseChange trace
+ * of the mobility models. The models which were moving at their last
+ * course change are moved to their current cell, at most once per
+ * simulation time, before a query is answered, so the grid is exact
+ * for every mobility model which reports its course changes when
+ * they happen. The only exceptions are the models which start moving
+ * without a course change, such as a ConstantAccelerationMobilityModel
+ * set with a zero velocity, and the models which notify their course
+ * changes lazily.
+ *
+ * The grid is two-dimensional: the z coordinate is only used in
+ * the final distance check.
+ */
+class SpatialGrid
+{
+public:
+  SpatialGrid ();
+  ~SpatialGrid ();
+
+  /**
+   * Set the size of the square cells. This must be called while the
+   * grid is empty.
+   *
+   * \param size The cell size, in meters.
+   */
+  void SetCellSize (double size);
+  /**
+   * \returns The cell size, in meters.
+   */
+  double GetCellSize (void) const;
+  /**
+   * Add an entry to the grid.
+   *
+   * \param mobility The mobility model of the entry. If this is
+   *        zero, the entry is returned by every query.
+   * \returns The entry index, which is the number of entries
+   *          added before this one.
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+  /**
+   * \returns The number of entries.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Remove all the entries.
+   */
+  void Clear (void);
+  /**
+   * Find the entries within some distance of a position.
+   *
+   * \param [in] position The position.
+   * \param [in] range The distance, in meters.
+   * \param [out] entries The indices of the entries whose distance to
+   *        \p position is not larger than \p range, plus the entries
+   *        without mobility model, in increasing order.
+   */
+  void GetInRange (const Vector &position, double range,
+                   std::vector<uint32_t> &entries);
+
+private:
+  /**
+   * Copy constructor, not implemented: the grid is connected to
+   * the trace sources of its mobility models.
+   *
+   * \param [in] o The grid to copy.
+   */
+  SpatialGrid (const SpatialGrid &o);
+  /**
+   * Assignment operator, not implemented.
+   *
+   * \param [in] o The grid to copy.
+   * \returns This grid.
+   */
+  SpatialGrid & operator = (const SpatialGrid &o);
+
+  /** The coordinates of a cell. */
+  typedef std::pair<int64_t, int64_t> Cell;
+  /** The entries of each non-empty cell. */
+  typedef std::map<Cell, std::vector<uint32_t> > Cells;
+
+  /** A mobility model in the grid. */
+  struct Entry
+  {
+    Ptr<MobilityModel> mobility;  //!< The mobility model.
+    Vector position;              //!< The position in the grid.
+    Cell cell;                    //!< The cell containing \c position.
+    bool moving;                  //!< Did the model have a velocity at its last course change.
+  };
+
+  /**
+   * \param [in] coordinate A coordinate.
+   * \returns The index of the cell containing \p coordinate.
+   */
+  int64_t GetCellIndex (double coordinate) const;
+  /**
+   * Move an entry to the cell of its current position.
+   *
+   * \param [in] index The entry index.
+   */
+  void Update (uint32_t index);
+  /**
+   * Move the entries which are moving, once per simulation time.
+   */
+  void Refresh (void);
+  /**
+   * Check the entries of a cell against the range.
+   *
+   * \param [in] cell The cell entries.
+   * \param [in] position The position.
+   * \param [in] range The distance, in meters.
+   * \param [out] entries The entries in range.
+   */
+  void AddInRange (const std::vector<uint32_t> &cell, const Vector &position,
+                   double range, std::vector<uint32_t> &entries) const;
+  /**
+   * Called when a mobility model of the grid changes course.
+   *
+   * \param [in] mobility The mobility model.
+   */
+  void CourseChange (Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;                 //!< The cell size.
+  std::vector<Entry> m_entries;      //!< The entries, by index.
+  Cells m_cells;                     //!< The non-empty cells.
+  std::vector<uint32_t> m_unplaced;  //!< The entries without mobility model.
+  /** The entries of each mobility model. */
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_models;
+  std::vector<uint32_t> m_moving;    //!< The moving entries.
+  bool m_movingChanged;              //!< Must m_moving be rebuilt.
+  Time m_lastRefresh;                //!< Time of the last Refresh.
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_H */
@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/spatial-grid.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Compare the entries returned by a SpatialGrid with the ones found
+ * by checking the distance to every mobility model, while the models
+ * move, change course and jump.
+ */
+class SpatialGridTestCase : public TestCase
+{
+public:
+  SpatialGridTestCase ();
+  virtual ~SpatialGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /** Check one query against all the models. */
+  void Check (void);
+  /** Give a new velocity to a random model. */
+  void ChangeCourse (void);
+  /** Move a random static model. */
+  void Jump (void);
+
+  SpatialGrid m_grid;
+  std::vector<Ptr<MobilityModel> > m_models;
+  Ptr<UniformRandomVariable> m_random;
+  uint32_t m_checks;
+};
+
+SpatialGridTestCase::SpatialGridTestCase ()
+  : TestCase ("Check SpatialGrid queries against a brute-force search"),
+    m_checks (0)
+{
+}
+
+SpatialGridTestCase::~SpatialGridTestCase ()
+{
+}
+
+void
+SpatialGridTestCase::Check (void)
+{
+  Vector position (m_random->GetValue (-100, 1100), m_random->GetValue (-100, 1100), 0);
+  double range = m_random->GetValue (0, 300);
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < m_models.size (); ++i)
+    {
+      if (m_models[i] == 0
+          || CalculateDistance (m_models[i]->GetPosition (), position) <= range)
+        {
+          expected.push_back (i);
+        }
+    }
+  std::vector<uint32_t> found;
+  m_grid.GetInRange (position, range, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of entries in range at " << Simulator::Now ().GetSeconds ());
+  for (uint32_t i = 0; i < found.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (found[i], expected[i], "Wrong entry in range");
+    }
+  m_checks++;
+}
+
+void
+SpatialGridTestCase::ChangeCourse (void)
+{
+  uint32_t i = m_random->GetInteger (0, m_models.size () - 1);
+  Ptr<ConstantVelocityMobilityModel> model = DynamicCast<ConstantVelocityMobilityModel> (m_models[i]);
+  if (model != 0)
+    {
+      // stop some of them, so that they are no longer refreshed
+      double speed = m_random->GetValue () < 0.3 ? 0 : 20;
+      model->SetVelocity (Vector (m_random->GetValue (-speed, speed), m_random->GetValue (-speed, speed), 0));
+    }
+}
+
+void
+SpatialGridTestCase::Jump (void)
+{
+  uint32_t i = m_random->GetInteger (0, m_models.size () - 1);
+  if (m_models[i] != 0)
+    {
+      m_models[i]->SetPosition (Vector (m_random->GetValue (0, 1000), m_random->GetValue (0, 1000), m_random->GetValue (0, 10)));
+    }
+}
+
+void
+SpatialGridTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_grid.SetCellSize (150);
+  for (uint32_t i = 0; i < 300; ++i)
+    {
+      Ptr<MobilityModel> model;
+      if (i % 50 == 0)
+        {
+          // no mobility model
+        }
+      else if (i % 3 == 0)
+        {
+          model = CreateObject<ConstantVelocityMobilityModel> ();
+          DynamicCast<ConstantVelocityMobilityModel> (model)->SetVelocity (Vector (m_random->GetValue (-20, 20), m_random->GetValue (-20, 20), 0));
+        }
+      else
+        {
+          model = CreateObject<ConstantPositionMobilityModel> ();
+        }
+      if (model != 0)
+        {
+          model->SetPosition (Vector (m_random->GetValue (0, 1000), m_random->GetValue (0, 1000), m_random->GetValue (0, 10)));
+        }
+      m_models.push_back (model);
+      NS_TEST_ASSERT_MSG_EQ (m_grid.Add (model), i, "Wrong entry index");
+    }
+  // two entries for the same model
+  m_models.push_back (m_models[3]);
+  m_grid.Add (m_models[3]);
+
+  for (uint32_t i = 0; i < 2000; ++i)
+    {
+      Time t = Seconds (m_random->GetValue (0, 60));
+      Simulator::Schedule (t, &SpatialGridTestCase::Check, this);
+      if (i % 4 == 0)
+        {
+          Simulator::Schedule (t, &SpatialGridTestCase::ChangeCourse, this);
+          Simulator::Schedule (t, &SpatialGridTestCase::Jump, this);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 2000, "Some queries did not run");
+}
+
+void
+SpatialGridTestCase::DoTeardown (void)
+{
+  m_grid.Clear ();
+  m_models.clear ();
+  m_random = 0;
+}
+
+/**
+ * The SpatialGrid test suite.
+ */
+class SpatialGridTestSuite : public TestSuite
+{
+public:
+  SpatialGridTestSuite ();
+};
+
+SpatialGridTestSuite::SpatialGridTestSuite ()
+  : TestSuite ("spatial-grid", UNIT)
+{
+  AddTestCase (new SpatialGridTestCase, TestCase::QUICK);
+}
+
+static SpatialGridTestSuite g_spatialGridTestSuite;
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Check that the packets batched into the MPI messages are all received,
+// at the same time as in a simulation which sends no MPI message.
+//
+// The nodes are split into 6 groups, and each node sends packets to the
+// node of same index in the next group, in a ring.  Group g runs on rank
+// g % size, so the topology does not depend on the number of ranks: with
+// one rank no packet is sent through MPI, with 2 or 3 ranks every packet
+// crosses a rank.  The packets are sent much faster than the delay of the
+// links, so each MPI message carries many of them, and with the default
+// packet size the batches fill up and are sent early.
+//
+// Rank 0 prints the number of packets received and a checksum of their
+// reception times and nodes, and fails if a packet was lost:
+//
+//   mpirun -np 1 batched-distributed
+//   mpirun -np 2 batched-distributed
+//   mpirun -np 3 batched-distributed [--nullmsg]
+//
+// must all print the same line.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-helper.h"
+#include <iostream>
+#include <vector>
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BatchedDistributed");
+
+static uint64_t g_rxCount = 0;
+static uint64_t g_rxChecksum = 0;
+
+static void
+Receive (uint32_t nodeId, Ptr<const Packet> packet, const Address &from)
+{
+  g_rxCount++;
+  g_rxChecksum += (nodeId + 1) * static_cast<uint64_t> (Simulator::Now ().GetNanoSeconds ());
+}
+
+int
+main (int argc, char *argv[])
+{
+#ifdef NS3_MPI
+
+  uint32_t n = 500;
+  uint32_t nodes = 4;
+  uint32_t packetSize = 1000;
+  bool nullmsg = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of packets sent by each node", n);
+  cmd.AddValue ("nodes", "number of nodes of each group", nodes);
+  cmd.AddValue ("packetSize", "size of the packets (bytes)", packetSize);
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.Parse (argc, argv);
+
+  // Distributed simulation setup; by default use granted time window algorithm.
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+
+  // Enable parallel simulator with the command line arguments
+  MpiInterface::Enable (&argc, &argv);
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  const uint32_t groups = 6;
+  std::vector<Ptr<Node> > allNodes;
+  for (uint32_t g = 0; g < groups; ++g)
+    {
+      for (uint32_t i = 0; i < nodes; ++i)
+        {
+          allNodes.push_back (CreateObject<Node> (g % systemCount));
+        }
+    }
+  PacketSocketHelper packetSocket;
+  for (uint32_t i = 0; i < allNodes.size (); ++i)
+    {
+      packetSocket.Install (allNodes[i]);
+    }
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  p2p.SetQueue ("ns3::DropTailQueue", "MaxPackets", UintegerValue (n));
+
+  Time interval = MicroSeconds (10);
+  Time stop = MilliSeconds (1) + interval * n;
+  for (uint32_t g = 0; g < groups; ++g)
+    {
+      for (uint32_t i = 0; i < nodes; ++i)
+        {
+          Ptr<Node> txNode = allNodes[g * nodes + i];
+          Ptr<Node> rxNode = allNodes[((g + 1) % groups) * nodes + i];
+          NetDeviceContainer devices = p2p.Install (txNode, rxNode);
+          PacketSocketAddress address;
+          // the point-to-point devices only carry the IPv4 and IPv6 protocols
+          address.SetProtocol (0x0800);
+          if (txNode->GetSystemId () == systemId)
+            {
+              address.SetSingleDevice (devices.Get (0)->GetIfIndex ());
+              address.SetPhysicalAddress (devices.Get (1)->GetAddress ());
+              Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+              client->SetAttribute ("PacketSize", UintegerValue (packetSize));
+              client->SetAttribute ("MaxPackets", UintegerValue (n));
+              client->SetAttribute ("Interval", TimeValue (interval));
+              client->SetRemote (address);
+              txNode->AddApplication (client);
+              client->SetStartTime (MilliSeconds (1) + NanoSeconds (i));
+              client->SetStopTime (stop);
+            }
+          if (rxNode->GetSystemId () == systemId)
+            {
+              address.SetSingleDevice (devices.Get (1)->GetIfIndex ());
+              Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+              server->SetLocal (address);
+              server->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&Receive, rxNode->GetId ()));
+              rxNode->AddApplication (server);
+              server->SetStartTime (Seconds (0));
+              server->SetStopTime (stop + Seconds (1));
+            }
+        }
+    }
+
+  Simulator::Stop (stop + Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  unsigned long long rx[2] = { g_rxCount, g_rxChecksum };
+  unsigned long long total[2] = { 0, 0 };
+  MPI_Reduce (rx, total, 2, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+  int ret = 0;
+  if (systemId == 0)
+    {
+      std::cout << total[0] << " packets received, checksum " << total[1] << std::endl;
+      if (total[0] != static_cast<unsigned long long> (groups) * nodes * n)
+        {
+          std::cout << "Error-- " << groups * nodes * n << " packets were sent" << std::endl;
+          ret = 1;
+        }
+    }
+
+  // Exit the MPI execution environment
+  MpiInterface::Disable ();
+  return ret;
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
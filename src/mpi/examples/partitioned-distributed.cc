@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * PartitionedDistributed creates a ring of routers, each one with a few
+ * leaf nodes, and lets the MpiPartitionHelper assign the nodes to the
+ * logical processors, whatever their number.
+ *
+ *   l0  l1        l2  l3
+ *     \ |         | /
+ *      r0 ------- r1
+ *      |           |
+ *      r3 ------- r2
+ *     / |         | \
+ *   l6  l7        l4  l5
+ *
+ * The topology is built a first time with all the nodes on rank 0, to
+ * compute the partition, then a second time with the system ids of the
+ * partition.  The leaf links are shorter than the minimum lookahead, so
+ * that the leaf nodes stay on the rank of their router.
+ *
+ * Each leaf node sends a few packets to the leaf node of the router on
+ * the other side of the ring.  Each rank prints the number of bytes
+ * received by its packet sinks.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-partition-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+
+#include <vector>
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("PartitionedDistributed");
+
+/**
+ * Create the nodes and the links of the topology.
+ *
+ * \param routers the number of routers of the ring
+ * \param leaves the number of leaf nodes of each router
+ * \param systemIds the system id of each node, or empty to create all
+ *        the nodes on rank 0
+ * \param [out] routerNodes the routers
+ * \param [out] leafNodes the leaf nodes, router by router
+ * \param [out] routerDevices the devices of the ring
+ * \param [out] leafDevices the devices of each leaf link, in the order of
+ *        leafNodes
+ */
+static void
+BuildTopology (uint32_t routers, uint32_t leaves, const std::vector<uint32_t> &systemIds,
+               NodeContainer &routerNodes, NodeContainer &leafNodes,
+               std::vector<NetDeviceContainer> &routerDevices,
+               std::vector<NetDeviceContainer> &leafDevices)
+{
+  // The nodes must be created in the same order in both builds
+  for (uint32_t i = 0; i < routers * (1 + leaves); ++i)
+    {
+      uint32_t systemId = systemIds.empty () ? 0 : systemIds[NodeList::GetNNodes ()];
+      if (i < routers)
+        {
+          routerNodes.Add (CreateObject<Node> (systemId));
+        }
+      else
+        {
+          leafNodes.Add (CreateObject<Node> (systemId));
+        }
+    }
+
+  PointToPointHelper routerLink;
+  routerLink.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  routerLink.SetChannelAttribute ("Delay", StringValue ("5ms"));
+
+  PointToPointHelper leafLink;
+  leafLink.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+  leafLink.SetChannelAttribute ("Delay", StringValue ("500us"));
+
+  for (uint32_t i = 0; i < routers; ++i)
+    {
+      routerDevices.push_back (routerLink.Install (routerNodes.Get (i),
+                                                   routerNodes.Get ((i + 1) % routers)));
+      for (uint32_t j = 0; j < leaves; ++j)
+        {
+          leafDevices.push_back (leafLink.Install (leafNodes.Get (i * leaves + j),
+                                                   routerNodes.Get (i)));
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+#ifdef NS3_MPI
+
+  uint32_t routers = 8;
+  uint32_t leaves = 4;
+  bool nullmsg = false;
+
+  // Parse command line
+  CommandLine cmd;
+  cmd.AddValue ("routers", "Number of routers of the ring", routers);
+  cmd.AddValue ("leaves", "Number of leaf nodes of each router", leaves);
+  cmd.AddValue ("nullmsg", "Enable the use of null-message synchronization", nullmsg);
+  cmd.Parse (argc, argv);
+
+  // Distributed simulation setup; by default use granted time window algorithm.
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+
+  // Enable parallel simulator with the command line arguments
+  MpiInterface::Enable (&argc, &argv);
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  if (routers < 2)
+    {
+      std::cout << "This simulation requires at least 2 routers." << std::endl;
+      return 1;
+    }
+
+  // Build a trial topology, with a sequential simulator, to partition it
+  Simulator::SetImplementation (CreateObject<DefaultSimulatorImpl> ());
+  {
+    NodeContainer routerNodes;
+    NodeContainer leafNodes;
+    std::vector<NetDeviceContainer> routerDevices;
+    std::vector<NetDeviceContainer> leafDevices;
+    BuildTopology (routers, leaves, std::vector<uint32_t> (),
+                   routerNodes, leafNodes, routerDevices, leafDevices);
+  }
+  MpiPartitionHelper partition;
+  partition.SetMinLookAhead (MilliSeconds (1));
+  partition.Partition (systemCount);
+  if (systemId == 0)
+    {
+      partition.Report (std::cout);
+    }
+  std::vector<uint32_t> systemIds = partition.GetSystemIds ();
+  // Clear the NodeList and the ChannelList, and go back to the
+  // distributed simulator
+  Simulator::Destroy ();
+
+  // Some default values
+  Config::SetDefault ("ns3::OnOffApplication::PacketSize", UintegerValue (512));
+  Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue ("1Mbps"));
+  Config::SetDefault ("ns3::OnOffApplication::MaxBytes", UintegerValue (5120));
+
+  NodeContainer routerNodes;
+  NodeContainer leafNodes;
+  std::vector<NetDeviceContainer> routerDevices;
+  std::vector<NetDeviceContainer> leafDevices;
+  BuildTopology (routers, leaves, systemIds,
+                 routerNodes, leafNodes, routerDevices, leafDevices);
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  for (uint32_t i = 0; i < routerDevices.size (); ++i)
+    {
+      address.Assign (routerDevices[i]);
+      address.NewNetwork ();
+    }
+  std::vector<Ipv4Address> leafAddresses;
+  for (uint32_t i = 0; i < leafDevices.size (); ++i)
+    {
+      Ipv4InterfaceContainer ifc = address.Assign (leafDevices[i]);
+      leafAddresses.push_back (ifc.GetAddress (0));
+      address.NewNetwork ();
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // Each leaf node sends to the leaf node of same index of the router
+  // on the other side of the ring
+  uint16_t port = 50000;
+  Address sinkLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", sinkLocalAddress);
+  OnOffHelper clientHelper ("ns3::UdpSocketFactory", Address ());
+  clientHelper.SetAttribute
+    ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+  clientHelper.SetAttribute
+    ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+  ApplicationContainer sinkApps;
+  ApplicationContainer clientApps;
+  for (uint32_t i = 0; i < leafNodes.GetN (); ++i)
+    {
+      Ptr<Node> leaf = leafNodes.Get (i);
+      if (leaf->GetSystemId () != systemId)
+        {
+          continue;
+        }
+      sinkApps.Add (sinkHelper.Install (leaf));
+      uint32_t peer = (i + (routers / 2) * leaves) % leafNodes.GetN ();
+      AddressValue remoteAddress (InetSocketAddress (leafAddresses[peer], port));
+      clientHelper.SetAttribute ("Remote", remoteAddress);
+      clientApps.Add (clientHelper.Install (leaf));
+    }
+  sinkApps.Start (Seconds (1.0));
+  sinkApps.Stop (Seconds (5));
+  clientApps.Start (Seconds (1.0));
+  clientApps.Stop (Seconds (5));
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+
+  uint64_t totalRx = 0;
+  for (uint32_t i = 0; i < sinkApps.GetN (); ++i)
+    {
+      totalRx += DynamicCast<PacketSink> (sinkApps.Get (i))->GetTotalRx ();
+    }
+  std::cout << "Rank " << systemId << ": " << sinkApps.GetN () << " sinks received "
+            << totalRx << " bytes" << std::endl;
+
+  Simulator::Destroy ();
+  // Exit the MPI execution environment
+  MpiInterface::Disable ();
+  return 0;
+#else
+  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
+#endif
+}
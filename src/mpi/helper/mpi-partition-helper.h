@@ -0,0 +1,53 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MPI_PARTITION_HELPER_H
+#define NS3_MPI_PARTITION_HELPER_H
+
+#include "ns3/partition-helper.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Assign the nodes of a topology to the ranks of a distributed
+ * simulation
+ *
+ * The system id of a node must be known when the node is created, and
+ * before its links are installed, since the PointToPointHelper creates a
+ * remote channel between the nodes of two different ranks.  The partition
+ * is therefore computed on a trial copy of the topology:
+ *
+ * \code
+ *   Simulator::SetImplementation (CreateObject<DefaultSimulatorImpl> ());
+ *   BuildTopology (std::vector<uint32_t> ());  // all the nodes on rank 0
+ *   MpiPartitionHelper partition;
+ *   partition.Partition (MpiInterface::GetSize ());
+ *   Simulator::Destroy ();                      // clears the NodeList and ChannelList
+ *   BuildTopology (partition.GetSystemIds ());  // the same nodes and links, in the same order
+ * \endcode
+ *
+ * The nodes are partitioned as by the PartitionHelper, each partition being
+ * a rank.
+ */
+class MpiPartitionHelper : public PartitionHelper
+{
+};
+
+} // namespace ns3
+
+#endif /* NS3_MPI_PARTITION_HELPER_H */
@@ -24,59 +24,15 @@
 #define NS3_GRANTED_TIME_WINDOW_MPI_INTERFACE_H
 
 #include <stdint.h>
-#include <list>
 
 #include "ns3/nstime.h"
 #include "ns3/buffer.h"
 
 #include "parallel-communication-interface.h"
-
-#ifdef NS3_MPI
-#include "mpi.h"
-#else
-typedef void* MPI_Request;
-#endif
+#include "mpi-batch-buffers.h"
 
 namespace ns3 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t MAX_MPI_MSG_SIZE = 2000;
-
-/**
- * \ingroup mpi
- *
- * \brief Tracks non-blocking sends
- *
- * This class is used to keep track of the asynchronous non-blocking
- * sends that have been posted.
- */
-class SentBuffer
-{
-public:
-  SentBuffer ();
-  ~SentBuffer ();
-
-  /**
-   * \return pointer to sent buffer
-   */
-  uint8_t* GetBuffer ();
-  /**
-   * \param buffer pointer to sent buffer
-   */
-  void SetBuffer (uint8_t* buffer);
-  /**
-   * \return MPI request
-   */
-  MPI_Request* GetRequest ();
-
-private:
-  uint8_t* m_buffer;
-  MPI_Request m_request;
-};
-
 class Packet;
 
 /**
@@ -128,9 +84,16 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device
+   * Serialize a packet for the specified node and net device.  The
+   * packets sent to a task are coalesced in one message, sent by
+   * SendMessages at the end of the granted time window.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * Send the packets serialized since the last call, one message per
+   * destination task
+   */
+  static void SendMessages ();
   /**
    * Check for received messages complete
    */
@@ -166,8 +129,8 @@ private:
   // Data buffers for non-blocking reads
   static char**   m_pRxBuffers;
 
-  // List of pending non-blocking sends
-  static std::list<SentBuffer> m_pendingTx;
+  // Packets to send, and pending non-blocking sends
+  static MpiBatchBuffers m_batches;
 };
 
 } // namespace ns3
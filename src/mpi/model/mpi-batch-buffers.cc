@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mpi-batch-buffers.h"
+#include "mpi-receiver.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpiBatchBuffers");
+
+/// Size of the header of a message
+static const uint32_t MPI_BATCH_HEADER_SIZE = sizeof (uint64_t) + 2 * sizeof (uint32_t);
+/// Size of the header of a packet in a message
+static const uint32_t MPI_PACKET_HEADER_SIZE = sizeof (uint64_t) + 4 * sizeof (uint32_t);
+
+/**
+ * \param size a number of bytes
+ * \return the size rounded up to a multiple of 8 bytes
+ */
+static inline uint32_t
+MpiBatchAlign (uint32_t size)
+{
+  return (size + 7) & ~7U;
+}
+
+MpiBatchBuffers::MpiBatchBuffers ()
+{
+}
+
+MpiBatchBuffers::~MpiBatchBuffers ()
+{
+  Destroy ();
+}
+
+void
+MpiBatchBuffers::Enable (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  Batch empty;
+  empty.buffer = 0;
+  empty.size = MPI_BATCH_HEADER_SIZE;
+  empty.nPackets = 0;
+  m_batches.assign (size, empty);
+}
+
+void
+MpiBatchBuffers::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MPI
+  for (std::vector<MPI_Request>::iterator i = m_requests.begin (); i != m_requests.end (); ++i)
+    {
+      MPI_Cancel (&*i);
+      MPI_Request_free (&*i);
+    }
+#endif
+  m_freeBuffers.insert (m_freeBuffers.end (), m_pendingBuffers.begin (), m_pendingBuffers.end ());
+  m_pendingBuffers.clear ();
+  m_requests.clear ();
+}
+
+void
+MpiBatchBuffers::Destroy (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Batch>::iterator i = m_batches.begin (); i != m_batches.end (); ++i)
+    {
+      delete [] i->buffer;
+    }
+  m_batches.clear ();
+  for (std::vector<uint8_t*>::iterator i = m_freeBuffers.begin (); i != m_freeBuffers.end (); ++i)
+    {
+      delete [] *i;
+    }
+  m_freeBuffers.clear ();
+  for (std::vector<uint8_t*>::iterator i = m_pendingBuffers.begin (); i != m_pendingBuffers.end (); ++i)
+    {
+      delete [] *i;
+    }
+  m_pendingBuffers.clear ();
+  m_requests.clear ();
+  m_completed.clear ();
+}
+
+uint8_t*
+MpiBatchBuffers::GetBuffer (void)
+{
+  if (m_freeBuffers.empty ())
+    {
+      NS_LOG_LOGIC ("allocating a buffer, " << m_pendingBuffers.size () << " sends pending");
+      return new uint8_t[MAX_MPI_MSG_SIZE];
+    }
+  uint8_t* buffer = m_freeBuffers.back ();
+  m_freeBuffers.pop_back ();
+  return buffer;
+}
+
+bool
+MpiBatchBuffers::HasRoom (uint32_t rank, uint32_t serializedSize) const
+{
+  NS_ASSERT (rank < m_batches.size ());
+  uint32_t recordSize = MpiBatchAlign (MPI_PACKET_HEADER_SIZE + serializedSize);
+  if (MPI_BATCH_HEADER_SIZE + recordSize > MAX_MPI_MSG_SIZE)
+    {
+      NS_FATAL_ERROR ("Packet of " << serializedSize << " bytes is too large for an MPI message of " << MAX_MPI_MSG_SIZE << " bytes");
+    }
+  return m_batches[rank].size + recordSize <= MAX_MPI_MSG_SIZE;
+}
+
+void
+MpiBatchBuffers::AddPacket (uint32_t rank, Ptr<Packet> p, uint32_t serializedSize,
+                            const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << rank << p << serializedSize << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT (HasRoom (rank, serializedSize));
+  Batch &batch = m_batches[rank];
+  if (batch.buffer == 0)
+    {
+      batch.buffer = GetBuffer ();
+    }
+  uint8_t* record = batch.buffer + batch.size;
+  uint64_t* pTime = reinterpret_cast<uint64_t *> (record);
+  *pTime++ = rxTime.GetInteger ();
+  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
+  *pData++ = node;
+  *pData++ = dev;
+  *pData++ = serializedSize;
+  *pData++ = 0;
+  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
+  batch.size += MpiBatchAlign (MPI_PACKET_HEADER_SIZE + serializedSize);
+  batch.nPackets++;
+}
+
+uint32_t
+MpiBatchBuffers::GetNPackets (uint32_t rank) const
+{
+  NS_ASSERT (rank < m_batches.size ());
+  return m_batches[rank].nPackets;
+}
+
+uint32_t
+MpiBatchBuffers::Send (uint32_t rank, uint64_t guarantee)
+{
+  NS_LOG_FUNCTION (this << rank << guarantee);
+  NS_ASSERT (rank < m_batches.size ());
+  Batch &batch = m_batches[rank];
+  if (batch.buffer == 0)
+    {
+      batch.buffer = GetBuffer ();
+    }
+  uint64_t* pTime = reinterpret_cast<uint64_t *> (batch.buffer);
+  *pTime++ = guarantee;
+  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
+  *pData++ = batch.nPackets;
+  *pData++ = 0;
+
+  uint32_t nPackets = batch.nPackets;
+#ifdef NS3_MPI
+  m_requests.push_back (MPI_REQUEST_NULL);
+  m_pendingBuffers.push_back (batch.buffer);
+  MPI_Isend (reinterpret_cast<void *> (batch.buffer), batch.size, MPI_CHAR, rank,
+             0, MPI_COMM_WORLD, &m_requests.back ());
+#else
+  m_freeBuffers.push_back (batch.buffer);
+#endif
+  batch.buffer = 0;
+  batch.size = MPI_BATCH_HEADER_SIZE;
+  batch.nPackets = 0;
+  return nPackets;
+}
+
+uint32_t
+MpiBatchBuffers::SendAll (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nPackets = 0;
+  for (uint32_t rank = 0; rank < m_batches.size (); ++rank)
+    {
+      if (m_batches[rank].nPackets > 0)
+        {
+          nPackets += Send (rank, 0);
+        }
+    }
+  return nPackets;
+}
+
+void
+MpiBatchBuffers::TestSendComplete (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MPI
+  if (m_requests.empty ())
+    {
+      return;
+    }
+  m_completed.resize (m_requests.size ());
+  int nCompleted = 0;
+  MPI_Testsome (m_requests.size (), &m_requests[0], &nCompleted, &m_completed[0], MPI_STATUSES_IGNORE);
+  if (nCompleted <= 0)
+    {
+      return;
+    }
+  // MPI_Testsome has set the completed requests to MPI_REQUEST_NULL
+  for (int i = 0; i < nCompleted; ++i)
+    {
+      m_freeBuffers.push_back (m_pendingBuffers[m_completed[i]]);
+    }
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < m_requests.size (); ++i)
+    {
+      if (m_requests[i] != MPI_REQUEST_NULL)
+        {
+          m_requests[j] = m_requests[i];
+          m_pendingBuffers[j] = m_pendingBuffers[i];
+          ++j;
+        }
+    }
+  m_requests.resize (j);
+  m_pendingBuffers.resize (j);
+#endif
+}
+
+uint32_t
+MpiBatchBuffers::Receive (const uint8_t* buffer, int count, uint64_t* guarantee)
+{
+  NS_LOG_FUNCTION (static_cast<const void *> (buffer) << count);
+  NS_ASSERT (count >= static_cast<int> (MPI_BATCH_HEADER_SIZE));
+
+  const uint64_t* pTime = reinterpret_cast<const uint64_t *> (buffer);
+  *guarantee = *pTime++;
+  const uint32_t* pData = reinterpret_cast<const uint32_t *> (pTime);
+  uint32_t nPackets = *pData;
+
+  const uint8_t* record = buffer + MPI_BATCH_HEADER_SIZE;
+  for (uint32_t n = 0; n < nPackets; ++n)
+    {
+      // Get the meta data first
+      pTime = reinterpret_cast<const uint64_t *> (record);
+      Time rxTime (*pTime++);
+      pData = reinterpret_cast<const uint32_t *> (pTime);
+      uint32_t node = *pData++;
+      uint32_t dev  = *pData++;
+      uint32_t size = *pData++;
+      pData++;
+      NS_ASSERT (record + MPI_PACKET_HEADER_SIZE + size <= buffer + count);
+
+      Ptr<Packet> p = Create<Packet> (reinterpret_cast<const uint8_t *> (pData), size, true);
+
+      // Find the correct node/device to schedule receive event
+      Ptr<Node> pNode = NodeList::GetNode (node);
+      Ptr<MpiReceiver> pMpiRec = 0;
+      uint32_t nDevices = pNode->GetNDevices ();
+      for (uint32_t i = 0; i < nDevices; ++i)
+        {
+          Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+          if (pThisDev->GetIfIndex () == dev)
+            {
+              pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+              break;
+            }
+        }
+      NS_ASSERT (pNode && pMpiRec);
+
+      // Schedule the rx event
+      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
+                                      &MpiReceiver::Receive, pMpiRec, p);
+
+      record += MpiBatchAlign (MPI_PACKET_HEADER_SIZE + size);
+    }
+  return nPackets;
+}
+
+} // namespace ns3
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MPI_BATCH_BUFFERS_H
+#define NS3_MPI_BATCH_BUFFERS_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#ifdef NS3_MPI
+#include "mpi.h"
+#else
+typedef void* MPI_Request;
+#endif
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * maximum MPI message size, the size of the send and receive
+ * buffers
+ */
+const uint32_t MAX_MPI_MSG_SIZE = 65536;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Coalesces the packets sent to each remote task into batch messages
+ *
+ * The packets sent to a remote task are serialized one after the other in
+ * the buffer of that task, and the whole buffer is sent in one message by
+ * Send, when the communication interface decides so, or before a packet
+ * which does not fit anymore.  The buffers are taken from a pool, and go
+ * back to the pool when their non-blocking send completes.
+ *
+ * \internal
+ * A message starts with a header:
+ *
+ * uint64_t guarantee time for the Null Message algorithm, 0 otherwise
+ * uint32_t number of packets
+ * uint32_t 0
+ *
+ * followed by the packets, each one starting on a multiple of 8 bytes:
+ *
+ * uint64_t time the packet should be delivered
+ * uint32_t node id of destination
+ * uint32_t dev id on destination
+ * uint32_t size of the serialized packet
+ * uint32_t 0
+ * uint8_t[] serialized packet
+ */
+class MpiBatchBuffers
+{
+public:
+  MpiBatchBuffers ();
+  ~MpiBatchBuffers ();
+
+  /**
+   * \param size the number of tasks
+   *
+   * Sets up an empty batch for each task.
+   */
+  void Enable (uint32_t size);
+  /**
+   * Cancels the sends not completed yet.  This function must be called
+   * before MPI_Finalize, and before Destroy.
+   */
+  void Cancel (void);
+  /**
+   * Deletes all the buffers.
+   */
+  void Destroy (void);
+  /**
+   * \param rank the destination task
+   * \param serializedSize the serialized size of a packet
+   * \return true if the packet fits in the batch of the task
+   *
+   * A packet fits in an empty batch unless it is larger than
+   * MAX_MPI_MSG_SIZE, minus the headers.
+   */
+  bool HasRoom (uint32_t rank, uint32_t serializedSize) const;
+  /**
+   * \param rank the destination task
+   * \param p the packet to send
+   * \param serializedSize the serialized size of the packet
+   * \param rxTime received time at destination node
+   * \param node destination node
+   * \param dev destination device
+   *
+   * Serializes the packet at the end of the batch of the task, which
+   * must have room for it.
+   */
+  void AddPacket (uint32_t rank, Ptr<Packet> p, uint32_t serializedSize,
+                  const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * \param rank the destination task
+   * \return the number of packets in the batch of the task
+   */
+  uint32_t GetNPackets (uint32_t rank) const;
+  /**
+   * \param rank the destination task
+   * \param guarantee the guarantee time written in the header
+   * \return the number of packets sent
+   *
+   * Posts a non-blocking send of the batch of the task, even if it is
+   * empty, and starts a new batch.
+   */
+  uint32_t Send (uint32_t rank, uint64_t guarantee);
+  /**
+   * \return the number of packets sent
+   *
+   * Sends the batches which are not empty.
+   */
+  uint32_t SendAll (void);
+  /**
+   * Checks for completed sends, and puts their buffers back in the pool.
+   */
+  void TestSendComplete (void);
+  /**
+   * \param buffer a received message
+   * \param count the size of the message
+   * \param guarantee where to store the guarantee time of the message
+   * \return the number of packets of the message
+   *
+   * Schedules the reception of the packets of the message by their
+   * MpiReceiver.
+   */
+  static uint32_t Receive (const uint8_t* buffer, int count, uint64_t* guarantee);
+
+private:
+  /**
+   * A batch being filled
+   */
+  struct Batch
+  {
+    uint8_t* buffer;   //!< the buffer, 0 until the first packet is added
+    uint32_t size;     //!< the number of bytes used, headers included
+    uint32_t nPackets; //!< the number of packets
+  };
+
+  /**
+   * \return a buffer of MAX_MPI_MSG_SIZE bytes from the pool
+   */
+  uint8_t* GetBuffer (void);
+
+  /// The batch of each task
+  std::vector<Batch> m_batches;
+  /// The buffers not in use
+  std::vector<uint8_t*> m_freeBuffers;
+  /// The requests of the pending sends
+  std::vector<MPI_Request> m_requests;
+  /// The buffers of the pending sends, in the order of m_requests
+  std::vector<uint8_t*> m_pendingBuffers;
+  /// The indices of the completed sends, for MPI_Testsome
+  std::vector<int> m_completed;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MPI_BATCH_BUFFERS_H */
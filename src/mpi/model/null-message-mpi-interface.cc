@@ -39,55 +39,17 @@
 
 #include <iostream>
 #include <iomanip>
-#include <list>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NullMessageMpiInterface");
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-#ifdef NS3_MPI
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
-#endif
-
-NullMessageSentBuffer::NullMessageSentBuffer ()
-{
-  m_buffer = 0;
-  m_request = 0;
-}
-
-NullMessageSentBuffer::~NullMessageSentBuffer ()
-{
-  delete [] m_buffer;
-}
-
-uint8_t*
-NullMessageSentBuffer::GetBuffer ()
-{
-  return m_buffer;
-}
-
-void
-NullMessageSentBuffer::SetBuffer (uint8_t* buffer)
-{
-  m_buffer = buffer;
-}
-
-MPI_Request*
-NullMessageSentBuffer::GetRequest ()
-{
-  return &m_request;
-}
-
 uint32_t              NullMessageMpiInterface::g_sid = 0;
 uint32_t              NullMessageMpiInterface::g_size = 1;
 uint32_t              NullMessageMpiInterface::g_numNeighbors = 0;
 bool                  NullMessageMpiInterface::g_initialized = false;
 bool                  NullMessageMpiInterface::g_enabled = false;
-std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
+MpiBatchBuffers       NullMessageMpiInterface::g_batches;
 
 MPI_Request* NullMessageMpiInterface::g_requests;
 char**       NullMessageMpiInterface::g_pRxBuffers;
@@ -174,6 +136,7 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers(void)
   NS_ASSERT (g_enabled);
 
   g_numNeighbors = RemoteChannelBundleManager::Size();
+  g_batches.Enable (g_size);
 
   // Post a non-blocking receive for all peers
   g_requests = new MPI_Request[g_numNeighbors];
@@ -184,8 +147,8 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers(void)
       Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
       if (bundle) 
         {
-          g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, rank, 0,
+          g_pRxBuffers[index] = new char[MAX_MPI_MSG_SIZE];
+          MPI_Irecv (g_pRxBuffers[index], MAX_MPI_MSG_SIZE, MPI_CHAR, rank, 0,
                      MPI_COMM_WORLD, &g_requests[index]);
           ++index;
         }
@@ -206,32 +169,13 @@ NullMessageMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t
   Ptr<Node> destNode = NodeList::GetNode (node);
   uint32_t nodeSysId = destNode->GetSystemId ();
 
-  NullMessageSentBuffer sendBuf;
-  g_pendingTx.push_back (sendBuf);
-  std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
-
   uint32_t serializedSize = p->GetSerializedSize ();
-  uint32_t bufferSize = serializedSize + ( 2 * sizeof (uint64_t) ) + ( 2 * sizeof (uint32_t) );
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
-
-  Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
-  *pTime++ = guarantee_update.GetTimeStep ();
-
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
-
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (iter->GetRequest ()));
-
-  NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+  if (!g_batches.HasRoom (nodeSysId, serializedSize))
+    {
+      Time guaranteeUpdate = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
+      g_batches.Send (nodeSysId, guaranteeUpdate.GetTimeStep ());
+    }
+  g_batches.AddPacket (nodeSysId, p, serializedSize, rxTime, node, dev);
 
 #endif
 }
@@ -245,26 +189,29 @@ NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<Remo
 
 #ifdef NS3_MPI
 
-  NullMessageSentBuffer sendBuf;
-  g_pendingTx.push_back (sendBuf);
-  std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
-
-  uint32_t bufferSize = 2 * sizeof (uint64_t) + 2 * sizeof (uint32_t);
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = 0;
-  *pTime++ = guarantee_update.GetInteger ();
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = 0;
-  *pData++ = 0;
-
   // Find the system id for the destination MPI rank
   uint32_t nodeSysId = bundle->GetSystemId ();
 
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (iter->GetRequest ()));
+  g_batches.Send (nodeSysId, guarantee_update.GetInteger ());
+#endif
+}
+
+void
+NullMessageMpiInterface::SendPendingPackets (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  NS_ASSERT (g_enabled);
+
+#ifdef NS3_MPI
+  for (uint32_t rank = 0; rank < g_size; ++rank)
+    {
+      if (g_batches.GetNPackets (rank) > 0)
+        {
+          Time guaranteeUpdate = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (rank);
+          g_batches.Send (rank, guaranteeUpdate.GetTimeStep ());
+        }
+    }
 #endif
 }
 
@@ -327,44 +274,9 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
           int count;
           MPI_Get_count (&status, MPI_CHAR, &count);
 
-          // Get the meta data first
-          uint64_t* pTime = reinterpret_cast<uint64_t *> (g_pRxBuffers[index]);
-          uint64_t time = *pTime++;
-          uint64_t guaranteeUpdate = *pTime++;
-
-          uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-          uint32_t node = *pData++;
-          uint32_t dev  = *pData++;
-
-          Time rxTime (time);
-
-          // rxtime == 0 means this is a Null Message
-          if (rxTime > Time (0))
-            {
-              count -= sizeof (time) + sizeof (guaranteeUpdate) + sizeof (node) + sizeof (dev);
-
-              Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-              // Find the correct node/device to schedule receive event
-              Ptr<Node> pNode = NodeList::GetNode (node);
-              Ptr<MpiReceiver> pMpiRec = 0;
-              uint32_t nDevices = pNode->GetNDevices ();
-              for (uint32_t i = 0; i < nDevices; ++i)
-                {
-                  Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-                  if (pThisDev->GetIfIndex () == dev)
-                    {
-                      pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-                      break;
-                    }
-                }
-              NS_ASSERT (pNode && pMpiRec);
-
-              // Schedule the rx event
-              Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                              &MpiReceiver::Receive, pMpiRec, p);
-
-            }
+          // Schedule the rx events of the packets of the message
+          uint64_t guaranteeUpdate;
+          MpiBatchBuffers::Receive (reinterpret_cast<uint8_t *> (g_pRxBuffers[index]), count, &guaranteeUpdate);
 
           // Update guarantee time for both packet receives and Null Messages.
           Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (status.MPI_SOURCE);
@@ -373,7 +285,7 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
           bundle->SetGuaranteeTime (Time (guaranteeUpdate));
 
           // Re-queue the next read
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
+          MPI_Irecv (g_pRxBuffers[index], MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
                      MPI_COMM_WORLD, &g_requests[index]);
 
         }
@@ -395,19 +307,7 @@ NullMessageMpiInterface::TestSendComplete ()
   NS_ASSERT (g_enabled);
 
 #ifdef NS3_MPI
-  std::list<NullMessageSentBuffer>::iterator iter = g_pendingTx.begin ();
-  while (iter != g_pendingTx.end ())
-    {
-      MPI_Status status;
-      int flag = 0;
-      MPI_Test (iter->GetRequest (), &flag, &status);
-      std::list<NullMessageSentBuffer>::iterator current = iter; // Save current for erasing
-      ++iter; // Advance to next
-      if (flag)
-        { // This message is complete
-          g_pendingTx.erase (current);
-        }
-    }
+  g_batches.TestSendComplete ();
 #endif
 }
 
@@ -422,13 +322,7 @@ NullMessageMpiInterface::Disable ()
   if (flag)
     {
 
-      for (std::list<NullMessageSentBuffer>::iterator iter = g_pendingTx.begin ();
-           iter != g_pendingTx.end ();
-           ++iter)
-        {
-          MPI_Cancel (iter->GetRequest ());
-          MPI_Request_free (iter->GetRequest ());
-        }
+      g_batches.Cancel ();
 
       for (uint32_t i = 0; i < g_numNeighbors; ++i)
         {
@@ -445,7 +339,7 @@ NullMessageMpiInterface::Disable ()
       delete [] g_pRxBuffers;
       delete [] g_requests;
 
-      g_pendingTx.clear ();
+      g_batches.Destroy ();
 
       g_enabled = false;
       g_initialized = false;
@@ -27,58 +27,13 @@
 #include <ns3/nstime.h>
 #include <ns3/buffer.h>
 
-#ifdef NS3_MPI
-#include "mpi.h"
-#else
-typedef void* MPI_Request;
-#endif
-
-#include <list>
+#include "mpi-batch-buffers.h"
 
 namespace ns3 {
 
 class RemoteChannelBundle;
 class Packet;
 
-/**
- * \ingroup mpi
- *
- * \brief Non-blocking send buffers for Null Message implementation.
- * 
- * One buffer is allocated for each non-blocking send.
- */
-class NullMessageSentBuffer
-{
-public:
-  NullMessageSentBuffer ();
-  ~NullMessageSentBuffer ();
-
-  /**
-   * \return pointer to sent buffer
-   */
-  uint8_t* GetBuffer ();
-  /**
-   * \param buffer pointer to sent buffer
-   */
-  void SetBuffer (uint8_t* buffer);
-  /**
-   * \return MPI request
-   */
-  MPI_Request* GetRequest ();
-
-private:
-
-  /**
-   * Buffer for send.
-   */
-  uint8_t* m_buffer;
-
-  /**
-   * MPI request posted for the send.
-   */
-  MPI_Request m_request;
-};
-
 /**
  * \ingroup mpi
  *
@@ -128,16 +83,10 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device.
-   *
-   * \internal
-   * The MPI buffer format packs a delivery information and the serialized packet.
-   *
-   * uint64_t time the packed should be delivered
-   * uint64_t guarantee time for the Null Message algorithm.
-   * uint32_t node id of destination
-   * unit32_t dev id on destination
-   * uint8_t[] serialized packet
+   * Serialize a packet for the specified node and net device.  The
+   * packets sent to a task are coalesced in one message, sent with the
+   * next Null Message to the task, or before the task blocks waiting for
+   * messages.  See MpiBatchBuffers for the message format.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
   /**
@@ -150,21 +99,23 @@ public:
    * possible event from this MPI task to the remote MPI task across
    * the bundle.  Remote task may execute events up to time.
    *
-   * Null Messages are sent when a packet has not been sent across
-   * this bundle in order to allow time advancement on the remote
-   * MPI task.
+   * Null Messages are sent periodically across each bundle in order
+   * to allow time advancement on the remote MPI task.  They carry the
+   * packets sent across the bundle since the previous message.
    *
    * \internal
-   * The Null Message MPI buffer format is based on the format for sending a packet with
-   * several fields set to 0 to signal that it is a Null Message.  Overloading the normal packet
-   * format simplifies receive logic.
-   *
-   * uint64_t 0 must be zero for Null Message
-   * uint64_t guarantee time
-   * uint32_t 0 must be zero for Null Message
-   * uint32_t 0 must be zero for Null Message
+   * A Null Message is a message of packets, possibly empty.  A
+   * message with a guarantee time must carry all the packets sent
+   * before, as the remote task may execute events up to that time.
    */
   static void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+  /**
+   * Send a Null Message with the pending packets across each bundle
+   * which has some.  Must be called before blocking on
+   * ReceiveMessagesBlocking, as the remote tasks may be waiting for
+   * these packets.
+   */
+  static void SendPendingPackets (void);
   /**
    * Non-blocking check for received messages complete.  Will
    * receive all messages that are queued up locally.
@@ -217,8 +168,8 @@ private:
   // Data buffers for non-blocking receives
   static char**   g_pRxBuffers;
 
-  // List of pending non-blocking sends
-  static std::list<NullMessageSentBuffer> g_pendingTx;
+  // Packets to send, and pending non-blocking sends
+  static MpiBatchBuffers g_batches;
 };
 
 } // namespace ns3
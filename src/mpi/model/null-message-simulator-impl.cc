@@ -342,6 +342,9 @@ NullMessageSimulatorImpl::HandleArrivingMessagesBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
+  // The remote tasks may be waiting for the packets of their batches
+  NullMessageMpiInterface::SendPendingPackets ();
+
   NullMessageMpiInterface::ReceiveMessagesBlocking ();
 
   CalculateSafeTime ();
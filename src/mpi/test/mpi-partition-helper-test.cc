@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/string.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/mpi-partition-helper.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * \brief Test the partition of a grid of point-to-point links with CSMA
+ * islands
+ *
+ * The nodes of a grid are linked to their neighbors by point-to-point
+ * links of various delays.  Some blocks of nodes are also linked by a CSMA
+ * channel, and some nodes of the diagonal by point-to-point links shorter
+ * than the minimum lookahead, which may not be cut either.  The test checks
+ * that these channels are not cut, that the load of each rank is within
+ * the imbalance, and that the cut weight and the lookahead of each rank
+ * are the ones of the assignment of the nodes.
+ */
+class MpiPartitionHelperTest : public TestCase
+{
+public:
+  /**
+   * \param nPartitions the number of ranks
+   */
+  MpiPartitionHelperTest (uint32_t nPartitions);
+
+  virtual void DoRun (void);
+
+private:
+  uint32_t m_nPartitions; //!< the number of ranks
+};
+
+/**
+ * \param nPartitions the number of ranks
+ * \return the name of the test
+ */
+static std::string
+GetTestName (uint32_t nPartitions)
+{
+  std::ostringstream oss;
+  oss << "Partition of a grid with CSMA islands into " << nPartitions << " ranks";
+  return oss.str ();
+}
+
+MpiPartitionHelperTest::MpiPartitionHelperTest (uint32_t nPartitions)
+  : TestCase (GetTestName (nPartitions)),
+    m_nPartitions (nPartitions)
+{
+}
+
+void
+MpiPartitionHelperTest::DoRun (void)
+{
+  const uint32_t size = 8;
+  const Time minLookAhead = MilliSeconds (1);
+  const double imbalance = 1.1;
+
+  NodeContainer nodes;
+  nodes.Create (size * size);
+  MpiPartitionHelper partition;
+  partition.SetMinLookAhead (minLookAhead);
+  partition.SetImbalance (imbalance);
+
+  // the grid, with delays from 1 to 3 ms, and heavier channels on the middle row
+  PointToPointHelper p2p;
+  std::set<uint32_t> heavy;
+  for (uint32_t r = 0; r < size; ++r)
+    {
+      for (uint32_t c = 0; c < size; ++c)
+        {
+          std::ostringstream delay;
+          delay << 1 + (r + 2 * c) % 3 << "ms";
+          p2p.SetChannelAttribute ("Delay", StringValue (delay.str ()));
+          if (c + 1 < size)
+            {
+              NetDeviceContainer devices = p2p.Install (nodes.Get (r * size + c), nodes.Get (r * size + c + 1));
+              if (r == size / 2)
+                {
+                  heavy.insert (devices.Get (0)->GetChannel ()->GetId ());
+                  partition.SetChannelWeight (devices.Get (0)->GetChannel ()->GetId (), 5);
+                }
+            }
+          if (r + 1 < size)
+            {
+              p2p.Install (nodes.Get (r * size + c), nodes.Get ((r + 1) * size + c));
+            }
+        }
+    }
+
+  // links shorter than the lookahead along a part of the diagonal
+  p2p.SetChannelAttribute ("Delay", StringValue ("500us"));
+  for (uint32_t i = 4; i + 1 < size; ++i)
+    {
+      p2p.Install (nodes.Get (i * size + i), nodes.Get ((i + 1) * size + i + 1));
+    }
+
+  // CSMA islands of 2x2 nodes
+  CsmaHelper csma;
+  uint32_t corners[] = { 0, 2, 5 * size + 1, 3 * size + 5 };
+  for (uint32_t k = 0; k < sizeof (corners) / sizeof (corners[0]); ++k)
+    {
+      NodeContainer island;
+      island.Add (nodes.Get (corners[k]));
+      island.Add (nodes.Get (corners[k] + 1));
+      island.Add (nodes.Get (corners[k] + size));
+      island.Add (nodes.Get (corners[k] + size + 1));
+      csma.Install (island);
+    }
+
+  // a few heavier nodes
+  partition.SetNodeWeight (size - 1, 10);
+  partition.SetNodeWeight (size * size - 1, 8);
+
+  partition.Partition (m_nPartitions);
+
+  NS_TEST_ASSERT_MSG_EQ (partition.GetSystemIds ().size (), size * size, "Every node has a system id");
+
+  // the load of each rank
+  std::vector<double> load (m_nPartitions, 0);
+  double total = 0;
+  for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      uint32_t systemId = partition.GetSystemId (i);
+      NS_TEST_ASSERT_MSG_LT (systemId, m_nPartitions, "System id of node " << i);
+      double weight = 1 + node->GetNDevices () + node->GetNApplications ();
+      if (i == size - 1)
+        {
+          weight = 10;
+        }
+      else if (i == size * size - 1)
+        {
+          weight = 8;
+        }
+      load[systemId] += weight;
+      total += weight;
+    }
+  for (uint32_t r = 0; r < m_nPartitions; ++r)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (partition.GetLoad (r), load[r], 1e-9, "Load of rank " << r);
+      NS_TEST_EXPECT_MSG_LT_OR_EQ (load[r], imbalance * total / m_nPartitions, "Imbalance of rank " << r);
+    }
+
+  // the channels which may not be cut, the cut weight and the lookahead
+  double cutWeight = 0;
+  std::vector<Time> lookAhead (m_nPartitions, Time::Max ());
+  for (uint32_t c = 0; c < ChannelList::GetNChannels (); ++c)
+    {
+      Ptr<Channel> channel = ChannelList::GetChannel (c);
+      uint32_t first = partition.GetSystemId (channel->GetDevice (0)->GetNode ()->GetId ());
+      TimeValue delay;
+      bool cuttable = channel->GetNDevices () == 2 && channel->GetDevice (0)->IsPointToPoint ()
+        && channel->GetAttributeFailSafe ("Delay", delay) && delay.Get () >= minLookAhead;
+      for (uint32_t k = 1; k < channel->GetNDevices (); ++k)
+        {
+          uint32_t other = partition.GetSystemId (channel->GetDevice (k)->GetNode ()->GetId ());
+          if (!cuttable)
+            {
+              NS_TEST_EXPECT_MSG_EQ (other, first, "Channel " << c << " may not be cut");
+            }
+          else if (other != first)
+            {
+              cutWeight += heavy.count (c) ? 5 : 1;
+              lookAhead[first] = std::min (lookAhead[first], delay.Get ());
+              lookAhead[other] = std::min (lookAhead[other], delay.Get ());
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (partition.GetCutWeight (), cutWeight, 1e-9, "Cut weight");
+  NS_TEST_EXPECT_MSG_GT (cutWeight, 0, "Some channels are cut");
+  for (uint32_t r = 0; r < m_nPartitions; ++r)
+    {
+      NS_TEST_EXPECT_MSG_EQ (partition.GetLookAhead (r), lookAhead[r], "Lookahead of rank " << r);
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (partition.GetLookAhead (r), minLookAhead, "Lookahead of rank " << r);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test the imbalance of a partition into 4 ranks
+ *
+ * The nodes have unit weights and form a chain of four rings, whose
+ * sizes are balanced within the imbalance by pairs but not one by one.
+ * Assigning one ring to each rank cuts the fewest channels, but the load
+ * of the largest ring exceeds the imbalance, so the partition must split
+ * it: the imbalances of the two levels of bisection may not add up to
+ * more than the imbalance set.
+ */
+class MpiPartitionHelperImbalanceTest : public TestCase
+{
+public:
+  MpiPartitionHelperImbalanceTest ();
+
+  virtual void DoRun (void);
+};
+
+MpiPartitionHelperImbalanceTest::MpiPartitionHelperImbalanceTest ()
+  : TestCase ("Imbalance of a partition of rings into 4 ranks")
+{
+}
+
+void
+MpiPartitionHelperImbalanceTest::DoRun (void)
+{
+  const uint32_t nPartitions = 4;
+  const double imbalance = 1.01;
+  uint32_t sizes[] = { 507, 497, 498, 498 };
+
+  NodeContainer nodes;
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  uint32_t first = 0;
+  for (uint32_t r = 0; r < sizeof (sizes) / sizeof (sizes[0]); ++r)
+    {
+      nodes.Create (sizes[r]);
+      for (uint32_t i = 0; i < sizes[r]; ++i)
+        {
+          p2p.Install (nodes.Get (first + i), nodes.Get (first + (i + 1) % sizes[r]));
+        }
+      if (r > 0)
+        {
+          p2p.Install (nodes.Get (first - sizes[r - 1] / 2), nodes.Get (first));
+        }
+      first += sizes[r];
+    }
+
+  MpiPartitionHelper partition;
+  partition.SetImbalance (imbalance);
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      partition.SetNodeWeight (i, 1);
+    }
+  partition.Partition (nPartitions);
+
+  double average = static_cast<double> (nodes.GetN ()) / nPartitions;
+  for (uint32_t r = 0; r < nPartitions; ++r)
+    {
+      NS_TEST_EXPECT_MSG_LT_OR_EQ (partition.GetLoad (r), imbalance * average, "Imbalance of rank " << r);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief TestSuite for the MpiPartitionHelper
+ */
+class MpiPartitionHelperTestSuite : public TestSuite
+{
+public:
+  MpiPartitionHelperTestSuite ();
+};
+
+MpiPartitionHelperTestSuite::MpiPartitionHelperTestSuite ()
+  : TestSuite ("mpi-partition-helper", UNIT)
+{
+  AddTestCase (new MpiPartitionHelperTest (2), TestCase::QUICK);
+  AddTestCase (new MpiPartitionHelperTest (3), TestCase::QUICK);
+  AddTestCase (new MpiPartitionHelperTest (4), TestCase::QUICK);
+  AddTestCase (new MpiPartitionHelperImbalanceTest, TestCase::QUICK);
+}
+
+static MpiPartitionHelperTestSuite g_mpiPartitionHelperTestSuite;
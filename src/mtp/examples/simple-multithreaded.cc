@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * SimpleMultithreaded creates a dumbbell topology of point-to-point
+ * links and runs it with the MultithreadedSimulatorImpl:
+ *
+ * n0 ---------|                       |---------- n6
+ *             |                       |
+ * n1 -------\ |                       | /------- n7
+ *            n4 -------------------- n5
+ * n2 -------/ |                       | \------- n8
+ *             |                       |
+ * n3 ---------|                       |---------- n9
+ *
+ * Every node is a partition of its own, and the partitions are spread
+ * over "threads" threads. OnOff clients are placed on each left leaf
+ * node, and each right leaf node is a packet sink for a left leaf node.
+ * When a packet crosses a link between two partitions, it is serialized
+ * by the sending thread and a copy is deserialized by the receiving one.
+ *
+ * Run it with --multithreaded=0 to get the same results with the
+ * DefaultSimulatorImpl.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SimpleMultithreaded");
+
+int
+main (int argc, char *argv[])
+{
+  bool multithreaded = true;
+  uint32_t threads = 0;
+  uint32_t leaves = 4;
+
+  CommandLine cmd;
+  cmd.AddValue ("multithreaded", "Use the MultithreadedSimulatorImpl", multithreaded);
+  cmd.AddValue ("threads", "Number of threads, zero for one per processor", threads);
+  cmd.AddValue ("leaves", "Number of leaf nodes on each side", leaves);
+  cmd.Parse (argc, argv);
+
+  if (multithreaded)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::MultithreadedSimulatorImpl"));
+      Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount",
+                          UintegerValue (threads));
+    }
+
+  Config::SetDefault ("ns3::OnOffApplication::PacketSize", UintegerValue (512));
+  Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue ("1Mbps"));
+  Config::SetDefault ("ns3::OnOffApplication::MaxBytes", UintegerValue (51200));
+
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer leftLeaves;
+  leftLeaves.Create (leaves);
+  NodeContainer rightLeaves;
+  rightLeaves.Create (leaves);
+
+  PointToPointHelper routerLink;
+  routerLink.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  routerLink.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  PointToPointHelper leafLink;
+  leafLink.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  leafLink.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  NetDeviceContainer routerDevices = routerLink.Install (routers);
+  std::vector<NetDeviceContainer> leftDevices (leaves);
+  std::vector<NetDeviceContainer> rightDevices (leaves);
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      leftDevices[i] = leafLink.Install (routers.Get (0), leftLeaves.Get (i));
+      rightDevices[i] = leafLink.Install (routers.Get (1), rightLeaves.Get (i));
+    }
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (routerDevices);
+  std::vector<Ipv4InterfaceContainer> rightInterfaces (leaves);
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      std::ostringstream subnet;
+      subnet << "10.1." << i + 2 << ".0";
+      address.SetBase (subnet.str ().c_str (), "255.255.255.0");
+      address.Assign (leftDevices[i]);
+      subnet.str ("");
+      subnet << "10.2." << i + 2 << ".0";
+      address.SetBase (subnet.str ().c_str (), "255.255.255.0");
+      rightInterfaces[i] = address.Assign (rightDevices[i]);
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 50000;
+  ApplicationContainer sinks;
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory",
+                                   InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.Add (sinkHelper.Install (rightLeaves.Get (i)));
+
+      OnOffHelper clientHelper ("ns3::UdpSocketFactory",
+                                InetSocketAddress (rightInterfaces[i].GetAddress (1), port));
+      clientHelper.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      clientHelper.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      ApplicationContainer client = clientHelper.Install (leftLeaves.Get (i));
+      client.Start (Seconds (1.0 + 0.01 * i));
+      client.Stop (Seconds (5));
+    }
+  sinks.Start (Seconds (0));
+  sinks.Stop (Seconds (5));
+
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      std::cout << impl->GetPartitionCount () << " partitions, lookahead "
+                << impl->GetLookAhead ().GetSeconds () << "s" << std::endl;
+    }
+  impl = 0;
+  for (uint32_t i = 0; i < leaves; ++i)
+    {
+      Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinks.Get (i));
+      std::cout << "sink " << i << " received " << sink->GetTotalRx () << " bytes" << std::endl;
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,954 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/partition-helper.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/**
+ * An event which delivers a copy of a packet to a node of another
+ * partition.
+ *
+ * The packet is serialized when the event is created, on the thread
+ * of the sending partition, and deserialized when the event is run,
+ * on the thread of the receiving partition.
+ */
+class PacketDeliveryEvent : public EventImpl
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] p The packet.
+   * \param [in] receive The receive callback.
+   */
+  PacketDeliveryEvent (Ptr<const Packet> p, Callback<void, Ptr<Packet> > receive)
+    : m_buffer (p->GetSerializedSize ()),
+      m_receive (receive)
+  {
+    p->Serialize (&m_buffer[0], m_buffer.size ());
+  }
+
+protected:
+  virtual void Notify (void)
+  {
+    Ptr<Packet> p = Create<Packet> (&m_buffer[0], m_buffer.size (), true);
+    m_receive (p);
+  }
+
+private:
+  std::vector<uint8_t> m_buffer;            //!< The serialized packet.
+  Callback<void, Ptr<Packet> > m_receive;   //!< The receive callback.
+};
+
+/**
+ * Get the propagation delay of a channel which may be cut between
+ * two partitions.
+ *
+ * \param [in] device A device attached to the channel.
+ * \param [out] delay The channel delay, in time steps.
+ * \returns \c true if the channel is point-to-point with a non-zero delay.
+ */
+bool
+GetCutDelay (Ptr<NetDevice> device, uint64_t &delay)
+{
+  Ptr<Channel> channel = device->GetChannel ();
+  if (channel == 0 || !device->IsPointToPoint ())
+    {
+      return false;
+    }
+  TimeValue value;
+  if (!channel->GetAttributeFailSafe ("Delay", value)
+      || !value.Get ().IsStrictlyPositive ())
+    {
+      return false;
+    }
+  delay = value.Get ().GetTimeStep ();
+  return true;
+}
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mtp")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "The maximum number of partitions, each one run by its "
+                   "own thread. Zero means one per online processor. This "
+                   "is ignored if the nodes have system ids.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_startCond, 0);
+  pthread_cond_init (&m_doneCond, 0);
+  pthread_key_create (&m_current, 0);
+#else
+  NS_FATAL_ERROR ("Can't use multithreaded simulator without pthreads");
+#endif
+
+  InitPartition (m_global);
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_global.uid = 4;
+  m_partitioned = false;
+  m_threadCount = 0;
+  m_lookAhead = GetMaximumSimulationTime ().GetTimeStep ();
+  m_maxLookAhead = m_lookAhead;
+  m_windowEnd = 0;
+  m_windows = 0;
+  m_stop = false;
+  m_nextWorker = 1;
+  m_round = 0;
+  m_running = 0;
+  m_exit = false;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  pthread_key_delete (m_current);
+  pthread_cond_destroy (&m_doneCond);
+  pthread_cond_destroy (&m_startCond);
+  pthread_mutex_destroy (&m_mutex);
+#endif
+}
+
+void
+MultithreadedSimulatorImpl::InitPartition (Partition &partition)
+{
+  partition.events = 0;
+  partition.uid = 0;
+  partition.currentUid = 0;
+  partition.currentTs = 0;
+  partition.currentContext = Simulator::NO_CONTEXT;
+  partition.unscheduledEvents = 0;
+  partition.stop = false;
+  partition.outbox.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  StopThreads ();
+  for (uint32_t i = 0; i <= m_partitions.size (); ++i)
+    {
+      Partition *partition = i < m_partitions.size () ? &m_partitions[i] : &m_global;
+      while (partition->events != 0 && !partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      partition->events = 0;
+      for (std::vector<Outbox>::iterator j = partition->outbox.begin ();
+           j != partition->outbox.end (); ++j)
+        {
+          for (Outbox::iterator k = j->begin (); k != j->end (); ++k)
+            {
+              k->event->Unref ();
+            }
+          j->clear ();
+        }
+    }
+  m_partitions.clear ();
+  for (std::vector<Ptr<PointToPointChannel> >::iterator i = m_cutChannels.begin ();
+       i != m_cutChannels.end (); ++i)
+    {
+      (*i)->SetDeliveryCallback (PointToPointChannel::DeliveryCallback ());
+    }
+  m_cutChannels.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+
+  StopThreads ();
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+
+  m_schedulerFactory = schedulerFactory;
+  for (uint32_t i = 0; i <= m_partitions.size (); ++i)
+    {
+      Partition *partition = i < m_partitions.size () ? &m_partitions[i] : &m_global;
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (partition->events != 0)
+        {
+          while (!partition->events->IsEmpty ())
+            {
+              Scheduler::Event next = partition->events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      partition->events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetMaximumLookAhead (const Time lookAhead)
+{
+  if (lookAhead > 0)
+    {
+      NS_LOG_FUNCTION (this << lookAhead);
+      m_maxLookAhead = lookAhead.GetTimeStep ();
+    }
+  else
+    {
+      NS_LOG_WARN ("attempted to set look ahead negative: " << lookAhead);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::BuildPartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  m_nodePartition.assign (nNodes, 0);
+
+  bool useSystemId = false;
+  uint32_t nPartitions = 1;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t systemId = NodeList::GetNode (i)->GetSystemId ();
+      if (systemId != 0)
+        {
+          useSystemId = true;
+        }
+      m_nodePartition[i] = systemId;
+      nPartitions = std::max (nPartitions, systemId + 1);
+    }
+
+  if (!useSystemId)
+    {
+      uint32_t threadCount = m_threadCount;
+      if (threadCount == 0)
+        {
+          threadCount = std::max (sysconf (_SC_NPROCESSORS_ONLN), 1L);
+        }
+      // Split the topology into balanced, connected pieces with few cut
+      // links, and drop the partitions which got no node.
+      PartitionHelper partition;
+      partition.Partition (threadCount);
+      std::vector<int32_t> index (threadCount, -1);
+      nPartitions = 0;
+      for (uint32_t i = 0; i < nNodes; ++i)
+        {
+          uint32_t part = partition.GetSystemId (i);
+          if (index[part] < 0)
+            {
+              index[part] = nPartitions++;
+            }
+          m_nodePartition[i] = index[part];
+        }
+      nPartitions = std::max (nPartitions, 1U);
+    }
+
+  // The lookahead is the smallest delay of the channels cut between
+  // two partitions, which deliver their packets through SendPacket.
+  m_lookAhead = m_maxLookAhead;
+  for (uint32_t c = 0; c < ChannelList::GetNChannels (); ++c)
+    {
+      Ptr<Channel> channel = ChannelList::GetChannel (c);
+      bool cut = false;
+      for (uint32_t k = 1; k < channel->GetNDevices (); ++k)
+        {
+          cut |= m_nodePartition[channel->GetDevice (k)->GetNode ()->GetId ()]
+            != m_nodePartition[channel->GetDevice (0)->GetNode ()->GetId ()];
+        }
+      if (!cut)
+        {
+          continue;
+        }
+      Ptr<PointToPointChannel> p2p = DynamicCast<PointToPointChannel> (channel);
+      uint64_t delay;
+      if (p2p == 0 || !GetCutDelay (channel->GetDevice (0), delay))
+        {
+          NS_FATAL_ERROR ("Channel " << c << " is between two partitions but is not "
+                          "a point-to-point channel with a delay");
+        }
+      m_lookAhead = std::min (m_lookAhead, delay);
+      p2p->SetDeliveryCallback (MakeCallback (&MultithreadedSimulatorImpl::SendPacket, this));
+      m_cutChannels.push_back (p2p);
+    }
+
+  // Each event list has its own uid counter, since the event list of
+  // an EventId is found from its context. The partitions start after
+  // the uids already allocated, so that EventIds stay valid when their
+  // event moves from the global event list to a partition.
+  m_partitions.resize (nPartitions);
+  for (uint32_t i = 0; i < nPartitions; ++i)
+    {
+      Partition &partition = m_partitions[i];
+      InitPartition (partition);
+      partition.events = m_schedulerFactory.Create<Scheduler> ();
+      partition.uid = m_global.uid;
+      partition.currentTs = m_global.currentTs;
+      partition.outbox.resize (nPartitions + 1);
+    }
+  m_global.outbox.resize (nPartitions + 1);
+  m_partitioned = true;
+
+  // Move the events scheduled so far to their partition.
+  Ptr<Scheduler> global = m_schedulerFactory.Create<Scheduler> ();
+  while (!m_global.events->IsEmpty ())
+    {
+      Scheduler::Event ev = m_global.events->RemoveNext ();
+      Partition *partition = GetPartitionOf (ev.key.m_context);
+      if (partition == &m_global)
+        {
+          global->Insert (ev);
+        }
+      else
+        {
+          partition->events->Insert (ev);
+          partition->unscheduledEvents++;
+          m_global.unscheduledEvents--;
+        }
+    }
+  m_global.events = global;
+
+  NS_LOG_INFO (nNodes << " nodes in " << nPartitions << " partitions, lookahead " <<
+               TimeStep (m_lookAhead));
+}
+
+void
+MultithreadedSimulatorImpl::StartThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_exit = false;
+  m_nextWorker = 1;
+  m_round = 0;
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      Ptr<SystemThread> thread =
+        Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::WorkerRun, this));
+      thread->Start ();
+      m_threads.push_back (thread);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StopThreads (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_threads.empty ())
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  m_exit = true;
+  pthread_cond_broadcast (&m_startCond);
+  pthread_mutex_unlock (&m_mutex);
+#endif
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin ();
+       i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_threads.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::WorkerRun (void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  Partition *partition = &m_partitions[m_nextWorker++];
+  pthread_mutex_unlock (&m_mutex);
+  SetCurrentPartition (partition);
+
+  // StartThreads resets the window number, and the first window may
+  // have been started before this thread got to run.
+  uint32_t round = 0;
+  while (true)
+    {
+      pthread_mutex_lock (&m_mutex);
+      while (m_round == round && !m_exit)
+        {
+          pthread_cond_wait (&m_startCond, &m_mutex);
+        }
+      if (m_exit)
+        {
+          pthread_mutex_unlock (&m_mutex);
+          return;
+        }
+      round = m_round;
+      pthread_mutex_unlock (&m_mutex);
+
+      ProcessWindow (partition);
+
+      pthread_mutex_lock (&m_mutex);
+      m_running--;
+      if (m_running == 0)
+        {
+          pthread_cond_signal (&m_doneCond);
+        }
+      pthread_mutex_unlock (&m_mutex);
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow (void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  m_running = m_threads.size ();
+  m_round++;
+  pthread_cond_broadcast (&m_startCond);
+  pthread_mutex_unlock (&m_mutex);
+
+  // The main thread runs the first partition.
+  SetCurrentPartition (&m_partitions[0]);
+  ProcessWindow (&m_partitions[0]);
+  SetCurrentPartition (&m_global);
+
+  pthread_mutex_lock (&m_mutex);
+  while (m_running != 0)
+    {
+      pthread_cond_wait (&m_doneCond, &m_mutex);
+    }
+  pthread_mutex_unlock (&m_mutex);
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition *partition)
+{
+  while (!partition->stop
+         && !partition->events->IsEmpty ()
+         && partition->events->PeekNext ().key.m_ts < m_windowEnd)
+    {
+      ProcessOneEvent (partition);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DeliverEvents (void)
+{
+  for (uint32_t i = 0; i <= m_partitions.size (); ++i)
+    {
+      Partition *source = i < m_partitions.size () ? &m_partitions[i] : &m_global;
+      for (uint32_t j = 0; j < source->outbox.size (); ++j)
+        {
+          Outbox &outbox = source->outbox[j];
+          Partition *destination = j < m_partitions.size () ? &m_partitions[j] : &m_global;
+          for (Outbox::const_iterator k = outbox.begin (); k != outbox.end (); ++k)
+            {
+              Insert (destination, k->ts, k->context, k->event);
+            }
+          outbox.clear ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->currentTs);
+  partition->unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  partition->currentTs = next.key.m_ts;
+  partition->currentContext = next.key.m_context;
+  partition->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+Scheduler::Event
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint64_t ts,
+                                    uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition->uid;
+  partition->uid++;
+  partition->unscheduledEvents++;
+  partition->events->Insert (ev);
+  return ev;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::NextTs (const Partition *partition) const
+{
+  if (partition->events->IsEmpty ())
+    {
+      return GetMaximumSimulationTime ().GetTimeStep ();
+    }
+  return partition->events->PeekNext ().key.m_ts;
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+#ifdef HAVE_PTHREAD_H
+  Partition *partition = static_cast<Partition *> (pthread_getspecific (m_current));
+  if (partition != 0)
+    {
+      return partition;
+    }
+#endif
+  return const_cast<Partition *> (&m_global);
+}
+
+void
+MultithreadedSimulatorImpl::SetCurrentPartition (Partition *partition)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_setspecific (m_current, partition);
+#endif
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartitionOf (uint32_t context) const
+{
+  if (!m_partitioned || context >= m_nodePartition.size ())
+    {
+      return const_cast<Partition *> (&m_global);
+    }
+  return const_cast<Partition *> (&m_partitions[m_nodePartition[context]]);
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetOwnerOf (const EventId &id) const
+{
+  Partition *caller = GetCurrentPartition ();
+  if (id.PeekEventImpl () == 0)
+    {
+      return caller;
+    }
+  // Destroy events belong to the main thread.
+  Partition *owner = id.GetUid () == 2 ? const_cast<Partition *> (&m_global)
+    : GetPartitionOf (id.GetContext ());
+  if (caller != &m_global && caller != owner)
+    {
+      NS_FATAL_ERROR ("Event of context " << id.GetContext () << " accessed from "
+                      "context " << caller->currentContext << " which is run by "
+                      "another thread");
+    }
+  return owner;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      if (!m_partitions[i].events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return m_global.events->IsEmpty ();
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_partitioned)
+    {
+      BuildPartitions ();
+    }
+  // The packet free lists are not thread-safe: they are disabled while
+  // several partitions run, and enabled again at the end of the run.
+  bool freeLists = m_partitions.size () > 1 && Packet::AreFreeListsEnabled ();
+  if (freeLists)
+    {
+      Packet::DisableFreeLists ();
+    }
+  if (m_threads.empty ())
+    {
+      StartThreads ();
+    }
+  SetCurrentPartition (&m_global);
+  m_stop = false;
+  m_global.stop = false;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      m_partitions[i].stop = false;
+    }
+
+  uint64_t infinity = GetMaximumSimulationTime ().GetTimeStep ();
+  while (true)
+    {
+      DeliverEvents ();
+      uint64_t localNext = infinity;
+      for (uint32_t i = 0; i < m_partitions.size (); ++i)
+        {
+          m_stop |= m_partitions[i].stop;
+          localNext = std::min (localNext, NextTs (&m_partitions[i]));
+        }
+      m_stop |= m_global.stop;
+      uint64_t globalNext = NextTs (&m_global);
+      if (m_stop || (localNext == infinity && globalNext == infinity))
+        {
+          break;
+        }
+
+      if (globalNext <= localNext)
+        {
+          // Global events run alone, at a time when all partitions
+          // are done with the earlier events.
+          ProcessOneEvent (&m_global);
+          continue;
+        }
+
+      if (m_lookAhead >= globalNext - localNext)
+        {
+          m_windowEnd = globalNext;
+        }
+      else
+        {
+          m_windowEnd = localNext + m_lookAhead;
+        }
+      m_windows++;
+      RunWindow ();
+    }
+
+  // Leave the global time at the latest time reached by a partition.
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      m_global.currentTs = std::max (m_global.currentTs, m_partitions[i].currentTs);
+    }
+  NS_LOG_INFO ("processed " << m_windows << " windows");
+  if (freeLists)
+    {
+      Packet::EnableFreeLists ();
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  int unscheduledEvents = m_global.unscheduledEvents;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      unscheduledEvents += m_partitions[i].unscheduledEvents;
+    }
+  NS_ASSERT (m_stop || unscheduledEvents == 0);
+  (void) unscheduledEvents;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  GetCurrentPartition ()->stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+
+  Partition *partition = GetCurrentPartition ();
+  Time tAbsolute = delay + TimeStep (partition->currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (partition->currentTs));
+  Scheduler::Event ev = Insert (partition, static_cast<uint64_t> (tAbsolute.GetTimeStep ()),
+                                partition->currentContext, event);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  Partition *source = GetCurrentPartition ();
+  Partition *destination = GetPartitionOf (context);
+  uint64_t ts = source->currentTs + delay.GetTimeStep ();
+  if (source == destination || source == &m_global)
+    {
+      // the destination is not running.
+      Insert (destination, ts, context, event);
+      return;
+    }
+  NS_ASSERT_MSG (ts >= m_windowEnd, "Event for context " << context <<
+                 " scheduled across partitions within the lookahead");
+  EventWithContext ev;
+  ev.context = context;
+  ev.ts = ts;
+  ev.event = event;
+  if (destination == &m_global)
+    {
+      source->outbox.back ().push_back (ev);
+    }
+  else
+    {
+      source->outbox[destination - &m_partitions[0]].push_back (ev);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+
+  Partition *partition = GetCurrentPartition ();
+  Scheduler::Event ev = Insert (partition, partition->currentTs,
+                                partition->currentContext, event);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  NS_ASSERT_MSG (GetCurrentPartition () == &m_global,
+                 "Simulator::ScheduleDestroy called from a partition");
+
+  EventId id (Ptr<EventImpl> (event, false), m_global.currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  m_global.uid++;
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentPartition ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrentPartition ()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  Partition *partition = GetOwnerOf (id);
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  // The owner is either the caller, or stopped while the main
+  // thread runs, so its state may be read here.
+  const Partition *partition = GetOwnerOf (id);
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < partition->currentTs
+      || (id.GetTs () == partition->currentTs
+          && id.GetUid () <= partition->currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  /// \todo I am fairly certain other compilers use other non-standard
+  /// post-fixes to indicate 64 bit constants.
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentPartition ()->currentContext;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitions.size ();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t nodeId) const
+{
+  NS_ASSERT_MSG (m_partitioned && nodeId < m_nodePartition.size (),
+                 "Node " << nodeId << " has no partition");
+  return m_nodePartition[nodeId];
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  return TimeStep (m_lookAhead);
+}
+
+void
+MultithreadedSimulatorImpl::SendPacket (uint32_t context, Time delay, Ptr<const Packet> p,
+                                        Callback<void, Ptr<Packet> > receive)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << p);
+
+  ScheduleWithContext (context, delay, new PacketDeliveryEvent (p, receive));
+}
+
+} // namespace ns3
@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-thread.h"
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+namespace ns3 {
+
+class PointToPointChannel;
+
+/**
+ * \defgroup mtp Multithreaded Simulation
+ *
+ * Run the partitions of a simulation on several threads of one process.
+ */
+
+/**
+ * \ingroup simulator
+ * \ingroup mtp
+ *
+ * \brief Shared-memory parallel simulator implementation using lookahead
+ *
+ * This simulator runs the events of different groups of nodes, called
+ * partitions, on different threads of the same process. It uses the
+ * same conservative, globally synchronized, time window algorithm as
+ * the DistributedSimulatorImpl, with thread barriers in place of the
+ * MPI all-gather:
+ *
+ *  - the lookahead is the smallest propagation delay of the
+ *    point-to-point channels which connect two partitions;
+ *  - all partitions process, in parallel, the events whose timestamp
+ *    is smaller than the earliest pending event plus the lookahead;
+ *  - events scheduled by one partition for a node of another partition
+ *    are kept in a per (source, destination) queue, written by the
+ *    source thread only and moved to the destination event list by
+ *    the main thread between two windows, so no lock is taken while
+ *    events are processed.
+ *
+ * Events which have no node context (Simulator::Schedule called
+ * from the main program, Simulator::Stop) are run by the main thread
+ * while all the partitions are stopped at the time of the event.
+ *
+ * Nodes are assigned to partitions when Run is first called. If any
+ * node has a non-zero system id, the system id is used as the partition
+ * number, and nodes of different partitions may only be connected
+ * through point-to-point channels with a non-zero delay. Otherwise
+ * the PartitionHelper splits the topology into up to "ThreadCount"
+ * balanced partitions with few cut channels, the nodes connected by
+ * any other kind of channel being kept together.
+ *
+ * The models used in the simulation must not share any mutable state
+ * between partitions. See the documentation of the mtp module for
+ * the current limitations.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &delay);
+  virtual EventId Schedule (Time const &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetMaximumLookAhead (const Time lookAhead);
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \returns The number of partitions, or zero before the first call to Run.
+   */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * \param [in] nodeId A node id.
+   * \returns The partition of the node, once the partitions are built.
+   */
+  uint32_t GetPartition (uint32_t nodeId) const;
+  /**
+   * \returns The lookahead used to synchronize the partitions.
+   */
+  Time GetLookAhead (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event sent from one partition to another. */
+  struct EventWithContext
+  {
+    uint32_t context;  /**< The event context. */
+    uint64_t ts;       /**< Absolute event timestamp. */
+    EventImpl *event;  /**< The event implementation. */
+  };
+  /** Queue of events sent to another partition. */
+  typedef std::vector<EventWithContext> Outbox;
+
+  /** The state of one partition. */
+  struct Partition
+  {
+    Ptr<Scheduler> events;       /**< The event list. */
+    uint32_t uid;                /**< Next event unique id in this partition. */
+    uint32_t currentUid;         /**< Unique id of the current event. */
+    uint64_t currentTs;          /**< Timestamp of the current event. */
+    uint32_t currentContext;     /**< Context of the current event. */
+    int unscheduledEvents;       /**< Events inserted but not yet run. */
+    bool stop;                   /**< Stop was called from this partition. */
+    std::vector<Outbox> outbox;  /**< Events for the other partitions, by destination. */
+  };
+
+  /**
+   * Initialize a partition.
+   *
+   * \param [out] partition The partition.
+   */
+  void InitPartition (Partition &partition);
+  /** Assign the nodes to partitions and compute the lookahead. */
+  void BuildPartitions (void);
+  /** Start the worker threads. */
+  void StartThreads (void);
+  /** Stop and join the worker threads. */
+  void StopThreads (void);
+  /** Body of a worker thread. */
+  void WorkerRun (void);
+  /** Process one time window in all partitions. */
+  void RunWindow (void);
+  /**
+   * Process the events of a partition which are in the current window.
+   *
+   * \param [in] partition The partition.
+   */
+  void ProcessWindow (Partition *partition);
+  /** Move the events sent between partitions to their event list. */
+  void DeliverEvents (void);
+  /**
+   * Deliver a packet to a node of another partition.
+   *
+   * This is the delivery callback of the point-to-point channels cut
+   * between two partitions. The packet is serialized by the calling
+   * thread, and a copy of it is deserialized and given to \p receive
+   * by the thread of the partition of \p context, so the two partitions
+   * never share the packet buffers.
+   *
+   * \param [in] context The node id of the receiver.
+   * \param [in] delay The delay of the reception.
+   * \param [in] p The packet.
+   * \param [in] receive The receive callback.
+   */
+  void SendPacket (uint32_t context, Time delay, Ptr<const Packet> p,
+                   Callback<void, Ptr<Packet> > receive);
+  /**
+   * Process the next event of a partition.
+   *
+   * \param [in] partition The partition.
+   */
+  void ProcessOneEvent (Partition *partition);
+  /**
+   * Insert an event in the event list of a partition.
+   *
+   * \param [in] partition The partition.
+   * \param [in] ts The absolute event timestamp.
+   * \param [in] context The event context.
+   * \param [in] event The event implementation.
+   * \returns The scheduler event.
+   */
+  Scheduler::Event Insert (Partition *partition, uint64_t ts,
+                           uint32_t context, EventImpl *event);
+  /**
+   * \param [in] partition The partition.
+   * \returns The timestamp of the next event of \p partition.
+   */
+  uint64_t NextTs (const Partition *partition) const;
+  /**
+   * \returns The partition run by the calling thread.
+   */
+  Partition * GetCurrentPartition (void) const;
+  /**
+   * Set the partition run by the calling thread.
+   *
+   * \param [in] partition The partition.
+   */
+  void SetCurrentPartition (Partition *partition);
+  /**
+   * \param [in] context An event context.
+   * \returns The partition which runs the events of \p context.
+   */
+  Partition * GetPartitionOf (uint32_t context) const;
+  /**
+   * Get the partition of an event, and check that the caller may
+   * access it.
+   *
+   * \param [in] id The event.
+   * \returns The partition which runs \p id.
+   */
+  Partition * GetOwnerOf (const EventId &id) const;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+
+  /** The factory of the partition schedulers. */
+  ObjectFactory m_schedulerFactory;
+  /** Events with no node context, run with all partitions stopped. */
+  Partition m_global;
+  /** The partitions. */
+  std::vector<Partition> m_partitions;
+  /** Partition index of each node. */
+  std::vector<uint32_t> m_nodePartition;
+  /** The channels cut between two partitions, which deliver through SendPacket. */
+  std::vector<Ptr<PointToPointChannel> > m_cutChannels;
+  /** Have the partitions been built. */
+  bool m_partitioned;
+  /** Maximum number of partitions. */
+  uint32_t m_threadCount;
+  /** Lookahead between partitions, in time steps. */
+  uint64_t m_lookAhead;
+  /** Lookahead set by SetMaximumLookAhead, in time steps. */
+  uint64_t m_maxLookAhead;
+  /** Events with a smaller timestamp are processed in this window. */
+  uint64_t m_windowEnd;
+  /** Number of windows processed, for statistics. */
+  uint64_t m_windows;
+  /** Flag calling for the end of the simulation. */
+  bool m_stop;
+
+  /** The worker threads, which run partitions 1 to N-1. */
+  std::vector<Ptr<SystemThread> > m_threads;
+  /** Index of the partition of the next worker thread to start. */
+  uint32_t m_nextWorker;
+  /** Current window number, bumped to start the workers. */
+  uint32_t m_round;
+  /** Number of workers which have not completed the current window. */
+  uint32_t m_running;
+  /** Flag telling the workers to exit. */
+  bool m_exit;
+#ifdef HAVE_PTHREAD_H
+  /** Protects the window state shared with the workers. */
+  pthread_mutex_t m_mutex;
+  /** Signals the start of a window to the workers. */
+  pthread_cond_t m_startCond;
+  /** Signals the end of a window to the main thread. */
+  pthread_cond_t m_doneCond;
+  /** Thread-specific pointer to the partition run by each thread. */
+  pthread_key_t m_current;
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
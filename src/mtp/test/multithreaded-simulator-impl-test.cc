@@ -0,0 +1,396 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \brief Test of the point-to-point links cut by the
+ * MultithreadedSimulatorImpl.
+ *
+ * Packets are sent around a ring of point-to-point links, and each
+ * node forwards the packets it receives with four bytes less, until
+ * they are smaller than a threshold. The same simulation is run with
+ * the DefaultSimulatorImpl and with the MultithreadedSimulatorImpl,
+ * with the nodes spread over three threads, and every node must
+ * receive the same packets at the same times in both runs.
+ */
+class MultithreadedRingTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  MultithreadedRingTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /** A packet received by a node. */
+  struct Record
+  {
+    int64_t time;     //!< Reception time, in time steps.
+    uint32_t size;    //!< Packet size.
+  };
+  /** The packets received by each node, in order. */
+  typedef std::vector<std::vector<Record> > Records;
+
+  /**
+   * \brief Run the ring simulation
+   *
+   * \param impl The simulator implementation factory
+   */
+  void RunRing (ObjectFactory impl);
+  /**
+   * \brief Send a packet on a device
+   *
+   * \param device The device
+   * \param size The packet size
+   */
+  void Send (Ptr<NetDevice> device, uint32_t size);
+  /**
+   * \brief Record a received packet, and forward it on the next link
+   * of the ring
+   *
+   * \param device The receiving device
+   * \param p The packet
+   * \param protocol The protocol number
+   * \param from The sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  /** Number of nodes in the ring. */
+  static const uint32_t N_NODES = 6;
+  /** Packets smaller than this are not forwarded. */
+  static const uint32_t MIN_SIZE = 90;
+
+  Records m_records;                //!< The packets received in the current run.
+  std::vector<Ptr<NetDevice> > m_next;  //!< The device of each node towards the next one.
+};
+
+MultithreadedRingTest::MultithreadedRingTest ()
+  : TestCase ("Compare a ring run by the default and multithreaded simulators")
+{
+}
+
+void
+MultithreadedRingTest::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+bool
+MultithreadedRingTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
+                                        uint16_t protocol, const Address &from)
+{
+  // Every node only touches its own record and its own devices.
+  uint32_t node = device->GetNode ()->GetId ();
+  Record record;
+  record.time = Simulator::Now ().GetTimeStep ();
+  record.size = p->GetSize ();
+  m_records[node].push_back (record);
+  if (record.size >= MIN_SIZE)
+    {
+      Send (m_next[node], record.size - 4);
+    }
+  return true;
+}
+
+void
+MultithreadedRingTest::RunRing (ObjectFactory impl)
+{
+  Simulator::SetImplementation (impl.Create<SimulatorImpl> ());
+
+  NodeContainer nodes;
+  nodes.Create (N_NODES);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+
+  m_records.assign (N_NODES, std::vector<Record> ());
+  m_next.assign (N_NODES, 0);
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      NetDeviceContainer devices = p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % N_NODES));
+      m_next[i] = devices.Get (0);
+      devices.Get (1)->SetReceiveCallback (MakeCallback (&MultithreadedRingTest::Receive, this));
+    }
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      for (uint32_t j = 0; j < 20; ++j)
+        {
+          Simulator::ScheduleWithContext (i, MicroSeconds (1000 * j + 137 * i),
+                                          &MultithreadedRingTest::Send,
+                                          this, m_next[i], 100 + i);
+        }
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_next.clear ();
+}
+
+void
+MultithreadedRingTest::DoRun (void)
+{
+  ObjectFactory impl;
+  impl.SetTypeId ("ns3::DefaultSimulatorImpl");
+  RunRing (impl);
+  Records expected = m_records;
+
+  bool freeLists = Packet::AreFreeListsEnabled ();
+  impl.SetTypeId ("ns3::MultithreadedSimulatorImpl");
+  impl.Set ("ThreadCount", UintegerValue (3));
+  RunRing (impl);
+  NS_TEST_ASSERT_MSG_EQ (Packet::AreFreeListsEnabled (), freeLists,
+                         "The packet free lists were not restored after the run");
+
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_records[i].size (), expected[i].size (),
+                             "Node " << i << " received a different number of packets");
+      uint32_t bytes = 0;
+      uint32_t expectedBytes = 0;
+      for (uint32_t j = 0; j < expected[i].size (); ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_records[i][j].time, expected[i][j].time,
+                                 "Packet " << j << " of node " << i << " received at another time");
+          NS_TEST_ASSERT_MSG_EQ (m_records[i][j].size, expected[i][j].size,
+                                 "Packet " << j << " of node " << i << " has another size");
+          bytes += m_records[i][j].size;
+          expectedBytes += expected[i][j].size;
+        }
+      NS_TEST_ASSERT_MSG_EQ (bytes, expectedBytes, "Node " << i << " received other bytes");
+      received += expected[i].size ();
+    }
+  // 20 packets of each node, and the forwarded ones.
+  NS_TEST_ASSERT_MSG_GT (received, 20 * N_NODES, "Packets were not forwarded");
+}
+
+/**
+ * \brief Test of the partitions built by the MultithreadedSimulatorImpl
+ * on point-to-point links.
+ */
+class MultithreadedPartitionTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  MultithreadedPartitionTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+};
+
+MultithreadedPartitionTest::MultithreadedPartitionTest ()
+  : TestCase ("Check the partitions and lookahead of the multithreaded simulator")
+{
+}
+
+void
+MultithreadedPartitionTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::MultithreadedSimulatorImpl");
+  factory.Set ("ThreadCount", UintegerValue (2));
+  Ptr<MultithreadedSimulatorImpl> impl = factory.Create<MultithreadedSimulatorImpl> ();
+  Simulator::SetImplementation (impl);
+
+  NodeContainer nodes;
+  nodes.Create (4);
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", StringValue ("3ms"));
+  p2p.Install (nodes.Get (0), nodes.Get (1));
+  p2p.Install (nodes.Get (2), nodes.Get (3));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  p2p.Install (nodes.Get (1), nodes.Get (2));
+
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartitionCount (), 0, "Partitions built before Run");
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartitionCount (), 2, "Expected one partition per thread");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartition (0), impl->GetPartition (1), "Link 0-1 cut");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartition (2), impl->GetPartition (3), "Link 2-3 cut");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetLookAhead (), MilliSeconds (1),
+                         "Lookahead is not the delay of the cut link");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (1), "Stop time not reached");
+  impl = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test of the locality of the partitions built by the
+ * MultithreadedSimulatorImpl.
+ *
+ * The nodes of a grid of point-to-point links are split over a few
+ * threads, and each partition must be a connected piece of the grid,
+ * with few links cut between the partitions.
+ */
+class MultithreadedLocalityTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   *
+   * \param rows The number of rows of the grid
+   * \param cols The number of columns of the grid
+   * \param threads The number of threads
+   * \param maxCut The maximum number of links cut
+   */
+  MultithreadedLocalityTest (uint32_t rows, uint32_t cols, uint32_t threads, uint32_t maxCut);
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  uint32_t m_rows;    //!< Number of rows of the grid.
+  uint32_t m_cols;    //!< Number of columns of the grid.
+  uint32_t m_threads; //!< Number of threads.
+  uint32_t m_maxCut;  //!< Maximum number of links cut.
+};
+
+MultithreadedLocalityTest::MultithreadedLocalityTest (uint32_t rows, uint32_t cols,
+                                                      uint32_t threads, uint32_t maxCut)
+  : TestCase ("Check that a grid is split into connected pieces"),
+    m_rows (rows),
+    m_cols (cols),
+    m_threads (threads),
+    m_maxCut (maxCut)
+{
+}
+
+void
+MultithreadedLocalityTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::MultithreadedSimulatorImpl");
+  factory.Set ("ThreadCount", UintegerValue (m_threads));
+  Ptr<MultithreadedSimulatorImpl> impl = factory.Create<MultithreadedSimulatorImpl> ();
+  Simulator::SetImplementation (impl);
+
+  uint32_t nNodes = m_rows * m_cols;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  std::vector<std::pair<uint32_t, uint32_t> > links;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      if ((i + 1) % m_cols != 0)
+        {
+          links.push_back (std::make_pair (i, i + 1));
+        }
+      if (i + m_cols < nNodes)
+        {
+          links.push_back (std::make_pair (i, i + m_cols));
+        }
+    }
+  for (uint32_t l = 0; l < links.size (); ++l)
+    {
+      p2p.Install (nodes.Get (links[l].first), nodes.Get (links[l].second));
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartitionCount (), m_threads, "Expected one partition per thread");
+
+  // Merge the nodes along the links which are not cut: there must be
+  // one connected piece per partition.
+  std::vector<uint32_t> piece (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      piece[i] = i;
+    }
+  uint32_t cut = 0;
+  for (uint32_t l = 0; l < links.size (); ++l)
+    {
+      uint32_t a = links[l].first;
+      uint32_t b = links[l].second;
+      if (impl->GetPartition (a) != impl->GetPartition (b))
+        {
+          cut++;
+          continue;
+        }
+      while (piece[a] != a)
+        {
+          a = piece[a];
+        }
+      while (piece[b] != b)
+        {
+          b = piece[b];
+        }
+      piece[std::max (a, b)] = std::min (a, b);
+    }
+  uint32_t nPieces = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      nPieces += piece[i] == i;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nPieces, m_threads, "A partition is not connected");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (cut, m_maxCut, "Too many links cut");
+  impl = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief TestSuite for the MultithreadedSimulatorImpl
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  MultithreadedSimulatorTestSuite ();
+};
+
+MultithreadedSimulatorTestSuite::MultithreadedSimulatorTestSuite ()
+  : TestSuite ("multithreaded-simulator", UNIT)
+{
+  AddTestCase (new MultithreadedRingTest, TestCase::QUICK);
+  AddTestCase (new MultithreadedPartitionTest, TestCase::QUICK);
+  // A chain is cut in three places, and an 8x8 grid in at least 16,
+  // within twice of which the bisection must stay.
+  AddTestCase (new MultithreadedLocalityTest (1, 16, 4, 3), TestCase::QUICK);
+  AddTestCase (new MultithreadedLocalityTest (8, 8, 4, 32), TestCase::QUICK);
+}
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite; //!< The testsuite
@@ -0,0 +1,566 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "partition-helper.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PartitionHelper");
+
+namespace {
+
+/**
+ * \param parent the parent of each node in the union-find forest
+ * \param i a node
+ * \return the root of the tree of the node
+ */
+uint32_t
+FindRoot (std::vector<uint32_t> &parent, uint32_t i)
+{
+  while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+  return i;
+}
+
+/**
+ * \param channel a channel
+ * \param [out] delay the delay of the channel
+ * \return true if the channel is a point-to-point channel with a non-zero delay
+ */
+bool
+GetCutDelay (Ptr<Channel> channel, Time &delay)
+{
+  if (channel->GetNDevices () != 2 || !channel->GetDevice (0)->IsPointToPoint ())
+    {
+      return false;
+    }
+  TimeValue value;
+  if (!channel->GetAttributeFailSafe ("Delay", value)
+      || !value.Get ().IsStrictlyPositive ())
+    {
+      return false;
+    }
+  delay = value.Get ();
+  return true;
+}
+
+} // unnamed namespace
+
+PartitionHelper::PartitionHelper ()
+  : m_minLookAhead (Seconds (0)),
+    m_imbalance (1.05),
+    m_nPartitions (0),
+    m_cutWeight (0)
+{
+}
+
+void
+PartitionHelper::SetMinLookAhead (Time lookAhead)
+{
+  m_minLookAhead = lookAhead;
+}
+
+void
+PartitionHelper::SetImbalance (double imbalance)
+{
+  NS_ASSERT (imbalance >= 1);
+  m_imbalance = imbalance;
+}
+
+void
+PartitionHelper::SetNodeWeight (uint32_t nodeId, double weight)
+{
+  NS_ASSERT (weight >= 0);
+  m_nodeWeight[nodeId] = weight;
+}
+
+void
+PartitionHelper::SetChannelWeight (uint32_t channelId, double weight)
+{
+  NS_ASSERT (weight >= 0);
+  m_channelWeight[channelId] = weight;
+}
+
+void
+PartitionHelper::Partition (uint32_t nPartitions)
+{
+  NS_LOG_FUNCTION (this << nPartitions);
+  NS_ASSERT (nPartitions > 0);
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  uint32_t nChannels = ChannelList::GetNChannels ();
+
+  // Estimate the event rate of each node
+  std::vector<double> nodeWeight (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      std::map<uint32_t, double>::const_iterator it = m_nodeWeight.find (i);
+      if (it != m_nodeWeight.end ())
+        {
+          nodeWeight[i] = it->second;
+        }
+      else
+        {
+          Ptr<Node> node = NodeList::GetNode (i);
+          nodeWeight[i] = 1 + node->GetNDevices () + node->GetNApplications ();
+        }
+    }
+
+  // Group the nodes which share a channel that may not be cut
+  std::vector<uint32_t> parent (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      parent[i] = i;
+    }
+  std::vector<bool> cuttable (nChannels, false);
+  for (uint32_t c = 0; c < nChannels; ++c)
+    {
+      Ptr<Channel> channel = ChannelList::GetChannel (c);
+      if (channel->GetNDevices () < 2)
+        {
+          continue;
+        }
+      Time delay;
+      if (GetCutDelay (channel, delay) && delay >= m_minLookAhead)
+        {
+          cuttable[c] = true;
+          continue;
+        }
+      uint32_t first = FindRoot (parent, channel->GetDevice (0)->GetNode ()->GetId ());
+      for (uint32_t k = 1; k < channel->GetNDevices (); ++k)
+        {
+          parent[FindRoot (parent, channel->GetDevice (k)->GetNode ()->GetId ())] = first;
+        }
+    }
+  std::vector<uint32_t> nodeGroup (nNodes);
+  std::vector<int32_t> rootGroup (nNodes, -1);
+  std::vector<double> groupWeight;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t root = FindRoot (parent, i);
+      if (rootGroup[root] < 0)
+        {
+          rootGroup[root] = groupWeight.size ();
+          groupWeight.push_back (0);
+        }
+      nodeGroup[i] = rootGroup[root];
+      groupWeight[nodeGroup[i]] += nodeWeight[i];
+    }
+  uint32_t nGroups = groupWeight.size ();
+  NS_LOG_LOGIC (nNodes << " nodes in " << nGroups << " groups");
+
+  // The graph of the groups, with the cuttable channels as edges
+  std::map<std::pair<uint32_t, uint32_t>, double> edgeWeight;
+  for (uint32_t c = 0; c < nChannels; ++c)
+    {
+      if (!cuttable[c])
+        {
+          continue;
+        }
+      Ptr<Channel> channel = ChannelList::GetChannel (c);
+      uint32_t a = nodeGroup[channel->GetDevice (0)->GetNode ()->GetId ()];
+      uint32_t b = nodeGroup[channel->GetDevice (1)->GetNode ()->GetId ()];
+      if (a == b)
+        {
+          continue;
+        }
+      std::map<uint32_t, double>::const_iterator it = m_channelWeight.find (c);
+      edgeWeight[std::make_pair (std::min (a, b), std::max (a, b))] += it != m_channelWeight.end () ? it->second : 1;
+    }
+  Adjacency adjacency (nGroups);
+  for (std::map<std::pair<uint32_t, uint32_t>, double>::const_iterator it = edgeWeight.begin ();
+       it != edgeWeight.end (); ++it)
+    {
+      Edge edge;
+      edge.weight = it->second;
+      edge.to = it->first.second;
+      adjacency[it->first.first].push_back (edge);
+      edge.to = it->first.first;
+      adjacency[it->first.second].push_back (edge);
+    }
+
+  std::vector<uint32_t> groups (nGroups);
+  for (uint32_t g = 0; g < nGroups; ++g)
+    {
+      groups[g] = g;
+    }
+  // The imbalances of the levels of bisections multiply, and a partition
+  // is the result of at most ceil (log2 (nPartitions)) of them
+  uint32_t depth = 0;
+  while ((1U << depth) < nPartitions)
+    {
+      ++depth;
+    }
+  double imbalance = depth > 0 ? std::pow (m_imbalance, 1.0 / depth) : m_imbalance;
+  std::vector<uint32_t> groupPart (nGroups, 0);
+  Bisect (adjacency, groupWeight, groups, 0, nPartitions, imbalance, groupPart);
+
+  // Assign the partitions and compute the statistics of each one
+  m_nPartitions = nPartitions;
+  m_systemId.assign (nNodes, 0);
+  m_load.assign (nPartitions, 0);
+  m_nodes.assign (nPartitions, 0);
+  m_cutChannels.assign (nPartitions, 0);
+  m_lookAhead.assign (nPartitions, Time::Max ());
+  m_cutWeight = 0;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t part = groupPart[nodeGroup[i]];
+      m_systemId[i] = part;
+      m_load[part] += nodeWeight[i];
+      m_nodes[part]++;
+    }
+  for (uint32_t c = 0; c < nChannels; ++c)
+    {
+      if (!cuttable[c])
+        {
+          continue;
+        }
+      Ptr<Channel> channel = ChannelList::GetChannel (c);
+      uint32_t a = m_systemId[channel->GetDevice (0)->GetNode ()->GetId ()];
+      uint32_t b = m_systemId[channel->GetDevice (1)->GetNode ()->GetId ()];
+      if (a == b)
+        {
+          continue;
+        }
+      Time delay;
+      GetCutDelay (channel, delay);
+      std::map<uint32_t, double>::const_iterator it = m_channelWeight.find (c);
+      m_cutWeight += it != m_channelWeight.end () ? it->second : 1;
+      m_cutChannels[a]++;
+      m_cutChannels[b]++;
+      m_lookAhead[a] = std::min (m_lookAhead[a], delay);
+      m_lookAhead[b] = std::min (m_lookAhead[b], delay);
+    }
+}
+
+void
+PartitionHelper::Bisect (const Adjacency &adjacency, const std::vector<double> &groupWeight,
+                         const std::vector<uint32_t> &groups, uint32_t firstPart, uint32_t nParts,
+                         double imbalance, std::vector<uint32_t> &groupPart) const
+{
+  NS_LOG_FUNCTION (this << groups.size () << firstPart << nParts);
+
+  if (nParts == 1 || groups.empty ())
+    {
+      for (uint32_t i = 0; i < groups.size (); ++i)
+        {
+          groupPart[groups[i]] = firstPart;
+        }
+      return;
+    }
+
+  uint32_t n = groups.size ();
+  std::vector<int32_t> local (adjacency.size (), -1);
+  double total = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      local[groups[i]] = i;
+      total += groupWeight[groups[i]];
+    }
+  uint32_t nParts0 = nParts / 2;
+  double target0 = total * nParts0 / nParts;
+  double maxWeight[2];
+  maxWeight[0] = target0 * imbalance;
+  maxWeight[1] = (total - target0) * imbalance;
+
+  // Find a group far from the first one, by breadth-first search
+  std::vector<uint32_t> order;
+  std::vector<bool> visited (n, false);
+  order.push_back (0);
+  visited[0] = true;
+  for (uint32_t k = 0; k < order.size (); ++k)
+    {
+      const std::vector<Edge> &edges = adjacency[groups[order[k]]];
+      for (std::vector<Edge>::const_iterator e = edges.begin (); e != edges.end (); ++e)
+        {
+          int32_t j = local[e->to];
+          if (j >= 0 && !visited[j])
+            {
+              visited[j] = true;
+              order.push_back (j);
+            }
+        }
+    }
+  uint32_t start = order.back ();
+
+  // Grow the first side from that group, in breadth-first order, the
+  // groups unreachable from it being visited last
+  std::vector<uint8_t> side (n, 1);
+  double weight0 = 0;
+  order.clear ();
+  visited.assign (n, false);
+  order.push_back (start);
+  visited[start] = true;
+  uint32_t next = 0;
+  for (uint32_t k = 0; k < n && weight0 < target0; ++k)
+    {
+      if (k == order.size ())
+        {
+          while (visited[next])
+            {
+              ++next;
+            }
+          order.push_back (next);
+          visited[next] = true;
+        }
+      uint32_t i = order[k];
+      double w = groupWeight[groups[i]];
+      if (weight0 + w / 2 > target0)
+        {
+          break;
+        }
+      side[i] = 0;
+      weight0 += w;
+      const std::vector<Edge> &edges = adjacency[groups[i]];
+      for (std::vector<Edge>::const_iterator e = edges.begin (); e != edges.end (); ++e)
+        {
+          int32_t j = local[e->to];
+          if (j >= 0 && !visited[j])
+            {
+              visited[j] = true;
+              order.push_back (j);
+            }
+        }
+    }
+
+  for (uint32_t pass = 0; pass < 10; ++pass)
+    {
+      if (!Refine (adjacency, groupWeight, groups, local, maxWeight, side))
+        {
+          break;
+        }
+    }
+
+  std::vector<uint32_t> halves[2];
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      halves[side[i]].push_back (groups[i]);
+    }
+  Bisect (adjacency, groupWeight, halves[0], firstPart, nParts0, imbalance, groupPart);
+  Bisect (adjacency, groupWeight, halves[1], firstPart + nParts0, nParts - nParts0, imbalance, groupPart);
+}
+
+bool
+PartitionHelper::Refine (const Adjacency &adjacency, const std::vector<double> &groupWeight,
+                         const std::vector<uint32_t> &groups, const std::vector<int32_t> &local,
+                            const double maxWeight[2], std::vector<uint8_t> &side) const
+{
+  NS_LOG_FUNCTION (this << groups.size ());
+
+  uint32_t n = groups.size ();
+  // The gain of a group is the reduction of the cut weight if it
+  // changes side.  The queue of each side is sorted by decreasing gain.
+  std::vector<double> gain (n, 0);
+  std::set<std::pair<double, uint32_t> > queue[2];
+  double weight[2] = { 0, 0 };
+  double cut = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      const std::vector<Edge> &edges = adjacency[groups[i]];
+      for (std::vector<Edge>::const_iterator e = edges.begin (); e != edges.end (); ++e)
+        {
+          int32_t j = local[e->to];
+          if (j < 0)
+            {
+              continue;
+            }
+          if (side[j] != side[i])
+            {
+              gain[i] += e->weight;
+              cut += e->weight;
+            }
+          else
+            {
+              gain[i] -= e->weight;
+            }
+        }
+      weight[side[i]] += groupWeight[groups[i]];
+      queue[side[i]].insert (std::make_pair (-gain[i], i));
+    }
+  cut /= 2;
+
+  double violation = std::max (weight[0] - maxWeight[0], 0.0) + std::max (weight[1] - maxWeight[1], 0.0);
+  double bestViolation = violation;
+  double bestCut = cut;
+  std::vector<uint32_t> moves;
+  uint32_t bestMoves = 0;
+  while (true)
+    {
+      // The best move of each side which does not make the balance worse
+      int32_t from = -1;
+      double newViolation = 0;
+      for (uint8_t s = 0; s < 2; ++s)
+        {
+          if (queue[s].empty ())
+            {
+              continue;
+            }
+          uint32_t i = queue[s].begin ()->second;
+          double w = groupWeight[groups[i]];
+          double v = std::max (weight[s] - w - maxWeight[s], 0.0)
+            + std::max (weight[1 - s] + w - maxWeight[1 - s], 0.0);
+          if (v > 0 && v >= violation)
+            {
+              continue;
+            }
+          if (from < 0 || gain[i] > gain[queue[from].begin ()->second])
+            {
+              from = s;
+              newViolation = v;
+            }
+        }
+      if (from < 0)
+        {
+          break;
+        }
+
+      uint32_t i = queue[from].begin ()->second;
+      queue[from].erase (queue[from].begin ());
+      side[i] = 1 - from;
+      weight[from] -= groupWeight[groups[i]];
+      weight[1 - from] += groupWeight[groups[i]];
+      cut -= gain[i];
+      violation = newViolation;
+      moves.push_back (i);
+
+      const std::vector<Edge> &edges = adjacency[groups[i]];
+      for (std::vector<Edge>::const_iterator e = edges.begin (); e != edges.end (); ++e)
+        {
+          int32_t j = local[e->to];
+          if (j < 0 || queue[side[j]].erase (std::make_pair (-gain[j], j)) == 0)
+            {
+              // not in this bisection, or already moved
+              continue;
+            }
+          gain[j] += side[j] == side[i] ? -2 * e->weight : 2 * e->weight;
+          queue[side[j]].insert (std::make_pair (-gain[j], j));
+        }
+
+      if (violation < bestViolation || (violation <= bestViolation && cut < bestCut))
+        {
+          bestViolation = violation;
+          bestCut = cut;
+          bestMoves = moves.size ();
+        }
+    }
+
+  // Undo the moves done after the best partition
+  for (uint32_t k = bestMoves; k < moves.size (); ++k)
+    {
+      side[moves[k]] = 1 - side[moves[k]];
+    }
+  NS_LOG_LOGIC ("cut " << bestCut << " after " << bestMoves << " moves");
+  return bestMoves > 0;
+}
+
+uint32_t
+PartitionHelper::GetSystemId (uint32_t nodeId) const
+{
+  NS_ASSERT_MSG (nodeId < m_systemId.size (), "Node " << nodeId << " was not partitioned");
+  return m_systemId[nodeId];
+}
+
+const std::vector<uint32_t> &
+PartitionHelper::GetSystemIds (void) const
+{
+  return m_systemId;
+}
+
+double
+PartitionHelper::GetLoad (uint32_t systemId) const
+{
+  NS_ASSERT (systemId < m_nPartitions);
+  return m_load[systemId];
+}
+
+Time
+PartitionHelper::GetLookAhead (uint32_t systemId) const
+{
+  NS_ASSERT (systemId < m_nPartitions);
+  return m_lookAhead[systemId];
+}
+
+double
+PartitionHelper::GetCutWeight (void) const
+{
+  return m_cutWeight;
+}
+
+void
+PartitionHelper::Report (std::ostream &os) const
+{
+  double total = 0;
+  double maxLoad = 0;
+  Time lookAhead = Time::Max ();
+  for (uint32_t r = 0; r < m_nPartitions; ++r)
+    {
+      total += m_load[r];
+      maxLoad = std::max (maxLoad, m_load[r]);
+      lookAhead = std::min (lookAhead, m_lookAhead[r]);
+    }
+  double average = m_nPartitions > 0 ? total / m_nPartitions : 0;
+
+  os << m_systemId.size () << " nodes on " << m_nPartitions << " partitions"
+     << ", cut weight " << m_cutWeight
+     << ", imbalance " << (average > 0 ? maxLoad / average : 1)
+     << ", lookahead ";
+  if (lookAhead == Time::Max ())
+    {
+      os << "none";
+    }
+  else
+    {
+      os << lookAhead.GetSeconds () << "s";
+    }
+  os << std::endl;
+  for (uint32_t r = 0; r < m_nPartitions; ++r)
+    {
+      os << "partition " << r << ": " << m_nodes[r] << " nodes"
+         << ", load " << m_load[r]
+         << " (" << (average > 0 ? m_load[r] / average : 1) << " of average)"
+         << ", " << m_cutChannels[r] << " cut channels"
+         << ", lookahead ";
+      if (m_lookAhead[r] == Time::Max ())
+        {
+          os << "none";
+        }
+      else
+        {
+          os << m_lookAhead[r].GetSeconds () << "s";
+        }
+      os << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_PARTITION_HELPER_H
+#define NS3_PARTITION_HELPER_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Assign the nodes of a topology to the partitions of a parallel
+ * simulation
+ *
+ * The graph is built from the NodeList and the ChannelList.  The nodes
+ * connected by a channel which may not be cut (any channel which is not a
+ * point-to-point channel with a delay of at least the minimum lookahead)
+ * are kept together, and the resulting groups are split by recursive
+ * bisection, each bisection being refined by Fiduccia-Mattheyses passes,
+ * so that the load of the partitions is balanced and the weight of the cut
+ * channels is small.
+ *
+ * The load of a node is an estimate of its event rate: one, plus one per
+ * device and one per application, unless set by SetNodeWeight.  The weight
+ * of a channel is an estimate of its packet rate, one unless set by
+ * SetChannelWeight.  The partition only depends on the topology and on
+ * these settings, so that all the processes of a distributed simulation
+ * compute the same one.
+ *
+ * The partition of a node is used as its system id by the
+ * MpiPartitionHelper, and as the index of its thread by the
+ * MultithreadedSimulatorImpl.
+ */
+class PartitionHelper
+{
+public:
+  PartitionHelper ();
+
+  /**
+   * \param lookAhead the minimum delay of the channels which may be cut
+   *
+   * Raising it raises the lookahead of the simulation, at the cost of a
+   * coarser partition.  The default, zero, allows all the point-to-point
+   * channels with a non-zero delay to be cut.
+   */
+  void SetMinLookAhead (Time lookAhead);
+  /**
+   * \param imbalance the maximum ratio of the load of a partition to
+   * the average load, at least 1
+   *
+   * The default is 1.05.  The ratio may be larger when the nodes which
+   * must stay together are too heavy.
+   */
+  void SetImbalance (double imbalance);
+  /**
+   * \param nodeId the id of a node
+   * \param weight the estimated event rate of the node
+   */
+  void SetNodeWeight (uint32_t nodeId, double weight);
+  /**
+   * \param channelId the id of a channel
+   * \param weight the estimated packet rate of the channel
+   */
+  void SetChannelWeight (uint32_t channelId, double weight);
+
+  /**
+   * \param nPartitions the number of partitions
+   *
+   * Partitions the nodes of the NodeList.
+   */
+  void Partition (uint32_t nPartitions);
+
+  /**
+   * \param nodeId the id of a node
+   * \return the partition assigned to the node
+   */
+  uint32_t GetSystemId (uint32_t nodeId) const;
+  /**
+   * \return the partition assigned to each node, indexed by node id
+   */
+  const std::vector<uint32_t> & GetSystemIds (void) const;
+  /**
+   * \param systemId a partition
+   * \return the estimated load of the partition
+   */
+  double GetLoad (uint32_t systemId) const;
+  /**
+   * \param systemId a partition
+   * \return the smallest delay of the channels cut between the partition
+   * and the other partitions, or Time::Max if it has no cut channel
+   */
+  Time GetLookAhead (uint32_t systemId) const;
+  /**
+   * \return the sum of the weights of the cut channels
+   */
+  double GetCutWeight (void) const;
+  /**
+   * \param os the output stream
+   *
+   * Prints the number of nodes, the load, the number of cut channels and
+   * the lookahead of each partition.
+   */
+  void Report (std::ostream &os) const;
+
+private:
+  /// A channel between two groups of nodes
+  struct Edge
+  {
+    uint32_t to;    //!< the other group
+    double weight;  //!< the weight of the channels between the groups
+  };
+  /// The groups adjacent to each group
+  typedef std::vector<std::vector<Edge> > Adjacency;
+
+  /**
+   * \param adjacency the graph of the groups
+   * \param groupWeight the load of each group
+   * \param groups the groups to split
+   * \param firstPart the first partition for these groups
+   * \param nParts the number of partitions for these groups
+   * \param imbalance the maximum imbalance of each bisection
+   * \param [out] groupPart the partition of each group
+   *
+   * Splits the groups in two, in proportion of the number of partitions
+   * of each half, and recurses on each half.
+   */
+  void Bisect (const Adjacency &adjacency, const std::vector<double> &groupWeight,
+               const std::vector<uint32_t> &groups, uint32_t firstPart, uint32_t nParts,
+               double imbalance, std::vector<uint32_t> &groupPart) const;
+  /**
+   * \param adjacency the graph of the groups
+   * \param groupWeight the load of each group
+   * \param groups the groups being split
+   * \param local the index in \p groups of each group, or -1
+   * \param maxWeight the maximum load of each side
+   * \param [in,out] side the side of each group of \p groups
+   * \return true if the cut or the balance was improved
+   *
+   * Runs one Fiduccia-Mattheyses pass: moves the groups one by one, each
+   * time the one which reduces the cut the most, and keeps the best
+   * partition seen.
+   */
+  bool Refine (const Adjacency &adjacency, const std::vector<double> &groupWeight,
+               const std::vector<uint32_t> &groups, const std::vector<int32_t> &local,
+               const double maxWeight[2], std::vector<uint8_t> &side) const;
+
+  Time m_minLookAhead;                        //!< minimum delay of the cut channels
+  double m_imbalance;                         //!< maximum load over average load
+  std::map<uint32_t, double> m_nodeWeight;    //!< node weights set by the user
+  std::map<uint32_t, double> m_channelWeight; //!< channel weights set by the user
+
+  uint32_t m_nPartitions;                     //!< the number of partitions
+  std::vector<uint32_t> m_systemId;           //!< partition of each node
+  std::vector<double> m_load;                 //!< load of each partition
+  std::vector<uint32_t> m_nodes;              //!< number of nodes of each partition
+  std::vector<uint32_t> m_cutChannels;        //!< number of cut channels of each partition
+  std::vector<Time> m_lookAhead;              //!< lookahead of each partition
+  double m_cutWeight;                         //!< weight of the cut channels
+};
+
+} // namespace ns3
+
+#endif /* NS3_PARTITION_HELPER_H */
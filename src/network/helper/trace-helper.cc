@@ -397,6 +397,92 @@ AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
+BinaryTraceHelper::BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+BinaryTraceHelper::~BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+Ptr<BinaryTraceFile>
+BinaryTraceHelper::CreateFile (std::string filename, uint32_t captureSize)
+{
+  NS_LOG_FUNCTION (filename << captureSize);
+
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> (filename, captureSize);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename);
+
+  //
+  // As for the ascii trace files, the helper forgets about the file, which
+  // is kept alive by the callbacks it is hooked to.  Unlike the ascii trace
+  // lines, the records are buffered, so they are also written when the
+  // simulator is destroyed, in case the objects with the trace sources
+  // are never deleted.
+  //
+  Simulator::ScheduleDestroy (&BinaryTraceFile::Flush, file);
+  return file;
+}
+
+std::string
+BinaryTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
+{
+  NS_LOG_FUNCTION (prefix << device << useObjectNames);
+  NS_ABORT_MSG_UNLESS (prefix.size (), "Empty prefix string");
+
+  std::ostringstream oss;
+  oss << prefix << "-";
+
+  std::string nodename;
+  std::string devicename;
+
+  Ptr<Node> node = device->GetNode ();
+
+  if (useObjectNames)
+    {
+      nodename = Names::FindName (node);
+      devicename = Names::FindName (device);
+    }
+
+  if (nodename.size ())
+    {
+      oss << nodename;
+    }
+  else
+    {
+      oss << node->GetId ();
+    }
+
+  oss << "-";
+
+  if (devicename.size ())
+    {
+      oss << devicename;
+    }
+  else
+    {
+      oss << device->GetIfIndex ();
+    }
+
+  oss << ".btr";
+
+  return oss.str ();
+}
+
+//
+// The binary trace sink.  The event type ('+', '-', 'd' or 'r'), the node
+// and the device are those of the context registered when the sink was
+// hooked, so the sink only records the time and the packet.
+//
+void
+BinaryTraceHelper::DefaultSink (Ptr<BinaryTraceFile> file, uint32_t context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (file << context << p);
+  file->Write (Simulator::Now (), context, p);
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
@@ -650,5 +736,148 @@ AsciiTraceHelperForDevice::EnableAsciiImpl (
     }
 }
 
+void
+BinaryTraceHelperForDevice::SetBinaryCaptureSize (uint32_t captureSize)
+{
+  m_binaryCaptureSize = captureSize;
+}
+
+uint32_t
+BinaryTraceHelperForDevice::GetBinaryCaptureSize (void) const
+{
+  return m_binaryCaptureSize;
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (std::string prefix, Ptr<NetDevice> nd, bool explicitFilename)
+{
+  EnableBinaryInternal (Ptr<BinaryTraceFile> (), prefix, nd, explicitFilename);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  EnableBinaryInternal (file, std::string (), nd, false);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (std::string prefix, std::string ndName, bool explicitFilename)
+{
+  Ptr<NetDevice> nd = Names::Find<NetDevice> (ndName);
+  EnableBinaryInternal (Ptr<BinaryTraceFile> (), prefix, nd, explicitFilename);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, std::string ndName)
+{
+  Ptr<NetDevice> nd = Names::Find<NetDevice> (ndName);
+  EnableBinaryInternal (file, std::string (), nd, false);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (std::string prefix, NetDeviceContainer d)
+{
+  EnableBinaryImpl (Ptr<BinaryTraceFile> (), prefix, d);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, NetDeviceContainer d)
+{
+  EnableBinaryImpl (file, std::string (), d);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinaryImpl (Ptr<BinaryTraceFile> file, std::string prefix, NetDeviceContainer d)
+{
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      Ptr<NetDevice> dev = *i;
+      EnableBinaryInternal (file, prefix, dev, false);
+    }
+}
+
+void
+BinaryTraceHelperForDevice::EnableBinary (std::string prefix, NodeContainer n)
+{
+  EnableBinaryImpl (Ptr<BinaryTraceFile> (), prefix, n);
+}
+
+void
+BinaryTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, NodeContainer n)
+{
+  EnableBinaryImpl (file, std::string (), n);
+}
+
+void
+BinaryTraceHelperForDevice::EnableBinaryImpl (Ptr<BinaryTraceFile> file, std::string prefix, NodeContainer n)
+{
+  NetDeviceContainer devs;
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          devs.Add (node->GetDevice (j));
+        }
+    }
+  EnableBinaryImpl (file, prefix, devs);
+}
+
+void
+BinaryTraceHelperForDevice::EnableBinaryAll (std::string prefix)
+{
+  EnableBinaryImpl (Ptr<BinaryTraceFile> (), prefix, NodeContainer::GetGlobal ());
+}
+
+void
+BinaryTraceHelperForDevice::EnableBinaryAll (Ptr<BinaryTraceFile> file)
+{
+  EnableBinaryImpl (file, std::string (), NodeContainer::GetGlobal ());
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (Ptr<BinaryTraceFile> file, uint32_t nodeid, uint32_t deviceid)
+{
+  EnableBinaryImpl (file, std::string (), nodeid, deviceid, false);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinary (
+  std::string prefix, 
+  uint32_t nodeid, 
+  uint32_t deviceid,
+  bool explicitFilename)
+{
+  EnableBinaryImpl (Ptr<BinaryTraceFile> (), prefix, nodeid, deviceid, explicitFilename);
+}
+
+void 
+BinaryTraceHelperForDevice::EnableBinaryImpl (
+  Ptr<BinaryTraceFile> file, 
+  std::string prefix, 
+  uint32_t nodeid, 
+  uint32_t deviceid,
+  bool explicitFilename)
+{
+  NodeContainer n = NodeContainer::GetGlobal ();
+
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      if (node->GetId () != nodeid) 
+        {
+          continue;
+        }
+
+      NS_ABORT_MSG_IF (deviceid >= node->GetNDevices (), 
+                       "BinaryTraceHelperForDevice::EnableBinary(): Unknown deviceid = " << deviceid);
+
+      Ptr<NetDevice> nd = node->GetDevice (deviceid);
+
+      EnableBinaryInternal (file, prefix, nd, explicitFilename);
+      return;
+    }
+}
+
 } // namespace ns3
 
@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-file.h"
 
 namespace ns3 {
 
@@ -545,6 +546,89 @@ AsciiTraceHelper::HookDefaultReceiveSinkWithContext (
                  << tracename << "\"");
 }
 
+/**
+ * \brief Manage binary trace files for device models
+ *
+ * This is the binary counterpart of AsciiTraceHelper.  The default sink
+ * records the time, the context, the uid and the size of the packets in a
+ * BinaryTraceFile, instead of printing them, so packet printing does not
+ * need to be enabled.  BinaryTraceReader converts the files to the ascii
+ * trace format.
+ */
+class BinaryTraceHelper
+{
+public:
+  /**
+   * @brief Create a binary trace helper.
+   */
+  BinaryTraceHelper ();
+
+  /**
+   * @brief Destroy a binary trace helper.
+   */
+  ~BinaryTraceHelper ();
+
+  /**
+   * @brief Let the binary trace helper figure out a reasonable filename to
+   * use for a binary trace file associated with a device.
+   * 
+   * @param prefix prefix string
+   * @param device NetDevice
+   * @param useObjectNames use node and device names instead of indexes
+   * @returns file name
+   */
+  std::string GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames = true);
+
+  /**
+   * @brief Create a binary trace file.
+   *
+   * As for the ascii trace files, the file is kept alive by the callbacks
+   * of the trace sources it is hooked to, and it is written and closed
+   * when the last one is destroyed.
+   *
+   * @param filename file name
+   * @param captureSize maximum number of packet bytes recorded with each event
+   * @returns a smart pointer to the file
+   */
+  Ptr<BinaryTraceFile> CreateFile (std::string filename, uint32_t captureSize = 0);
+
+  /**
+   * @brief Hook a trace source to the default trace sink.
+   *
+   * @param object object
+   * @param traceName trace source name
+   * @param file binary trace file
+   * @param event event type recorded, '+', '-', 'd' or 'r' as in the ascii traces
+   * @param device the device the trace source belongs to
+   * @param path the config path of the object, ending with a '/', or an
+   * empty string if the file records a single device and the records need
+   * no context
+   */
+  template <typename T> 
+  void HookDefaultSink (Ptr<T> object, std::string traceName, Ptr<BinaryTraceFile> file,
+                        char event, Ptr<NetDevice> device, std::string path);
+
+  /**
+   * @brief Basic default trace sink.
+   *
+   * @param file the binary trace file
+   * @param context the index of the context in the file
+   * @param p the packet
+   */
+  static void DefaultSink (Ptr<BinaryTraceFile> file, uint32_t context, Ptr<const Packet> p);
+};
+
+template <typename T> void
+BinaryTraceHelper::HookDefaultSink (Ptr<T> object, std::string tracename, Ptr<BinaryTraceFile> file,
+                                    char event, Ptr<NetDevice> device, std::string path)
+{
+  std::string context = path.empty () ? path : path + tracename;
+  uint32_t index = file->AddContext (event, device->GetNode ()->GetId (), device->GetIfIndex (), context);
+  bool result = object->TraceConnectWithoutContext (tracename, MakeBoundCallback (&DefaultSink, file, index));
+  NS_ASSERT_MSG (result == true, "BinaryTraceHelper::HookDefaultSink():  Unable to hook \"" 
+                 << tracename << "\"");
+}
+
 /**
  * \brief Base class providing common user-level pcap operations for helpers
  * representing net devices.
@@ -865,6 +949,220 @@ private:
   void EnableAsciiImpl (Ptr<OutputStreamWrapper> stream, std::string prefix, Ptr<NetDevice> nd, bool explicitFilename);
 };
 
+/**
+ * \brief Base class providing common user-level binary trace operations for
+ * helpers representing net devices.
+ *
+ * The methods mirror the ones of AsciiTraceHelperForDevice.
+ */
+class BinaryTraceHelperForDevice
+{
+public:
+  /**
+   * @brief Construct a BinaryTraceHelperForDevice.
+   */
+  BinaryTraceHelperForDevice () : m_binaryCaptureSize (0) {}
+
+  /**
+   * @brief Destroy a BinaryTraceHelperForDevice.
+   */
+  virtual ~BinaryTraceHelperForDevice () {}
+
+  /**
+   * @brief Enable binary trace output on the indicated net device.
+   *
+   * The implementation is expected to use a provided Ptr<BinaryTraceFile>
+   * if it is non-null.  If the file is null, the implementation is expected
+   * to use a provided prefix to construct a new file name for each net
+   * device, and to create the file with the capture size returned by
+   * GetBinaryCaptureSize.
+   *
+   * If the prefix is provided, there will be one file per net device
+   * created, and the records have no context.  If the file is provided,
+   * there may be many different devices writing to it, and the
+   * implementation is expected to give the config path of each trace
+   * source as context.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param nd Net device for which you want to enable tracing
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  virtual void EnableBinaryInternal (Ptr<BinaryTraceFile> file, 
+                                     std::string prefix, 
+                                     Ptr<NetDevice> nd,
+                                     bool explicitFilename) = 0;
+
+  /**
+   * @brief Set the number of packet bytes recorded with each event in the
+   * files created from a prefix.
+   *
+   * @param captureSize maximum number of packet bytes recorded
+   */
+  void SetBinaryCaptureSize (uint32_t captureSize);
+
+  /**
+   * @returns the number of packet bytes recorded with each event in the
+   * files created from a prefix
+   */
+  uint32_t GetBinaryCaptureSize (void) const;
+
+  /**
+   * @brief Enable binary trace output on the indicated net device.
+   *
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param nd Net device for which you want to enable tracing.
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  void EnableBinary (std::string prefix, Ptr<NetDevice> nd, bool explicitFilename = false);
+
+  /**
+   * @brief Enable binary trace output on the indicated net device.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param nd Net device for which you want to enable tracing.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd);
+
+  /**
+   * @brief Enable binary trace output the indicated net device using a
+   * device previously named using the ns-3 object name service.
+   *
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param ndName The name of the net device in which you want to enable tracing.
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  void EnableBinary (std::string prefix, std::string ndName, bool explicitFilename = false);
+
+  /**
+   * @brief Enable binary trace output the indicated net device using a
+   * device previously named using the ns-3 object name service.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param ndName The name of the net device in which you want to enable tracing.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, std::string ndName);
+
+  /**
+   * @brief Enable binary trace output on each device in the container which
+   * is of the appropriate type.
+   *
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param d container of devices
+   */
+  void EnableBinary (std::string prefix, NetDeviceContainer d);
+
+  /**
+   * @brief Enable binary trace output on each device in the container which
+   * is of the appropriate type.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param d container of devices
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, NetDeviceContainer d);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the 
+   * appropriate type) in the nodes provided in the container.
+   *
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param n container of nodes.
+   */
+  void EnableBinary (std::string prefix, NodeContainer n);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the 
+   * appropriate type) in the nodes provided in the container.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param n container of nodes.
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, NodeContainer n);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the
+   * appropriate type) in the set of all nodes created in the simulation.
+   *
+   * @param prefix Filename prefix to use for binary trace files.
+   */
+  void EnableBinaryAll (std::string prefix);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the
+   * appropriate type) in the set of all nodes created in the simulation.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   */
+  void EnableBinaryAll (Ptr<BinaryTraceFile> file);
+
+  /**
+   * @brief Enable binary trace output on the device specified by a global 
+   * node-id (of a previously created node) and associated device-id.
+   *
+   * @param prefix Filename prefix to use when creating binary trace files
+   * @param nodeid The node identifier/number of the node on which to enable
+   *               binary tracing
+   * @param deviceid The device identifier/index of the device on which to
+   *               enable binary tracing
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  void EnableBinary (std::string prefix, uint32_t nodeid, uint32_t deviceid, bool explicitFilename);
+
+  /**
+   * @brief Enable binary trace output on the device specified by a global 
+   * node-id (of a previously created node) and associated device-id.
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param nodeid The node identifier/number of the node on which to enable
+   *               binary tracing
+   * @param deviceid The device identifier/index of the device on which to
+   *               enable binary tracing
+   */
+  void EnableBinary (Ptr<BinaryTraceFile> file, uint32_t nodeid, uint32_t deviceid);
+
+private:
+  /**
+   * @brief Enable binary trace output on each device in the container which
+   * is of the appropriate type (implementation).
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param d container of devices
+   */
+  void EnableBinaryImpl (Ptr<BinaryTraceFile> file, std::string prefix, NetDeviceContainer d);
+
+  /**
+   * @brief Enable binary trace output on each device (which is of the
+   * appropriate type) in the nodes provided in the container (implementation).
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param n container of nodes.
+   */
+  void EnableBinaryImpl (Ptr<BinaryTraceFile> file, std::string prefix, NodeContainer n);
+
+  /**
+   * @brief Enable binary trace output on the device specified by a global
+   * node-id (of a previously created node) and associated device-id
+   * (implementation).
+   *
+   * @param file A BinaryTraceFile to use when writing trace data.
+   * @param prefix Filename prefix to use for binary trace files.
+   * @param nodeid The node identifier/number of the node on which to enable
+   *               binary tracing
+   * @param deviceid The device identifier/index of the device on which to
+   *               enable binary tracing
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  void EnableBinaryImpl (Ptr<BinaryTraceFile> file, 
+                         std::string prefix, 
+                         uint32_t nodeid, 
+                         uint32_t deviceid,
+                         bool explicitFilename);
+
+  uint32_t m_binaryCaptureSize; //!< packet bytes recorded in the files created from a prefix
+};
+
 } // namespace ns3
 
 #endif /* TRACE_HELPER_H */
@@ -51,6 +51,7 @@ NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
 uint32_t Buffer::g_recommendedStart = 0;
+bool Buffer::g_useFreeList = true;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -99,11 +100,16 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
+  if (!g_useFreeList)
+    {
+      Buffer::Deallocate (data);
+      return;
+    }
   g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
+  /* feed into free list, unless the buffer was created while the free
+   * list was disabled, before the list was created */
   if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
+      !IS_INITIALIZED (g_freeList) ||
       g_freeList->size () > 1000)
     {
       Buffer::Deallocate (data);
@@ -119,6 +125,10 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
+  if (!g_useFreeList)
+    {
+      return Buffer::Allocate (dataSize);
+    }
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
@@ -159,6 +169,30 @@ Buffer::Create (uint32_t size)
 }
 #endif /* BUFFER_FREE_LIST */
 
+void
+Buffer::DisableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_useFreeList = false;
+}
+
+void
+Buffer::EnableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_useFreeList = true;
+}
+
+bool
+Buffer::IsFreeListEnabled (void)
+{
+#ifdef BUFFER_FREE_LIST
+  return g_useFreeList;
+#else
+  return false;
+#endif
+}
+
 struct Buffer::Data *
 Buffer::Allocate (uint32_t reqSize)
 {
@@ -270,7 +304,10 @@ Buffer::operator = (Buffer const&o)
       m_data = o.m_data;
       m_data->m_count++;
     }
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+  if (g_useFreeList)
+    {
+      g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+    }
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
   m_zeroAreaEnd = o.m_zeroAreaEnd;
@@ -284,7 +321,10 @@ Buffer::~Buffer ()
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+  if (g_useFreeList)
+    {
+      g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+    }
   m_data->m_count--;
   if (m_data->m_count == 0) 
     {
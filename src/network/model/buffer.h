@@ -641,6 +641,25 @@ private:
    */
   Buffer (uint32_t dataSize, bool initialize);
   ~Buffer ();
+
+  /**
+   * \brief Stop recycling the buffer data through the global free list.
+   *
+   * The free list and the global sizing heuristics are not protected
+   * by a lock. Until EnableFreeList is called, buffers only use the
+   * system allocator and do not update any global state, so they can
+   * be created and destroyed concurrently by several threads.
+   */
+  static void DisableFreeList (void);
+  /**
+   * \brief Recycle the buffer data through the global free list again.
+   */
+  static void EnableFreeList (void);
+  /**
+   * \returns true if the buffer data is recycled through the global
+   *          free list.
+   */
+  static bool IsFreeListEnabled (void);
 private:
   /**
    * This data structure is variable-sized through its last member whose size
@@ -767,6 +786,11 @@ private:
    * value.
    */
   static uint32_t g_recommendedStart;
+  /**
+   * false between DisableFreeList and EnableFreeList. When false,
+   * g_recommendedStart is not updated either.
+   */
+  static bool g_useFreeList;
 
   /**
    * offset to the start of the virtual zero area from the start
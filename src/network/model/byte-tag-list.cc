@@ -58,6 +58,7 @@ public:
   ~ByteTagListDataFreeList ();
 } g_freeList; //!< Container for struct ByteTagListData
 static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static bool g_useFreeList = true; //!< recycle the data through g_freeList
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
@@ -340,10 +341,39 @@ ByteTagList::AddAtStart (int32_t prependOffset)
 
 #ifdef USE_FREE_LIST
 
+void
+ByteTagList::DisableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_useFreeList = false;
+}
+
+void
+ByteTagList::EnableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_useFreeList = true;
+}
+
+bool
+ByteTagList::IsFreeListEnabled (void)
+{
+  return g_useFreeList;
+}
+
 struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  if (!g_useFreeList)
+    {
+      uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
+      struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+      data->count = 1;
+      data->size = size;
+      data->dirty = 0;
+      return data;
+    }
   while (!g_freeList.empty ())
     {
       struct ByteTagListData *data = g_freeList.back ();
@@ -374,8 +404,17 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  g_maxSize = std::max (g_maxSize, data->size);
   data->count--;
+  if (!g_useFreeList)
+    {
+      if (data->count == 0)
+        {
+          uint8_t *buffer = (uint8_t *)data;
+          delete [] buffer;
+        }
+      return;
+    }
+  g_maxSize = std::max (g_maxSize, data->size);
   if (data->count == 0)
     {
       if (g_freeList.size () > FREE_LIST_SIZE ||
@@ -393,6 +432,24 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
 
 #else /* USE_FREE_LIST */
 
+void
+ByteTagList::DisableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+void
+ByteTagList::EnableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+bool
+ByteTagList::IsFreeListEnabled (void)
+{
+  return false;
+}
+
 struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
@@ -225,6 +225,22 @@ private:
    */
   void AddAtStart (int32_t prependOffset);
 
+  /**
+   * \brief Stop recycling the tag storage through the global free list,
+   * so that byte tag lists can be created and destroyed concurrently
+   * by several threads.
+   */
+  static void DisableFreeList (void);
+  /**
+   * \brief Recycle the tag storage through the global free list again.
+   */
+  static void EnableFreeList (void);
+  /**
+   * \returns true if the tag storage is recycled through the global
+   *          free list.
+   */
+  static bool IsFreeListEnabled (void);
+
 private:
   /**
    * \brief Returns an iterator pointing to the very first tag in this list.
@@ -33,6 +33,7 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
+bool PacketMetadata::m_useFreeList = true;
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
@@ -48,6 +49,12 @@ PacketMetadata::DataFreeList::~DataFreeList ()
   PacketMetadata::m_enable = false;
 }
 
+void
+PacketMetadata::SetMetadataSkipped (void)
+{
+  __atomic_store_n (&m_metadataSkipped, true, __ATOMIC_RELAXED);
+}
+
 void 
 PacketMetadata::Enable (void)
 {
@@ -70,6 +77,26 @@ PacketMetadata::EnableChecking (void)
   m_enableChecking = true;
 }
 
+void
+PacketMetadata::DisableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_useFreeList = false;
+}
+
+void
+PacketMetadata::EnableFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_useFreeList = true;
+}
+
+bool
+PacketMetadata::IsFreeListEnabled (void)
+{
+  return m_useFreeList;
+}
+
 void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
@@ -571,6 +598,10 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
+  if (!m_useFreeList)
+    {
+      return PacketMetadata::Allocate (size);
+    }
   NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
   if (size > m_maxSize)
     {
@@ -597,7 +628,7 @@ void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
+  if (!m_enable || !m_useFreeList)
     {
       PacketMetadata::Deallocate (data);
       return;
@@ -666,7 +697,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   NS_LOG_FUNCTION (this << uid << size);
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
 
@@ -688,7 +719,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -736,7 +767,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   NS_ASSERT (IsStateOk ());
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -758,7 +789,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -805,7 +836,7 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   if (m_tail == 0xffff)
@@ -882,7 +913,7 @@ PacketMetadata::AddPaddingAtEnd (uint32_t end)
   NS_LOG_FUNCTION (this << end);
   if (!m_enable)
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
 }
@@ -893,7 +924,7 @@ PacketMetadata::RemoveAtStart (uint32_t start)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   NS_ASSERT (m_data != 0);
@@ -956,7 +987,7 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
   NS_ASSERT (IsStateOk ());
   if (!m_enable) 
     {
-      m_metadataSkipped = true;
+      SetMetadataSkipped ();
       return;
     }
   NS_ASSERT (m_data != 0);
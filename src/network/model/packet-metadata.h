@@ -159,6 +159,22 @@ private:
    * \brief Enable the packet metadata checking
    */
   static void EnableChecking (void);
+  /**
+   * \brief Stop recycling the metadata storage through the global
+   * free list, so that packets can be created and destroyed
+   * concurrently by several threads.
+   */
+  static void DisableFreeList (void);
+  /**
+   * \brief Recycle the metadata storage through the global free list
+   * again.
+   */
+  static void EnableFreeList (void);
+  /**
+   * \returns true if the metadata storage is recycled through the
+   *          global free list.
+   */
+  static bool IsFreeListEnabled (void);
 
   /**
    * \brief Constructor
@@ -659,6 +675,7 @@ public:
   static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
+  static bool m_useFreeList; //!< Recycle the metadata storage through m_freeList
 
   /**
    * Set to true when adding metadata to a packet is skipped because
@@ -666,6 +683,13 @@ public:
    * middle of a simulation, which isn't allowed.
    */
   static bool m_metadataSkipped;
+  /**
+   * \brief Set m_metadataSkipped
+   *
+   * The flag is set by all the threads of a MultithreadedSimulatorImpl,
+   * so it is stored atomically.
+   */
+  static void SetMetadataSkipped (void);
 
   static uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
@@ -137,10 +137,9 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -179,10 +178,9 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -205,10 +203,9 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -545,6 +542,38 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::DisableFreeLists (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Buffer::DisableFreeList ();
+  PacketMetadata::DisableFreeList ();
+  ByteTagList::DisableFreeList ();
+}
+
+void
+Packet::EnableFreeLists (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Buffer::EnableFreeList ();
+  PacketMetadata::EnableFreeList ();
+  ByteTagList::EnableFreeList ();
+}
+
+bool
+Packet::AreFreeListsEnabled (void)
+{
+  return Buffer::IsFreeListEnabled ()
+         || PacketMetadata::IsFreeListEnabled ()
+         || ByteTagList::IsFreeListEnabled ();
+}
+
+uint32_t
+Packet::AllocateUid (void)
+{
+  return __sync_fetch_and_add (&m_globalUid, 1);
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
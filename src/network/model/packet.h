@@ -503,6 +503,26 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Stop recycling the packet storage through global free lists.
+   *
+   * The Buffer, PacketMetadata and ByteTagList storage is normally
+   * recycled through global free lists which are not protected by
+   * a lock. They must be disabled while packets are created and
+   * destroyed concurrently by several threads, as they are while
+   * the MultithreadedSimulatorImpl runs several partitions.
+   */
+  static void DisableFreeLists (void);
+  /**
+   * \brief Recycle the packet storage through the global free lists
+   * again.
+   */
+  static void EnableFreeLists (void);
+  /**
+   * \returns true if any of the packet storage is recycled through
+   *          a global free list.
+   */
+  static bool AreFreeListsEnabled (void);
 
   /**
    * \brief Returns number of bytes required for packet
@@ -729,6 +749,16 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+  /**
+   * \brief Allocate the uid of a new packet.
+   *
+   * The counter is incremented atomically, so that packets created
+   * concurrently by several threads get different uids.
+   *
+   * \returns the new uid
+   */
+  static uint32_t AllocateUid (void);
+
   static uint32_t m_globalUid; //!< Global counter of packets Uid
 };
 
@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFileTestSuite");
+
+// ===========================================================================
+// Test case to make sure that the records written to a binary trace file
+// are read back, over several blocks.
+// ===========================================================================
+class BinaryTraceFileReadWriteTestCase : public TestCase
+{
+public:
+  /**
+   * \param captureSize the number of packet bytes recorded
+   */
+  BinaryTraceFileReadWriteTestCase (uint32_t captureSize);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  uint32_t m_captureSize;       //!< the number of packet bytes recorded
+  std::string m_testFilename;   //!< the name of the file
+};
+
+BinaryTraceFileReadWriteTestCase::BinaryTraceFileReadWriteTestCase (uint32_t captureSize)
+  : TestCase ("Check that BinaryTraceReader reads the records of BinaryTraceFile"),
+    m_captureSize (captureSize)
+{
+}
+
+void
+BinaryTraceFileReadWriteTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+BinaryTraceFileReadWriteTestCase::DoRun (void)
+{
+  std::ostringstream filename;
+  filename << "binary-trace-" << m_captureSize << ".btr";
+  m_testFilename = CreateTempDirFilename (filename.str ());
+
+  uint8_t data[100];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i * 3;
+    }
+
+  uint32_t nRecords = 3 * BinaryTraceFile::BLOCK_RECORDS + 10;
+  std::vector<Ptr<Packet> > packets;
+  std::vector<Time> times;
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      packets.push_back (Create<Packet> (data, i % sizeof (data)));
+      // times which do not always increase
+      times.push_back (NanoSeconds ((i * 7919) % 100000));
+    }
+  {
+    Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> (m_testFilename, m_captureSize);
+    NS_TEST_ASSERT_MSG_EQ (file->Fail (), false, "Could not open " << m_testFilename);
+    uint32_t enqueue = file->AddContext ('+', 3, 1, "/NodeList/3/DeviceList/1/$ns3::PointToPointNetDevice/TxQueue/Enqueue");
+    uint32_t receive = file->AddContext ('r', 4, 0, "");
+    NS_TEST_ASSERT_MSG_EQ (enqueue, 0, "wrong context index");
+    NS_TEST_ASSERT_MSG_EQ (receive, 1, "wrong context index");
+    for (uint32_t i = 0; i < nRecords; ++i)
+      {
+        // uids which do not always increase
+        file->Write (times[i], i % 2 ? receive : enqueue, packets[(i * 13) % packets.size ()]);
+      }
+  }
+
+  BinaryTraceReader reader (m_testFilename);
+  NS_TEST_ASSERT_MSG_EQ (reader.Fail (), false, "Could not read " << m_testFilename);
+  NS_TEST_ASSERT_MSG_EQ (reader.GetResolution (), Time::GetResolution (), "wrong time resolution");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetCaptureSize (), m_captureSize, "wrong capture size");
+  BinaryTraceReader::Record record;
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reader.Read (record), true, "missing record " << i);
+      Ptr<Packet> p = packets[(i * 13) % packets.size ()];
+      NS_TEST_ASSERT_MSG_EQ (record.time, times[i], "wrong time of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.event, (i % 2 ? 'r' : '+'), "wrong event of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.node, (i % 2 ? 4 : 3), "wrong node of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.device, (i % 2 ? 0 : 1), "wrong device of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.context.empty (), (i % 2 == 1), "wrong context of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.uid, p->GetUid (), "wrong uid of record " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.size, p->GetSize (), "wrong size of record " << i);
+      uint32_t captured = std::min (m_captureSize, p->GetSize ());
+      NS_TEST_ASSERT_MSG_EQ (record.data.size (), captured, "wrong data size of record " << i);
+      for (uint32_t j = 0; j < captured; ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) record.data[j], (uint32_t) data[j], "wrong data of record " << i);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (reader.Read (record), false, "too many records");
+  NS_TEST_ASSERT_MSG_EQ (reader.Fail (), false, "error at the end of " << m_testFilename);
+}
+
+// ===========================================================================
+// Test case to make sure that the records are converted to the layout of
+// the ascii traces.
+// ===========================================================================
+class BinaryTraceFileAsciiTestCase : public TestCase
+{
+public:
+  BinaryTraceFileAsciiTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  std::string m_testFilename;   //!< the name of the file
+};
+
+BinaryTraceFileAsciiTestCase::BinaryTraceFileAsciiTestCase ()
+  : TestCase ("Check the conversion of BinaryTraceFile records to ascii")
+{
+}
+
+void
+BinaryTraceFileAsciiTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+BinaryTraceFileAsciiTestCase::DoRun (void)
+{
+  m_testFilename = CreateTempDirFilename ("binary-trace-ascii.btr");
+  uint8_t data[4] = { 0x45, 0x00, 0x0a, 0xff };
+  Ptr<Packet> p = Create<Packet> (data, sizeof (data));
+  {
+    Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> (m_testFilename, 2);
+    uint32_t drop = file->AddContext ('d', 0, 1, "/NodeList/0/DeviceList/1/$ns3::CsmaNetDevice/TxQueue/Drop");
+    uint32_t receive = file->AddContext ('r', 0, 1, "");
+    file->Write (Seconds (1.5), drop, p);
+    file->Write (MilliSeconds (2001), receive, p);
+  }
+
+  std::ostringstream expected;
+  expected << "d 1.5 /NodeList/0/DeviceList/1/$ns3::CsmaNetDevice/TxQueue/Drop uid=" << p->GetUid ()
+           << " size=4 data=4500\n"
+           << "r 2.001 uid=" << p->GetUid () << " size=4 data=4500\n";
+  std::ostringstream ascii;
+  BinaryTraceReader reader (m_testFilename);
+  reader.PrintAscii (ascii);
+  NS_TEST_ASSERT_MSG_EQ (ascii.str (), expected.str (), "wrong ascii conversion");
+}
+
+// ===========================================================================
+// Test case to make sure that the sizes read from a corrupted file are
+// rejected before anything is allocated.
+// ===========================================================================
+class BinaryTraceFileCorruptedTestCase : public TestCase
+{
+public:
+  BinaryTraceFileCorruptedTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * \brief Write a valid header followed by a corrupted block, and read it
+   * \param block the bytes of the block
+   * \param description what is corrupted in the block
+   */
+  void CheckCorrupted (std::vector<uint8_t> const &block, std::string description);
+
+  std::string m_testFilename;   //!< the name of the file
+};
+
+BinaryTraceFileCorruptedTestCase::BinaryTraceFileCorruptedTestCase ()
+  : TestCase ("Check that BinaryTraceReader rejects corrupted block sizes")
+{
+}
+
+void
+BinaryTraceFileCorruptedTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+/**
+ * \brief Append a variable length integer, as stored in a binary trace file
+ * \param block the buffer
+ * \param v the integer
+ */
+static void
+AppendVarint (std::vector<uint8_t> &block, uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      block.push_back (static_cast<uint8_t> (v | 0x80));
+      v >>= 7;
+    }
+  block.push_back (static_cast<uint8_t> (v));
+}
+
+void
+BinaryTraceFileCorruptedTestCase::CheckCorrupted (std::vector<uint8_t> const &block,
+                                                  std::string description)
+{
+  {
+    Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> (m_testFilename, 40);
+    file->AddContext ('r', 0, 0, "");
+  }
+  {
+    std::ofstream os (m_testFilename.c_str (), std::ios::out | std::ios::binary | std::ios::app);
+    os.write ((const char *)&block[0], block.size ());
+  }
+
+  BinaryTraceReader reader (m_testFilename);
+  NS_TEST_ASSERT_MSG_EQ (reader.Fail (), false, "Could not read the header of " << m_testFilename);
+  BinaryTraceReader::Record record;
+  NS_TEST_ASSERT_MSG_EQ (reader.Read (record), false, "record read with " << description);
+  NS_TEST_ASSERT_MSG_EQ (reader.Fail (), true, "no error with " << description);
+}
+
+void
+BinaryTraceFileCorruptedTestCase::DoRun (void)
+{
+  m_testFilename = CreateTempDirFilename ("binary-trace-corrupted.btr");
+  uint64_t huge = static_cast<uint64_t> (1) << 50;
+
+  std::vector<uint8_t> block;
+  block.push_back ('C');
+  block.push_back ('d');
+  AppendVarint (block, 0);
+  AppendVarint (block, 0);
+  AppendVarint (block, huge);
+  block.push_back ('x');
+  CheckCorrupted (block, "a huge context path");
+
+  block.clear ();
+  block.push_back ('R');
+  AppendVarint (block, huge);
+  AppendVarint (block, 4);
+  block.insert (block.end (), 4, 0);
+  CheckCorrupted (block, "a huge number of records");
+
+  block.clear ();
+  block.push_back ('R');
+  AppendVarint (block, 1);
+  AppendVarint (block, huge);
+  block.insert (block.end (), 4, 0);
+  CheckCorrupted (block, "a huge block size");
+
+  // one record of context 0, whose data size exceeds the capture size
+  block.clear ();
+  block.push_back ('R');
+  AppendVarint (block, 1);
+  AppendVarint (block, 5);
+  AppendVarint (block, 0);
+  AppendVarint (block, 0);
+  AppendVarint (block, 0);
+  AppendVarint (block, 100);
+  AppendVarint (block, 100);
+  CheckCorrupted (block, "a huge data size");
+}
+
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceFileReadWriteTestCase (0), TestCase::QUICK);
+  AddTestCase (new BinaryTraceFileReadWriteTestCase (40), TestCase::QUICK);
+  AddTestCase (new BinaryTraceFileAsciiTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceFileCorruptedTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite binaryTraceFileTestSuite;
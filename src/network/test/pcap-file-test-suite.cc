@@ -21,10 +21,13 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <fstream>
+#include <vector>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/packet.h"
 
 using namespace ns3;
 
@@ -1121,6 +1124,148 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that the buffered writes of PcapFile produce the
+// same file as the direct writes.
+// ===========================================================================
+class WriteBufferTestCase : public TestCase
+{
+public:
+  WriteBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Write the same records to a file
+   * \param filename the name of the file
+   * \param bufferSize the size of the write buffer
+   * \param background whether to use the background writer
+   */
+  void WriteFile (std::string filename, uint32_t bufferSize, bool background);
+  /**
+   * \param filename the name of the file
+   * \returns the content of the file
+   */
+  std::vector<char> ReadFile (std::string filename);
+
+  std::vector<std::string> m_filenames;
+};
+
+WriteBufferTestCase::WriteBufferTestCase ()
+  : TestCase ("Check that PcapFile::SetWriteBuffer does not change the file")
+{
+}
+
+void
+WriteBufferTestCase::WriteFile (std::string filename, uint32_t bufferSize, bool background)
+{
+  PcapFile f;
+  f.SetWriteBuffer (bufferSize, background);
+  f.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  f.Init (1, 300);
+
+  uint8_t data[1000];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i * 7;
+    }
+  for (uint32_t i = 0; i < 2000; ++i)
+    {
+      // records shorter and longer than the snap length and the buffers
+      uint32_t size = (i * 37) % sizeof (data);
+      if (i % 2)
+        {
+          f.Write (i, i * 3, data, size);
+        }
+      else
+        {
+          f.Write (i, i * 3, Create<Packet> (data + i % 16, size));
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Write (" << filename << ") returns error");
+  f.Close ();
+}
+
+std::vector<char>
+WriteBufferTestCase::ReadFile (std::string filename)
+{
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  return std::vector<char> ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+}
+
+void
+WriteBufferTestCase::DoTeardown (void)
+{
+  for (uint32_t i = 0; i < m_filenames.size (); ++i)
+    {
+      if (remove (m_filenames[i].c_str ()))
+        {
+          NS_LOG_ERROR ("Failed to delete file " << m_filenames[i]);
+        }
+    }
+}
+
+void
+WriteBufferTestCase::DoRun (void)
+{
+  std::string direct = CreateTempDirFilename ("direct.pcap");
+  m_filenames.push_back (direct);
+  WriteFile (direct, 0, false);
+  std::vector<char> expected = ReadFile (direct);
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 24, "no records written");
+
+  uint32_t sizes[] = { 100, 4096, 1 << 20 };
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      for (uint32_t background = 0; background < 2; ++background)
+        {
+          std::stringstream filename;
+          filename << "buffered-" << sizes[i] << "-" << background << ".pcap";
+          std::string buffered = CreateTempDirFilename (filename.str ());
+          m_filenames.push_back (buffered);
+          WriteFile (buffered, sizes[i], background);
+          std::vector<char> actual = ReadFile (buffered);
+          NS_TEST_ASSERT_MSG_EQ (actual.size (), expected.size (), "wrong size of " << buffered);
+          NS_TEST_ASSERT_MSG_EQ ((actual == expected), true, "wrong content of " << buffered);
+        }
+    }
+
+  //
+  // Several files share the background writer.
+  //
+  std::vector<PcapFile *> files;
+  std::vector<std::string> shared;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      std::stringstream filename;
+      filename << "shared-" << i << ".pcap";
+      shared.push_back (CreateTempDirFilename (filename.str ()));
+      m_filenames.push_back (shared.back ());
+      PcapFile *f = new PcapFile;
+      f->SetWriteBuffer (256, true);
+      f->Open (shared.back (), std::ios::out);
+      f->Init (1, 300);
+      files.push_back (f);
+    }
+  uint8_t data[200];
+  memset (data, 0, sizeof (data));
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      data[0] = i;
+      files[i % 4]->Write (i, 0, data, sizeof (data));
+    }
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      files[i]->Close ();
+      delete files[i];
+      NS_TEST_ASSERT_MSG_EQ (CheckFileLength (shared[i], 24 + 250 * (16 + 200)), true,
+                             "wrong size of " << shared[i]);
+    }
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1283,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new WriteBufferTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
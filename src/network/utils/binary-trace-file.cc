@@ -0,0 +1,524 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/packet.h"
+#include "binary-trace-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+/// Magic bytes at the start of a binary trace file
+static const char BINARY_TRACE_MAGIC[8] = { 'n', 's', '3', 'b', 't', 'r', 'c', 0 };
+/// Version of the binary trace file format
+static const uint8_t BINARY_TRACE_VERSION = 1;
+/// Tag of a block registering a context
+static const uint8_t CONTEXT_BLOCK = 'C';
+/// Tag of a block of records
+static const uint8_t RECORD_BLOCK = 'R';
+
+/**
+ * \brief Append a variable length integer to a buffer
+ *
+ * The integer is stored 7 bits per byte, least significant bits first,
+ * and the high bit of each byte tells whether another byte follows.
+ *
+ * \param buffer the buffer
+ * \param v the integer
+ */
+static void
+AppendVarint (std::vector<uint8_t> &buffer, uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      buffer.push_back (static_cast<uint8_t> (v | 0x80));
+      v >>= 7;
+    }
+  buffer.push_back (static_cast<uint8_t> (v));
+}
+
+/**
+ * \brief Read a variable length integer from a buffer
+ * \param [in,out] p the position in the buffer
+ * \param end the end of the buffer
+ * \param [out] v the integer
+ * \returns false if the buffer ends before the integer
+ */
+static bool
+ReadVarint (uint8_t const *&p, uint8_t const *end, uint64_t &v)
+{
+  v = 0;
+  for (uint32_t shift = 0; p != end && shift < 64; shift += 7)
+    {
+      uint8_t byte = *p++;
+      v |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * \brief Read a variable length integer from a stream
+ * \param is the stream
+ * \param [out] v the integer
+ * \returns false if the stream ends before the integer
+ */
+static bool
+ReadVarint (std::istream &is, uint64_t &v)
+{
+  v = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      char byte;
+      if (!is.get (byte))
+        {
+          return false;
+        }
+      v |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * \param v a signed integer
+ * \returns the integer mapped to an unsigned one, small if v is close to 0
+ */
+static uint64_t
+ZigZag (int64_t v)
+{
+  return (static_cast<uint64_t> (v) << 1) ^ static_cast<uint64_t> (v >> 63);
+}
+
+/**
+ * \param v an integer returned by ZigZag
+ * \returns the signed integer
+ */
+static int64_t
+UnZigZag (uint64_t v)
+{
+  return static_cast<int64_t> (v >> 1) ^ -static_cast<int64_t> (v & 1);
+}
+
+BinaryTraceFile::BinaryTraceFile (std::string filename, uint32_t captureSize)
+  : m_captureSize (captureSize),
+    m_nContexts (0)
+{
+  NS_LOG_FUNCTION (this << filename << captureSize);
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+  FatalImpl::RegisterStream (&m_file);
+  if (!m_file.good ())
+    {
+      NS_FATAL_ERROR ("Could not open " << filename);
+    }
+
+  std::vector<uint8_t> header (BINARY_TRACE_MAGIC, BINARY_TRACE_MAGIC + sizeof (BINARY_TRACE_MAGIC));
+  AppendVarint (header, BINARY_TRACE_VERSION);
+  AppendVarint (header, Time::GetResolution ());
+  AppendVarint (header, m_captureSize);
+  m_file.write ((const char *)&header[0], header.size ());
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  FatalImpl::UnregisterStream (&m_file);
+  m_file.close ();
+}
+
+bool
+BinaryTraceFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.fail ();
+}
+
+uint32_t
+BinaryTraceFile::AddContext (char event, uint32_t node, uint32_t device, std::string path)
+{
+  NS_LOG_FUNCTION (this << event << node << device << path);
+  //
+  // The context is written right away, so that it precedes the blocks of
+  // the records which refer to it.
+  //
+  std::vector<uint8_t> block;
+  block.push_back (CONTEXT_BLOCK);
+  block.push_back (static_cast<uint8_t> (event));
+  AppendVarint (block, node);
+  AppendVarint (block, device);
+  AppendVarint (block, path.size ());
+  block.insert (block.end (), path.begin (), path.end ());
+  m_file.write ((const char *)&block[0], block.size ());
+  return m_nContexts++;
+}
+
+void
+BinaryTraceFile::Write (Time t, uint32_t context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << t << context << p);
+  NS_ASSERT (context < m_nContexts);
+  m_times.push_back (t.GetTimeStep ());
+  m_contexts.push_back (context);
+  m_uids.push_back (p->GetUid ());
+  m_sizes.push_back (p->GetSize ());
+  if (m_captureSize > 0)
+    {
+      uint32_t size = std::min (m_captureSize, p->GetSize ());
+      std::vector<uint8_t>::size_type start = m_data.size ();
+      m_data.resize (start + size);
+      if (size > 0)
+        {
+          p->CopyData (&m_data[start], size);
+        }
+      m_dataSizes.push_back (size);
+    }
+  if (m_times.size () == BLOCK_RECORDS)
+    {
+      WriteBlock ();
+    }
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_times.empty ())
+    {
+      WriteBlock ();
+    }
+  m_file.flush ();
+}
+
+void
+BinaryTraceFile::WriteBlock (void)
+{
+  NS_LOG_FUNCTION (this << m_times.size ());
+  uint32_t n = m_times.size ();
+  m_block.clear ();
+
+  int64_t lastTime = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      AppendVarint (m_block, ZigZag (m_times[i] - lastTime));
+      lastTime = m_times[i];
+    }
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      AppendVarint (m_block, m_contexts[i]);
+    }
+  uint64_t lastUid = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      AppendVarint (m_block, ZigZag (static_cast<int64_t> (m_uids[i] - lastUid)));
+      lastUid = m_uids[i];
+    }
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      AppendVarint (m_block, m_sizes[i]);
+    }
+  if (m_captureSize > 0)
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          AppendVarint (m_block, m_dataSizes[i]);
+        }
+      m_block.insert (m_block.end (), m_data.begin (), m_data.end ());
+    }
+
+  std::vector<uint8_t> header;
+  header.push_back (RECORD_BLOCK);
+  AppendVarint (header, n);
+  AppendVarint (header, m_block.size ());
+  m_file.write ((const char *)&header[0], header.size ());
+  m_file.write ((const char *)&m_block[0], m_block.size ());
+
+  m_times.clear ();
+  m_contexts.clear ();
+  m_uids.clear ();
+  m_sizes.clear ();
+  m_data.clear ();
+  m_dataSizes.clear ();
+}
+
+BinaryTraceReader::BinaryTraceReader (std::string filename)
+  : m_fileSize (0),
+    m_fail (false),
+    m_resolution (Time::NS),
+    m_captureSize (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  if (m_file.seekg (0, std::ios::end))
+    {
+      m_fileSize = m_file.tellg ();
+      m_file.seekg (0, std::ios::beg);
+    }
+
+  char magic[sizeof (BINARY_TRACE_MAGIC)];
+  uint64_t version, resolution, captureSize;
+  if (!m_file.read (magic, sizeof (magic))
+      || !std::equal (magic, magic + sizeof (magic), BINARY_TRACE_MAGIC)
+      || !ReadVarint (m_file, version) || version != BINARY_TRACE_VERSION
+      || !ReadVarint (m_file, resolution) || resolution >= Time::LAST
+      || !ReadVarint (m_file, captureSize))
+    {
+      NS_LOG_WARN ("Invalid binary trace file " << filename);
+      m_fail = true;
+      return;
+    }
+  m_resolution = static_cast<Time::Unit> (resolution);
+  m_captureSize = static_cast<uint32_t> (captureSize);
+}
+
+bool
+BinaryTraceReader::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_fail;
+}
+
+Time::Unit
+BinaryTraceReader::GetResolution (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_resolution;
+}
+
+uint32_t
+BinaryTraceReader::GetCaptureSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_captureSize;
+}
+
+bool
+BinaryTraceReader::Read (Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_next == m_records.size ())
+    {
+      if (!ReadBlock ())
+        {
+          return false;
+        }
+    }
+  record = m_records[m_next++];
+  return true;
+}
+
+uint64_t
+BinaryTraceReader::GetRemaining (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::streampos position = m_file.tellg ();
+  if (position < 0 || static_cast<uint64_t> (position) > m_fileSize)
+    {
+      return 0;
+    }
+  return m_fileSize - position;
+}
+
+bool
+BinaryTraceReader::ReadBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fail)
+    {
+      return false;
+    }
+  char tag;
+  if (!m_file.get (tag))
+    {
+      // end of the file
+      return false;
+    }
+
+  if (tag == CONTEXT_BLOCK)
+    {
+      Context context;
+      uint64_t node, device, pathSize;
+      if (!m_file.get (context.event)
+          || !ReadVarint (m_file, node) || !ReadVarint (m_file, device)
+          || !ReadVarint (m_file, pathSize))
+        {
+          m_fail = true;
+          return false;
+        }
+      if (pathSize > GetRemaining ())
+        {
+          // the sizes are checked before anything is allocated
+          m_fail = true;
+          return false;
+        }
+      context.node = static_cast<uint32_t> (node);
+      context.device = static_cast<uint32_t> (device);
+      context.path.resize (pathSize);
+      if (pathSize > 0 && !m_file.read (&context.path[0], pathSize))
+        {
+          m_fail = true;
+          return false;
+        }
+      m_contextTable.push_back (context);
+      return true;
+    }
+
+  NS_ABORT_MSG_IF (m_resolution != Time::GetResolution (),
+                   "The time resolution differs from the one of the binary trace file");
+  uint64_t n, blockSize;
+  if (tag != RECORD_BLOCK || !ReadVarint (m_file, n) || !ReadVarint (m_file, blockSize)
+      || n > BinaryTraceFile::BLOCK_RECORDS || blockSize > GetRemaining ())
+    {
+      m_fail = true;
+      return false;
+    }
+  std::vector<uint8_t> block (blockSize);
+  if (blockSize > 0 && !m_file.read ((char *)&block[0], blockSize))
+    {
+      m_fail = true;
+      return false;
+    }
+
+  uint8_t const *p = blockSize > 0 ? &block[0] : 0;
+  uint8_t const *end = p + blockSize;
+  m_records.resize (n);
+  m_next = 0;
+  uint64_t v;
+  int64_t lastTime = 0;
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      if (!ReadVarint (p, end, v))
+        {
+          m_fail = true;
+          return false;
+        }
+      lastTime += UnZigZag (v);
+      m_records[i].time = TimeStep (lastTime);
+    }
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      if (!ReadVarint (p, end, v) || v >= m_contextTable.size ())
+        {
+          m_fail = true;
+          return false;
+        }
+      Context const &context = m_contextTable[v];
+      m_records[i].event = context.event;
+      m_records[i].node = context.node;
+      m_records[i].device = context.device;
+      m_records[i].context = context.path;
+    }
+  uint64_t lastUid = 0;
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      if (!ReadVarint (p, end, v))
+        {
+          m_fail = true;
+          return false;
+        }
+      lastUid += UnZigZag (v);
+      m_records[i].uid = lastUid;
+    }
+  for (uint64_t i = 0; i < n; ++i)
+    {
+      if (!ReadVarint (p, end, v))
+        {
+          m_fail = true;
+          return false;
+        }
+      m_records[i].size = static_cast<uint32_t> (v);
+      m_records[i].data.clear ();
+    }
+  if (m_captureSize > 0)
+    {
+      for (uint64_t i = 0; i < n; ++i)
+        {
+          if (!ReadVarint (p, end, v))
+            {
+              m_fail = true;
+              return false;
+            }
+          if (v > m_captureSize || v > static_cast<uint64_t> (end - p))
+            {
+              m_fail = true;
+              return false;
+            }
+          m_records[i].data.resize (v);
+        }
+      for (uint64_t i = 0; i < n; ++i)
+        {
+          uint32_t size = m_records[i].data.size ();
+          if (static_cast<uint64_t> (end - p) < size)
+            {
+              m_fail = true;
+              return false;
+            }
+          std::copy (p, p + size, m_records[i].data.begin ());
+          p += size;
+        }
+    }
+  return true;
+}
+
+void
+BinaryTraceReader::PrintAscii (std::ostream &os)
+{
+  NS_LOG_FUNCTION (this << &os);
+  Record record;
+  while (Read (record))
+    {
+      PrintAscii (os, record);
+    }
+}
+
+void
+BinaryTraceReader::PrintAscii (std::ostream &os, Record const &record)
+{
+  os << record.event << " " << record.time.GetSeconds () << " ";
+  if (!record.context.empty ())
+    {
+      os << record.context << " ";
+    }
+  os << "uid=" << record.uid << " size=" << record.size;
+  if (!record.data.empty ())
+    {
+      std::ios::fmtflags flags = os.flags ();
+      char fill = os.fill ('0');
+      os << " data=" << std::hex;
+      for (uint32_t i = 0; i < record.data.size (); ++i)
+        {
+          os << std::setw (2) << static_cast<uint32_t> (record.data[i]);
+        }
+      os.flags (flags);
+      os.fill (fill);
+    }
+  os << "\n";
+}
+
+} // namespace ns3
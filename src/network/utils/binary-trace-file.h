@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief A binary file of packet trace events
+ *
+ * This is the binary counterpart of the ascii traces written through
+ * OutputStreamWrapper by the AsciiTraceHelper default sinks.  Instead of
+ * a line of text with the whole packet printed, each event is recorded
+ * as a time, a context, the packet uid and the packet size, and
+ * optionally the first bytes of the packet.
+ *
+ * A context is registered once per hooked trace source with AddContext:
+ * it holds the node id, the device index, the event type ('+', '-', 'd'
+ * or 'r', as in the ascii traces) and the config path of the trace
+ * source, which is empty when the file records a single device.
+ *
+ * The records are stored by blocks of up to BLOCK_RECORDS records.  In a
+ * block, each column is stored contiguously and encoded with variable
+ * length integers: the times and the uids as differences with the
+ * previous record, and the contexts as their index in the context table.
+ * The blocks are written when they are full and when the file is flushed
+ * or destroyed.
+ *
+ * BinaryTraceReader reads the records back, and converts them to the
+ * ascii trace format.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /**
+   * \brief Create a binary trace file
+   *
+   * \param filename the name of the file
+   * \param captureSize the maximum number of packet bytes recorded with
+   * each event
+   */
+  BinaryTraceFile (std::string filename, uint32_t captureSize = 0);
+  ~BinaryTraceFile ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying stream
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Register the context of the events of a trace source
+   *
+   * \param event the event type, '+', '-', 'd' or 'r'
+   * \param node the id of the node
+   * \param device the index of the device in the node
+   * \param path the config path of the trace source, or an empty string
+   * \returns the index of the context, to pass to Write
+   */
+  uint32_t AddContext (char event, uint32_t node, uint32_t device, std::string path);
+
+  /**
+   * \brief Record an event
+   *
+   * \param t the time of the event
+   * \param context the index of the context of the event
+   * \param p the packet
+   */
+  void Write (Time t, uint32_t context, Ptr<const Packet> p);
+
+  /**
+   * \brief Write the buffered records to the file
+   */
+  void Flush (void);
+
+  /// Maximum number of records of a block
+  static const uint32_t BLOCK_RECORDS = 4096;
+
+private:
+  /**
+   * \brief Encode the buffered records and write them as a block
+   */
+  void WriteBlock (void);
+
+  std::ofstream m_file;                //!< the file
+  uint32_t m_captureSize;              //!< maximum number of packet bytes recorded
+  uint32_t m_nContexts;                //!< number of registered contexts
+  std::vector<int64_t> m_times;        //!< time column of the buffered records
+  std::vector<uint32_t> m_contexts;    //!< context column of the buffered records
+  std::vector<uint64_t> m_uids;        //!< uid column of the buffered records
+  std::vector<uint32_t> m_sizes;       //!< size column of the buffered records
+  std::vector<uint8_t> m_data;         //!< packet bytes of the buffered records
+  std::vector<uint32_t> m_dataSizes;   //!< number of packet bytes of each buffered record
+  std::vector<uint8_t> m_block;        //!< the encoded block
+};
+
+/**
+ * \brief Read a BinaryTraceFile
+ */
+class BinaryTraceReader
+{
+public:
+  /**
+   * \brief An event read from the file
+   */
+  struct Record
+  {
+    Time time;                  //!< time of the event
+    char event;                 //!< event type
+    uint32_t node;              //!< id of the node
+    uint32_t device;            //!< index of the device in the node
+    std::string context;        //!< config path of the trace source, if any
+    uint64_t uid;               //!< packet uid
+    uint32_t size;              //!< packet size
+    std::vector<uint8_t> data;  //!< first bytes of the packet
+  };
+
+  /**
+   * \brief Open a binary trace file
+   *
+   * The time resolution must be the one of the simulation which wrote the
+   * file.
+   *
+   * \param filename the name of the file
+   */
+  BinaryTraceReader (std::string filename);
+
+  /**
+   * \return true if the file could not be opened, or is not a binary
+   * trace file, or is corrupted
+   */
+  bool Fail (void) const;
+
+  /**
+   * \returns the time resolution of the simulation which wrote the file
+   */
+  Time::Unit GetResolution (void) const;
+
+  /**
+   * \returns the maximum number of packet bytes recorded with each event
+   */
+  uint32_t GetCaptureSize (void) const;
+
+  /**
+   * \brief Read the next record
+   *
+   * \param [out] record the record
+   * \returns false at the end of the file or on error
+   */
+  bool Read (Record &record);
+
+  /**
+   * \brief Convert the next records to ascii trace lines
+   *
+   * The lines have the layout of the lines written by the AsciiTraceHelper
+   * default sinks, but the packet is described by its uid, its size and
+   * its recorded bytes, in hexadecimal, instead of being printed.
+   *
+   * \param os the output stream
+   */
+  void PrintAscii (std::ostream &os);
+
+  /**
+   * \brief Print a record as an ascii trace line
+   *
+   * \param os the output stream
+   * \param record the record
+   */
+  static void PrintAscii (std::ostream &os, Record const &record);
+
+private:
+  /**
+   * \brief Read the next block of the file
+   * \returns false at the end of the file or on error
+   */
+  bool ReadBlock (void);
+  /**
+   * \returns the number of bytes of the file which are not read yet
+   */
+  uint64_t GetRemaining (void);
+
+  /**
+   * \brief A registered context
+   */
+  struct Context
+  {
+    char event;                 //!< event type
+    uint32_t node;              //!< id of the node
+    uint32_t device;            //!< index of the device in the node
+    std::string path;           //!< config path of the trace source
+  };
+
+  std::ifstream m_file;                //!< the file
+  uint64_t m_fileSize;                 //!< size of the file, in bytes
+  bool m_fail;                         //!< whether the file is invalid
+  Time::Unit m_resolution;             //!< time resolution of the file
+  uint32_t m_captureSize;              //!< maximum number of packet bytes recorded
+  std::vector<Context> m_contextTable; //!< the registered contexts
+  std::vector<Record> m_records;       //!< records of the current block
+  uint32_t m_next;                     //!< index of the next record of the block
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -246,6 +246,22 @@ Mac48Address Mac48Address::GetMulticast (Ipv6Address addr)
   return etherAddr;
 }
 
+size_t
+Mac48AddressHash::operator() (Mac48Address const &x) const
+{
+  uint8_t ad[6];
+  x.CopyTo (ad);
+
+  // FNV-1a over the six bytes: the allocated addresses differ in their
+  // last bytes only
+  uint32_t hash = 2166136261U;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      hash = (hash ^ ad[i]) * 16777619U;
+    }
+  return hash;
+}
+
 std::ostream& operator<< (std::ostream& os, const Mac48Address & address)
 {
   uint8_t ad[6];
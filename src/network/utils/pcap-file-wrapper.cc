@@ -46,6 +46,19 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size in bytes of the memory buffer in which the records are serialized "
+                   "before being written to the file.  If 0, each record is written to "
+                   "the file stream when it is received.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BackgroundWrite",
+                   "Whether the full write buffers are written to the file by a background "
+                   "thread, while the next records are serialized in a second buffer.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_backgroundWrite),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -93,6 +106,7 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  m_file.SetWriteBuffer (m_writeBufferSize, m_backgroundWrite);
   m_file.Open (filename, mode);
 }
 
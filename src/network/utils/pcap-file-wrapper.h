@@ -224,6 +224,8 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_writeBufferSize; //!< size of the write buffer, 0 to write each record
+  bool     m_backgroundWrite; //!< whether the write buffers are written by a thread
 };
 
 } // namespace ns3
@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <cstring>
+#include <list>
 #include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
@@ -29,6 +30,9 @@
 #include "pcap-file.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
 // adding any ns-3 specific constructs such as Packet to this file.
@@ -47,10 +51,216 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+const uint32_t RECORD_HEADER_SIZE = 16;       /**< Size of a record header in the file */
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \brief The thread writing the buffers of the pcap files
+ *
+ * A single thread serves all the files which use a background writer.  It
+ * runs while such files are open.  The buffers of each file are queued in
+ * order, and a file has at most one buffer queued at a time.
+ */
+class PcapFileWriter
+{
+public:
+  /**
+   * \returns the writer shared by all the pcap files
+   */
+  static PcapFileWriter *Get (void);
+  ~PcapFileWriter ();
+  /**
+   * \brief Register an open file, and start the thread for the first one
+   */
+  void AddFile (void);
+  /**
+   * \brief Unregister a file, and stop the thread after the last one
+   *
+   * The buffer of the file must have been written.
+   */
+  void RemoveFile (void);
+  /**
+   * \brief Queue the write buffer of a file
+   * \param file the file
+   */
+  void Submit (PcapFile *file);
+  /**
+   * \brief Wait until the buffer queued for a file has been written
+   * \param file the file
+   */
+  void Wait (PcapFile const *file);
+
+private:
+  PcapFileWriter ();
+  /**
+   * \brief Write the queued buffers until the writer is stopped
+   */
+  void Run (void);
+
+  /**
+   * Maximum time to wait for a condition, in nanoseconds.  SystemCondition
+   * may miss a signal sent while the condition is reset, so the waits
+   * re-check the state periodically.
+   */
+  static const uint64_t WAIT_NS = 10000000;
+
+  SystemMutex m_mutex;            //!< protects the members below and PcapFile::m_pendingBusy
+  SystemCondition m_work;         //!< signaled when a buffer is queued or the writer stops
+  SystemCondition m_done;         //!< signaled when a buffer has been written
+  std::list<PcapFile *> m_queue;  //!< files whose pending buffer is to be written
+  Ptr<SystemThread> m_thread;     //!< the writer thread
+  uint32_t m_files;               //!< number of open files using the writer
+  bool m_stop;                    //!< whether the thread should exit
+};
+
+PcapFileWriter *
+PcapFileWriter::Get (void)
+{
+  static PcapFileWriter writer;
+  return &writer;
+}
+
+PcapFileWriter::PcapFileWriter ()
+  : m_files (0),
+    m_stop (false)
+{
+}
+
+PcapFileWriter::~PcapFileWriter ()
+{
+  Ptr<SystemThread> thread;
+  {
+    CriticalSection cs (m_mutex);
+    m_stop = true;
+    thread = m_thread;
+    m_thread = 0;
+  }
+  if (thread != 0)
+    {
+      m_work.SetCondition (true);
+      m_work.Broadcast ();
+      thread->Join ();
+    }
+}
+
+void
+PcapFileWriter::AddFile (void)
+{
+  CriticalSection cs (m_mutex);
+  if (m_files++ == 0)
+    {
+      NS_LOG_LOGIC ("Starting the pcap writer thread");
+      m_stop = false;
+      m_thread = Create<SystemThread> (MakeCallback (&PcapFileWriter::Run, this));
+      m_thread->Start ();
+    }
+}
+
+void
+PcapFileWriter::RemoveFile (void)
+{
+  Ptr<SystemThread> thread;
+  {
+    CriticalSection cs (m_mutex);
+    NS_ASSERT (m_files > 0);
+    if (--m_files == 0)
+      {
+        NS_LOG_LOGIC ("Stopping the pcap writer thread");
+        m_stop = true;
+        thread = m_thread;
+        m_thread = 0;
+      }
+  }
+  if (thread != 0)
+    {
+      m_work.SetCondition (true);
+      m_work.Broadcast ();
+      thread->Join ();
+    }
+}
+
+void
+PcapFileWriter::Submit (PcapFile *file)
+{
+  Wait (file);
+  //
+  // The writer does not touch the pending buffer of the file any more, so
+  // it can be swapped with the full buffer without holding the lock.
+  //
+  file->m_buffer.swap (file->m_pending);
+  {
+    CriticalSection cs (m_mutex);
+    file->m_pendingBusy = true;
+    m_queue.push_back (file);
+  }
+  m_work.SetCondition (true);
+  m_work.Broadcast ();
+}
+
+void
+PcapFileWriter::Wait (PcapFile const *file)
+{
+  while (true)
+    {
+      {
+        CriticalSection cs (m_mutex);
+        if (!file->m_pendingBusy)
+          {
+            return;
+          }
+        m_done.SetCondition (false);
+      }
+      m_done.TimedWait (WAIT_NS);
+    }
+}
+
+void
+PcapFileWriter::Run (void)
+{
+  while (true)
+    {
+      PcapFile *file = 0;
+      {
+        CriticalSection cs (m_mutex);
+        if (!m_queue.empty ())
+          {
+            file = m_queue.front ();
+            m_queue.pop_front ();
+          }
+        else if (m_stop)
+          {
+            return;
+          }
+        else
+          {
+            m_work.SetCondition (false);
+          }
+      }
+      if (file == 0)
+        {
+          m_work.TimedWait (WAIT_NS);
+          continue;
+        }
+      file->m_file.write ((const char *)&file->m_pending[0], file->m_pending.size ());
+      file->m_pending.clear ();
+      {
+        CriticalSection cs (m_mutex);
+        file->m_pendingBusy = false;
+      }
+      m_done.SetCondition (true);
+      m_done.Broadcast ();
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_bufferSize (0),
+    m_background (false),
+    m_writerUser (false),
+    m_pendingBusy (false)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,6 +278,13 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_background)
+    {
+      // the background writer may be using the stream
+      PcapFileWriter::Get ()->Wait (this);
+    }
+#endif /* HAVE_PTHREAD_H */
   return m_file.fail ();
 }
 bool 
@@ -88,9 +305,87 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_writerUser)
+    {
+      PcapFileWriter::Get ()->RemoveFile ();
+      m_writerUser = false;
+    }
+#endif /* HAVE_PTHREAD_H */
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBuffer (uint32_t size, bool background)
+{
+  NS_LOG_FUNCTION (this << size << background);
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_writerUser && (size == 0 || !background))
+    {
+      PcapFileWriter::Get ()->RemoveFile ();
+      m_writerUser = false;
+    }
+#else
+  background = false;
+#endif /* HAVE_PTHREAD_H */
+  m_bufferSize = size;
+  m_background = size > 0 && background;
+  m_buffer.reserve (size);
+#ifdef HAVE_PTHREAD_H
+  if (m_background && !m_writerUser && m_file.is_open ())
+    {
+      PcapFileWriter::Get ()->AddFile ();
+      m_writerUser = true;
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_buffer.empty ())
+    {
+      WriteBuffer ();
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_background)
+    {
+      PcapFileWriter::Get ()->Wait (this);
+    }
+#endif /* HAVE_PTHREAD_H */
+  if (m_file.is_open ())
+    {
+      m_file.flush ();
+    }
+}
+
+void
+PcapFile::WriteBuffer (void)
+{
+  NS_LOG_FUNCTION (this << m_buffer.size ());
+#ifdef HAVE_PTHREAD_H
+  if (m_background)
+    {
+      PcapFileWriter::Get ()->Submit (this);
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  m_file.write ((const char *)&m_buffer[0], m_buffer.size ());
+  m_buffer.clear ();
+}
+
+uint8_t *
+PcapFile::AppendToBuffer (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  std::vector<uint8_t>::size_type start = m_buffer.size ();
+  m_buffer.resize (start + size);
+  return &m_buffer[start];
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -204,8 +499,9 @@ PcapFile::WriteFileHeader (void)
   NS_LOG_FUNCTION (this);
   //
   // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
+  // at the start of the file.  The buffered records are written first.
   //
+  Flush ();
   m_file.seekp (0, std::ios::beg);
  
   //
@@ -334,6 +630,13 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
 
   m_filename=filename;
   m_file.open (filename.c_str (), mode);
+#ifdef HAVE_PTHREAD_H
+  if (m_background && !m_writerUser && m_file.is_open ())
+    {
+      PcapFileWriter::Get ()->AddFile ();
+      m_writerUser = true;
+    }
+#endif /* HAVE_PTHREAD_H */
   if (mode & std::ios::in)
     {
       // will set the fail bit if file header is invalid.
@@ -403,7 +706,7 @@ uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_background || m_file.good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -418,6 +721,24 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
       Swap (&header, &header);
     }
 
+  if (m_bufferSize > 0)
+    {
+      //
+      // Make room for the whole record, so that its data can be appended
+      // to the buffer by the caller.
+      //
+      if (!m_buffer.empty () && m_buffer.size () + RECORD_HEADER_SIZE + inclLen > m_bufferSize)
+        {
+          WriteBuffer ();
+        }
+      uint8_t *start = AppendToBuffer (RECORD_HEADER_SIZE);
+      std::memcpy (start, &header.m_tsSec, sizeof(header.m_tsSec));
+      std::memcpy (start + 4, &header.m_tsUsec, sizeof(header.m_tsUsec));
+      std::memcpy (start + 8, &header.m_inclLen, sizeof(header.m_inclLen));
+      std::memcpy (start + 12, &header.m_origLen, sizeof(header.m_origLen));
+      return inclLen;
+    }
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
@@ -435,6 +756,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
+  if (m_bufferSize > 0)
+    {
+      std::memcpy (AppendToBuffer (inclLen), data, inclLen);
+      return;
+    }
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -444,6 +770,12 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_bufferSize > 0)
+    {
+      // only the first inclLen bytes of the packet are copied
+      p->CopyData (AppendToBuffer (inclLen), inclLen);
+      return;
+    }
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -460,6 +792,13 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_bufferSize > 0)
+    {
+      uint8_t *start = AppendToBuffer (inclLen);
+      headerBuffer.CopyData (start, toCopy);
+      p->CopyData (start + toCopy, inclLen - toCopy);
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
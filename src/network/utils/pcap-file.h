@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -30,6 +31,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class PcapFileWriter;
 
 
 /**
@@ -81,10 +83,39 @@ public:
   void Open (std::string const &filename, std::ios::openmode mode);
 
   /**
-   * Close the underlying file.
+   * Write the buffered records and close the underlying file.
    */
   void Close (void);
 
+  /**
+   * \brief Serialize the records in a memory buffer
+   *
+   * By default, each record is written to the underlying iostream as soon
+   * as it is received (and, in debug builds, the stream is flushed).  With
+   * a write buffer, the records are serialized in memory, and the buffer is
+   * written to the file when it is full, when Flush () is called and when
+   * the file is closed.  Records written by a simulation which crashes may
+   * thus be lost.
+   *
+   * With a background writer, the full buffers are written by a thread
+   * shared by all the pcap files, while the records which follow are
+   * serialized in a second buffer.  If that buffer fills up before the
+   * first one is written, the writing of the next record waits for it, so
+   * that at most two buffers per file are in memory.  Without threading
+   * support, the buffers are always written synchronously.
+   *
+   * \param size the size in bytes of the buffer, or 0 to write each record
+   * to the iostream
+   * \param background whether the full buffers are written by a background
+   * thread
+   */
+  void SetWriteBuffer (uint32_t size, bool background);
+
+  /**
+   * \brief Write the buffered records to the underlying file
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -290,6 +321,8 @@ public:
                     uint32_t snapLen = SNAPLEN_DEFAULT);
 
 private:
+  friend class PcapFileWriter;
+
   /**
    * \brief Pcap file header
    */
@@ -360,6 +393,23 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Extend the write buffer
+   *
+   * WritePacketHeader has already made room for the whole record, so that
+   * the extension never triggers a write of the buffer.
+   *
+   * \param size the number of bytes to add at the end of the buffer
+   * \returns a pointer to the first byte added
+   */
+  uint8_t *AppendToBuffer (uint32_t size);
+  /**
+   * \brief Hand the records of the write buffer to the file
+   *
+   * The buffer is either written synchronously or queued for the
+   * background writer.
+   */
+  void WriteBuffer (void);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -371,6 +421,12 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  uint32_t m_bufferSize;        //!< size of the write buffer, 0 if the records are not buffered
+  bool m_background;            //!< whether the buffers are written by the background writer
+  bool m_writerUser;            //!< whether the open file holds the background writer
+  std::vector<uint8_t> m_buffer;  //!< records not handed to the file yet
+  std::vector<uint8_t> m_pending; //!< records queued for the background writer
+  bool m_pendingBusy;           //!< whether m_pending is owned by the background writer
 };
 
 } // namespace ns3
@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "olsr-mpr-engine.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+/// Willingness for forwarding packets from other nodes: never.
+#define OLSR_WILL_NEVER         0
+/// Willingness for forwarding packets from other nodes: always.
+#define OLSR_WILL_ALWAYS        7
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OlsrMprEngine");
+
+namespace olsr {
+
+bool
+MprEngine::Candidate::operator < (const Candidate &other) const
+{
+  if (willingness != other.willingness)
+    {
+      return willingness < other.willingness;
+    }
+  if (reachability != other.reachability)
+    {
+      return reachability < other.reachability;
+    }
+  // The next criterion of the RFC is D(y), but RoutingProtocol::Degree
+  // only counted the 2-hop tuples of y when y was not in the neighbor
+  // set, so it was 0 for every member of N. The first neighbor in the
+  // order of N wins the ties, as before.
+  return neighbor > other.neighbor;
+}
+
+MprEngine::Candidate
+MprEngine::GetCandidate (uint32_t neighbor) const
+{
+  Candidate candidate;
+  candidate.willingness = m_willingness[neighbor];
+  candidate.reachability = m_reachability[neighbor];
+  candidate.neighbor = neighbor;
+  return candidate;
+}
+
+void
+MprEngine::Cover (uint32_t twoHopNeighbor)
+{
+  m_covered[twoHopNeighbor] = true;
+  const std::vector<uint32_t> &neighbors = m_neighbors[twoHopNeighbor];
+  for (std::vector<uint32_t>::const_iterator i = neighbors.begin (); i != neighbors.end (); i++)
+    {
+      bool queued = m_candidates.erase (GetCandidate (*i)) > 0;
+      m_reachability[*i]--;
+      if (queued && m_reachability[*i] > 0)
+        {
+          m_candidates.insert (GetCandidate (*i));
+        }
+    }
+}
+
+void
+MprEngine::Select (uint32_t neighbor, MprSet &mprSet)
+{
+  mprSet.insert (m_neighborAddresses[neighbor]);
+  const std::vector<uint32_t> &twoHopNeighbors = m_twoHopNeighbors[neighbor];
+  for (std::vector<uint32_t>::const_iterator i = twoHopNeighbors.begin (); i != twoHopNeighbors.end (); i++)
+    {
+      if (!m_covered[*i])
+        {
+          Cover (*i);
+        }
+    }
+}
+
+void
+MprEngine::Compute (Ipv4Address mainAddress, const NeighborSet &neighbors,
+                    const TwoHopNeighborSet &twoHopNeighbors, MprSet &mprSet)
+{
+  NS_LOG_FUNCTION (this << mainAddress);
+  mprSet.clear ();
+  m_neighborIndex.clear ();
+  m_twoHopNeighborIndex.clear ();
+  m_neighborAddresses.clear ();
+  m_willingness.clear ();
+  m_candidates.clear ();
+
+  // N is the set of the symmetric neighbors.
+  for (NeighborSet::const_iterator neighbor = neighbors.begin ();
+       neighbor != neighbors.end (); neighbor++)
+    {
+      if (neighbor->status == NeighborTuple::STATUS_SYM
+          && m_neighborIndex.insert (std::make_pair (neighbor->neighborMainAddr,
+                                                     m_neighborAddresses.size ())).second)
+        {
+          m_neighborAddresses.push_back (neighbor->neighborMainAddr);
+          m_willingness.push_back (neighbor->willingness);
+        }
+    }
+  uint32_t nNeighbors = m_neighborAddresses.size ();
+  m_reachability.assign (nNeighbors, 0);
+  if (m_twoHopNeighbors.size () < nNeighbors)
+    {
+      m_twoHopNeighbors.resize (nNeighbors);
+    }
+  for (uint32_t i = 0; i < nNeighbors; i++)
+    {
+      m_twoHopNeighbors[i].clear ();
+    }
+
+  // N2 is the set of the 2-hop neighbors reached through the members of
+  // N, excluding the links through the members with willingness
+  // WILL_NEVER, the node itself and the symmetric neighbors.
+  uint32_t nTwoHopNeighbors = 0;
+  for (TwoHopNeighborSet::const_iterator twoHopNeigh = twoHopNeighbors.begin ();
+       twoHopNeigh != twoHopNeighbors.end (); twoHopNeigh++)
+    {
+      if (twoHopNeigh->twoHopNeighborAddr == mainAddress)
+        {
+          continue;
+        }
+      std::map<Ipv4Address, uint32_t>::const_iterator neighbor =
+        m_neighborIndex.find (twoHopNeigh->neighborMainAddr);
+      if (neighbor == m_neighborIndex.end ()
+          || m_willingness[neighbor->second] == OLSR_WILL_NEVER
+          || m_neighborIndex.find (twoHopNeigh->twoHopNeighborAddr) != m_neighborIndex.end ())
+        {
+          continue;
+        }
+      std::pair<std::map<Ipv4Address, uint32_t>::iterator, bool> twoHopNeighbor =
+        m_twoHopNeighborIndex.insert (std::make_pair (twoHopNeigh->twoHopNeighborAddr,
+                                                      nTwoHopNeighbors));
+      if (twoHopNeighbor.second)
+        {
+          nTwoHopNeighbors++;
+          if (m_neighbors.size () < nTwoHopNeighbors)
+            {
+              m_neighbors.resize (nTwoHopNeighbors);
+            }
+          m_neighbors[nTwoHopNeighbors - 1].clear ();
+        }
+      m_twoHopNeighbors[neighbor->second].push_back (twoHopNeighbor.first->second);
+      m_neighbors[twoHopNeighbor.first->second].push_back (neighbor->second);
+      m_reachability[neighbor->second]++;
+    }
+  m_covered.assign (nTwoHopNeighbors, false);
+  NS_LOG_DEBUG ("N: " << nNeighbors << " neighbors, N2: " << nTwoHopNeighbors << " 2-hop neighbors");
+
+  // 1. Start with an MPR set made of all members of N with
+  // N_willingness equal to WILL_ALWAYS, and cover their 2-hop neighbors.
+  for (uint32_t i = 0; i < nNeighbors; i++)
+    {
+      if (m_willingness[i] == OLSR_WILL_ALWAYS)
+        {
+          Select (i, mprSet);
+        }
+    }
+
+  // 3. Add to the MPR set those nodes in N, which are the *only*
+  // nodes to provide reachability to a node in N2.
+  for (uint32_t i = 0; i < nTwoHopNeighbors; i++)
+    {
+      if (m_covered[i])
+        {
+          continue;
+        }
+      const std::vector<uint32_t> &reachedBy = m_neighbors[i];
+      bool onlyOne = true;
+      for (std::vector<uint32_t>::const_iterator j = reachedBy.begin (); j != reachedBy.end (); j++)
+        {
+          if (*j != reachedBy.front ())
+            {
+              onlyOne = false;
+              break;
+            }
+        }
+      if (onlyOne)
+        {
+          NS_LOG_LOGIC ("Neighbor " << m_neighborAddresses[reachedBy.front ()]
+                                    << " is the only that can reach a 2-hop neighbor => select as MPR.");
+          Select (reachedBy.front (), mprSet);
+        }
+    }
+
+  // 4. While there exist nodes in N2 which are not covered by at
+  // least one node in the MPR set, select as a MPR the node with
+  // highest N_willingness among the nodes in N with non-zero
+  // reachability, and then the highest reachability.
+  for (uint32_t i = 0; i < nNeighbors; i++)
+    {
+      if (m_reachability[i] > 0)
+        {
+          m_candidates.insert (GetCandidate (i));
+        }
+    }
+  while (!m_candidates.empty ())
+    {
+      uint32_t best = m_candidates.rbegin ()->neighbor;
+      Select (best, mprSet);
+      NS_ASSERT (m_reachability[best] == 0);
+      NS_LOG_LOGIC ("Neighbor " << m_neighborAddresses[best] << " selected as MPR, "
+                                << m_candidates.size () << " candidates left");
+    }
+}
+
+} // namespace olsr
+} // namespace ns3
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OLSR_MPR_ENGINE_H
+#define OLSR_MPR_ENGINE_H
+
+#include "olsr-repositories.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+namespace olsr {
+
+/// \ingroup olsr
+/// \brief Computes the MPR set of a node with the heuristic of \RFC{3626}
+/// section 8.3.1.
+///
+/// The symmetric neighbors (N) and the 2-hop neighbors which they reach
+/// (N2) are numbered densely, in the order of the neighbor and 2-hop
+/// neighbor sets. The 2-hop neighbors covered by the MPR set are marked
+/// in a bitset, and the reachability of each neighbor, i.e., the number
+/// of links to the 2-hop neighbors not covered yet, is decreased when a
+/// 2-hop neighbor becomes covered. The candidates of step 4 are kept in
+/// a set ordered by selection priority, so that each step takes the best
+/// one instead of counting the reachability of all the neighbors again.
+///
+/// The buffers are kept from one computation to the next.
+class MprEngine
+{
+public:
+  /**
+   * Compute the MPR set.
+   *
+   * \param [in] mainAddress The main address of the node.
+   * \param [in] neighbors The neighbor set of the node.
+   * \param [in] twoHopNeighbors The 2-hop neighbor set of the node.
+   * \param [out] mprSet The MPR set. It is cleared first.
+   */
+  void Compute (Ipv4Address mainAddress, const NeighborSet &neighbors,
+                const TwoHopNeighborSet &twoHopNeighbors, MprSet &mprSet);
+
+private:
+  /// A neighbor which is a candidate of step 4.
+  struct Candidate
+  {
+    uint8_t willingness;   //!< The neighbor willingness.
+    uint32_t reachability; //!< The reachability of the neighbor.
+    uint32_t neighbor;     //!< The neighbor index.
+    /**
+     * \param other Another candidate.
+     * \returns True if this candidate has a lower priority than \p other.
+     */
+    bool operator < (const Candidate &other) const;
+  };
+
+  /**
+   * Add a neighbor to the MPR set and cover its 2-hop neighbors.
+   *
+   * \param [in] neighbor The neighbor index.
+   * \param [in,out] mprSet The MPR set.
+   */
+  void Select (uint32_t neighbor, MprSet &mprSet);
+  /**
+   * Mark a 2-hop neighbor as covered, and update the reachability of the
+   * neighbors which reach it.
+   *
+   * \param twoHopNeighbor The 2-hop neighbor index.
+   */
+  void Cover (uint32_t twoHopNeighbor);
+  /**
+   * \param neighbor A neighbor index.
+   * \returns The candidate of this neighbor.
+   */
+  Candidate GetCandidate (uint32_t neighbor) const;
+
+  /// The neighbor indices, by main address.
+  std::map<Ipv4Address, uint32_t> m_neighborIndex;
+  /// The 2-hop neighbor indices, by address.
+  std::map<Ipv4Address, uint32_t> m_twoHopNeighborIndex;
+  std::vector<Ipv4Address> m_neighborAddresses; //!< The neighbor main addresses.
+  std::vector<uint8_t> m_willingness;           //!< The neighbor willingness.
+  std::vector<uint32_t> m_reachability;         //!< The neighbor reachability.
+  /// The 2-hop neighbors of each neighbor, one entry per link.
+  std::vector<std::vector<uint32_t> > m_twoHopNeighbors;
+  /// The neighbors of each 2-hop neighbor, one entry per link.
+  std::vector<std::vector<uint32_t> > m_neighbors;
+  std::vector<bool> m_covered;                  //!< The covered 2-hop neighbors.
+  std::set<Candidate> m_candidates;             //!< The candidates of step 4.
+};
+
+} // namespace olsr
+} // namespace ns3
+
+#endif /* OLSR_MPR_ENGINE_H */
@@ -529,339 +529,16 @@ RoutingProtocol::RecvOlsr (Ptr<Socket> socket)
   RoutingTableComputation ();
 }
 
-///
-/// \brief This auxiliary function (defined in \RFC{3626}) is used for calculating the MPR Set.
-///
-/// \param tuple the neighbor tuple which has the main address of the node we are going to calculate its degree to.
-/// \return the degree of the node.
-///
-int
-RoutingProtocol::Degree (NeighborTuple const &tuple)
-{
-  int degree = 0;
-  for (TwoHopNeighborSet::const_iterator it = m_state.GetTwoHopNeighbors ().begin ();
-       it != m_state.GetTwoHopNeighbors ().end (); it++)
-    {
-      TwoHopNeighborTuple const &nb2hop_tuple = *it;
-      if (nb2hop_tuple.neighborMainAddr == tuple.neighborMainAddr)
-        {
-          const NeighborTuple *nb_tuple =
-            m_state.FindNeighborTuple (nb2hop_tuple.neighborMainAddr);
-          if (nb_tuple == NULL)
-            {
-              degree++;
-            }
-        }
-    }
-  return degree;
-}
-
-namespace {
-///
-/// \brief Remove all covered 2-hop neighbors from N2 set.
-/// This is a helper function used by MprComputation algorithm.
-///
-/// \param neighborMainAddr Neighbor main address.
-/// \param N2 Reference to the 2-hop neighbor set.
-///
-void
-CoverTwoHopNeighbors (Ipv4Address neighborMainAddr, TwoHopNeighborSet & N2)
-{
-  // first gather all 2-hop neighbors to be removed
-  std::set<Ipv4Address> toRemove;
-  for (TwoHopNeighborSet::iterator twoHopNeigh = N2.begin (); twoHopNeigh != N2.end (); twoHopNeigh++)
-    {
-      if (twoHopNeigh->neighborMainAddr == neighborMainAddr)
-        {
-          toRemove.insert (twoHopNeigh->twoHopNeighborAddr);
-        }
-    }
-  // Now remove all matching records from N2
-  for (TwoHopNeighborSet::iterator twoHopNeigh = N2.begin (); twoHopNeigh != N2.end (); )
-    {
-      if (toRemove.find (twoHopNeigh->twoHopNeighborAddr) != toRemove.end ())
-        {
-          twoHopNeigh = N2.erase (twoHopNeigh);
-        }
-      else
-        {
-          twoHopNeigh++;
-        }
-    }
-}
-} // anonymous namespace
-
 void
 RoutingProtocol::MprComputation ()
 {
   NS_LOG_FUNCTION (this);
+  const OlsrState &state = m_state;
 
   // MPR computation should be done for each interface. See section 8.3.1
   // (RFC 3626) for details.
   MprSet mprSet;
-
-  // N is the subset of neighbors of the node, which are
-  // neighbor "of the interface I"
-  NeighborSet N;
-  for (NeighborSet::const_iterator neighbor = m_state.GetNeighbors ().begin ();
-       neighbor != m_state.GetNeighbors ().end (); neighbor++)
-    {
-      if (neighbor->status == NeighborTuple::STATUS_SYM) // I think that we need this check
-        {
-          N.push_back (*neighbor);
-        }
-    }
-
-  // N2 is the set of 2-hop neighbors reachable from "the interface
-  // I", excluding:
-  // (i)   the nodes only reachable by members of N with willingness WILL_NEVER
-  // (ii)  the node performing the computation
-  // (iii) all the symmetric neighbors: the nodes for which there exists a symmetric
-  //       link to this node on some interface.
-  TwoHopNeighborSet N2;
-  for (TwoHopNeighborSet::const_iterator twoHopNeigh = m_state.GetTwoHopNeighbors ().begin ();
-       twoHopNeigh != m_state.GetTwoHopNeighbors ().end (); twoHopNeigh++)
-    {
-      // excluding:
-      // (ii)  the node performing the computation
-      if (twoHopNeigh->twoHopNeighborAddr == m_mainAddress)
-        {
-          continue;
-        }
-
-      //  excluding:
-      // (i)   the nodes only reachable by members of N with willingness WILL_NEVER
-      bool ok = false;
-      for (NeighborSet::const_iterator neigh = N.begin ();
-           neigh != N.end (); neigh++)
-        {
-          if (neigh->neighborMainAddr == twoHopNeigh->neighborMainAddr)
-            {
-              if (neigh->willingness == OLSR_WILL_NEVER)
-                {
-                  ok = false;
-                  break;
-                }
-              else
-                {
-                  ok = true;
-                  break;
-                }
-            }
-        }
-      if (!ok)
-        {
-          continue;
-        }
-
-      // excluding:
-      // (iii) all the symmetric neighbors: the nodes for which there exists a symmetric
-      //       link to this node on some interface.
-      for (NeighborSet::const_iterator neigh = N.begin ();
-           neigh != N.end (); neigh++)
-        {
-          if (neigh->neighborMainAddr == twoHopNeigh->twoHopNeighborAddr)
-            {
-              ok = false;
-              break;
-            }
-        }
-
-      if (ok)
-        {
-          N2.push_back (*twoHopNeigh);
-        }
-    }
-
-#ifdef NS3_LOG_ENABLE
-  {
-    std::ostringstream os;
-    os << "[";
-    for (TwoHopNeighborSet::const_iterator iter = N2.begin ();
-         iter != N2.end (); iter++)
-      {
-        TwoHopNeighborSet::const_iterator next = iter;
-        next++;
-        os << iter->neighborMainAddr << "->" << iter->twoHopNeighborAddr;
-        if (next != N2.end ())
-          {
-            os << ", ";
-          }
-      }
-    os << "]";
-    NS_LOG_DEBUG ("N2: " << os.str ());
-  }
-#endif  //NS3_LOG_ENABLE
-
-  // 1. Start with an MPR set made of all members of N with
-  // N_willingness equal to WILL_ALWAYS
-  for (NeighborSet::const_iterator neighbor = N.begin (); neighbor != N.end (); neighbor++)
-    {
-      if (neighbor->willingness == OLSR_WILL_ALWAYS)
-        {
-          mprSet.insert (neighbor->neighborMainAddr);
-          // (not in RFC but I think is needed: remove the 2-hop
-          // neighbors reachable by the MPR from N2)
-          CoverTwoHopNeighbors (neighbor->neighborMainAddr, N2);
-        }
-    }
-
-  // 2. Calculate D(y), where y is a member of N, for all nodes in N.
-  // (we do this later)
-
-  // 3. Add to the MPR set those nodes in N, which are the *only*
-  // nodes to provide reachability to a node in N2.
-  std::set<Ipv4Address> coveredTwoHopNeighbors;
-  for (TwoHopNeighborSet::const_iterator twoHopNeigh = N2.begin (); twoHopNeigh != N2.end (); twoHopNeigh++)
-    {
-      bool onlyOne = true;
-      // try to find another neighbor that can reach twoHopNeigh->twoHopNeighborAddr
-      for (TwoHopNeighborSet::const_iterator otherTwoHopNeigh = N2.begin (); otherTwoHopNeigh != N2.end (); otherTwoHopNeigh++)
-        {
-          if (otherTwoHopNeigh->twoHopNeighborAddr == twoHopNeigh->twoHopNeighborAddr
-              && otherTwoHopNeigh->neighborMainAddr != twoHopNeigh->neighborMainAddr)
-            {
-              onlyOne = false;
-              break;
-            }
-        }
-      if (onlyOne)
-        {
-          NS_LOG_LOGIC ("Neighbor " << twoHopNeigh->neighborMainAddr
-                                    << " is the only that can reach 2-hop neigh. "
-                                    << twoHopNeigh->twoHopNeighborAddr
-                                    << " => select as MPR.");
-
-          mprSet.insert (twoHopNeigh->neighborMainAddr);
-
-          // take note of all the 2-hop neighbors reachable by the newly elected MPR
-          for (TwoHopNeighborSet::const_iterator otherTwoHopNeigh = N2.begin ();
-               otherTwoHopNeigh != N2.end (); otherTwoHopNeigh++)
-            {
-              if (otherTwoHopNeigh->neighborMainAddr == twoHopNeigh->neighborMainAddr)
-                {
-                  coveredTwoHopNeighbors.insert (otherTwoHopNeigh->twoHopNeighborAddr);
-                }
-            }
-        }
-    }
-  // Remove the nodes from N2 which are now covered by a node in the MPR set.
-  for (TwoHopNeighborSet::iterator twoHopNeigh = N2.begin ();
-       twoHopNeigh != N2.end (); )
-    {
-      if (coveredTwoHopNeighbors.find (twoHopNeigh->twoHopNeighborAddr) != coveredTwoHopNeighbors.end ())
-        {
-          // This works correctly only because it is known that twoHopNeigh is reachable by exactly one neighbor,
-          // so only one record in N2 exists for each of them. This record is erased here.
-          NS_LOG_LOGIC ("2-hop neigh. " << twoHopNeigh->twoHopNeighborAddr << " is already covered by an MPR.");
-          twoHopNeigh = N2.erase (twoHopNeigh);
-        }
-      else
-        {
-          twoHopNeigh++;
-        }
-    }
-
-  // 4. While there exist nodes in N2 which are not covered by at
-  // least one node in the MPR set:
-  while (N2.begin () != N2.end ())
-    {
-
-#ifdef NS3_LOG_ENABLE
-      {
-        std::ostringstream os;
-        os << "[";
-        for (TwoHopNeighborSet::const_iterator iter = N2.begin ();
-             iter != N2.end (); iter++)
-          {
-            TwoHopNeighborSet::const_iterator next = iter;
-            next++;
-            os << iter->neighborMainAddr << "->" << iter->twoHopNeighborAddr;
-            if (next != N2.end ())
-              {
-                os << ", ";
-              }
-          }
-        os << "]";
-        NS_LOG_DEBUG ("Step 4 iteration: N2=" << os.str ());
-      }
-#endif  //NS3_LOG_ENABLE
-
-
-      // 4.1. For each node in N, calculate the reachability, i.e., the
-      // number of nodes in N2 which are not yet covered by at
-      // least one node in the MPR set, and which are reachable
-      // through this 1-hop neighbor
-      std::map<int, std::vector<const NeighborTuple *> > reachability;
-      std::set<int> rs;
-      for (NeighborSet::iterator it = N.begin (); it != N.end (); it++)
-        {
-          NeighborTuple const &nb_tuple = *it;
-          int r = 0;
-          for (TwoHopNeighborSet::iterator it2 = N2.begin (); it2 != N2.end (); it2++)
-            {
-              TwoHopNeighborTuple const &nb2hop_tuple = *it2;
-              if (nb_tuple.neighborMainAddr == nb2hop_tuple.neighborMainAddr)
-                {
-                  r++;
-                }
-            }
-          rs.insert (r);
-          reachability[r].push_back (&nb_tuple);
-        }
-
-      // 4.2. Select as a MPR the node with highest N_willingness among
-      // the nodes in N with non-zero reachability. In case of
-      // multiple choice select the node which provides
-      // reachability to the maximum number of nodes in N2. In
-      // case of multiple nodes providing the same amount of
-      // reachability, select the node as MPR whose D(y) is
-      // greater. Remove the nodes from N2 which are now covered
-      // by a node in the MPR set.
-      NeighborTuple const *max = NULL;
-      int max_r = 0;
-      for (std::set<int>::iterator it = rs.begin (); it != rs.end (); it++)
-        {
-          int r = *it;
-          if (r == 0)
-            {
-              continue;
-            }
-          for (std::vector<const NeighborTuple *>::iterator it2 = reachability[r].begin ();
-               it2 != reachability[r].end (); it2++)
-            {
-              const NeighborTuple *nb_tuple = *it2;
-              if (max == NULL || nb_tuple->willingness > max->willingness)
-                {
-                  max = nb_tuple;
-                  max_r = r;
-                }
-              else if (nb_tuple->willingness == max->willingness)
-                {
-                  if (r > max_r)
-                    {
-                      max = nb_tuple;
-                      max_r = r;
-                    }
-                  else if (r == max_r)
-                    {
-                      if (Degree (*nb_tuple) > Degree (*max))
-                        {
-                          max = nb_tuple;
-                          max_r = r;
-                        }
-                    }
-                }
-            }
-        }
-
-      if (max != NULL)
-        {
-          mprSet.insert (max->neighborMainAddr);
-          CoverTwoHopNeighbors (max->neighborMainAddr, N2);
-          NS_LOG_LOGIC (N2.size () << " 2-hop neighbors left to cover!");
-        }
-    }
+  m_mprEngine.Compute (m_mainAddress, state.GetNeighbors (), state.GetTwoHopNeighbors (), mprSet);
 
 #ifdef NS3_LOG_ENABLE
   {
@@ -907,13 +584,14 @@ RoutingProtocol::RoutingTableComputation ()
 {
   NS_LOG_DEBUG (Simulator::Now ().GetSeconds () << " s: Node " << m_mainAddress
                                                 << ": RoutingTableComputation begin...");
+  const OlsrState &state = m_state;
 
   // 1. All the entries from the routing table are removed.
   Clear ();
 
   // 2. The new routing entries are added starting with the
   // symmetric neighbors (h=1) as the destination nodes.
-  const NeighborSet &neighborSet = m_state.GetNeighbors ();
+  const NeighborSet &neighborSet = state.GetNeighbors ();
   for (NeighborSet::const_iterator it = neighborSet.begin ();
        it != neighborSet.end (); it++)
     {
@@ -980,7 +658,7 @@ RoutingProtocol::RoutingTableComputation ()
   //  least one entry in the 2-hop neighbor set where
   //  N_neighbor_main_addr correspond to a neighbor node with
   //  willingness different of WILL_NEVER,
-  const TwoHopNeighborSet &twoHopNeighbors = m_state.GetTwoHopNeighbors ();
+  const TwoHopNeighborSet &twoHopNeighbors = state.GetTwoHopNeighbors ();
   for (TwoHopNeighborSet::const_iterator it = twoHopNeighbors.begin ();
        it != twoHopNeighbors.end (); it++)
     {
@@ -1232,7 +910,8 @@ RoutingProtocol::ProcessHello (const olsr::MessageHeader &msg,
 
 #ifdef NS3_LOG_ENABLE
   {
-    const LinkSet &links = m_state.GetLinks ();
+    const OlsrState &state = m_state;
+    const LinkSet &links = state.GetLinks ();
     NS_LOG_DEBUG (Simulator::Now ().GetSeconds ()
                   << "s ** BEGIN dump Link Set for OLSR Node " << m_mainAddress);
     for (LinkSet::const_iterator link = links.begin (); link != links.end (); link++)
@@ -1241,7 +920,7 @@ RoutingProtocol::ProcessHello (const olsr::MessageHeader &msg,
       }
     NS_LOG_DEBUG ("** END dump Link Set for OLSR Node " << m_mainAddress);
 
-    const NeighborSet &neighbors = m_state.GetNeighbors ();
+    const NeighborSet &neighbors = state.GetNeighbors ();
     NS_LOG_DEBUG (Simulator::Now ().GetSeconds ()
                   << "s ** BEGIN dump Neighbor Set for OLSR Node " << m_mainAddress);
     for (NeighborSet::const_iterator neighbor = neighbors.begin (); neighbor != neighbors.end (); neighbor++)
@@ -1257,7 +936,8 @@ RoutingProtocol::ProcessHello (const olsr::MessageHeader &msg,
 
 #ifdef NS3_LOG_ENABLE
   {
-    const TwoHopNeighborSet &twoHopNeighbors = m_state.GetTwoHopNeighbors ();
+    const OlsrState &state = m_state;
+    const TwoHopNeighborSet &twoHopNeighbors = state.GetTwoHopNeighbors ();
     NS_LOG_DEBUG (Simulator::Now ().GetSeconds ()
                   << "s ** BEGIN dump TwoHopNeighbor Set for OLSR Node " << m_mainAddress);
     for (TwoHopNeighborSet::const_iterator tuple = twoHopNeighbors.begin ();
@@ -1635,6 +1315,7 @@ void
 RoutingProtocol::SendHello ()
 {
   NS_LOG_FUNCTION (this);
+  const OlsrState &state = m_state;
 
   olsr::MessageHeader msg;
   Time now = Simulator::Now ();
@@ -1687,8 +1368,8 @@ RoutingProtocol::SendHello ()
       else
         {
           bool ok = false;
-          for (NeighborSet::const_iterator nb_tuple = m_state.GetNeighbors ().begin ();
-               nb_tuple != m_state.GetNeighbors ().end ();
+          for (NeighborSet::const_iterator nb_tuple = state.GetNeighbors ().begin ();
+               nb_tuple != state.GetNeighbors ().end ();
                nb_tuple++)
             {
               if (nb_tuple->neighborMainAddr == GetMainAddress (link_tuple->neighborIfaceAddr))
@@ -3099,17 +2780,18 @@ void
 RoutingProtocol::Dump (void)
 {
 #ifdef NS3_LOG_ENABLE
+  const OlsrState &state = m_state;
   Time now = Simulator::Now ();
   NS_LOG_DEBUG ("Dumping for node with main address " << m_mainAddress);
   NS_LOG_DEBUG (" Neighbor set");
-  for (NeighborSet::const_iterator iter = m_state.GetNeighbors ().begin ();
-       iter != m_state.GetNeighbors ().end (); iter++)
+  for (NeighborSet::const_iterator iter = state.GetNeighbors ().begin ();
+       iter != state.GetNeighbors ().end (); iter++)
     {
       NS_LOG_DEBUG ("  " << *iter);
     }
   NS_LOG_DEBUG (" Two-hop neighbor set");
-  for (TwoHopNeighborSet::const_iterator iter = m_state.GetTwoHopNeighbors ().begin ();
-       iter != m_state.GetTwoHopNeighbors ().end (); iter++)
+  for (TwoHopNeighborSet::const_iterator iter = state.GetTwoHopNeighbors ().begin ();
+       iter != state.GetTwoHopNeighbors ().end (); iter++)
     {
       if (now < iter->expirationTime)
         {
@@ -26,6 +26,7 @@
 #include "olsr-header.h"
 #include "ns3/test.h"
 #include "olsr-state.h"
+#include "olsr-mpr-engine.h"
 #include "olsr-repositories.h"
 
 #include "ns3/object.h"
@@ -213,6 +214,7 @@ private:
   uint8_t m_willingness;  //!<  Willingness for forwarding packets on behalf of other nodes.
 
   OlsrState m_state;  //!< Internal state with all needed data structs.
+  MprEngine m_mprEngine;  //!< Computes the MPR set.
   Ptr<Ipv4> m_ipv4;   //!< IPv4 object the routing is linked to.
 
   /**
@@ -746,7 +748,6 @@ private:
   void PopulateMprSelectorSet (const olsr::MessageHeader &msg,
                                const olsr::MessageHeader::Hello &hello);
 
-  int Degree (NeighborTuple const &tuple);
   /// Check that address is one of my interfaces
   bool IsMyOwnAddress (const Ipv4Address & a) const;
 
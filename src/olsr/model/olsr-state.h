@@ -27,9 +27,228 @@
 
 #include "olsr-repositories.h"
 
+#include <map>
+#include <utility>
+
 namespace ns3 {
 namespace olsr {
 
+/// \ingroup olsr
+/// An index of the tuples of a set, by key, kept alongside the set.
+///
+/// The index holds the positions of the tuples in the set; the positions
+/// of the tuples with equal keys are in increasing order, so that lookups
+/// find the same tuple as a scan of the set would.  When the keys of the
+/// set are changed from outside, the index is invalidated and rebuilt
+/// at the next lookup.
+///
+/// \tparam Tuple The tuple type.
+/// \tparam KeyOf A class with a Key type, and a static Get method
+///         which returns the key of a tuple.
+template <class Tuple, class KeyOf>
+class TupleIndex
+{
+public:
+  typedef typename KeyOf::Key Key;                     //!< The key type.
+  typedef std::multimap<Key, uint32_t> Positions;      //!< The positions by key.
+  typedef typename Positions::const_iterator Iterator; //!< A position.
+  typedef std::pair<Iterator, Iterator> Range;         //!< A range of positions.
+
+  TupleIndex ()
+    : m_valid (false)
+  {
+  }
+
+  /**
+   * Invalidates the index, after the keys of the set were changed.
+   */
+  void Invalidate (void)
+  {
+    m_valid = false;
+  }
+  /**
+   * Finds the tuples with a key.
+   * \param set The set.
+   * \param key The key.
+   * \returns The positions of the tuples with this key.
+   */
+  Range Find (const std::vector<Tuple> &set, const Key &key) const
+  {
+    Update (set);
+    return m_positions.equal_range (key);
+  }
+  /**
+   * Finds the tuples with a key within an interval.
+   * \param set The set.
+   * \param first The smallest key.
+   * \param last The largest key.
+   * \returns The positions of the tuples with these keys, by key.
+   */
+  Range Find (const std::vector<Tuple> &set, const Key &first, const Key &last) const
+  {
+    Update (set);
+    return Range (m_positions.lower_bound (first), m_positions.upper_bound (last));
+  }
+  /**
+   * Indexes the tuple which was just added at the end of the set.
+   * \param set The set.
+   */
+  void Append (const std::vector<Tuple> &set)
+  {
+    if (m_valid)
+      {
+        m_positions.insert (std::make_pair (KeyOf::Get (set.back ()), set.size () - 1));
+      }
+  }
+  /**
+   * Removes a tuple from the index, before it is erased from the set.
+   * \param set The set.
+   * \param position The position of the tuple.
+   */
+  void Erase (const std::vector<Tuple> &set, uint32_t position)
+  {
+    if (!m_valid)
+      {
+        return;
+      }
+    std::pair<typename Positions::iterator, typename Positions::iterator> range =
+      m_positions.equal_range (KeyOf::Get (set[position]));
+    for (typename Positions::iterator it = range.first; it != range.second; it++)
+      {
+        if (it->second == position)
+          {
+            m_positions.erase (it);
+            break;
+          }
+      }
+    for (typename Positions::iterator it = m_positions.begin (); it != m_positions.end (); it++)
+      {
+        if (it->second > position)
+          {
+            it->second--;
+          }
+      }
+  }
+
+private:
+  /**
+   * Rebuilds the index if it is not valid.
+   * \param set The set.
+   */
+  void Update (const std::vector<Tuple> &set) const
+  {
+    if (m_valid)
+      {
+        return;
+      }
+    m_positions.clear ();
+    for (uint32_t i = 0; i < set.size (); i++)
+      {
+        m_positions.insert (std::make_pair (KeyOf::Get (set[i]), i));
+      }
+    m_valid = true;
+  }
+
+  mutable Positions m_positions; //!< The positions of the tuples, by key.
+  mutable bool m_valid;          //!< Whether m_positions matches the set.
+};
+
+/// \ingroup olsr
+/// The key of the Link Set: the neighbor interface address.
+struct LinkTupleKey
+{
+  typedef Ipv4Address Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const LinkTuple &tuple)
+  {
+    return tuple.neighborIfaceAddr;
+  }
+};
+
+/// \ingroup olsr
+/// The key of the Neighbor Set: the neighbor main address.
+struct NeighborTupleKey
+{
+  typedef Ipv4Address Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const NeighborTuple &tuple)
+  {
+    return tuple.neighborMainAddr;
+  }
+};
+
+/// \ingroup olsr
+/// The key of the 2-hop Neighbor Set: the neighbor and 2-hop neighbor main addresses.
+struct TwoHopNeighborTupleKey
+{
+  typedef std::pair<Ipv4Address, Ipv4Address> Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const TwoHopNeighborTuple &tuple)
+  {
+    return Key (tuple.neighborMainAddr, tuple.twoHopNeighborAddr);
+  }
+};
+
+/// \ingroup olsr
+/// The key of the Topology Set: the destination and last addresses.
+struct TopologyTupleKey
+{
+  typedef std::pair<Ipv4Address, Ipv4Address> Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const TopologyTuple &tuple)
+  {
+    return Key (tuple.destAddr, tuple.lastAddr);
+  }
+};
+
+/// \ingroup olsr
+/// A secondary key of the Topology Set: the last address.
+struct TopologyTupleLastKey
+{
+  typedef Ipv4Address Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const TopologyTuple &tuple)
+  {
+    return tuple.lastAddr;
+  }
+};
+
+/// \ingroup olsr
+/// The key of the MPR Selector Set: the MPR selector main address.
+struct MprSelectorTupleKey
+{
+  typedef Ipv4Address Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const MprSelectorTuple &tuple)
+  {
+    return tuple.mainAddr;
+  }
+};
+
+/// \ingroup olsr
+/// The key of the Duplicate Set: the originator address and the sequence number.
+struct DuplicateTupleKey
+{
+  typedef std::pair<Ipv4Address, uint16_t> Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const DuplicateTuple &tuple)
+  {
+    return Key (tuple.address, tuple.sequenceNumber);
+  }
+};
+
+/// \ingroup olsr
+/// The key of the Interface Association Set: the interface address.
+struct IfaceAssocTupleKey
+{
+  typedef Ipv4Address Key; //!< The key type.
+  /// \param tuple The tuple. \returns The key.
+  static Key Get (const IfaceAssocTuple &tuple)
+  {
+    return tuple.ifaceAddr;
+  }
+};
+
 /// \ingroup olsr
 /// This class encapsulates all data structures needed for maintaining internal state of an OLSR node.
 class OlsrState
@@ -48,6 +267,15 @@ protected:
   AssociationSet m_associationSet; //!<	Association Set (\RFC{3626}, section12.2). Associations obtained from HNA messages generated by other nodes.
   Associations m_associations;  //!< The node's local Host Network Associations that will be advertised using HNA messages.
 
+  TupleIndex<LinkTuple, LinkTupleKey> m_linkIndex; //!< Index of the Link Set.
+  TupleIndex<NeighborTuple, NeighborTupleKey> m_neighborIndex; //!< Index of the Neighbor Set.
+  TupleIndex<TwoHopNeighborTuple, TwoHopNeighborTupleKey> m_twoHopNeighborIndex; //!< Index of the 2-hop Neighbor Set.
+  TupleIndex<TopologyTuple, TopologyTupleKey> m_topologyIndex; //!< Index of the Topology Set.
+  TupleIndex<TopologyTuple, TopologyTupleLastKey> m_topologyLastIndex; //!< Index of the Topology Set by last address.
+  TupleIndex<MprSelectorTuple, MprSelectorTupleKey> m_mprSelectorIndex; //!< Index of the MPR Selector Set.
+  TupleIndex<DuplicateTuple, DuplicateTupleKey> m_duplicateIndex; //!< Index of the Duplicate Set.
+  TupleIndex<IfaceAssocTuple, IfaceAssocTupleKey> m_ifaceAssocIndex; //!< Index of the Interface Association Set.
+
 public:
   OlsrState ()
   {
@@ -107,10 +335,14 @@ public:
   }
   /**
    * Gets the neighbor set.
+   *
+   * The index of the set is rebuilt at the next lookup, since the
+   * caller may change the main addresses.
    * \returns The neighbor set.
    */
   NeighborSet & GetNeighbors ()
   {
+    m_neighborIndex.Invalidate ();
     return m_neighborSet;
   }
 
@@ -166,10 +398,14 @@ public:
   }
   /**
    * Gets the 2-hop neighbor set.
+   *
+   * The index of the set is rebuilt at the next lookup, since the
+   * caller may change the addresses.
    * \returns The 2-hop neighbor set.
    */
   TwoHopNeighborSet & GetTwoHopNeighbors ()
   {
+    m_twoHopNeighborIndex.Invalidate ();
     return m_twoHopNeighborSet;
   }
 
@@ -339,10 +575,14 @@ public:
   }
   /**
    * Gets a mutable reference to the interface association set.
+   *
+   * The index of the set is rebuilt at the next lookup, since the
+   * caller may change the interface addresses.
    * \returns The interface association set.
    */
   IfaceAssocSet & GetIfaceAssocSetMutable ()
   {
+    m_ifaceAssocIndex.Invalidate ();
     return m_ifaceAssocSet;
   }
 
@@ -428,6 +668,12 @@ public:
   std::vector<Ipv4Address>
   FindNeighborInterfaces (const Ipv4Address &neighborMainAddr) const;
 
+private:
+  /**
+   * Erases a topology tuple.
+   * \param position The position of the tuple in the topology set.
+   */
+  void EraseTopologyTuple (uint32_t position);
 };
 
 }
@@ -0,0 +1,343 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2004 Francisco J. Ros
+ * Copyright (c) 2007 INESC Porto
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Francisco J. Ros  <fjrm@dif.um.es>
+ *          Gustavo J. A. M. Carneiro <gjc@inescporto.pt>
+ */
+
+#ifndef OLSR_MPR_ENGINE_TEST_H
+#define OLSR_MPR_ENGINE_TEST_H
+
+#include "ns3/test.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/random-variable-stream.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup olsr
+ * \brief Check the MPR sets computed by an MprEngine for random
+ * neighborhoods against the MprComputation it replaced.
+ *
+ * The OLSR and IOLSR modules have the same repositories and engine, in
+ * their own namespaces: \p Types gives the NeighborTuple, the
+ * TwoHopNeighborTuple and the MprEngine of the module.
+ */
+template <class Types>
+class MprEngineTestCase : public TestCase
+{
+public:
+  /**
+   * \param [in] name The name of the routing protocol.
+   */
+  MprEngineTestCase (std::string name);
+  /// \brief Run test case
+  virtual void DoRun (void);
+
+private:
+  typedef typename Types::NeighborTuple NeighborTuple;             //!< Neighbor tuple type.
+  typedef typename Types::TwoHopNeighborTuple TwoHopNeighborTuple; //!< 2-hop neighbor tuple type.
+  typedef std::vector<NeighborTuple> NeighborSet;                  //!< Neighbor set type.
+  typedef std::vector<TwoHopNeighborTuple> TwoHopNeighborSet;      //!< 2-hop neighbor set type.
+  typedef std::set<Ipv4Address> MprSet;                            //!< MPR set type.
+
+  /// Willingness for forwarding packets from other nodes.
+  enum
+  {
+    WILL_NEVER = 0,  //!< Never.
+    WILL_ALWAYS = 7  //!< Always.
+  };
+
+  /**
+   * Remove the 2-hop neighbors reachable by a neighbor from N2.
+   *
+   * \param [in] neighborMainAddr The main address of the neighbor.
+   * \param [in,out] N2 The 2-hop neighbors not covered yet.
+   */
+  static void CoverTwoHopNeighbors (Ipv4Address neighborMainAddr, TwoHopNeighborSet &N2);
+  /**
+   * The MprComputation of the routing protocol before the MprEngine.
+   *
+   * \param [in] mainAddress The main address of the node.
+   * \param [in] neighbors The neighbor set of the node.
+   * \param [in] twoHopNeighbors The 2-hop neighbor set of the node.
+   * \param [out] mprSet The MPR set.
+   */
+  static void ReferenceMprComputation (Ipv4Address mainAddress, const NeighborSet &neighbors,
+                                       const TwoHopNeighborSet &twoHopNeighbors, MprSet &mprSet);
+};
+
+template <class Types>
+MprEngineTestCase<Types>::MprEngineTestCase (std::string name)
+  : TestCase ("Check the " + name + " MPR sets of random neighborhoods")
+{
+}
+
+template <class Types>
+void
+MprEngineTestCase<Types>::CoverTwoHopNeighbors (Ipv4Address neighborMainAddr, TwoHopNeighborSet &N2)
+{
+  // first gather all 2-hop neighbors to be removed
+  std::set<Ipv4Address> toRemove;
+  for (typename TwoHopNeighborSet::iterator twoHopNeigh = N2.begin (); twoHopNeigh != N2.end (); twoHopNeigh++)
+    {
+      if (twoHopNeigh->neighborMainAddr == neighborMainAddr)
+        {
+          toRemove.insert (twoHopNeigh->twoHopNeighborAddr);
+        }
+    }
+  // Now remove all matching records from N2
+  for (typename TwoHopNeighborSet::iterator twoHopNeigh = N2.begin (); twoHopNeigh != N2.end (); )
+    {
+      if (toRemove.find (twoHopNeigh->twoHopNeighborAddr) != toRemove.end ())
+        {
+          twoHopNeigh = N2.erase (twoHopNeigh);
+        }
+      else
+        {
+          twoHopNeigh++;
+        }
+    }
+}
+
+template <class Types>
+void
+MprEngineTestCase<Types>::ReferenceMprComputation (Ipv4Address mainAddress, const NeighborSet &neighbors,
+                                                   const TwoHopNeighborSet &twoHopNeighbors, MprSet &mprSet)
+{
+  mprSet.clear ();
+
+  // N is the subset of neighbors of the node, which are
+  // neighbor "of the interface I"
+  NeighborSet N;
+  for (typename NeighborSet::const_iterator neighbor = neighbors.begin ();
+       neighbor != neighbors.end (); neighbor++)
+    {
+      if (neighbor->status == NeighborTuple::STATUS_SYM)
+        {
+          N.push_back (*neighbor);
+        }
+    }
+
+  // N2 is the set of 2-hop neighbors reachable from "the interface
+  // I", excluding:
+  // (i)   the nodes only reachable by members of N with willingness WILL_NEVER
+  // (ii)  the node performing the computation
+  // (iii) all the symmetric neighbors: the nodes for which there exists a symmetric
+  //       link to this node on some interface.
+  TwoHopNeighborSet N2;
+  for (typename TwoHopNeighborSet::const_iterator twoHopNeigh = twoHopNeighbors.begin ();
+       twoHopNeigh != twoHopNeighbors.end (); twoHopNeigh++)
+    {
+      if (twoHopNeigh->twoHopNeighborAddr == mainAddress)
+        {
+          continue;
+        }
+      bool ok = false;
+      for (typename NeighborSet::const_iterator neigh = N.begin ();
+           neigh != N.end (); neigh++)
+        {
+          if (neigh->neighborMainAddr == twoHopNeigh->neighborMainAddr)
+            {
+              ok = neigh->willingness != WILL_NEVER;
+              break;
+            }
+        }
+      if (!ok)
+        {
+          continue;
+        }
+      for (typename NeighborSet::const_iterator neigh = N.begin ();
+           neigh != N.end (); neigh++)
+        {
+          if (neigh->neighborMainAddr == twoHopNeigh->twoHopNeighborAddr)
+            {
+              ok = false;
+              break;
+            }
+        }
+      if (ok)
+        {
+          N2.push_back (*twoHopNeigh);
+        }
+    }
+
+  // 1. Start with an MPR set made of all members of N with
+  // N_willingness equal to WILL_ALWAYS
+  for (typename NeighborSet::const_iterator neighbor = N.begin (); neighbor != N.end (); neighbor++)
+    {
+      if (neighbor->willingness == WILL_ALWAYS)
+        {
+          mprSet.insert (neighbor->neighborMainAddr);
+          CoverTwoHopNeighbors (neighbor->neighborMainAddr, N2);
+        }
+    }
+
+  // 3. Add to the MPR set those nodes in N, which are the *only*
+  // nodes to provide reachability to a node in N2.
+  std::set<Ipv4Address> coveredTwoHopNeighbors;
+  for (typename TwoHopNeighborSet::const_iterator twoHopNeigh = N2.begin (); twoHopNeigh != N2.end (); twoHopNeigh++)
+    {
+      bool onlyOne = true;
+      for (typename TwoHopNeighborSet::const_iterator otherTwoHopNeigh = N2.begin (); otherTwoHopNeigh != N2.end (); otherTwoHopNeigh++)
+        {
+          if (otherTwoHopNeigh->twoHopNeighborAddr == twoHopNeigh->twoHopNeighborAddr
+              && otherTwoHopNeigh->neighborMainAddr != twoHopNeigh->neighborMainAddr)
+            {
+              onlyOne = false;
+              break;
+            }
+        }
+      if (onlyOne)
+        {
+          mprSet.insert (twoHopNeigh->neighborMainAddr);
+          for (typename TwoHopNeighborSet::const_iterator otherTwoHopNeigh = N2.begin ();
+               otherTwoHopNeigh != N2.end (); otherTwoHopNeigh++)
+            {
+              if (otherTwoHopNeigh->neighborMainAddr == twoHopNeigh->neighborMainAddr)
+                {
+                  coveredTwoHopNeighbors.insert (otherTwoHopNeigh->twoHopNeighborAddr);
+                }
+            }
+        }
+    }
+  for (typename TwoHopNeighborSet::iterator twoHopNeigh = N2.begin ();
+       twoHopNeigh != N2.end (); )
+    {
+      if (coveredTwoHopNeighbors.find (twoHopNeigh->twoHopNeighborAddr) != coveredTwoHopNeighbors.end ())
+        {
+          twoHopNeigh = N2.erase (twoHopNeigh);
+        }
+      else
+        {
+          twoHopNeigh++;
+        }
+    }
+
+  // 4. While there exist nodes in N2 which are not covered by at
+  // least one node in the MPR set:
+  while (N2.begin () != N2.end ())
+    {
+      // 4.1. For each node in N, calculate the reachability.
+      std::map<int, std::vector<const NeighborTuple *> > reachability;
+      std::set<int> rs;
+      for (typename NeighborSet::iterator it = N.begin (); it != N.end (); it++)
+        {
+          NeighborTuple const &nb_tuple = *it;
+          int r = 0;
+          for (typename TwoHopNeighborSet::iterator it2 = N2.begin (); it2 != N2.end (); it2++)
+            {
+              if (nb_tuple.neighborMainAddr == it2->neighborMainAddr)
+                {
+                  r++;
+                }
+            }
+          rs.insert (r);
+          reachability[r].push_back (&nb_tuple);
+        }
+
+      // 4.2. Select the node with highest N_willingness, then with the
+      // highest reachability. D(y) was always null, so the ties were
+      // broken by the order of N.
+      NeighborTuple const *max = NULL;
+      int max_r = 0;
+      for (std::set<int>::iterator it = rs.begin (); it != rs.end (); it++)
+        {
+          int r = *it;
+          if (r == 0)
+            {
+              continue;
+            }
+          for (typename std::vector<const NeighborTuple *>::iterator it2 = reachability[r].begin ();
+               it2 != reachability[r].end (); it2++)
+            {
+              const NeighborTuple *nb_tuple = *it2;
+              if (max == NULL || nb_tuple->willingness > max->willingness)
+                {
+                  max = nb_tuple;
+                  max_r = r;
+                }
+              else if (nb_tuple->willingness == max->willingness && r > max_r)
+                {
+                  max = nb_tuple;
+                  max_r = r;
+                }
+            }
+        }
+
+      if (max != NULL)
+        {
+          mprSet.insert (max->neighborMainAddr);
+          CoverTwoHopNeighbors (max->neighborMainAddr, N2);
+        }
+    }
+}
+
+template <class Types>
+void
+MprEngineTestCase<Types>::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  Ipv4Address mainAddress ("10.0.0.1");
+  typename Types::MprEngine engine;
+
+  for (uint32_t round = 0; round < 500; ++round)
+    {
+      uint32_t nAddresses = random->GetInteger (2, 100);
+      NeighborSet neighbors;
+      std::set<Ipv4Address> addresses;
+      for (uint32_t i = 0; i < nAddresses / 3; ++i)
+        {
+          NeighborTuple neighbor;
+          neighbor.neighborMainAddr = Ipv4Address (mainAddress.Get () + random->GetInteger (1, nAddresses));
+          if (!addresses.insert (neighbor.neighborMainAddr).second)
+            {
+              continue;
+            }
+          neighbor.status = random->GetValue () < 0.8 ? NeighborTuple::STATUS_SYM : NeighborTuple::STATUS_NOT_SYM;
+          neighbor.willingness = random->GetInteger (WILL_NEVER, WILL_ALWAYS);
+          neighbors.push_back (neighbor);
+        }
+      // the 2-hop neighbors include the node itself, the neighbors and
+      // duplicate tuples.
+      TwoHopNeighborSet twoHopNeighbors;
+      for (uint32_t i = 0; i < 3 * nAddresses; ++i)
+        {
+          TwoHopNeighborTuple tuple;
+          tuple.neighborMainAddr = Ipv4Address (mainAddress.Get () + random->GetInteger (1, nAddresses));
+          tuple.twoHopNeighborAddr = Ipv4Address (mainAddress.Get () + random->GetInteger (0, nAddresses));
+          twoHopNeighbors.push_back (tuple);
+        }
+
+      MprSet mpr;
+      engine.Compute (mainAddress, neighbors, twoHopNeighbors, mpr);
+      MprSet expected;
+      ReferenceMprComputation (mainAddress, neighbors, twoHopNeighbors, expected);
+      NS_TEST_EXPECT_MSG_EQ (mpr.size (), expected.size (), "Wrong MPR set size in round " << round);
+      NS_TEST_EXPECT_MSG_EQ ((mpr == expected), true, "Wrong MPR set in round " << round);
+    }
+}
+
+} // namespace ns3
+
+#endif /* OLSR_MPR_ENGINE_TEST_H */
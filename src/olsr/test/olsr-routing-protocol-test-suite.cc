@@ -22,7 +22,9 @@
 
 #include "ns3/test.h"
 #include "ns3/olsr-routing-protocol.h"
+#include "ns3/olsr-mpr-engine.h"
 #include "ns3/ipv4-header.h"
+#include "olsr-mpr-engine-test.h"
 
 /********** Willingness **********/
 
@@ -167,6 +169,14 @@ OlsrMprTestCase::DoRun ()
   NS_TEST_EXPECT_MSG_EQ ((mpr.find ("10.0.0.9") == mpr.end ()), true, "Node 1 must NOT select node 8 as MPR");
 }
 
+/// The OLSR types of the MPR engine test
+struct OlsrMprTypes
+{
+  typedef olsr::NeighborTuple NeighborTuple;             //!< Neighbor tuple type.
+  typedef olsr::TwoHopNeighborTuple TwoHopNeighborTuple; //!< 2-hop neighbor tuple type.
+  typedef olsr::MprEngine MprEngine;                     //!< MPR engine type.
+};
+
 static class OlsrProtocolTestSuite : public TestSuite
 {
 public:
@@ -177,4 +187,5 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite ()
   : TestSuite ("routing-olsr", UNIT)
 {
   AddTestCase (new OlsrMprTestCase (), TestCase::QUICK);
+  AddTestCase (new MprEngineTestCase<OlsrMprTypes> ("OLSR"), TestCase::QUICK);
 }
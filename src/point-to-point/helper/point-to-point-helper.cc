@@ -214,6 +214,63 @@ PointToPointHelper::EnableAsciiInternal (
   Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
 }
 
+void 
+PointToPointHelper::EnableBinaryInternal (
+  Ptr<BinaryTraceFile> file, 
+  std::string prefix, 
+  Ptr<NetDevice> nd,
+  bool explicitFilename)
+{
+  //
+  // All of the binary enable functions vector through here.  We can only
+  // deal with devices of type PointToPointNetDevice.
+  //
+  Ptr<PointToPointNetDevice> device = nd->GetObject<PointToPointNetDevice> ();
+  if (device == 0)
+    {
+      NS_LOG_INFO ("PointToPointHelper::EnableBinaryInternal(): Device " << device << 
+                   " not of type ns3::PointToPointNetDevice");
+      return;
+    }
+
+  //
+  // As for the ascii traces, the events written to a file created for the
+  // device have no context, and the events written to a provided file have
+  // the config path of their trace source as context.  Unlike the ascii
+  // traces, packet printing is not needed.
+  //
+  BinaryTraceHelper binaryTraceHelper;
+  std::string devicePath;
+  std::string queuePath;
+  if (file == 0)
+    {
+      std::string filename;
+      if (explicitFilename)
+        {
+          filename = prefix;
+        }
+      else
+        {
+          filename = binaryTraceHelper.GetFilenameFromDevice (prefix, device);
+        }
+      file = binaryTraceHelper.CreateFile (filename, GetBinaryCaptureSize ());
+    }
+  else
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << nd->GetNode ()->GetId () << "/DeviceList/" << nd->GetIfIndex () << "/$ns3::PointToPointNetDevice/";
+      devicePath = oss.str ();
+      queuePath = devicePath + "TxQueue/";
+    }
+
+  binaryTraceHelper.HookDefaultSink<PointToPointNetDevice> (device, "MacRx", file, 'r', device, devicePath);
+  Ptr<Queue> queue = device->GetQueue ();
+  binaryTraceHelper.HookDefaultSink<Queue> (queue, "Enqueue", file, '+', device, queuePath);
+  binaryTraceHelper.HookDefaultSink<Queue> (queue, "Dequeue", file, '-', device, queuePath);
+  binaryTraceHelper.HookDefaultSink<Queue> (queue, "Drop", file, 'd', device, queuePath);
+  binaryTraceHelper.HookDefaultSink<PointToPointNetDevice> (device, "PhyRxDrop", file, 'd', device, devicePath);
+}
+
 NetDeviceContainer 
 PointToPointHelper::Install (NodeContainer c)
 {
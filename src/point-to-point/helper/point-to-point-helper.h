@@ -42,7 +42,8 @@ class Node;
  * "mixins".
  */
 class PointToPointHelper : public PcapHelperForDevice,
-	                   public AsciiTraceHelperForDevice
+	                   public AsciiTraceHelperForDevice,
+	                   public BinaryTraceHelperForDevice
 {
 public:
   /**
@@ -182,6 +183,23 @@ private:
     Ptr<NetDevice> nd,
     bool explicitFilename);
 
+  /**
+   * \brief Enable binary trace output on the indicated net device.
+   *
+   * NetDevice-specific implementation mechanism for hooking the trace and
+   * writing to the trace file.
+   *
+   * \param file The binary trace file to use, or 0 to create one.
+   * \param prefix Filename prefix to use for binary trace files.
+   * \param nd Net device for which you want to enable tracing.
+   * \param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  virtual void EnableBinaryInternal (
+    Ptr<BinaryTraceFile> file,
+    std::string prefix,
+    Ptr<NetDevice> nd,
+    bool explicitFilename);
+
   ObjectFactory m_queueFactory;         //!< Queue Factory
   ObjectFactory m_channelFactory;       //!< Channel Factory
   ObjectFactory m_remoteChannelFactory; //!< Remote Channel Factory
@@ -97,6 +97,16 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+  if (!m_delivery.IsNull ())
+    {
+      // The destination may be run by another thread: do not take a
+      // reference to the device. The animation trace is not fired, as
+      // its sinks would get one.
+      m_delivery (m_link[wire].m_dst->GetNodeId (), txTime + m_delay, p,
+                  MakeCallback (&PointToPointNetDevice::Receive, PeekPointer (m_link[wire].m_dst)));
+      return true;
+    }
+
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p);
@@ -121,6 +131,22 @@ PointToPointChannel::GetPointToPointDevice (uint32_t i) const
   return m_link[i].m_src;
 }
 
+void
+PointToPointChannel::SetDeliveryCallback (DeliveryCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_delivery = cb;
+}
+
+PointToPointNetDevice *
+PointToPointChannel::PeekRemoteDevice (const PointToPointNetDevice *device) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT (m_nDevices == N_DEVICES);
+  return PeekPointer (m_link[0].m_src) == device ? PeekPointer (m_link[1].m_src)
+    : PeekPointer (m_link[0].m_src);
+}
+
 Ptr<NetDevice>
 PointToPointChannel::GetDevice (uint32_t i) const
 {
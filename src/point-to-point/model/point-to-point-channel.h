@@ -22,6 +22,7 @@
 #include <list>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
+#include "ns3/callback.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
 #include "ns3/traced-callback.h"
@@ -80,6 +81,28 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+  /**
+   * \brief Callback delivering a packet to the other end of the channel
+   *
+   * The arguments are the node id of the receiving device, the delay of
+   * the reception, the packet and the receive method of the device.
+   */
+  typedef Callback<void, uint32_t, Time, Ptr<const Packet>, Callback<void, Ptr<Packet> > > DeliveryCallback;
+
+  /**
+   * \brief Deliver the packets through a callback
+   *
+   * By default, the channel schedules the reception of each packet by
+   * the other device.  A parallel simulator which runs the two devices
+   * on different threads sets this callback when it cuts the channel,
+   * so that the devices do not share the packets.  These packets are
+   * not reported to the TxRxPointToPoint trace.  A null callback
+   * restores the default.
+   *
+   * \param cb the delivery callback
+   */
+  void SetDeliveryCallback (DeliveryCallback cb);
+
   /**
    * \brief Get number of devices on this channel
    * \returns number of devices on this channel
@@ -93,6 +116,18 @@ public:
    */
   Ptr<PointToPointNetDevice> GetPointToPointDevice (uint32_t i) const;
 
+  /**
+   * \brief Get the device at the other end of the channel
+   *
+   * Unlike GetPointToPointDevice, this does not take a reference to
+   * the device, which may be run by another thread of a parallel
+   * simulator.
+   *
+   * \param device One of the two devices of the channel
+   * \returns the other device
+   */
+  PointToPointNetDevice * PeekRemoteDevice (const PointToPointNetDevice *device) const;
+
   /**
    * \brief Get NetDevice corresponding to index i on this channel
    * \param i Index number of the device requested
@@ -151,6 +186,7 @@ private:
 
   Time          m_delay;    //!< Propagation delay
   int32_t       m_nDevices; //!< Devices of this channel
+  DeliveryCallback m_delivery; //!< Delivery of the packets, if not null
 
   /**
    * The trace source for the packet transmission animation events that the 
@@ -678,6 +678,12 @@ PointToPointNetDevice::GetNode (void) const
   return m_node;
 }
 
+uint32_t
+PointToPointNetDevice::GetNodeId (void) const
+{
+  return m_node->GetId ();
+}
+
 void
 PointToPointNetDevice::SetNode (Ptr<Node> node)
 {
@@ -723,17 +729,7 @@ PointToPointNetDevice::GetRemote (void) const
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_channel->GetNDevices () == 2);
-  for (uint32_t i = 0; i < m_channel->GetNDevices (); ++i)
-    {
-      Ptr<NetDevice> tmp = m_channel->GetDevice (i);
-      if (tmp != this)
-        {
-          return tmp->GetAddress ();
-        }
-    }
-  NS_ASSERT (false);
-  // quiet compiler.
-  return Address ();
+  return m_channel->PeekRemoteDevice (this)->GetAddress ();
 }
 
 bool
@@ -149,6 +149,17 @@ public:
    */
   void Receive (Ptr<Packet> p);
 
+  /**
+   * \brief Get the id of the node of this device
+   *
+   * Unlike GetNode, this does not take a reference to the node, so
+   * the channel may call it for a device run by another thread of a
+   * parallel simulator.
+   *
+   * \returns the node id
+   */
+  uint32_t GetNodeId (void) const;
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -82,6 +82,9 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_numDevices (0),
+    m_maxRange (0.0),
+    m_gridChanged (true)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -95,6 +98,8 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_grid.Clear ();
+  m_gridPhys.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +124,16 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "If not zero, signals are only propagated to the "
+                   "receivers within this distance (in meters) of the "
+                   "transmitter, which are found without visiting the "
+                   "other receivers. Like MaxLossDb, this parameter is "
+                   "to be used to reduce the computational load of large "
+                   "networks. Tune this value with care.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -150,6 +165,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
   NS_ASSERT_MSG ((0 != rxSpectrumModel), "phy->GetRxSpectrumModel () returned 0. Please check that the RxSpectrumModel is already set for the phy before calling MultiModelSpectrumChannel::AddRx (phy)");
 
   SpectrumModelUid_t rxSpectrumModelUid = rxSpectrumModel->GetUid ();
+  m_gridChanged = true;
 
   std::vector<Ptr<SpectrumPhy> >::const_iterator it;
 
@@ -272,6 +288,30 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // the receivers in range, for each RX SpectrumModel
+  std::map<SpectrumModelUid_t, std::set<Ptr<SpectrumPhy> > > rxPhysInRange;
+  bool useGrid = m_maxRange > 0 && txMobility != 0;
+  if (useGrid)
+    {
+      UpdateGrid ();
+      std::vector<uint32_t> receivers;
+      m_grid.GetInRange (txMobility->GetPosition (), m_maxRange, receivers);
+      for (std::vector<uint32_t>::const_iterator i = receivers.begin (); i != receivers.end (); ++i)
+        {
+          Ptr<SpectrumPhy> phy = m_gridPhys[*i];
+          for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+               rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+               ++rxInfoIterator)
+            {
+              if (rxInfoIterator->second.m_rxPhySet.find (phy) != rxInfoIterator->second.m_rxPhySet.end ())
+                {
+                  rxPhysInRange[rxInfoIterator->first].insert (phy);
+                  break;
+                }
+            }
+        }
+    }
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -279,6 +319,12 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
+      const std::set<Ptr<SpectrumPhy> > &rxPhySet = useGrid ? rxPhysInRange[rxInfoIterator->first] : rxInfoIterator->second.m_rxPhySet;
+      if (rxPhySet.empty ())
+        {
+          continue;
+        }
+
       Ptr <SpectrumValue> convertedTxPowerSpectrum;
       if (txSpectrumModelUid == rxSpectrumModelUid)
         {
@@ -293,9 +339,14 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
+      // the signal parameters copied for the receivers of this
+      // SpectrumModel start from the converted PSD
+      Ptr<SpectrumValue> txPsd = txParams->psd;
+      txParams->psd = convertedTxPowerSpectrum;
 
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxPhySet.begin ();
+           rxPhyIterator != rxPhySet.end ();
            ++rxPhyIterator)
         {
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
@@ -303,9 +354,8 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+              // the signal parameters are only copied for the receivers in range
+              Ptr<SpectrumSignalParameters> rxParams;
               Time delay = MicroSeconds (0);
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
@@ -313,10 +363,10 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               if (txMobility && receiverMobility)
                 {
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (txParams->txAntenna != 0)
                     {
                       Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
@@ -341,6 +391,8 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       // beyond range
                       continue;
                     }
+                  NS_LOG_LOGIC ("copying signal parameters " << txParams);
+                  rxParams = txParams->Copy ();
                   double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
                   *(rxParams->psd) *= pathGainLinear;              
 
@@ -355,6 +407,12 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
+              if (rxParams == 0)
+                {
+                  NS_LOG_LOGIC ("copying signal parameters " << txParams);
+                  rxParams = txParams->Copy ();
+                }
+
               Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
               if (netDev)
                 {
@@ -371,11 +429,38 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                 }
             }
         }
+      txParams->psd = txPsd;
 
     }
 
 }
 
+void
+MultiModelSpectrumChannel::UpdateGrid (void)
+{
+  if (!m_gridChanged && m_grid.GetCellSize () == m_maxRange)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_grid.Clear ();
+  m_gridPhys.clear ();
+  m_grid.SetCellSize (m_maxRange);
+  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIterator->second.m_rxPhySet.begin ();
+           phyIt != rxInfoIterator->second.m_rxPhySet.end ();
+           ++phyIt)
+        {
+          m_grid.Add ((*phyIt)->GetMobility ());
+          m_gridPhys.push_back (*phyIt);
+        }
+    }
+  m_gridChanged = false;
+}
+
 void
 MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
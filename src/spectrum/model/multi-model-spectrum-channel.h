@@ -27,8 +27,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/spatial-grid.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -102,6 +104,11 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * If the MaxRange attribute is set, the receivers are kept in a
+ * SpatialGrid and a signal is only propagated to the receivers within
+ * that distance of the transmitter. The receivers must have their
+ * mobility model set before the first transmission.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -158,6 +165,11 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Put all the receivers in the spatial grid, if it is not up to date.
+   */
+  void UpdateGrid (void);
+
   /**
    * Propagation delay model to be used with this channel.
    */
@@ -201,6 +213,26 @@ private:
    */
   double m_maxLossDb;
 
+  /**
+   * Maximum distance [m] to a receiver, or zero if unlimited.
+   */
+  double m_maxRange;
+
+  /**
+   * Position of the receivers, indexed as m_gridPhys.
+   */
+  SpatialGrid m_grid;
+
+  /**
+   * The receivers in m_grid.
+   */
+  std::vector<Ptr<SpectrumPhy> > m_gridPhys;
+
+  /**
+   * Has a receiver been added since m_grid was built.
+   */
+  bool m_gridChanged;
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
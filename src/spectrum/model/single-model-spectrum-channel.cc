@@ -45,6 +45,7 @@ NS_LOG_COMPONENT_DEFINE ("SingleModelSpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SingleModelSpectrumChannel);
 
 SingleModelSpectrumChannel::SingleModelSpectrumChannel ()
+  : m_maxRange (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -53,6 +54,7 @@ void
 SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_grid.Clear ();
   m_phyList.clear ();
   m_spectrumModel = 0;
   m_propagationDelay = 0;
@@ -83,6 +85,16 @@ SingleModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "If not zero, signals are only propagated to the "
+                   "receivers within this distance (in meters) of the "
+                   "transmitter, which are found without visiting the "
+                   "other receivers. Like MaxLossDb, this parameter is "
+                   "to be used to reduce the computational load of large "
+                   "networks. Tune this value with care.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -134,25 +146,33 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
-  for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
-       rxPhyIterator != m_phyList.end ();
-       ++rxPhyIterator)
+  std::vector<uint32_t> receivers;
+  bool useGrid = m_maxRange > 0 && senderMobility != 0;
+  if (useGrid)
     {
+      UpdateGrid ();
+      m_grid.GetInRange (senderMobility->GetPosition (), m_maxRange, receivers);
+    }
+  uint32_t nReceivers = useGrid ? receivers.size () : m_phyList.size ();
+
+  for (uint32_t k = 0; k < nReceivers; ++k)
+    {
+      PhyList::const_iterator rxPhyIterator = m_phyList.begin () + (useGrid ? receivers[k] : k);
       if ((*rxPhyIterator) != txParams->txPhy)
         {
           Time delay  = MicroSeconds (0);
 
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-          NS_LOG_LOGIC ("copying signal parameters " << txParams);
-          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+          // the signal parameters are only copied for the receivers in range
+          Ptr<SpectrumSignalParameters> rxParams;
 
           if (senderMobility && receiverMobility)
             {
               double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
+              if (txParams->txAntenna != 0)
                 {
                   Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                  double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                   NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                   pathLossDb -= txAntennaGain;
                 }
@@ -177,6 +197,8 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   // beyond range
                   continue;
                 }
+              NS_LOG_LOGIC ("copying signal parameters " << txParams);
+              rxParams = txParams->Copy ();
               double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
               *(rxParams->psd) *= pathGainLinear;              
 
@@ -192,6 +214,12 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
             }
 
 
+          if (rxParams == 0)
+            {
+              NS_LOG_LOGIC ("copying signal parameters " << txParams);
+              rxParams = txParams->Copy ();
+            }
+
           Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
           if (netDev)
             {
@@ -210,6 +238,22 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 }
 
+void
+SingleModelSpectrumChannel::UpdateGrid (void)
+{
+  if (m_grid.GetN () == m_phyList.size () && m_grid.GetCellSize () == m_maxRange)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_grid.Clear ();
+  m_grid.SetCellSize (m_maxRange);
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); ++i)
+    {
+      m_grid.Add ((*i)->GetMobility ());
+    }
+}
+
 void
 SingleModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -25,6 +25,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/traced-callback.h>
+#include <ns3/spatial-grid.h>
 
 namespace ns3 {
 
@@ -36,6 +37,11 @@ namespace ns3 {
  * @brief SpectrumChannel implementation which handles a single spectrum model
  *
  * All SpectrumPhy layers attached to this SpectrumChannel
+ *
+ * If the MaxRange attribute is set, the receivers are kept in a
+ * SpatialGrid and a signal is only propagated to the receivers within
+ * that distance of the transmitter. The receivers must have their
+ * mobility model set before the first transmission.
  */
 class SingleModelSpectrumChannel : public SpectrumChannel
 {
@@ -81,11 +87,26 @@ private:
    */
   void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Put all the receivers in the spatial grid, if it is not up to date.
+   */
+  void UpdateGrid (void);
+
   /**
    * List of SpectrumPhy instances attached to the channel.
    */
   PhyList m_phyList;
 
+  /**
+   * Maximum distance [m] to a receiver, or zero if unlimited.
+   */
+  double m_maxRange;
+
+  /**
+   * Position of the receivers, indexed as m_phyList.
+   */
+  SpatialGrid m_grid;
+
   /**
    * SpectrumModel that this channel instance is supporting.
    */
@@ -228,6 +228,17 @@ SpectrumValue::Divide (double s)
 
 
 
+void
+SpectrumValue::SetSpectrumModel (Ptr<const SpectrumModel> sm)
+{
+  if (m_spectrumModel != sm)
+    {
+      m_spectrumModel = sm;
+      m_values.resize (sm->GetNumBands ());
+    }
+}
+
+
 void
 SpectrumValue::ChangeSign ()
 {
@@ -403,6 +414,73 @@ Integral (const SpectrumValue& arg)
   return i;
 }
 
+double
+Integral (const SpectrumValue& x, const SpectrumValue& y)
+{
+  NS_ASSERT (x.m_spectrumModel == y.m_spectrumModel);
+  NS_ASSERT (x.m_values.size () == y.m_values.size ());
+  NS_ASSERT (x.m_values.size () == x.m_spectrumModel->GetNumBands ());
+
+  double i = 0;
+  size_t n = x.m_values.size ();
+  Bands::const_iterator bit = x.ConstBandsBegin ();
+  for (size_t k = 0; k < n; ++k, ++bit)
+    {
+      i += x.m_values[k] * y.m_values[k] * (bit->fh - bit->fl);
+    }
+  return i;
+}
+
+void
+MultiplyAdd (SpectrumValue& res, const SpectrumValue& x, const SpectrumValue& y, const SpectrumValue& z)
+{
+  NS_ASSERT (x.m_spectrumModel == y.m_spectrumModel);
+  NS_ASSERT (x.m_spectrumModel == z.m_spectrumModel);
+  NS_ASSERT (x.m_values.size () == y.m_values.size ());
+  NS_ASSERT (x.m_values.size () == z.m_values.size ());
+
+  res.SetSpectrumModel (x.m_spectrumModel);
+  size_t n = res.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      res.m_values[i] = x.m_values[i] * y.m_values[i] + z.m_values[i];
+    }
+}
+
+void
+InterferencePlusNoise (SpectrumValue& res, const SpectrumValue& signal,
+                       const SpectrumValue& allSignals, const SpectrumValue& noise)
+{
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  NS_ASSERT (signal.m_values.size () == allSignals.m_values.size ());
+  NS_ASSERT (signal.m_values.size () == noise.m_values.size ());
+
+  res.SetSpectrumModel (signal.m_spectrumModel);
+  size_t n = res.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      res.m_values[i] = allSignals.m_values[i] - signal.m_values[i] + noise.m_values[i];
+    }
+}
+
+void
+Sinr (SpectrumValue& res, const SpectrumValue& signal,
+      const SpectrumValue& allSignals, const SpectrumValue& noise)
+{
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  NS_ASSERT (signal.m_values.size () == allSignals.m_values.size ());
+  NS_ASSERT (signal.m_values.size () == noise.m_values.size ());
+
+  res.SetSpectrumModel (signal.m_spectrumModel);
+  size_t n = res.m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      res.m_values[i] = signal.m_values[i] / (allSignals.m_values[i] - signal.m_values[i] + noise.m_values[i]);
+    }
+}
+
 
 
 Ptr<SpectrumValue>
@@ -467,9 +545,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -674,6 +751,36 @@ SpectrumValue::operator= (double rhs)
   return *this;
 }
 
+SpectrumValue&
+SpectrumValue::MultiplyAdd (const SpectrumValue& x, const SpectrumValue& y)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == y.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  NS_ASSERT (m_values.size () == y.m_values.size ());
+
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      m_values[i] += x.m_values[i] * y.m_values[i];
+    }
+  return *this;
+}
+
+SpectrumValue&
+SpectrumValue::MultiplyAdd (const SpectrumValue& x, double a)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      m_values[i] += x.m_values[i] * a;
+    }
+  return *this;
+}
+
 
 
 SpectrumValue
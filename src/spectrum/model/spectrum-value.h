@@ -409,6 +409,30 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Multiply-accumulate: add x * y to each element, in a single pass
+   * and without creating a temporary SpectrumValue, as opposed to
+   * (*this) += x * y
+   *
+   * @param x the first factor
+   * @param y the second factor
+   *
+   * @return a reference to this SpectrumValue
+   */
+  SpectrumValue& MultiplyAdd (const SpectrumValue& x, const SpectrumValue& y);
+
+  /**
+   * Multiply-accumulate: add x * a to each element, in a single pass
+   * and without creating a temporary SpectrumValue, as opposed to
+   * (*this) += x * a
+   *
+   * @param x the SpectrumValue factor
+   * @param a the flat factor
+   *
+   * @return a reference to this SpectrumValue
+   */
+  SpectrumValue& MultiplyAdd (const SpectrumValue& x, double a);
+
 
 
   /**
@@ -497,6 +521,60 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Compute x * y + z, in a single pass and into an existing
+   * SpectrumValue, as opposed to res = x * y + z which creates two
+   * temporaries. This is typically a power spectral density times a
+   * frequency-dependent gain plus a noise power spectral density.
+   *
+   * @param res the result, which is given the SpectrumModel of x. Its
+   * storage is reused if it already has this SpectrumModel, and it
+   * may be one of the operands.
+   * @param x the first factor
+   * @param y the second factor
+   * @param z the added term
+   */
+  friend void MultiplyAdd (SpectrumValue& res, const SpectrumValue& x, const SpectrumValue& y, const SpectrumValue& z);
+
+  /**
+   * Compute the interference plus noise seen by a signal, i.e.,
+   * allSignals - signal + noise, in a single pass and into an existing
+   * SpectrumValue.
+   *
+   * @param res the result, which is given the SpectrumModel of signal,
+   * as with MultiplyAdd
+   * @param signal the power spectral density of the signal
+   * @param allSignals the power spectral density of all the signals,
+   * including signal
+   * @param noise the power spectral density of the noise
+   */
+  friend void InterferencePlusNoise (SpectrumValue& res, const SpectrumValue& signal,
+                                     const SpectrumValue& allSignals, const SpectrumValue& noise);
+
+  /**
+   * Compute the SINR of a signal, i.e., signal / (allSignals - signal
+   * + noise), in a single pass and into an existing SpectrumValue.
+   *
+   * @param res the result, which is given the SpectrumModel of signal,
+   * as with MultiplyAdd
+   * @param signal the power spectral density of the signal
+   * @param allSignals the power spectral density of all the signals,
+   * including signal
+   * @param noise the power spectral density of the noise
+   */
+  friend void Sinr (SpectrumValue& res, const SpectrumValue& signal,
+                    const SpectrumValue& allSignals, const SpectrumValue& noise);
+
+  /**
+   *
+   * @param x the first factor
+   * @param y the second factor
+   *
+   * @return the value of the integral \f$\int_F x(f) y(f) df  \f$,
+   * i.e., Integral (x * y) without the temporary SpectrumValue
+   */
+  friend double Integral (const SpectrumValue& x, const SpectrumValue& y);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -555,6 +633,12 @@ private:
    * \param s flat value
    */
   void Divide (double s);
+  /**
+   * Give this SpectrumValue a SpectrumModel, keeping the values if it
+   * already has it
+   * \param sm the SpectrumModel
+   */
+  void SetSpectrumModel (Ptr<const SpectrumModel> sm);
   /**
    * Change the values sign
    */
@@ -619,6 +703,12 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+void MultiplyAdd (SpectrumValue& res, const SpectrumValue& x, const SpectrumValue& y, const SpectrumValue& z);
+void InterferencePlusNoise (SpectrumValue& res, const SpectrumValue& signal,
+                            const SpectrumValue& allSignals, const SpectrumValue& noise);
+void Sinr (SpectrumValue& res, const SpectrumValue& signal,
+           const SpectrumValue& allSignals, const SpectrumValue& noise);
+double Integral (const SpectrumValue& x, const SpectrumValue& y);
 
 
 } // namespace ns3
@@ -242,6 +242,38 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
 
+  SpectrumValue tv11 (f), tv12 (f), tv13, tv14 (f), tv15 (f);
+  MultiplyAdd (tv11, v1, v2, v3);
+  tv12 = v3;
+  tv12.MultiplyAdd (v1, v2);
+  // a SpectrumValue without SpectrumModel is given the one of the operands
+  MultiplyAdd (tv13, v1, v2, v3);
+  // the result may be one of the operands
+  tv14 = v1;
+  MultiplyAdd (tv14, tv14, v2, v3);
+  tv15 = v3;
+  tv15.MultiplyAdd (v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv11, v1 * v2 + v3, "MultiplyAdd (tv11, v1, v2, v3)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv12, v1 * v2 + v3, "tv12.MultiplyAdd (v1, v2)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv13, v1 * v2 + v3, "MultiplyAdd (tv13, v1, v2, v3)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv14, v1 * v2 + v3, "MultiplyAdd (tv14, tv14, v2, v3)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv15, v1 * doubleValue + v3, "tv15.MultiplyAdd (v1, doubleValue)"), TestCase::QUICK);
+
+  SpectrumValue signal = v1 * v1;
+  SpectrumValue allSignals = signal + v2 * v2;
+  SpectrumValue noise = v9 * v9;
+  SpectrumValue tv16 (f), tv17 (f);
+  InterferencePlusNoise (tv16, signal, allSignals, noise);
+  Sinr (tv17, signal, allSignals, noise);
+  AddTestCase (new SpectrumValueTestCase (tv16, allSignals - signal + noise, "InterferencePlusNoise (tv16, signal, allSignals, noise)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv17, signal / (allSignals - signal + noise), "Sinr (tv17, signal, allSignals, noise)"), TestCase::QUICK);
+
+  SpectrumValue tv18 (f), v18 (f);
+  tv18 = Integral (v1, v2);
+  v18 = Integral (v1 * v2);
+  AddTestCase (new SpectrumValueTestCase (tv18, v18, "Integral (v1, v2)"), TestCase::QUICK);
+
+
 }
 
 
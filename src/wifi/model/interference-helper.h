@@ -276,14 +276,18 @@ private:
    */
   void AppendEvent (Ptr<Event> event);
   /**
-   * Calculate noise and interference power in W.
+   * Calculate noise and interference power in W at the start of the
+   * event, and find the changes of the noise and interference power
+   * during the event, without copying them.
    *
    * \param event
-   * \param ni
+   * \param first the first change after the start of the event
+   * \param last the change at the end of the event, or the end of the changes
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges::const_iterator *first,
+                                      NiChanges::const_iterator *last) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -312,21 +316,27 @@ private:
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param noiseInterferenceW noise and interference power at the start of the event
+   * \param first the first change after the start of the event
+   * \param last the change at the end of the event, or the end of the changes
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, double noiseInterferenceW,
+                                  NiChanges::const_iterator first, NiChanges::const_iterator last) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param noiseInterferenceW noise and interference power at the start of the event
+   * \param first the first change after the start of the event
+   * \param last the change at the end of the event, or the end of the changes
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, double noiseInterferenceW,
+                                 NiChanges::const_iterator first, NiChanges::const_iterator last) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -334,6 +344,15 @@ private:
   NiChanges m_niChanges;
   double m_firstPower;
   bool m_rxing;
+  /**
+   * The number of NiChanges before the current time already summed by
+   * GetEnergyDuration.  The NiChanges are only added at or after the
+   * current time, so these ones keep their positions and their sum does
+   * not change until m_niChanges is pruned.
+   */
+  uint32_t m_energyChanges;
+  /// m_firstPower plus the power of the first m_energyChanges NiChanges
+  double m_energyPower;
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
   /**
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include "table-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/system-mutex.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+/**
+ * \ingroup wifi
+ * The key of a table shared by the TableErrorRateModel instances.
+ */
+struct SharedTableKey
+{
+  uint16_t model;    //!< the TypeId uid of the wrapped model
+  double minSnr;     //!< the SNR of the first bin (dB)
+  double maxSnr;     //!< the SNR of the last bin (dB)
+  double step;       //!< the SNR step between two bins (dB)
+  uint32_t mode;     //!< the WifiMode uid
+  uint32_t txVector; //!< the channel width, guard interval and number of streams
+};
+
+/**
+ * \ingroup wifi
+ * \param a the first key
+ * \param b the second key
+ * \returns true if a is before b in the lexicographic order of the fields
+ */
+static bool
+operator < (const SharedTableKey &a, const SharedTableKey &b)
+{
+  if (a.model != b.model)
+    {
+      return a.model < b.model;
+    }
+  if (a.minSnr != b.minSnr)
+    {
+      return a.minSnr < b.minSnr;
+    }
+  if (a.maxSnr != b.maxSnr)
+    {
+      return a.maxSnr < b.maxSnr;
+    }
+  if (a.step != b.step)
+    {
+      return a.step < b.step;
+    }
+  if (a.mode != b.mode)
+    {
+      return a.mode < b.mode;
+    }
+  return a.txVector < b.txVector;
+}
+
+/**
+ * \ingroup wifi
+ * \returns The tables shared by the TableErrorRateModel instances.
+ */
+static std::map<SharedTableKey, std::vector<double> > &
+GetSharedTables (void)
+{
+  static std::map<SharedTableKey, std::vector<double> > g_tables;
+  return g_tables;
+}
+
+/**
+ * \ingroup wifi
+ * \returns The mutex which protects the shared tables, as the PHYs of
+ * the partitions of a parallel simulator look them up concurrently.
+ */
+static SystemMutex &
+GetSharedTablesMutex (void)
+{
+  static SystemMutex g_tablesMutex;
+  return g_tablesMutex;
+}
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose chunk success rates are tabulated. "
+                   "A NistErrorRateModel is used if none is set.",
+                   PointerValue (),
+                   MakePointerAccessor (&TableErrorRateModel::SetErrorRateModel,
+                                        &TableErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The SNR of the first bin of the tables (dB). "
+                   "Lower SNRs are passed to the tabulated model.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::SetMinSnr,
+                                       &TableErrorRateModel::GetMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The SNR of the last bin of the tables (dB). "
+                   "Higher SNRs are passed to the tabulated model.",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&TableErrorRateModel::SetMaxSnr,
+                                       &TableErrorRateModel::GetMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The SNR step between two bins of the tables (dB). "
+                   "The smaller the step, the closer the success rates are "
+                   "to the ones of the tabulated model.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TableErrorRateModel::SetSnrStep,
+                                       &TableErrorRateModel::GetSnrStep),
+                   MakeDoubleChecker<double> (1e-4))
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+  : m_minSnr (-10.0),
+    m_maxSnr (60.0),
+    m_step (0.05)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TableErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TableErrorRateModel::SetErrorRateModel (Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_tables.clear ();
+}
+
+Ptr<ErrorRateModel>
+TableErrorRateModel::GetErrorRateModel (void) const
+{
+  if (m_model == 0)
+    {
+      m_model = CreateObject<NistErrorRateModel> ();
+    }
+  return m_model;
+}
+
+void
+TableErrorRateModel::SetMinSnr (double minSnr)
+{
+  NS_LOG_FUNCTION (this << minSnr);
+  m_minSnr = minSnr;
+  m_tables.clear ();
+}
+
+double
+TableErrorRateModel::GetMinSnr (void) const
+{
+  return m_minSnr;
+}
+
+void
+TableErrorRateModel::SetMaxSnr (double maxSnr)
+{
+  NS_LOG_FUNCTION (this << maxSnr);
+  m_maxSnr = maxSnr;
+  m_tables.clear ();
+}
+
+double
+TableErrorRateModel::GetMaxSnr (void) const
+{
+  return m_maxSnr;
+}
+
+void
+TableErrorRateModel::SetSnrStep (double step)
+{
+  NS_LOG_FUNCTION (this << step);
+  m_step = step;
+  m_tables.clear ();
+}
+
+double
+TableErrorRateModel::GetSnrStep (void) const
+{
+  return m_step;
+}
+
+const TableErrorRateModel::Table &
+TableErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1);
+    }
+  uint32_t key = (txVector.GetChannelWidth () << 16)
+    | (txVector.IsShortGuardInterval () << 8)
+    | txVector.GetNss ();
+  const Table *&table = m_tables[uid][key];
+  if (table != 0)
+    {
+      return *table;
+    }
+
+  // The tables are shared by the instances which wrap the same type of
+  // model, and the std::map keeps their addresses valid.
+  NS_ABORT_MSG_UNLESS (m_maxSnr > m_minSnr, "TableErrorRateModel: MaxSnr must be higher than MinSnr");
+  SharedTableKey sharedKey;
+  sharedKey.model = GetErrorRateModel ()->GetInstanceTypeId ().GetUid ();
+  sharedKey.minSnr = m_minSnr;
+  sharedKey.maxSnr = m_maxSnr;
+  sharedKey.step = m_step;
+  sharedKey.mode = uid;
+  sharedKey.txVector = key;
+  CriticalSection critical (GetSharedTablesMutex ());
+  Table &shared = GetSharedTables ()[sharedKey];
+  if (shared.empty ())
+    {
+      ComputeTable (mode, txVector, shared);
+    }
+  table = &shared;
+  return shared;
+}
+
+void
+TableErrorRateModel::ComputeTable (WifiMode mode, WifiTxVector txVector, Table &table) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector);
+  Ptr<ErrorRateModel> model = GetErrorRateModel ();
+  uint32_t nBins = static_cast<uint32_t> ((m_maxSnr - m_minSnr) / m_step + 0.5) + 1;
+  // A bit success rate of 1 gives a null exponent, which is clamped to
+  // DBL_MIN: the chunk success rate stays 1 for any number of bits.
+  double minValue = std::log (std::numeric_limits<double>::min ());
+  table.resize (nBins);
+  for (uint32_t i = 0; i < nBins; ++i)
+    {
+      double snr = std::pow (10.0, (m_minSnr + i * m_step) / 10.0);
+      double csr = model->GetChunkSuccessRate (mode, txVector, snr, 1);
+      if (csr <= 0)
+        {
+          // marks the bins where the success rate is null
+          table[i] = std::numeric_limits<double>::infinity ();
+        }
+      else
+        {
+          table[i] = std::max (std::log (-std::log (csr)), minValue);
+        }
+    }
+  NS_LOG_DEBUG ("mode " << mode << ", width " << txVector.GetChannelWidth () << ": " << nBins << " bins");
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  const Table &table = GetTable (mode, txVector);
+  double x = (10.0 * std::log10 (snr) - m_minSnr) / m_step;
+  // also false for a null or a NaN snr
+  if (x >= 0 && x < table.size () - 1)
+    {
+      uint32_t i = static_cast<uint32_t> (x);
+      double v0 = table[i];
+      double v1 = table[i + 1];
+      double inf = std::numeric_limits<double>::infinity ();
+      if (v0 != inf && v1 != inf)
+        {
+          double v = v0 + (x - i) * (v1 - v0);
+          return std::exp (-std::exp (v) * nbits);
+        }
+      if (v1 == inf)
+        {
+          // the success rate does not decrease with the SNR
+          return 0;
+        }
+    }
+  return GetErrorRateModel ()->GetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+} //namespace ns3
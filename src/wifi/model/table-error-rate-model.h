@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "wifi-mode.h"
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief Look up the chunk success rates of another error rate model in
+ * precomputed tables.
+ * \ingroup wifi
+ *
+ * The NistErrorRateModel and the YansErrorRateModel evaluate erfc and
+ * long series of powers for every chunk of every received frame.  This
+ * model evaluates the wrapped model once per WifiMode, on a grid of SNR
+ * values, the first time the mode is received, and then interpolates
+ * between the grid points.
+ *
+ * All the wrapped models of this module compute the success rate of a
+ * chunk of nbits bits as \f$ (1 - p)^{k \cdot nbits} \f$, where p does not
+ * depend on nbits.  The table stores, for each SNR bin,
+ * \f$ \log (-\log (csr_1)) \f$ where \f$ csr_1 \f$ is the success rate
+ * of a single bit, which varies slowly with the SNR in dB.  The success
+ * rate of a chunk is then \f$ \exp (-nbits \cdot \exp (v)) \f$ where v is
+ * interpolated linearly between the two bins around the SNR, so the
+ * absolute error on the success rate does not grow with nbits.
+ *
+ * The accuracy is set by the SnrStep attribute.  The success rate is
+ * null between two bins where the wrapped model returns a null single bit
+ * success rate, as the success rate of the wrapped model must not
+ * decrease when the SNR increases.  The SNRs between a bin with a null
+ * and a bin with a positive success rate, and the SNRs outside of the
+ * [MinSnr, MaxSnr] range, are passed to the wrapped model.  A table is
+ * computed for each WifiMode, channel width, guard interval and number
+ * of spatial streams, from which the YansErrorRateModel derives the PHY
+ * rate; the other fields of the WifiTxVector must not change the success
+ * rates of the wrapped model.
+ *
+ * The tables are shared by all the instances which wrap a model of the
+ * same TypeId with the same bins, so that they are computed once per
+ * simulation rather than once per PHY.  The success rates of the wrapped
+ * model must thus only depend on its TypeId, as for the stateless
+ * NistErrorRateModel and YansErrorRateModel.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  /**
+   * \param model the error rate model whose success rates are tabulated
+   *
+   * Setting the model discards the tables already computed.
+   */
+  void SetErrorRateModel (Ptr<ErrorRateModel> model);
+  /**
+   * \return the error rate model whose success rates are tabulated,
+   *         a NistErrorRateModel unless another model was set
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+
+  virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const;
+
+
+protected:
+  virtual void DoDispose (void);
+
+
+private:
+  /// The table of a WifiMode, one value per SNR bin
+  typedef std::vector<double> Table;
+  /// The shared tables of a WifiMode, indexed by channel width, guard interval and number of streams
+  typedef std::map<uint32_t, const Table *> Tables;
+
+  /**
+   * \param mode the WifiMode
+   * \param txVector the WifiTxVector passed to the wrapped model
+   *
+   * \return the table of the mode and of the txVector, computed if needed
+   */
+  const Table & GetTable (WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * \param mode the WifiMode
+   * \param txVector the WifiTxVector passed to the wrapped model
+   * \param table the table to fill
+   *
+   * Compute the table of the mode and of the txVector.
+   */
+  void ComputeTable (WifiMode mode, WifiTxVector txVector, Table &table) const;
+  /**
+   * \param minSnr the SNR of the first bin, in dB
+   */
+  void SetMinSnr (double minSnr);
+  /**
+   * \return the SNR of the first bin, in dB
+   */
+  double GetMinSnr (void) const;
+  /**
+   * \param maxSnr the SNR of the last bin, in dB
+   */
+  void SetMaxSnr (double maxSnr);
+  /**
+   * \return the SNR of the last bin, in dB
+   */
+  double GetMaxSnr (void) const;
+  /**
+   * \param step the SNR step between two bins, in dB
+   */
+  void SetSnrStep (double step);
+  /**
+   * \return the SNR step between two bins, in dB
+   */
+  double GetSnrStep (void) const;
+
+  mutable Ptr<ErrorRateModel> m_model;  //!< the tabulated error rate model
+  double m_minSnr;                      //!< SNR of the first bin (dB)
+  double m_maxSnr;                      //!< SNR of the last bin (dB)
+  double m_step;                        //!< SNR step between two bins (dB)
+  mutable std::vector<Tables> m_tables; //!< the shared tables used so far, indexed by WifiMode uid
+};
+
+} //namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
@@ -1992,6 +1992,18 @@ WifiPhy::NotifyMonitorSniffTx (Ptr<const Packet> packet, uint16_t channelFreqMhz
   m_phyMonitorSniffTxTrace (packet, channelFreqMhz, channelNumber, rate, preamble, txVector, aMpdu);
 }
 
+bool
+WifiPhy::IsMonitorSniffRxTraced (void) const
+{
+  return !m_phyMonitorSniffRxTrace.IsEmpty ();
+}
+
+bool
+WifiPhy::IsMonitorSniffTxTraced (void) const
+{
+  return !m_phyMonitorSniffTxTrace.IsEmpty ();
+}
+
 
 // Clause 15 rates (DSSS)
 
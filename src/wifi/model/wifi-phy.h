@@ -1579,6 +1579,22 @@ protected:
    * \return the transmission power in dBm at the given power level
    */
   double GetPowerDbm (uint8_t power) const;
+  /**
+   * Check whether a function is connected to the MonitorSnifferRx trace
+   * source, to skip building the arguments of NotifyMonitorSniffRx when
+   * none is.
+   *
+   * \return true if the MonitorSnifferRx trace source is connected
+   */
+  bool IsMonitorSniffRxTraced (void) const;
+  /**
+   * Check whether a function is connected to the MonitorSnifferTx trace
+   * source, to skip building the arguments of NotifyMonitorSniffTx when
+   * none is.
+   *
+   * \return true if the MonitorSnifferTx trace source is connected
+   */
+  bool IsMonitorSniffTxTraced (void) const;
   
   InterferenceHelper m_interference;   //!< Pointer to InterferenceHelper
   Ptr<UniformRandomVariable> m_random; //!< Provides uniform random variables.
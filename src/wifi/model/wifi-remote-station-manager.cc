@@ -378,11 +378,13 @@ WifiRemoteStationManager::DoDispose (void)
       delete (*i);
     }
   m_states.clear ();
+  m_stateIndex.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
 }
 
 void
@@ -1447,12 +1449,24 @@ WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  if (m_states.size () <= LOOKUP_INDEX_THRESHOLD)
     {
-      if ((*i)->m_address == address)
+      for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+        {
+          if ((*i)->m_address == address)
+            {
+              NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+              return (*i);
+            }
+        }
+    }
+  else
+    {
+      StationStateIndex::const_iterator i = m_stateIndex.find (address);
+      if (i != m_stateIndex.end ())
         {
           NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
+          return i->second;
         }
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
@@ -1469,7 +1483,22 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_stbc = false;
   state->m_htSupported = false;
   state->m_vhtSupported = false;
-  const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  WifiRemoteStationManager *self = const_cast<WifiRemoteStationManager *> (this);
+  self->m_states.push_back (state);
+  if (m_states.size () > LOOKUP_INDEX_THRESHOLD)
+    {
+      if (m_stateIndex.empty ())
+        {
+          for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+            {
+              self->m_stateIndex[(*i)->m_address] = (*i);
+            }
+        }
+      else
+        {
+          self->m_stateIndex[address] = state;
+        }
+    }
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1493,12 +1522,23 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << (uint16_t)tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  if (m_stations.size () <= LOOKUP_INDEX_THRESHOLD)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
+      for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
         {
-          return (*i);
+          if ((*i)->m_tid == tid
+              && (*i)->m_state->m_address == address)
+            {
+              return (*i);
+            }
+        }
+    }
+  else
+    {
+      StationIndex::const_iterator i = m_stationIndex.find (std::make_pair (address, tid));
+      if (i != m_stationIndex.end ())
+        {
+          return i->second;
         }
     }
   WifiRemoteStationState *state = LookupState (address);
@@ -1508,7 +1548,22 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
-  const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  WifiRemoteStationManager *self = const_cast<WifiRemoteStationManager *> (this);
+  self->m_stations.push_back (station);
+  if (m_stations.size () > LOOKUP_INDEX_THRESHOLD)
+    {
+      if (m_stationIndex.empty ())
+        {
+          for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+            {
+              self->m_stationIndex[std::make_pair ((*i)->m_state->m_address, (*i)->m_tid)] = (*i);
+            }
+        }
+      else
+        {
+          self->m_stationIndex[std::make_pair (address, tid)] = station;
+        }
+    }
   return station;
 }
 
@@ -1584,6 +1639,7 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicRateSet.push_back (m_defaultTxMode);
   m_bssBasicMcsSet.clear ();
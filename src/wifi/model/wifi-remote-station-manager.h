@@ -24,6 +24,7 @@
 #include <vector>
 #include <utility>
 #include "ns3/mac48-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ns3/traced-callback.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
@@ -1185,6 +1186,38 @@ private:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * The address and the TID of a WifiRemoteStation
+   */
+  typedef std::pair<Mac48Address, uint8_t> StationKey;
+  /**
+   * Hash function of the StationKeys
+   */
+  struct StationKeyHash
+  {
+    /**
+     * \param key the address and the TID of a station
+     * \return the hash of the key
+     */
+    size_t operator() (const StationKey & key) const
+    {
+      return Mac48AddressHash () (key.first) ^ (key.second * 0x9e3779b9U);
+    }
+  };
+  /**
+   * The WifiRemoteStations, hashed by address and TID
+   */
+  typedef sgi::hash_map <StationKey, WifiRemoteStation *, StationKeyHash> StationIndex;
+  /**
+   * The WifiRemoteStationStates, hashed by address
+   */
+  typedef sgi::hash_map <Mac48Address, WifiRemoteStationState *, Mac48AddressHash> StationStateIndex;
+  /**
+   * Up to this number of stations or station states, Lookup and
+   * LookupState scan the vectors, which is faster than hashing the
+   * address; beyond it, they use the hash indexes.
+   */
+  static const uint32_t LOOKUP_INDEX_THRESHOLD = 96;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1217,6 +1250,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  StationStateIndex m_stateIndex; //!< m_states hashed by address, when there are many of them
+  StationIndex m_stationIndex;    //!< m_stations hashed by address and TID, when there are many of them
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -25,6 +25,7 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
@@ -51,11 +52,22 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "If not zero, packets are only delivered to the PHYs "
+                   "within this distance (in meters) of the sender. This "
+                   "parameter is to be used to reduce the computational "
+                   "load of large networks by not evaluating the propagation "
+                   "models for receivers that are far beyond the interference "
+                   "range. Tune this value with care.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0.0)
 {
 }
 
@@ -65,6 +77,15 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the grid holds references to the mobility models of the PHYs
+  m_grid.Clear ();
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
@@ -83,24 +104,40 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  std::vector<uint32_t> receivers;
+  if (m_maxRange > 0)
     {
-      if (sender != (*i))
+      UpdateGrid ();
+      m_grid.GetInRange (senderMobility->GetPosition (), m_maxRange, receivers);
+    }
+  uint32_t nReceivers = m_maxRange > 0 ? receivers.size () : m_phyList.size ();
+  // All the receivers share the same copy of the packet, which is
+  // taken from the sender so that it is not affected by later changes
+  // to the sender's packet, and the PHYs only copy it again when they
+  // pass it up to their MAC.
+  Ptr<const Packet> copy;
+  for (uint32_t k = 0; k < nReceivers; k++)
+    {
+      uint32_t j = m_maxRange > 0 ? receivers[k] : k;
+      Ptr<YansWifiPhy> phy = m_phyList[j];
+      if (sender != phy)
         {
           //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (phy->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> receiverMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
+          if (copy == 0)
+            {
+              copy = packet->Copy ();
+            }
+          Ptr<Object> dstNetDevice = phy->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
             {
@@ -126,7 +163,25 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const
+YansWifiChannel::UpdateGrid (void) const
+{
+  if (m_grid.GetN () == m_phyList.size () && m_grid.GetCellSize () == m_maxRange)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_grid.Clear ();
+  m_grid.SetCellSize (m_maxRange);
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      m_grid.Add (mobility);
+    }
+}
+
+void
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, struct Parameters parameters) const
 {
   m_phyList[i]->StartReceivePreambleAndHeader (packet, parameters.rxPowerDbm, parameters.txVector, parameters.preamble, parameters.type, parameters.duration);
 }
@@ -30,6 +30,7 @@
 #include "wifi-tx-vector.h"
 #include "yans-wifi-phy.h"
 #include "ns3/nstime.h"
+#include "ns3/spatial-grid.h"
 
 namespace ns3 {
 
@@ -57,6 +58,13 @@ struct Parameters
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * If the MaxRange attribute is set, the PHYs are kept in a SpatialGrid
+ * and a transmission is only delivered to the PHYs within that distance
+ * of the sender, without evaluating the propagation models for the
+ * other ones. The range should be set beyond the distance at which the
+ * propagation loss model can bring a signal above the energy detection
+ * threshold of the receivers.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -116,6 +124,8 @@ public:
 
 
 private:
+  virtual void DoDispose (void);
+
   /**
    * A vector of pointers to YansWifiPhy.
    */
@@ -127,16 +137,22 @@ private:
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param atts a vector containing the received power in dBm and the packet type
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
+  void Receive (uint32_t i, Ptr<const Packet> packet, struct Parameters parameters) const;
+  /**
+   * Put all the PHYs in the spatial grid, if it is not up to date.
+   */
+  void UpdateGrid (void) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Maximum distance to a receiver, zero if unlimited
+  mutable SpatialGrid m_grid;          //!< Position of the PHYs, indexed as m_phyList
 };
 
 } //namespace ns3
@@ -23,6 +23,10 @@
 #include "ns3/dsss-error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
 
 using namespace ns3;
 
@@ -279,6 +283,183 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+class WifiErrorRateModelsTestCaseTable : public TestCase
+{
+public:
+  /**
+   * \param model the tabulated error rate model
+   * \param name the name of the tabulated error rate model
+   * \param step the SNR step of the tables (dB)
+   * \param tolerance the maximum deviation of the success rates
+   */
+  WifiErrorRateModelsTestCaseTable (Ptr<ErrorRateModel> model, std::string name,
+                                    double step, double tolerance);
+  virtual ~WifiErrorRateModelsTestCaseTable ();
+
+private:
+  virtual void DoRun (void);
+
+  Ptr<ErrorRateModel> m_model; //!< the tabulated error rate model
+  double m_step;               //!< the SNR step of the tables (dB)
+  double m_tolerance;          //!< the maximum deviation of the success rates
+};
+
+WifiErrorRateModelsTestCaseTable::WifiErrorRateModelsTestCaseTable (Ptr<ErrorRateModel> model, std::string name,
+                                                                    double step, double tolerance)
+  : TestCase ("WifiErrorRateModel test case TableErrorRateModel of " + name),
+    m_model (model),
+    m_step (step),
+    m_tolerance (tolerance)
+{
+}
+
+WifiErrorRateModelsTestCaseTable::~WifiErrorRateModelsTestCaseTable ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTable::DoRun (void)
+{
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetDsssRate1Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate2Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate5_5Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetHtMcs0 ());
+  modes.push_back (WifiPhy::GetHtMcs1 ());
+  modes.push_back (WifiPhy::GetHtMcs2 ());
+  modes.push_back (WifiPhy::GetHtMcs3 ());
+  modes.push_back (WifiPhy::GetHtMcs4 ());
+  modes.push_back (WifiPhy::GetHtMcs5 ());
+  modes.push_back (WifiPhy::GetHtMcs6 ());
+  modes.push_back (WifiPhy::GetHtMcs7 ());
+  modes.push_back (WifiPhy::GetVhtMcs8 ());
+  modes.push_back (WifiPhy::GetVhtMcs9 ());
+
+  // an ACK, a 1500 bytes MPDU and the largest A-MPDU of 802.11n
+  uint32_t sizes[] = { 14, 1500, 65535 };
+
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (m_model));
+  table->SetAttribute ("SnrStep", DoubleValue (m_step));
+
+  // The SNRs do not fall on the bins, and go beyond the range of the tables.
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); ++mode)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (*mode);
+      // VHT MCS 9 is not allowed at 20 MHz
+      txVector.SetChannelWidth (mode->GetModulationClass () == WIFI_MOD_CLASS_VHT ? 40 : 20);
+      for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i)
+        {
+          double maxDeviation = 0;
+          double maxSnr = 0;
+          for (double snr = -15.0; snr < 65.0; snr += 0.0137)
+            {
+              double ratio = std::pow (10.0, snr / 10.0);
+              double expected = m_model->GetChunkSuccessRate (*mode, txVector, ratio, sizes[i] * 8);
+              double ps = table->GetChunkSuccessRate (*mode, txVector, ratio, sizes[i] * 8);
+              if (std::fabs (ps - expected) > maxDeviation)
+                {
+                  maxDeviation = std::fabs (ps - expected);
+                  maxSnr = snr;
+                }
+            }
+          NS_TEST_ASSERT_MSG_EQ_TOL (maxDeviation, 0, m_tolerance, "Deviation too high for " << *mode
+                                     << " and " << sizes[i] << " bytes at " << maxSnr << " dB");
+        }
+    }
+}
+
+/**
+ * A NistErrorRateModel which counts the success rates it computes.
+ */
+class CountingErrorRateModel : public NistErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const;
+
+  static uint32_t m_count; //!< the number of success rates computed
+};
+
+uint32_t CountingErrorRateModel::m_count = 0;
+
+TypeId
+CountingErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingErrorRateModel")
+    .SetParent<NistErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CountingErrorRateModel> ()
+  ;
+  return tid;
+}
+
+double
+CountingErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const
+{
+  m_count++;
+  return NistErrorRateModel::GetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+class WifiErrorRateModelsTestCaseTableSharing : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTableSharing ();
+  virtual ~WifiErrorRateModelsTestCaseTableSharing ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param step the SNR step of the tables (dB)
+   * \return the number of success rates computed by the wrapped model
+   *         for one look up in a new TableErrorRateModel
+   */
+  uint32_t LookUp (double step);
+};
+
+WifiErrorRateModelsTestCaseTableSharing::WifiErrorRateModelsTestCaseTableSharing ()
+  : TestCase ("WifiErrorRateModel test case TableErrorRateModel sharing its tables")
+{
+}
+
+WifiErrorRateModelsTestCaseTableSharing::~WifiErrorRateModelsTestCaseTableSharing ()
+{
+}
+
+uint32_t
+WifiErrorRateModelsTestCaseTableSharing::LookUp (double step)
+{
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (CreateObject<CountingErrorRateModel> ()));
+  table->SetAttribute ("SnrStep", DoubleValue (step));
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  txVector.SetChannelWidth (20);
+  uint32_t count = CountingErrorRateModel::m_count;
+  table->GetChunkSuccessRate (txVector.GetMode (), txVector, std::pow (10.0, 0.5), 1000);
+  return CountingErrorRateModel::m_count - count;
+}
+
+void
+WifiErrorRateModelsTestCaseTableSharing::DoRun (void)
+{
+  // 70 dB in steps of 0.1 and 0.2 dB, plus the last bin
+  NS_TEST_ASSERT_MSG_EQ (LookUp (0.1), 701, "The table was not computed");
+  NS_TEST_ASSERT_MSG_EQ (LookUp (0.1), 0, "The table was not shared");
+  NS_TEST_ASSERT_MSG_EQ (LookUp (0.2), 351, "A table with other bins was shared");
+}
+
 class WifiErrorRateModelsTestSuite : public TestSuite
 {
 public:
@@ -290,6 +471,10 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable (CreateObject<NistErrorRateModel> (), "NistErrorRateModel", 0.05, 5e-4), TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable (CreateObject<YansErrorRateModel> (), "YansErrorRateModel", 0.05, 5e-4), TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable (CreateObject<NistErrorRateModel> (), "NistErrorRateModel", 0.01, 2e-5), TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTableSharing, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite;
@@ -28,12 +28,16 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/interference-helper.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/wifi-mac-header.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/packet-socket-address.h"
 #include "ns3/packet-socket-server.h"
@@ -326,6 +330,87 @@ InterferenceHelperSequenceTest::DoRun (void)
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that InterferenceHelper::GetEnergyDuration returns the time until
+ * the energy on the medium falls below the threshold, when it is called
+ * several times while signals are added and expire.
+ */
+class InterferenceHelperEnergyDurationTest : public TestCase
+{
+public:
+  InterferenceHelperEnergyDurationTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * \param duration the duration of the signal
+   * \param rxPowerW the power of the signal (W)
+   */
+  void AddSignal (Time duration, double rxPowerW);
+  /**
+   * \param energyW the threshold (W)
+   * \param expected the expected energy duration
+   */
+  void CheckEnergyDuration (double energyW, Time expected);
+
+  InterferenceHelper m_interference; //!< the tested InterferenceHelper
+};
+
+InterferenceHelperEnergyDurationTest::InterferenceHelperEnergyDurationTest ()
+  : TestCase ("InterferenceHelperEnergyDuration")
+{
+}
+
+void
+InterferenceHelperEnergyDurationTest::AddSignal (Time duration, double rxPowerW)
+{
+  m_interference.AddForeignSignal (duration, rxPowerW);
+}
+
+void
+InterferenceHelperEnergyDurationTest::CheckEnergyDuration (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), expected,
+                         "Wrong energy duration at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperEnergyDurationTest::DoRun (void)
+{
+  // A: 0-100us, 1 nW; B: 10-60us, 2 nW; C: 70-80us, 1 nW
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyDurationTest::AddSignal, this,
+                       MicroSeconds (100), 1e-9);
+  Simulator::Schedule (MicroSeconds (5), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (95));
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperEnergyDurationTest::AddSignal, this,
+                       MicroSeconds (50), 2e-9);
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       2.5e-9, MicroSeconds (50));
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (80));
+  Simulator::Schedule (MicroSeconds (30), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       1.5e-9, MicroSeconds (30));
+  Simulator::Schedule (MicroSeconds (65), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (35));
+  Simulator::Schedule (MicroSeconds (70), &InterferenceHelperEnergyDurationTest::AddSignal, this,
+                       MicroSeconds (10), 1e-9);
+  Simulator::Schedule (MicroSeconds (75), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       1.5e-9, MicroSeconds (5));
+  Simulator::Schedule (MicroSeconds (75), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (25));
+  Simulator::Schedule (MicroSeconds (90), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (10));
+  Simulator::Schedule (MicroSeconds (120), &InterferenceHelperEnergyDurationTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_interference.EraseEvents ();
+}
+
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that when multiple broadcast packets are queued on the same
@@ -1090,6 +1175,200 @@ Bug2222TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_countInternalCollisions, 1, "unexpected number of internal collisions!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the WifiRemoteStationManager keeps the state of each
+ * remote station and the retry counters of each of its TIDs apart, when
+ * many stations are known.
+ */
+class WifiRemoteStationManagerLookupTest : public TestCase
+{
+public:
+  WifiRemoteStationManagerLookupTest ();
+  virtual void DoRun (void);
+};
+
+WifiRemoteStationManagerLookupTest::WifiRemoteStationManagerLookupTest ()
+  : TestCase ("Lookup of many remote stations and TIDs")
+{
+}
+
+void
+WifiRemoteStationManagerLookupTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+  manager->SetupPhy (phy);
+  manager->SetMaxSsrc (2);
+
+  const uint32_t nStations = 300;
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+      if (i % 2 == 0)
+        {
+          manager->RecordWaitAssocTxOk (addresses[i]);
+          manager->RecordGotAssocTxOk (addresses[i]);
+        }
+    }
+
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      hdr.SetAddr1 (addresses[i]);
+      hdr.SetQosTid (i % 8);
+      manager->ReportRtsFailed (addresses[i], &hdr);
+      manager->ReportRtsFailed (addresses[i], &hdr);
+    }
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (addresses[i]), (i % 2 == 0), "wrong association state of station " << i);
+      hdr.SetAddr1 (addresses[i]);
+      hdr.SetQosTid (i % 8);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedRtsRetransmission (addresses[i], &hdr, packet), false,
+                             "the RTS of station " << i << " was retransmitted too many times");
+      hdr.SetQosTid ((i + 1) % 8);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedRtsRetransmission (addresses[i], &hdr, packet), true,
+                             "the RTS failures of another TID of station " << i << " were counted");
+    }
+
+  manager->Dispose ();
+  phy->Dispose ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel with a MaxRange only delivers a
+ * transmission to the PHYs within that range of the sender.
+ */
+class YansWifiChannelMaxRangeTest : public TestCase
+{
+public:
+  YansWifiChannelMaxRangeTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run a transmission of the first of three PHYs, the second one 50 m
+   * away and the third one 500 m away, with no propagation loss.
+   *
+   * \param maxRange the MaxRange of the channel
+   */
+  void RunOne (double maxRange);
+  /**
+   * Create a PHY at the given position
+   *
+   * \param pos the position
+   * \param channel the channel
+   * \returns the PHY
+   */
+  Ptr<YansWifiPhy> CreateOne (Vector pos, Ptr<YansWifiChannel> channel);
+  /**
+   * Send a packet
+   *
+   * \param dev the sending device
+   */
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  /**
+   * Count a packet whose reception begins
+   *
+   * \param i the index of the receiving PHY
+   * \param p the packet
+   */
+  void RxBegin (uint32_t i, Ptr<const Packet> p);
+
+  std::vector<uint32_t> m_received; //!< number of receptions of each PHY
+};
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest ()
+  : TestCase ("YansWifiChannel MaxRange")
+{
+}
+
+void
+YansWifiChannelMaxRangeTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelMaxRangeTest::RxBegin (uint32_t i, Ptr<const Packet> p)
+{
+  m_received[i]++;
+}
+
+Ptr<YansWifiPhy>
+YansWifiChannelMaxRangeTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return phy;
+}
+
+void
+YansWifiChannelMaxRangeTest::RunOne (double maxRange)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  Ptr<MatrixPropagationLossModel> propLoss = CreateObject<MatrixPropagationLossModel> ();
+  propLoss->SetDefaultLoss (0);
+  channel->SetPropagationLossModel (propLoss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  Ptr<YansWifiPhy> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<YansWifiPhy> inRange = CreateOne (Vector (50.0, 0.0, 0.0), channel);
+  Ptr<YansWifiPhy> outOfRange = CreateOne (Vector (500.0, 0.0, 0.0), channel);
+  m_received.assign (3, 0);
+  inRange->TraceConnectWithoutContext ("PhyRxBegin",
+                                       MakeCallback (&YansWifiChannelMaxRangeTest::RxBegin, this).Bind (1));
+  outOfRange->TraceConnectWithoutContext ("PhyRxBegin",
+                                          MakeCallback (&YansWifiChannelMaxRangeTest::RxBegin, this).Bind (2));
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (sender->GetDevice ()));
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelMaxRangeTest::DoRun (void)
+{
+  RunOne (0);
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 1, "the PHY at 50 m did not receive the packet");
+  NS_TEST_ASSERT_MSG_EQ (m_received[2], 1, "the PHY at 500 m did not receive the packet without MaxRange");
+
+  RunOne (100);
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 1, "the PHY within MaxRange did not receive the packet");
+  NS_TEST_ASSERT_MSG_EQ (m_received[2], 0, "the PHY beyond MaxRange received the packet");
+}
+
 //-----------------------------------------------------------------------------
 
 class WifiTestSuite : public TestSuite
@@ -1104,10 +1383,13 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
+  AddTestCase (new InterferenceHelperEnergyDurationTest, TestCase::QUICK);
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
   AddTestCase (new SetChannelFrequencyTest, TestCase::QUICK);
   AddTestCase (new Bug2222TestCase, TestCase::QUICK); //Bug 2222
+  AddTestCase (new WifiRemoteStationManagerLookupTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelMaxRangeTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
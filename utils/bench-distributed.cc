@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the transfer of packets between the ranks of a distributed
+// simulation.  Each rank owns the same number of nodes, and each node is
+// linked by a point-to-point link to the node of same index on the next
+// rank, to which it sends packets at a constant interval.  Run it with
+// e.g. mpirun -np 4 bench-distributed --n=1000000 [--nullmsg].
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/node.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/packet-socket-client.h"
+#include "ns3/packet-socket-server.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+using namespace ns3;
+
+static uint64_t g_rxCount = 0;
+
+static void
+Receive (Ptr<const Packet> packet, const Address &from)
+{
+  g_rxCount++;
+}
+
+int main (int argc, char *argv[])
+{
+#ifdef NS3_MPI
+  uint32_t n = 0;
+  uint32_t nodes = 10;
+  uint32_t packetSize = 100;
+  std::string interval = "10us";
+  std::string delay = "1ms";
+  bool nullmsg = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the transfer of packets between the ranks of a distributed simulation");
+  cmd.AddValue ("n", "number of packets sent by each node", n);
+  cmd.AddValue ("nodes", "number of nodes of each rank", nodes);
+  cmd.AddValue ("packetSize", "size of the packets (bytes)", packetSize);
+  cmd.AddValue ("interval", "interval between two packets sent by a node", interval);
+  cmd.AddValue ("delay", "delay of the links between the ranks", delay);
+  cmd.AddValue ("nullmsg", "use the null message synchronization", nullmsg);
+  cmd.Parse (argc, argv);
+
+  if (nullmsg)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::NullMessageSimulatorImpl"));
+    }
+  else
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+    }
+  MpiInterface::Enable (&argc, &argv);
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  if (n == 0 || systemCount < 2)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets), " <<
+        "and at least 2 ranks must be used" << std::endl;
+      MpiInterface::Disable ();
+      exit (1);
+    }
+  if (systemId == 0)
+    {
+      std::cout << "Running bench-distributed with n=" << n
+                << ", ranks=" << systemCount
+                << ", nodes=" << nodes
+                << ", packetSize=" << packetSize
+                << ", interval=" << interval
+                << ", delay=" << delay
+                << ", nullmsg=" << nullmsg << std::endl;
+    }
+
+  // all the ranks create all the nodes and links, in the same order
+  std::vector<Ptr<Node> > allNodes;
+  for (uint32_t r = 0; r < systemCount; ++r)
+    {
+      for (uint32_t i = 0; i < nodes; ++i)
+        {
+          allNodes.push_back (CreateObject<Node> (r));
+        }
+    }
+  PacketSocketHelper packetSocket;
+  for (uint32_t i = 0; i < allNodes.size (); ++i)
+    {
+      packetSocket.Install (allNodes[i]);
+    }
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue (delay));
+  p2p.SetQueue ("ns3::DropTailQueue", "MaxPackets", UintegerValue (1000000));
+
+  Time stop = MilliSeconds (1) + Time (interval) * n;
+  for (uint32_t r = 0; r < systemCount; ++r)
+    {
+      for (uint32_t i = 0; i < nodes; ++i)
+        {
+          Ptr<Node> txNode = allNodes[r * nodes + i];
+          Ptr<Node> rxNode = allNodes[((r + 1) % systemCount) * nodes + i];
+          NetDeviceContainer devices = p2p.Install (txNode, rxNode);
+          PacketSocketAddress address;
+          // the point-to-point devices only carry the IPv4 and IPv6 protocols
+          address.SetProtocol (0x0800);
+          if (txNode->GetSystemId () == systemId)
+            {
+              address.SetSingleDevice (devices.Get (0)->GetIfIndex ());
+              address.SetPhysicalAddress (devices.Get (1)->GetAddress ());
+              Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+              client->SetAttribute ("PacketSize", UintegerValue (packetSize));
+              client->SetAttribute ("MaxPackets", UintegerValue (n));
+              client->SetAttribute ("Interval", TimeValue (Time (interval)));
+              client->SetRemote (address);
+              txNode->AddApplication (client);
+              client->SetStartTime (MilliSeconds (1) + NanoSeconds (i));
+              client->SetStopTime (stop);
+            }
+          if (rxNode->GetSystemId () == systemId)
+            {
+              address.SetSingleDevice (devices.Get (1)->GetIfIndex ());
+              Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+              server->SetLocal (address);
+              server->TraceConnectWithoutContext ("Rx", MakeCallback (&Receive));
+              rxNode->AddApplication (server);
+              server->SetStartTime (Seconds (0));
+              server->SetStopTime (stop + Seconds (1));
+            }
+        }
+    }
+
+  Simulator::Stop (stop + Seconds (1));
+  MPI_Barrier (MPI_COMM_WORLD);
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+
+  unsigned long long rxCount = g_rxCount;
+  unsigned long long totalRxCount = 0;
+  MPI_Reduce (&rxCount, &totalRxCount, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+  unsigned long long maxMs = 0;
+  unsigned long long ms = deltaMs;
+  MPI_Reduce (&ms, &maxMs, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+  if (systemId == 0)
+    {
+      double ps = totalRxCount;
+      ps *= 1000;
+      ps /= maxMs > 0 ? maxMs : 1;
+      std::cout << ps << " packets/s"
+                << " (" << maxMs << " ms elapsed, "
+                << totalRxCount << " packets received)" << std::endl;
+    }
+  MpiInterface::Disable ();
+#else
+  std::cerr << "bench-distributed requires MPI" << std::endl;
+#endif
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure ErrorRateModel::GetChunkSuccessRate, called by the
+// InterferenceHelper for every chunk of every received frame, for the
+// NistErrorRateModel and the YansErrorRateModel and for the
+// TableErrorRateModel wrapping them, on the 802.11n MCS of a 20 MHz channel.
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/pointer.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static double g_result = 0;
+
+static void
+RunBench (Ptr<ErrorRateModel> model, uint32_t n, std::string name)
+{
+  WifiMode modes[] = {
+    WifiPhy::GetHtMcs0 (), WifiPhy::GetHtMcs1 (), WifiPhy::GetHtMcs2 (), WifiPhy::GetHtMcs3 (),
+    WifiPhy::GetHtMcs4 (), WifiPhy::GetHtMcs5 (), WifiPhy::GetHtMcs6 (), WifiPhy::GetHtMcs7 ()
+  };
+  uint32_t nModes = sizeof (modes) / sizeof (modes[0]);
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (20);
+  // fill the tables, if any, before timing
+  for (uint32_t i = 0; i < nModes; ++i)
+    {
+      txVector.SetMode (modes[i]);
+      g_result += model->GetChunkSuccessRate (modes[i], txVector, 10.0, 1);
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      WifiMode mode = modes[i % nModes];
+      txVector.SetMode (mode);
+      // SNRs from 0 to 40 dB
+      double snr = std::pow (10.0, (i % 4000) / 1000.0);
+      g_result += model->GetChunkSuccessRate (mode, txVector, snr, 1500 * 8);
+    }
+  uint64_t deltaMs = time.End ();
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << ps << " chunks/s"
+            << " (" << deltaMs << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the chunk success rates of the wifi error rate models");
+  cmd.AddValue ("n", "number of chunks", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of chunks must be specified " <<
+        "by command-line argument --n=(number of chunks)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-error-rate-model with n=" << n << std::endl;
+
+  RunBench (CreateObject<NistErrorRateModel> (), n, "NistErrorRateModel");
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (CreateObject<NistErrorRateModel> ()));
+  RunBench (table, n, "TableErrorRateModel of NistErrorRateModel");
+
+  RunBench (CreateObject<YansErrorRateModel> (), n, "YansErrorRateModel");
+  table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("ErrorRateModel", PointerValue (CreateObject<YansErrorRateModel> ()));
+  RunBench (table, n, "TableErrorRateModel of YansErrorRateModel");
+
+  std::cout << "result " << g_result << std::endl;
+
+  return 0;
+}
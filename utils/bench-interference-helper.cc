@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the InterferenceHelper of a receiver which receives frames back
+// to back while a given number of other transmissions overlap with them,
+// as in a dense wifi network.  The InterferenceHelper is driven as the
+// YansWifiPhy drives it: the signals are added when they arrive, the CCA
+// energy duration is computed for each of them, and the PER of the header
+// and of the payload of each received frame is computed.  The sum of the
+// SNRs and PERs is printed, to compare the results of two builds.
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/interference-helper.h"
+#include "ns3/wifi-phy.h"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static InterferenceHelper g_interference;
+static WifiTxVector g_txVector;
+static Time g_duration;
+static double g_ccaThresholdW;
+static double g_result = 0;
+
+static void
+Interferer (uint32_t i)
+{
+  // received powers from -92 dBm to -78 dBm
+  g_interference.Add (1500, g_txVector, WIFI_PREAMBLE_HT_MF, g_duration, 1e-12 * (1 + (i * 7919) % 25));
+  g_result += g_interference.GetEnergyDuration (g_ccaThresholdW).GetSeconds ();
+}
+
+static void
+EndRx (Ptr<InterferenceHelper::Event> event)
+{
+  struct InterferenceHelper::SnrPer snrPer = g_interference.CalculatePlcpPayloadSnrPer (event);
+  g_interference.NotifyRxEnd ();
+  g_result += snrPer.snr + snrPer.per;
+}
+
+static void
+StartRx (void)
+{
+  Ptr<InterferenceHelper::Event> event;
+  event = g_interference.Add (1500, g_txVector, WIFI_PREAMBLE_HT_MF, g_duration, 1e-9);
+  g_interference.NotifyRxStart ();
+  struct InterferenceHelper::SnrPer snrPer = g_interference.CalculatePlcpHeaderSnrPer (event);
+  g_result += snrPer.snr + snrPer.per;
+  Simulator::Schedule (g_duration, &EndRx, event);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t interferers = 10;
+  double ccaThreshold = -62;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the InterferenceHelper with overlapping transmissions");
+  cmd.AddValue ("n", "number of received frames", n);
+  cmd.AddValue ("interferers", "number of transmissions which overlap with each frame", interferers);
+  cmd.AddValue ("ccaThreshold", "the CCA mode 1 threshold (dBm)", ccaThreshold);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of frames must be specified " <<
+        "by command-line argument --n=(number of frames)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-interference-helper with n=" << n
+            << ", interferers=" << interferers
+            << ", ccaThreshold=" << ccaThreshold << std::endl;
+
+  g_ccaThresholdW = std::pow (10.0, (ccaThreshold - 30) / 10.0);
+  g_interference.SetNoiseFigure (5.01187);
+  g_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  g_txVector.SetMode (WifiPhy::GetHtMcs7 ());
+  g_txVector.SetChannelWidth (20);
+  // a 1500 bytes frame at HT MCS 7, with its HT mixed format preamble
+  g_duration = MicroSeconds (224);
+
+  // the frames are received back to back, with a gap of 1 us
+  Time period = g_duration + MicroSeconds (1);
+  Time interval = g_duration / interferers;
+  uint32_t nInterferers = static_cast<uint32_t> ((period * n) / interval);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Simulator::Schedule (period * i, &StartRx);
+    }
+  for (uint32_t i = 0; i < nInterferers; ++i)
+    {
+      Simulator::Schedule (interval * i + NanoSeconds (i % 997), &Interferer, i);
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << ps << " frames/s"
+            << " (" << deltaMs << " ms elapsed, "
+            << nInterferers << " interfering signals)" << std::endl;
+  std::cout << "result " << std::setprecision (17) << g_result << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the unicast route lookups of Ipv4GlobalRouting and
+// Ipv4StaticRouting, with tables shaped like the ones which
+// Ipv4GlobalRoutingHelper::PopulateRoutingTables builds for a
+// point-to-point topology: one /32 host route per router and one /30
+// network route per link.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * \param base The first address.
+ * \param i A router or link index.
+ * \returns The address of the router, or the network of the link.
+ */
+static Ipv4Address
+GetAddress (uint32_t base, uint32_t i)
+{
+  return Ipv4Address (base + (i << 2));
+}
+
+static void
+runBench (Ptr<Ipv4RoutingProtocol> routing, const std::vector<Ipv4Address> &dests,
+          uint32_t n, char const *name)
+{
+  Ptr<Packet> p = Create<Packet> ();
+  Ipv4Header header;
+  Socket::SocketErrno sockerr;
+  uint32_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      header.SetDestination (dests[i % dests.size ()]);
+      if (routing->RouteOutput (p, header, 0, sockerr) != 0)
+        {
+          found++;
+        }
+    }
+  uint64_t deltaMs = time.End ();
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << ps << " lookups/s"
+            << " (" << deltaMs << " ms elapsed, " << found << " routes found)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nRoutes = 2000;
+  uint32_t n = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark Ipv4GlobalRouting and Ipv4StaticRouting lookups");
+  cmd.AddValue ("routes", "number of host routes and of network routes", nRoutes);
+  cmd.AddValue ("n", "number of lookups", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of lookups must be specified " <<
+        "by command-line argument --n=(number of lookups)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-ipv4-routing with routes=" << nRoutes
+            << " n=" << n << std::endl;
+
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (device);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  uint32_t interface = ipv4->AddInterface (device);
+  ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address ("192.168.0.1"), Ipv4Mask ("255.255.255.0")));
+  ipv4->SetUp (interface);
+
+  Ptr<Ipv4GlobalRouting> global = CreateObject<Ipv4GlobalRouting> ();
+  global->SetIpv4 (ipv4);
+  Ptr<Ipv4StaticRouting> stat = CreateObject<Ipv4StaticRouting> ();
+  stat->SetIpv4 (ipv4);
+
+  uint32_t hostBase = Ipv4Address ("10.0.0.1").Get ();
+  uint32_t networkBase = Ipv4Address ("172.16.0.0").Get ();
+  Ipv4Address gateway ("192.168.0.2");
+  Ipv4Mask linkMask ("255.255.255.252");
+  for (uint32_t i = 0; i < nRoutes; ++i)
+    {
+      global->AddHostRouteTo (GetAddress (hostBase, i), gateway, interface);
+      global->AddNetworkRouteTo (GetAddress (networkBase, i), linkMask, gateway, interface);
+      stat->AddHostRouteTo (GetAddress (hostBase, i), gateway, interface);
+      stat->AddNetworkRouteTo (GetAddress (networkBase, i), linkMask, gateway, interface);
+    }
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  std::vector<Ipv4Address> hosts;
+  std::vector<Ipv4Address> networks;
+  for (uint32_t i = 0; i < 10000; ++i)
+    {
+      uint32_t route = random->GetInteger (0, nRoutes - 1);
+      hosts.push_back (GetAddress (hostBase, route));
+      networks.push_back (Ipv4Address (GetAddress (networkBase, route).Get () + 1));
+    }
+
+  runBench (global, hosts, n, "Ipv4GlobalRouting, host routes");
+  runBench (global, networks, n, "Ipv4GlobalRouting, network routes");
+  runBench (stat, hosts, n, "Ipv4StaticRouting, host routes");
+  runBench (stat, networks, n, "Ipv4StaticRouting, network routes");
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the WifiRemoteStationManager of an access point with many
+// associated stations.  The stations are registered as the ApWifiMac
+// registers them on association, then the calls done by the ApWifiMac and
+// the MacLow for each data frame sent to a station and acknowledged by it
+// are repeated, for all the stations and for several TIDs.
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/nqos-wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t stations = 500;
+  uint32_t tids = 4;
+  std::string manager = "ns3::ArfWifiManager";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the remote station manager of an access point with many stations");
+  cmd.AddValue ("n", "number of data frames", n);
+  cmd.AddValue ("stations", "number of associated stations", stations);
+  cmd.AddValue ("tids", "number of TIDs used towards each station", tids);
+  cmd.AddValue ("manager", "the type of the remote station manager", manager);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of frames must be specified " <<
+        "by command-line argument --n=(number of frames)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-remote-station-manager with n=" << n
+            << ", stations=" << stations
+            << ", tids=" << tids
+            << ", manager=" << manager << std::endl;
+
+  NodeContainer ap;
+  ap.Create (1);
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager (manager);
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::ApWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, ap);
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiRemoteStationManager> stationManager = device->GetRemoteStationManager ();
+  Ptr<WifiPhy> wifiPhy = device->GetPhy ();
+
+  // associate the stations, as the ApWifiMac does
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < stations; ++i)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      stationManager->AddSupportedPlcpPreamble (address, false);
+      for (uint32_t j = 0; j < wifiPhy->GetNModes (); j++)
+        {
+          stationManager->AddSupportedMode (address, wifiPhy->GetMode (j));
+        }
+      stationManager->RecordWaitAssocTxOk (address);
+      stationManager->RecordGotAssocTxOk (address);
+      addresses.push_back (address);
+    }
+
+  Ptr<Packet> packet = Create<Packet> (1500);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr2 (device->GetMac ()->GetAddress ());
+  WifiMode ackMode = wifiPhy->GetMode (0);
+  uint64_t result = 0;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      // visit the stations in a scattered order
+      Mac48Address to = addresses[(i * 7919U) % stations];
+      hdr.SetAddr1 (to);
+      hdr.SetQosTid ((i / stations) % tids);
+      if (!stationManager->IsAssociated (to))
+        {
+          continue;
+        }
+      WifiTxVector txVector = stationManager->GetDataTxVector (to, &hdr, packet);
+      result += stationManager->NeedRts (to, &hdr, packet, txVector);
+      if (i % 8 == 0)
+        {
+          stationManager->ReportDataFailed (to, &hdr);
+          result += stationManager->NeedDataRetransmission (to, &hdr, packet);
+        }
+      stationManager->ReportRxOk (to, &hdr, 100.0, ackMode);
+      stationManager->ReportDataOk (to, &hdr, 100.0, ackMode, 100.0);
+      result += txVector.GetMode ().GetUid ();
+    }
+  uint64_t deltaMs = time.End ();
+  Simulator::Destroy ();
+
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << ps << " frames/s"
+            << " (" << deltaMs << " ms elapsed)" << std::endl;
+  std::cout << "result " << result << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the SpectrumValue computations done per received signal by
+// SpectrumInterference, LteInterference, LteChunkProcessor and
+// SpectrumWifiPhy, written with the SpectrumValue operators and with the
+// fused SpectrumValue functions, on the spectrum models of a 100 RB LTE
+// carrier and of a 20 MHz wifi channel at 2.4 GHz.
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static double g_result = 0;
+
+static void
+Report (uint64_t deltaMs, uint32_t n, std::string model, char const *name)
+{
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << ps << " computations/s"
+            << " (" << deltaMs << " ms elapsed)\t"
+            << model << ", " << name
+            << std::endl;
+}
+
+static void
+RunBench (Ptr<const SpectrumValue> psd, Ptr<const SpectrumValue> noise,
+          Ptr<const SpectrumValue> filter, uint32_t n, std::string model)
+{
+  SpectrumValue signal = (*psd) * 1e-9;
+  SpectrumValue allSignals = signal + (*psd) * 1e-10;
+  SpectrumValue gain = (*filter) * 0.5 + 0.25;
+  SpectrumValue res (psd->GetSpectrumModel ());
+  SpectrumValue sum (psd->GetSpectrumModel ());
+  SystemWallClockMs time;
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      SpectrumValue sinr = signal / (allSignals - signal + (*noise));
+      g_result += sinr[0];
+    }
+  Report (time.End (), n, model, "sinr = signal / (allSignals - signal + noise)");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      SpectrumValue sinr (signal.GetSpectrumModel ());
+      Sinr (sinr, signal, allSignals, *noise);
+      g_result += sinr[0];
+    }
+  Report (time.End (), n, model, "Sinr (sinr, signal, allSignals, noise)");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      res = (*psd) * gain + (*noise);
+      g_result += res[0];
+    }
+  Report (time.End (), n, model, "res = psd * gain + noise");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      MultiplyAdd (res, *psd, gain, *noise);
+      g_result += res[0];
+    }
+  Report (time.End (), n, model, "MultiplyAdd (res, psd, gain, noise)");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sum += signal * 1e-3;
+    }
+  g_result += sum[0];
+  Report (time.End (), n, model, "sum += sinr * duration");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sum.MultiplyAdd (signal, 1e-3);
+    }
+  g_result += sum[0];
+  Report (time.End (), n, model, "sum.MultiplyAdd (sinr, duration)");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      g_result += Integral ((*filter) * (*psd));
+    }
+  Report (time.End (), n, model, "Integral (filter * psd)");
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      g_result += Integral (*filter, *psd);
+    }
+  Report (time.End (), n, model, "Integral (filter, psd)");
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the SpectrumValue operators and fused functions");
+  cmd.AddValue ("n", "number of computations", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of computations must be specified " <<
+        "by command-line argument --n=(number of computations)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-spectrum-value with n=" << n << std::endl;
+
+  // downlink of a 20 MHz (100 RB) carrier in band 1
+  uint16_t earfcn = 100;
+  uint8_t rbs = 100;
+  std::vector<int> activeRbs;
+  for (uint8_t i = 0; i < rbs; ++i)
+    {
+      activeRbs.push_back (i);
+    }
+  Ptr<SpectrumValue> ltePsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (earfcn, rbs, 30, activeRbs);
+  Ptr<SpectrumValue> lteNoise = LteSpectrumValueHelper::CreateNoisePowerSpectralDensity (earfcn, rbs, 9);
+  Ptr<SpectrumValue> lteFilter = Create<SpectrumValue> (ltePsd->GetSpectrumModel ());
+  (*lteFilter) = 1;
+  RunBench (ltePsd, lteNoise, lteFilter, n, "LTE 100 RB");
+
+  // 802.11n channel 1
+  uint32_t frequency = 2412;
+  uint32_t channelWidth = 20;
+  Ptr<SpectrumValue> wifiPsd = WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (frequency, channelWidth, 0.1);
+  Ptr<SpectrumValue> wifiNoise = WifiSpectrumValueHelper::CreateNoisePowerSpectralDensity (frequency, channelWidth, 7);
+  Ptr<SpectrumValue> wifiFilter = WifiSpectrumValueHelper::CreateRfFilter (frequency, channelWidth);
+  RunBench (wifiPsd, wifiNoise, wifiFilter, n, "wifi 2.4 GHz 20 MHz");
+
+  std::cout << "result " << g_result << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure how many bytes of bulk TCP transfers are simulated per second
+// of wall-clock time. Long-lived flows cross a fast link with a large
+// bandwidth-delay product, so that the send and receive buffers of
+// TcpSocketBase hold many application writes.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static uint32_t g_writeSize = 512;     //!< Size of the application writes
+static uint64_t g_flowBytes = 0;       //!< Bytes to send on each flow
+static uint64_t g_received = 0;        //!< Bytes received on all flows
+static std::vector<uint64_t> g_sent;   //!< Bytes sent on each flow
+
+static void
+WriteUntilBufferFull (Ptr<Socket> socket, uint32_t flow)
+{
+  static std::vector<uint8_t> data;
+  data.resize (g_writeSize, 0);
+  while (g_sent[flow] < g_flowBytes && socket->GetTxAvailable () > 0)
+    {
+      uint32_t left = static_cast<uint32_t> (std::min<uint64_t> (g_flowBytes - g_sent[flow], g_writeSize));
+      uint32_t size = std::min (left, socket->GetTxAvailable ());
+      int sent = socket->Send (&data[0], size, 0);
+      if (sent <= 0)
+        {
+          return;
+        }
+      g_sent[flow] += sent;
+    }
+}
+
+static void
+SendCallback (uint32_t flow, Ptr<Socket> socket, uint32_t available)
+{
+  WriteUntilBufferFull (socket, flow);
+}
+
+static void
+ConnectionSucceeded (uint32_t flow, Ptr<Socket> socket)
+{
+  WriteUntilBufferFull (socket, flow);
+}
+
+static void
+ConnectionFailed (Ptr<Socket> socket)
+{
+  NS_FATAL_ERROR ("connection failed");
+}
+
+static void
+Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      g_received += packet->GetSize ();
+    }
+}
+
+static void
+Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&Receive));
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFlows = 4;
+  uint32_t megabytes = 50;
+  uint32_t bufferSize = 4 << 20;
+  std::string rate = "10Gbps";
+  std::string delay = "10ms";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark bulk TCP transfers over a fast link");
+  cmd.AddValue ("flows", "number of flows", nFlows);
+  cmd.AddValue ("megabytes", "megabytes to send on each flow", megabytes);
+  cmd.AddValue ("buffer", "size of the send and receive buffers", bufferSize);
+  cmd.AddValue ("write", "size of the application writes", g_writeSize);
+  cmd.AddValue ("rate", "data rate of the link", rate);
+  cmd.AddValue ("delay", "delay of the link", delay);
+  cmd.Parse (argc, argv);
+
+  g_flowBytes = static_cast<uint64_t> (megabytes) << 20;
+  g_sent.assign (nFlows, 0);
+  std::cout << "Running bench-tcp-bulk with flows=" << nFlows << " megabytes=" << megabytes
+            << " buffer=" << bufferSize << " write=" << g_writeSize
+            << " rate=" << rate << " delay=" << delay << std::endl;
+
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::Queue::MaxPackets", UintegerValue (100000));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  SimpleNetDeviceHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue (rate));
+  link.SetChannelAttribute ("Delay", StringValue (delay));
+  link.SetNetDevicePointToPointMode (true);
+  NetDeviceContainer devices = link.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 5000;
+  Ptr<Socket> listener = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+  listener->Listen ();
+  listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&Accept));
+
+  for (uint32_t flow = 0; flow < nFlows; flow++)
+    {
+      Ptr<Socket> sender = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+      sender->Bind ();
+      sender->SetConnectCallback (MakeBoundCallback (&ConnectionSucceeded, flow),
+                                  MakeCallback (&ConnectionFailed));
+      sender->SetSendCallback (MakeBoundCallback (&SendCallback, flow));
+      // connect once the nodes are initialized
+      Simulator::Schedule (MilliSeconds (1), &Socket::Connect, sender,
+                           Address (InetSocketAddress (interfaces.GetAddress (1), port)));
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  double bps = g_received;
+  bps *= 1000;
+  bps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << g_received << " bytes received in " << Simulator::Now ().GetSeconds ()
+            << " simulated seconds, " << deltaMs << " ms elapsed, "
+            << bps << " simulated bytes/s" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the invocation of TracedCallback with the signatures of the
+// busiest trace sources of the wifi and internet modules, with none, one
+// and two functions connected.  The Ipv4L3Protocol Tx source is measured
+// with the packet copy of Ipv4L3Protocol::CallTxTrace, with and without
+// the TracedCallback::IsEmpty check.
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/traced-callback.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/wifi-phy.h"
+#include <iostream>
+#include <string>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static uint32_t g_calls = 0;
+
+static void
+PacketSink (Ptr<const Packet> packet)
+{
+  g_calls++;
+}
+
+static void
+MonitorSnifferRxSink (Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                      uint16_t channelNumber, uint32_t rate, WifiPreamble preamble,
+                      WifiTxVector txVector, struct mpduInfo aMpdu, struct signalNoiseDbm signalNoise)
+{
+  g_calls++;
+}
+
+static void
+Ipv4TxRxSink (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  g_calls++;
+}
+
+static void
+SendOutgoingSink (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface)
+{
+  g_calls++;
+}
+
+/**
+ * \param trace The traced callback.
+ * \param cb The function to connect.
+ * \param sinks The number of times to connect it.
+ */
+template <typename T>
+static void
+ConnectSinks (T &trace, const CallbackBase &cb, uint32_t sinks)
+{
+  for (uint32_t i = 0; i < sinks; ++i)
+    {
+      trace.ConnectWithoutContext (cb);
+    }
+}
+
+static void
+Report (uint64_t deltaMs, uint32_t n, uint32_t sinks, char const *name)
+{
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs > 0 ? deltaMs : 1;
+  std::cout << ps << " invocations/s"
+            << " (" << deltaMs << " ms elapsed, " << sinks << " sinks)\t"
+            << name
+            << std::endl;
+}
+
+// WifiPhy PhyTxBegin, PhyRxBegin, PhyRxEnd, WifiMac MacTx, MacRx, ...
+static void
+BenchPacket (uint32_t n, uint32_t sinks)
+{
+  TracedCallback<Ptr<const Packet> > trace;
+  ConnectSinks (trace, MakeCallback (&PacketSink), sinks);
+  Ptr<const Packet> packet = Create<Packet> (1000);
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      trace (packet);
+    }
+  Report (time.End (), n, sinks, "WifiPhy PhyRxBegin, WifiMac MacTx");
+}
+
+static void
+BenchMonitorSnifferRx (uint32_t n, uint32_t sinks)
+{
+  TracedCallback<Ptr<const Packet>, uint16_t, uint16_t, uint32_t,
+                 WifiPreamble, WifiTxVector, struct mpduInfo, struct signalNoiseDbm> trace;
+  ConnectSinks (trace, MakeCallback (&MonitorSnifferRxSink), sinks);
+  Ptr<const Packet> packet = Create<Packet> (1000);
+  WifiTxVector txVector;
+  struct mpduInfo aMpdu;
+  aMpdu.type = NORMAL_MPDU;
+  aMpdu.mpduRefNumber = 0;
+  struct signalNoiseDbm signalNoise;
+  signalNoise.signal = -60;
+  signalNoise.noise = -90;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      trace (packet, 5180, 36, 12, WIFI_PREAMBLE_LONG, txVector, aMpdu, signalNoise);
+    }
+  Report (time.End (), n, sinks, "WifiPhy MonitorSnifferRx");
+}
+
+static void
+BenchIpv4Rx (uint32_t n, uint32_t sinks)
+{
+  TracedCallback<Ptr<const Packet>, Ptr<Ipv4>, uint32_t> trace;
+  ConnectSinks (trace, MakeCallback (&Ipv4TxRxSink), sinks);
+  Ptr<const Packet> packet = Create<Packet> (1000);
+  Ptr<Ipv4> ipv4 = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      trace (packet, ipv4, 1);
+    }
+  Report (time.End (), n, sinks, "Ipv4L3Protocol Rx");
+}
+
+static void
+BenchSendOutgoing (uint32_t n, uint32_t sinks)
+{
+  TracedCallback<const Ipv4Header &, Ptr<const Packet>, uint32_t> trace;
+  ConnectSinks (trace, MakeCallback (&SendOutgoingSink), sinks);
+  Ptr<const Packet> packet = Create<Packet> (1000);
+  Ipv4Header header;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      trace (header, packet, 1);
+    }
+  Report (time.End (), n, sinks, "Ipv4L3Protocol SendOutgoing");
+}
+
+static void
+BenchIpv4Tx (uint32_t n, uint32_t sinks, bool checkEmpty)
+{
+  TracedCallback<Ptr<const Packet>, Ptr<Ipv4>, uint32_t> trace;
+  ConnectSinks (trace, MakeCallback (&Ipv4TxRxSink), sinks);
+  Ptr<Packet> packet = Create<Packet> (1000);
+  Ptr<Ipv4> ipv4 = 0;
+  Ipv4Header header;
+  header.SetPayloadSize (1000);
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      if (checkEmpty && trace.IsEmpty ())
+        {
+          continue;
+        }
+      Ptr<Packet> packetCopy = packet->Copy ();
+      packetCopy->AddHeader (header);
+      trace (packetCopy, ipv4, 1);
+    }
+  Report (time.End (), n, sinks, checkEmpty ?
+          "Ipv4L3Protocol Tx, with the packet copy, IsEmpty checked" :
+          "Ipv4L3Protocol Tx, with the packet copy");
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the invocation of TracedCallback");
+  cmd.AddValue ("n", "number of invocations", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of invocations must be specified " <<
+        "by command-line argument --n=(number of invocations)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-traced-callback with n=" << n << std::endl;
+
+  for (uint32_t sinks = 0; sinks <= 2; ++sinks)
+    {
+      BenchPacket (n, sinks);
+      BenchMonitorSnifferRx (n, sinks);
+      BenchIpv4Rx (n, sinks);
+      BenchSendOutgoing (n, sinks);
+      BenchIpv4Tx (n, sinks, false);
+      BenchIpv4Tx (n, sinks, true);
+    }
+  std::cout << g_calls << " functions called" << std::endl;
+
+  return 0;
+}
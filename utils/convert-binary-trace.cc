@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a binary trace file, written by the BinaryTraceHelperForDevice
+// EnableBinary methods, to the ascii trace format.
+
+#include "ns3/core-module.h"
+#include "ns3/binary-trace-file.h"
+#include <iostream>
+#include <fstream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file to the ascii trace format");
+  cmd.AddValue ("input", "the binary trace file", input);
+  cmd.AddValue ("output", "the ascii trace file, or the standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "No input file, see --help" << std::endl;
+      return 1;
+    }
+
+  //
+  // The time steps of the file are converted with the resolution of the
+  // simulation which wrote it.
+  //
+  Time::Unit resolution;
+  {
+    BinaryTraceReader header (input);
+    if (header.Fail ())
+      {
+        std::cerr << "Invalid binary trace file " << input << std::endl;
+        return 1;
+      }
+    resolution = header.GetResolution ();
+  }
+  Time::SetResolution (resolution);
+
+  BinaryTraceReader reader (input);
+  std::ofstream file;
+  std::ostream *os = &std::cout;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file.good ())
+        {
+          std::cerr << "Could not open " << output << std::endl;
+          return 1;
+        }
+      os = &file;
+    }
+  reader.PrintAscii (*os);
+  if (reader.Fail ())
+    {
+      std::cerr << "Corrupted binary trace file " << input << std::endl;
+      return 1;
+    }
+  return 0;
+}